@@ -0,0 +1,68 @@
+"""
+OpenClaw Gateway Bridge - Gateway Stand-in
+
+A local stand-in for the OpenClaw gateway's message API, for running the
+bridge without the real thing. Features:
+- POST /api/v1/message with "stream": true answers with server-sent
+  events ("data: {"delta": ...}" then "data: [DONE]"); otherwise JSON
+- Scripted timing: delay before the first token, then a fixed interval
+  between tokens, like a model generating
+- Replies echo the message followed by filler text of a set length
+
+Usage:
+    python gateway_standin.py --port 8080 --first-token-ms 300 --token-ms 30
+    OPENCLAW_GATEWAY_URL=http://localhost:8080 python main.py
+"""
+
+import argparse
+import asyncio
+import json
+
+import uvicorn
+from fastapi import FastAPI
+from fastapi.responses import JSONResponse, StreamingResponse
+
+FILLER = ("The quick brown fox jumps over the lazy dog while the Cardputer "
+          "listens patiently for the rest of the answer to arrive. ")
+
+app = FastAPI(title="OpenClaw Gateway Stand-in")
+settings = argparse.Namespace(first_token_ms=300.0, token_ms=30.0, reply_words=60)
+
+
+def reply_tokens(message: str) -> list[str]:
+    words = f"You said: {message}. ".split() + (FILLER.split() * settings.reply_words)
+    words = words[:max(1, settings.reply_words)]
+    # Tokens carry their leading space, as most model tokenizers do
+    return [word if i == 0 else " " + word for i, word in enumerate(words)]
+
+
+@app.post("/api/v1/message")
+async def message(payload: dict):
+    tokens = reply_tokens(payload.get("message", ""))
+
+    if not payload.get("stream"):
+        await asyncio.sleep((settings.first_token_ms + settings.token_ms * len(tokens)) / 1000)
+        return JSONResponse({"response": "".join(tokens)})
+
+    async def events():
+        await asyncio.sleep(settings.first_token_ms / 1000)
+        for i, token in enumerate(tokens):
+            if i > 0:
+                await asyncio.sleep(settings.token_ms / 1000)
+            yield f"data: {json.dumps({'delta': token})}\n\n"
+        yield "data: [DONE]\n\n"
+
+    return StreamingResponse(events(), media_type="text/event-stream")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Stand-in for the OpenClaw gateway")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--first-token-ms", type=float, default=300.0)
+    parser.add_argument("--token-ms", type=float, default=30.0, help="interval between tokens")
+    parser.add_argument("--reply-words", type=int, default=60, help="tokens per reply")
+    args = parser.parse_args()
+    settings.first_token_ms = args.first_token_ms
+    settings.token_ms = args.token_ms
+    settings.reply_words = args.reply_words
+    uvicorn.run(app, host="0.0.0.0", port=args.port, log_level="warning")
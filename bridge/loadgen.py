@@ -0,0 +1,304 @@
+"""
+OpenClaw Gateway Bridge - Load Generator
+
+Simulates a fleet of Cardputers against a running bridge and reports
+latency percentiles. Features:
+- N devices connect over a ramp, negotiate a codec and authenticate
+- Each device replays ping traffic at a fixed rate, and optionally text
+  requests (these go through to the OpenClaw gateway)
+- Round trips are matched exactly: the ping timestamp carries a sequence
+  number that the bridge echoes back
+- Reports connect, ping, first-chunk and text latency (p50/p90/p99/max)
+  and throughput
+- Barge-in: a share of replies is interrupted at their first chunk by a
+  CANCEL and a new turn; reports how fast the new turn's first chunk
+  arrives and how many frames of cancelled turns still came down
+- Same-turn voice: a share of requests are two utterances sent under one
+  turn id, as firmware that kept one turn per listening session did; the
+  second supersedes the first, so any turn answered twice is reported
+  (needs STT_BACKEND=stub or a real STT backend on the bridge)
+
+Usage:
+    python loadgen.py --devices 2000 --duration 60 --rate 2
+    python loadgen.py --devices 50 --rate 1 --same-turn-ratio 0.5
+"""
+
+import argparse
+import asyncio
+import base64
+import random
+import time
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional
+
+import websockets
+
+from main import CODEC_JSON, CODEC_V1, CODEC_V2, ProtocolMessage, encode_message
+
+CODECS = {"v2": CODEC_V2, "v1": CODEC_V1, "json": CODEC_JSON}
+
+# One 20 ms frame of 16 kHz PCM16 silence, as the device streams it
+AUDIO_FRAME = base64.b64encode(bytes(640)).decode()
+UTTERANCE_FRAMES = 10
+
+
+@dataclass
+class LoadStats:
+    """Counters shared by all simulated devices."""
+    connect_ms: List[float] = field(default_factory=list)
+    ping_ms: List[float] = field(default_factory=list)
+    text_ms: List[float] = field(default_factory=list)
+    first_chunk_ms: List[float] = field(default_factory=list)
+    barge_in_ms: List[float] = field(default_factory=list)
+    stale_frames: int = 0
+    same_turns: int = 0
+    repeat_finals: int = 0
+    connected: int = 0
+    connect_failures: int = 0
+    auth_failures: int = 0
+    disconnects: int = 0
+    sent: int = 0
+    received: int = 0
+    lost_pings: int = 0
+
+
+def percentile(samples: List[float], pct: float) -> float:
+    if not samples:
+        return 0.0
+    ordered = sorted(samples)
+    index = min(len(ordered) - 1, int(round(pct / 100 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def decode(frame) -> Optional[ProtocolMessage]:
+    if isinstance(frame, bytes):
+        return ProtocolMessage.from_binary(frame)
+    return ProtocolMessage.from_json(frame)
+
+
+class SimulatedDevice:
+    """One Cardputer: authenticates, then replays pings and text requests."""
+
+    def __init__(self, index: int, args: argparse.Namespace, stats: LoadStats):
+        self.device_id = f"{args.device_prefix}-{index:05d}"
+        self.args = args
+        self.stats = stats
+        self.codec = CODECS[args.codec]
+        self.pending_pings: Dict[int, float] = {}
+        self.text_sent_at: Optional[float] = None
+        self.awaiting_first_chunk = False
+        self.barged_in = False
+        self.turn = 0
+        self.answered_turns: set = set()
+        self.next_seq = 1
+
+    async def send(self, websocket, message: ProtocolMessage):
+        data, text = encode_message(message, self.codec)
+        await websocket.send(text if text is not None else data)
+        self.stats.sent += 1
+
+    async def run(self, start_delay: float, stop_at: float):
+        await asyncio.sleep(start_delay)
+        started = time.perf_counter()
+        try:
+            websocket = await websockets.connect(self.args.url, subprotocols=[self.codec],
+                                                 open_timeout=self.args.timeout, max_size=None)
+        except Exception:
+            self.stats.connect_failures += 1
+            return
+
+        try:
+            # The bridge may pick no codec for an old offer; it then speaks v1
+            if websocket.subprotocol is None:
+                self.codec = CODEC_V1
+
+            await self.send(websocket, ProtocolMessage(type="auth", payload={
+                "device_id": self.device_id,
+                "device_name": "loadgen",
+                "version": "loadgen",
+                "api_key": self.args.api_key or "",
+                "capabilities": ["text", "stream"]
+            }))
+            reply = decode(await asyncio.wait_for(websocket.recv(), self.args.timeout))
+            if not reply or reply.type != "auth_response" or not reply.payload.get("success"):
+                self.stats.auth_failures += 1
+                return
+
+            self.stats.connect_ms.append((time.perf_counter() - started) * 1000)
+            self.stats.connected += 1
+
+            receiver = asyncio.create_task(self.receive(websocket))
+            try:
+                await self.replay(websocket, stop_at)
+                # Give the last replies a chance to arrive
+                await asyncio.sleep(min(self.args.timeout, 1.0))
+            finally:
+                receiver.cancel()
+        except (websockets.ConnectionClosed, asyncio.TimeoutError, OSError):
+            self.stats.disconnects += 1
+        finally:
+            self.stats.lost_pings += len(self.pending_pings)
+            await websocket.close()
+
+    async def replay(self, websocket, stop_at: float):
+        interval = 1.0 / self.args.rate
+        # Spread devices across the interval so the fleet doesn't tick in lockstep
+        await asyncio.sleep(random.uniform(0, interval))
+
+        while time.perf_counter() < stop_at:
+            draw = random.random()
+            if self.text_sent_at is None and draw < self.args.text_ratio:
+                await self.send_turn(websocket)
+            elif self.text_sent_at is None and draw < self.args.text_ratio + self.args.same_turn_ratio:
+                await self.send_same_turn_voice(websocket)
+            else:
+                seq = self.next_seq
+                self.next_seq += 1
+                self.pending_pings[seq] = time.perf_counter()
+                await self.send(websocket, ProtocolMessage(type="ping", payload={"timestamp": seq}))
+            await asyncio.sleep(interval)
+
+    async def send_turn(self, websocket):
+        self.turn += 1
+        self.text_sent_at = time.perf_counter()
+        self.awaiting_first_chunk = True
+        await self.send(websocket, ProtocolMessage(type="text", payload={
+            "text": f"load test from {self.device_id}",
+            "turn": self.turn
+        }))
+
+    async def send_same_turn_voice(self, websocket):
+        """Two utterances under one turn id, the second right after the first
+        ended, while the bridge is still working on it."""
+        self.turn += 1
+        self.text_sent_at = time.perf_counter()
+        self.awaiting_first_chunk = True
+        self.stats.same_turns += 1
+        for utterance in range(2):
+            if utterance:
+                await asyncio.sleep(self.args.utterance_gap_ms / 1000)
+            for frame in range(UTTERANCE_FRAMES):
+                await self.send(websocket, ProtocolMessage(type="audio", payload={
+                    "data": AUDIO_FRAME,
+                    "codec": "pcm",
+                    "is_final": frame == UTTERANCE_FRAMES - 1,
+                    "turn": self.turn
+                }))
+
+    async def barge_in(self, websocket):
+        await self.send(websocket, ProtocolMessage(type="command", payload={
+            "command": "cancel",
+            "turn": self.turn
+        }))
+        self.barged_in = True
+        await self.send_turn(websocket)
+
+    async def receive(self, websocket):
+        try:
+            await self.receive_frames(websocket)
+        except websockets.ConnectionClosed:
+            self.stats.disconnects += 1
+
+    async def receive_frames(self, websocket):
+        async for frame in websocket:
+            message = decode(frame)
+            if not message:
+                continue
+            self.stats.received += 1
+            now = time.perf_counter()
+
+            # Replies to a cancelled turn: the device would drop these
+            turn = message.payload.get("turn")
+            if turn and turn != self.turn:
+                self.stats.stale_frames += 1
+                continue
+
+            # A device shows one answer per turn; another is a superseded
+            # utterance the bridge kept working on
+            if message.type in ("response_final", "error") and turn:
+                if turn in self.answered_turns:
+                    self.stats.repeat_finals += 1
+                    continue
+                self.answered_turns.add(turn)
+
+            if message.type == "pong":
+                sent_at = self.pending_pings.pop(message.payload.get("ping_timestamp"), None)
+                if sent_at is not None:
+                    self.stats.ping_ms.append((now - sent_at) * 1000)
+            elif message.type == "response" and message.payload.get("append") and self.awaiting_first_chunk:
+                latency_ms = (now - self.text_sent_at) * 1000
+                self.awaiting_first_chunk = False
+                if self.barged_in:
+                    self.barged_in = False
+                    self.stats.barge_in_ms.append(latency_ms)
+                else:
+                    self.stats.first_chunk_ms.append(latency_ms)
+                    if random.random() < self.args.barge_in_ratio:
+                        await self.barge_in(websocket)
+            elif message.type in ("response_final", "error") and self.text_sent_at is not None:
+                self.stats.text_ms.append((now - self.text_sent_at) * 1000)
+                self.text_sent_at = None
+                self.awaiting_first_chunk = False
+                self.barged_in = False
+
+
+def print_latency(name: str, samples: List[float]):
+    if not samples:
+        print(f"  {name:<9} no samples")
+        return
+    print(f"  {name:<9} n={len(samples):<8} p50={percentile(samples, 50):8.1f}  "
+          f"p90={percentile(samples, 90):8.1f}  p99={percentile(samples, 99):8.1f}  "
+          f"max={max(samples):8.1f} ms")
+
+
+async def main(args: argparse.Namespace):
+    stats = LoadStats()
+    start = time.perf_counter()
+    stop_at = start + args.ramp + args.duration
+    devices = [SimulatedDevice(i, args, stats) for i in range(args.devices)]
+
+    await asyncio.gather(*(
+        device.run(args.ramp * i / max(1, args.devices), stop_at)
+        for i, device in enumerate(devices)
+    ))
+    elapsed = time.perf_counter() - start
+
+    print(f"Devices: {stats.connected}/{args.devices} connected "
+          f"({stats.connect_failures} refused, {stats.auth_failures} auth failed, "
+          f"{stats.disconnects} dropped)")
+    print(f"Messages: {stats.sent} sent, {stats.received} received in {elapsed:.1f} s "
+          f"({(stats.sent + stats.received) / elapsed:.0f}/s), {stats.lost_pings} pings unanswered")
+    if args.barge_in_ratio > 0:
+        print(f"Barge-in: {len(stats.barge_in_ms)} turns interrupted, "
+              f"{stats.stale_frames} frames of cancelled turns received")
+    if args.same_turn_ratio > 0:
+        print(f"Same-turn voice: {stats.same_turns} turns of two utterances, "
+              f"{stats.repeat_finals} extra answers")
+    print("Latency:")
+    print_latency("connect", stats.connect_ms)
+    print_latency("ping", stats.ping_ms)
+    print_latency("1st chunk", stats.first_chunk_ms)
+    print_latency("barge-in", stats.barge_in_ms)
+    print_latency("text", stats.text_ms)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Simulate Cardputers against the bridge")
+    parser.add_argument("--url", default="ws://localhost:8765/ws")
+    parser.add_argument("--devices", type=int, default=100, help="simulated devices")
+    parser.add_argument("--duration", type=float, default=30.0, help="seconds of traffic after the ramp")
+    parser.add_argument("--ramp", type=float, default=5.0, help="seconds over which devices connect")
+    parser.add_argument("--rate", type=float, default=1.0, help="messages per second per device")
+    parser.add_argument("--text-ratio", type=float, default=0.0,
+                        help="fraction of messages that are text requests (needs a gateway)")
+    parser.add_argument("--barge-in-ratio", type=float, default=0.0,
+                        help="fraction of replies interrupted by a new turn")
+    parser.add_argument("--same-turn-ratio", type=float, default=0.0,
+                        help="fraction of messages that are two utterances under one turn id")
+    parser.add_argument("--utterance-gap-ms", type=float, default=50.0,
+                        help="silence between the two utterances of a same-turn request")
+    parser.add_argument("--codec", choices=sorted(CODECS), default="v2")
+    parser.add_argument("--api-key", default=None)
+    parser.add_argument("--device-prefix", default="loadgen")
+    parser.add_argument("--timeout", type=float, default=10.0, help="connect and auth timeout")
+    asyncio.run(main(parser.parse_args()))
@@ -3,32 +3,48 @@ OpenClaw Gateway Bridge - Reimplemented
 
 FastAPI server that acts as a bridge between the Cardputer ADV device
 and the OpenClaw gateway. Features:
-- Binary WebSocket protocol
+- Binary WebSocket protocol, with the wire codec (binary v2, binary v1
+  or JSON) negotiated through the WebSocket subprotocol
 - Streaming audio processing with Opus codec
-- STT (Speech-to-Text) integration
-- Connection management with health monitoring
+- STT (Speech-to-Text) integration, batched across devices on a
+  process pool (one pool per worker process)
+- Replies streamed token by token from the OpenClaw gateway and
+  coalesced into RESPONSE chunks
+- Turns run as tasks; a CANCEL command (or a newer turn) aborts the
+  transcription and the upstream request of the turn it replaces
+- Speculative transcription: a "likely final" hint from the device's
+  endpointer starts STT before the utterance has officially ended
+- Sharded connection management with per-shard send queues and
+  batched writes; several worker processes share one session store
 - Message routing and queueing
 """
 
 import asyncio
 import base64
+import importlib.util
 import json
 import logging
 import os
+import socket
 import time
 import uuid
+import zlib
 from contextlib import asynccontextmanager
 from dataclasses import dataclass, field
 from enum import Enum, auto
-from typing import Dict, Optional, Set, Callable, Any
+from typing import AsyncIterator, Dict, Optional, Set, Callable, Any
 from collections import deque
 
 import httpx
+import msgpack
 import uvicorn
 from fastapi import FastAPI, WebSocket, WebSocketDisconnect, HTTPException, status
 from fastapi.middleware.cors import CORSMiddleware
 from pydantic import BaseModel, Field
 
+from session_store import InProcessSessionStore, SessionRecord, SqliteSessionStore
+from stt_scheduler import TranscriptionScheduler
+
 # Configure logging
 logging.basicConfig(
     level=logging.INFO,
@@ -58,6 +74,16 @@ class MessageType(Enum):
     UNKNOWN = 0xFF
 
 
+# Message flags
+FLAG_COMPRESSED = 0x02
+
+# Wire codecs, in order of preference (Sec-WebSocket-Protocol names)
+CODEC_V2 = "openclaw.v2"        # Binary frames, MessagePack payload
+CODEC_V1 = "openclaw.v1"        # Binary frames, JSON payload
+CODEC_JSON = "openclaw.json"    # Flat JSON text frames
+SUPPORTED_CODECS = (CODEC_V2, CODEC_V1, CODEC_JSON)
+
+
 class ConnectionState(Enum):
     """Connection state."""
     DISCONNECTED = auto()
@@ -85,6 +111,21 @@ class BridgeConfig:
     session_timeout_seconds: int = int(os.getenv("SESSION_TIMEOUT_SECONDS", "300"))
     max_message_queue_size: int = int(os.getenv("MAX_MESSAGE_QUEUE_SIZE", "100"))
     enable_opus: bool = os.getenv("ENABLE_OPUS", "true").lower() == "true"
+    workers: int = int(os.getenv("BRIDGE_WORKERS", "1"))
+    shard_count: int = int(os.getenv("BRIDGE_SHARDS", "16"))
+    shard_queue_size: int = int(os.getenv("SHARD_QUEUE_SIZE", "4096"))
+    session_queue_size: int = int(os.getenv("SESSION_QUEUE_SIZE", "256"))
+    send_timeout_seconds: float = float(os.getenv("SEND_TIMEOUT_SECONDS", "5"))
+    session_store_path: str = os.getenv("SESSION_STORE_PATH", "/tmp/openclaw-sessions.db")
+    mailbox_poll_ms: int = int(os.getenv("MAILBOX_POLL_MS", "50"))
+    worker_timeout_seconds: int = int(os.getenv("WORKER_TIMEOUT_SECONDS", "15"))
+    stt_backend: str = os.getenv("STT_BACKEND", "whisper")
+    stt_workers: int = int(os.getenv("STT_WORKERS", "1"))
+    stt_batch_size: int = int(os.getenv("STT_BATCH_SIZE", "8"))
+    stt_max_wait_ms: float = float(os.getenv("STT_MAX_WAIT_MS", "50"))
+    stream_window_ms: float = float(os.getenv("STREAM_WINDOW_MS", "80"))
+    stream_chunk_chars: int = int(os.getenv("STREAM_CHUNK_CHARS", "48"))
+    speculative_stt: bool = os.getenv("SPECULATIVE_STT", "true").lower() == "true"
     
     def __post_init__(self):
         logging.getLogger().setLevel(getattr(logging, self.log_level.upper()))
@@ -122,7 +163,7 @@ class ProtocolMessage(BaseModel):
     
     @classmethod
     def from_binary(cls, data: bytes) -> Optional["ProtocolMessage"]:
-        """Parse binary protocol message."""
+        """Parse binary protocol message (version 1 or 2)."""
         if len(data) < 12:
             return None
         
@@ -134,33 +175,62 @@ class ProtocolMessage(BaseModel):
         payload_len = int.from_bytes(data[4:6], 'little')
         timestamp = int.from_bytes(data[6:10], 'little')
         
-        if magic != 0x4F or version != 1:  # 'O' for OpenClaw
+        if magic != 0x4F or version not in (1, 2):  # 'O' for OpenClaw
             return None
         
         # Extract payload
         payload_data = data[10:10+payload_len]
         
         try:
-            payload = json.loads(payload_data.decode('utf-8'))
-        except (json.JSONDecodeError, UnicodeDecodeError):
+            if flags & FLAG_COMPRESSED:
+                payload = msgpack.unpackb(payload_data)
+            else:
+                payload = json.loads(payload_data.decode('utf-8'))
+        except (json.JSONDecodeError, UnicodeDecodeError, ValueError, msgpack.UnpackException):
             payload = {"raw": base64.b64encode(payload_data).decode()}
         
         type_str = MessageType(msg_type).name.lower() if msg_type in [t.value for t in MessageType] else "unknown"
         
         return cls(type=type_str, payload=payload, timestamp=timestamp)
     
-    def to_binary(self) -> bytes:
+    @classmethod
+    def from_json(cls, text: str) -> Optional["ProtocolMessage"]:
+        """Parse a flat JSON text frame ({"type": ..., ...})."""
+        try:
+            payload = json.loads(text)
+        except json.JSONDecodeError:
+            return None
+        if not isinstance(payload, dict):
+            return None
+        
+        msg_type = str(payload.pop("type", "unknown"))
+        timestamp = payload.get("timestamp", int(time.time() * 1000))
+        return cls(type=msg_type, payload=payload, timestamp=timestamp)
+    
+    def to_json(self) -> str:
+        """Convert to a flat JSON text frame."""
+        return json.dumps({"type": self.type, **self.payload})
+    
+    def to_binary(self, version: int = 1) -> bytes:
         """Convert to binary protocol format."""
         payload_bytes = json.dumps(self.payload).encode('utf-8')
+        flags = 0
+        
+        # Version 2 packs the payload when that is smaller
+        if version == 2:
+            packed = msgpack.packb(self.payload)
+            if len(packed) < len(payload_bytes):
+                payload_bytes = packed
+                flags |= FLAG_COMPRESSED
         
         # Build header
         header = bytearray(10)
         header[0] = 0x4F  # Magic
-        header[1] = 1     # Version
+        header[1] = version
         header[2] = getattr(MessageType, self.type.upper(), MessageType.UNKNOWN).value
-        header[3] = 0     # Flags
+        header[3] = flags
         header[4:6] = len(payload_bytes).to_bytes(2, 'little')
-        header[6:10] = self.timestamp.to_bytes(4, 'little')
+        header[6:10] = (self.timestamp & 0xFFFFFFFF).to_bytes(4, 'little')
         
         # Calculate CRC16
         data = header + payload_bytes
@@ -169,6 +239,42 @@ class ProtocolMessage(BaseModel):
         return bytes(data + crc.to_bytes(2, 'little'))
 
 
+def choose_codec(offered: list[str]) -> Optional[str]:
+    """Pick the preferred codec among those the device offered."""
+    for codec in SUPPORTED_CODECS:
+        if codec in offered:
+            return codec
+    return None
+
+
+def encode_message(message: ProtocolMessage, codec: str) -> tuple[Optional[bytes], Optional[str]]:
+    """Encode for the wire; returns (bytes, None) or (None, text)."""
+    if codec == CODEC_JSON:
+        return None, message.to_json()
+    return message.to_binary(2 if codec == CODEC_V2 else 1), None
+
+
+async def send_message(websocket: WebSocket, codec: str, message: ProtocolMessage):
+    """Send one message in the connection's codec."""
+    data, text = encode_message(message, codec)
+    if text is not None:
+        await websocket.send_text(text)
+    else:
+        await websocket.send_bytes(data)
+
+
+async def receive_message(websocket: WebSocket) -> Optional[ProtocolMessage]:
+    """Receive one message, decoding by frame type."""
+    frame = await websocket.receive()
+    if frame["type"] == "websocket.disconnect":
+        raise WebSocketDisconnect(frame.get("code", 1000))
+    if frame.get("bytes") is not None:
+        return ProtocolMessage.from_binary(frame["bytes"])
+    if frame.get("text") is not None:
+        return ProtocolMessage.from_json(frame["text"])
+    return None
+
+
 def calculate_crc16(data: bytes) -> int:
     """Calculate CRC16-CCITT-FALSE."""
     crc = 0xFFFF
@@ -217,6 +323,15 @@ CRC16_TABLE = [
 # Connection Manager
 # =============================================================================
 
+@dataclass
+class SpeculativeTranscript:
+    """Transcription started on a "likely final" hint, ahead of the end."""
+    turn: int
+    audio_length: int           # Buffered bytes it covers
+    started_at: float
+    task: asyncio.Task
+
+
 @dataclass
 class DeviceConnection:
     """Represents a connected device."""
@@ -229,14 +344,27 @@ class DeviceConnection:
     last_activity: float = field(default_factory=time.time)
     state: ConnectionState = ConnectionState.CONNECTED
     session_id: str = field(default_factory=lambda: str(uuid.uuid4()))
+    codec: str = CODEC_V1
     audio_config: Optional[AudioConfig] = None
     message_queue: deque = field(default_factory=lambda: deque(maxlen=config.max_message_queue_size))
     audio_buffer: bytearray = field(default_factory=bytearray)
+    audio_turn: int = 0
+    turns: Dict[int, asyncio.Task] = field(default_factory=dict)
+    speculation: Optional[SpeculativeTranscript] = None
+    outbox: Optional[asyncio.Queue] = None
+    writer_task: Optional[asyncio.Task] = None
     stats: dict = field(default_factory=lambda: {
         "messages_sent": 0,
         "messages_received": 0,
         "audio_bytes_received": 0,
-        "audio_bytes_sent": 0
+        "audio_bytes_sent": 0,
+        "turns_cancelled": 0,
+        "stream_turns": 0,
+        "stream_chunks": 0,
+        "ttft_ms_last": None,
+        "ttft_ms_avg": None,
+        "chunks_per_second_last": None,
+        "stt_head_start_ms_last": None
     })
     
     def touch(self):
@@ -257,129 +385,327 @@ class DeviceConnection:
         return None
 
 
-class ConnectionManager:
-    """Manages WebSocket connections from devices."""
+class ConnectionShard:
+    """A slice of the connection table with its own send queue.
     
-    def __init__(self):
+    The shard queue only fans out: one task moves each message to its
+    session's bounded outbox, and every session has its own writer task,
+    so a slow socket only ever holds up itself. A session whose outbox
+    fills up, or whose socket stalls past the send timeout, is closed.
+    """
+    
+    def __init__(self, index: int):
+        self.index = index
         self.connections: Dict[str, DeviceConnection] = {}
-        self.device_to_session: Dict[str, str] = {}
-        self._lock = asyncio.Lock()
+        self.queue: asyncio.Queue = asyncio.Queue(maxsize=config.shard_queue_size)
+        self.fanout_task: Optional[asyncio.Task] = None
+        self.closing: set = set()
+        self.stats = {"queued": 0, "dropped": 0, "sent": 0, "evicted": 0, "send_failures": 0}
+    
+    def start(self):
+        """Start the fan-out task."""
+        if self.fanout_task is None:
+            self.fanout_task = asyncio.create_task(self._fanout())
+    
+    async def stop(self):
+        """Stop the fan-out and session writers, dropping anything still queued."""
+        tasks = [conn.writer_task for conn in self.connections.values() if conn.writer_task]
+        if self.fanout_task:
+            tasks.append(self.fanout_task)
+            self.fanout_task = None
+        for task in tasks:
+            task.cancel()
+        await asyncio.gather(*tasks, return_exceptions=True)
+    
+    def add(self, conn: DeviceConnection):
+        """Register a connection and start its writer."""
+        conn.outbox = asyncio.Queue(maxsize=config.session_queue_size)
+        conn.writer_task = asyncio.create_task(self._session_writer(conn))
+        self.connections[conn.session_id] = conn
+    
+    def remove(self, session_id: str) -> Optional[DeviceConnection]:
+        """Unregister a connection and stop its writer."""
+        conn = self.connections.pop(session_id, None)
+        if conn and conn.writer_task:
+            conn.writer_task.cancel()
+            conn.writer_task = None
+        return conn
+    
+    def enqueue(self, conn: DeviceConnection, message: ProtocolMessage) -> bool:
+        """Queue a message for the fan-out; False if the shard is backed up."""
+        try:
+            self.queue.put_nowait((conn, message))
+        except asyncio.QueueFull:
+            self.stats["dropped"] += 1
+            return False
+        self.stats["queued"] += 1
+        return True
+    
+    async def _fanout(self):
+        while True:
+            conn, message = await self.queue.get()
+            if conn.outbox is None or conn.session_id not in self.connections:
+                self.stats["dropped"] += 1
+                continue
+            try:
+                conn.outbox.put_nowait(message)
+            except asyncio.QueueFull:
+                self.stats["evicted"] += 1
+                logger.warning(f"Send queue full for {conn.device_id}, closing session {conn.session_id}")
+                self._close(conn)
+    
+    async def _session_writer(self, conn: DeviceConnection):
+        while True:
+            message = await conn.outbox.get()
+            try:
+                await asyncio.wait_for(send_message(conn.websocket, conn.codec, message),
+                                       config.send_timeout_seconds)
+            except asyncio.CancelledError:
+                raise
+            except Exception as e:
+                self.stats["send_failures"] += 1
+                logger.error(f"Failed to send to {conn.device_id}: {e!r}")
+                self._close(conn)
+                return
+            conn.stats["messages_sent"] += 1
+            self.stats["sent"] += 1
     
-    async def connect(self, websocket: WebSocket, device_id: str) -> DeviceConnection:
-        """Accept a new WebSocket connection."""
-        await websocket.accept()
+    def _close(self, conn: DeviceConnection):
+        """Stop sending to a session and close its socket.
         
+        Closing ends the receive loop, which unregisters the session.
+        Nothing more is queued for it in the meantime.
+        """
+        conn.outbox = None
+        if conn.writer_task and conn.writer_task is not asyncio.current_task():
+            conn.writer_task.cancel()
+        conn.writer_task = None
+        task = asyncio.create_task(self._close_socket(conn))
+        self.closing.add(task)
+        task.add_done_callback(self.closing.discard)
+    
+    async def _close_socket(self, conn: DeviceConnection):
+        try:
+            await asyncio.wait_for(conn.websocket.close(), config.send_timeout_seconds)
+        except Exception:
+            pass
+
+
+class ConnectionManager:
+    """Manages this worker's device connections, sharded by session.
+    
+    Shards hold disjoint connections and send queues, so sends never wait
+    on a lock and broadcasts and cleanup sweep one shard at a time. Which
+    worker holds which device lives in the session store; a send for a
+    device held by another worker goes through that worker's mailbox.
+    """
+    
+    def __init__(self, store, worker_id: str, shard_count: int):
+        self.store = store
+        self.worker_id = worker_id
+        self.shards = [ConnectionShard(i) for i in range(max(1, shard_count))]
+        self.device_to_session: Dict[str, str] = {}
+    
+    def _shard(self, session_id: str) -> ConnectionShard:
+        return self.shards[zlib.crc32(session_id.encode()) % len(self.shards)]
+    
+    async def start(self):
+        """Open the session store and start the shard writers."""
+        await self.store.open()
+        await self.store.heartbeat(self.worker_id, config.worker_timeout_seconds)
+        for shard in self.shards:
+            shard.start()
+    
+    async def stop(self):
+        """Stop the shard writers and close the session store."""
+        for shard in self.shards:
+            await shard.stop()
+        await self.store.close()
+    
+    async def connect(self, websocket: WebSocket, device_id: str, codec: str) -> DeviceConnection:
+        """Register an accepted WebSocket connection."""
         conn = DeviceConnection(
             websocket=websocket,
             device_id=device_id,
             device_name="Unknown",
-            version="unknown"
+            version="unknown",
+            codec=codec
         )
         
-        async with self._lock:
-            self.connections[conn.session_id] = conn
+        self._shard(conn.session_id).add(conn)
         
-        logger.info(f"New connection: {device_id} (session: {conn.session_id})")
+        logger.info(f"New connection: {device_id} (session: {conn.session_id}, codec: {codec})")
         return conn
     
     async def disconnect(self, session_id: str):
         """Remove a connection."""
-        async with self._lock:
-            if session_id in self.connections:
-                conn = self.connections[session_id]
-                logger.info(f"Disconnected: {conn.device_id} (session: {session_id})")
-                del self.connections[session_id]
-                
-                # Clean up device mapping
-                for device_id, sid in list(self.device_to_session.items()):
-                    if sid == session_id:
-                        del self.device_to_session[device_id]
+        conn = self._shard(session_id).remove(session_id)
+        if not conn:
+            return
+        
+        logger.info(f"Disconnected: {conn.device_id} (session: {session_id})")
+        
+        # Nobody is left to read the replies
+        for task in conn.turns.values():
+            task.cancel()
+        drop_speculation(conn)
+        
+        # Leave the mapping alone if the device has already reconnected
+        if self.device_to_session.get(conn.device_id) == session_id:
+            del self.device_to_session[conn.device_id]
+        await self.store.release(conn.device_id, session_id)
     
     async def authenticate(self, session_id: str, device_info: DeviceInfo) -> bool:
-        """Mark a connection as authenticated."""
-        async with self._lock:
-            if session_id not in self.connections:
-                return False
-            
-            conn = self.connections[session_id]
-            conn.state = ConnectionState.AUTHENTICATED
-            conn.device_name = device_info.device_name
-            conn.version = device_info.version
-            conn.capabilities = device_info.capabilities
-            self.device_to_session[device_info.device_id] = session_id
-            
-            logger.info(f"Authenticated: {device_info.device_id} ({device_info.device_name})")
-            return True
+        """Mark a connection as authenticated and claim the device for this worker."""
+        conn = self.get_connection(session_id)
+        if not conn:
+            return False
+        
+        conn.state = ConnectionState.AUTHENTICATED
+        conn.device_name = device_info.device_name
+        conn.version = device_info.version
+        conn.capabilities = device_info.capabilities
+        self.device_to_session[device_info.device_id] = session_id
+        
+        previous = await self.store.claim(SessionRecord(
+            device_id=device_info.device_id,
+            worker_id=self.worker_id,
+            session_id=session_id,
+            device_name=device_info.device_name,
+            connected_at=conn.connected_at
+        ))
+        
+        # A device that reconnects before its old socket times out would
+        # otherwise leave a ghost session behind, possibly on another worker
+        if previous and previous.session_id != session_id:
+            if previous.worker_id == self.worker_id:
+                await self.evict(previous.session_id)
+            else:
+                await self.store.post(previous.worker_id, device_info.device_id,
+                                      {"op": "evict", "session_id": previous.session_id})
+        
+        logger.info(f"Authenticated: {device_info.device_id} ({device_info.device_name})")
+        return True
+    
+    async def evict(self, session_id: str):
+        """Drop a session and close its socket."""
+        conn = self.get_connection(session_id)
+        if not conn:
+            return
+        
+        logger.info(f"Evicting superseded session: {session_id}")
+        await self.disconnect(session_id)
+        try:
+            await conn.websocket.close()
+        except Exception:
+            pass
     
     async def send_to_session(self, session_id: str, message: ProtocolMessage) -> bool:
-        """Send a message to a specific session."""
-        async with self._lock:
-            if session_id not in self.connections:
-                return False
-            
-            conn = self.connections[session_id]
-            try:
-                await conn.websocket.send_bytes(message.to_binary())
-                conn.touch()
-                conn.stats["messages_sent"] += 1
-                return True
-            except Exception as e:
-                logger.error(f"Failed to send to {conn.device_id}: {e}")
-                return False
+        """Queue a message for a session on this worker."""
+        shard = self._shard(session_id)
+        conn = shard.connections.get(session_id)
+        if not conn:
+            return False
+        
+        conn.touch()
+        return shard.enqueue(conn, message)
     
     async def send_to_device(self, device_id: str, message: ProtocolMessage) -> bool:
-        """Send a message to a device by ID."""
-        async with self._lock:
-            if device_id not in self.device_to_session:
-                return False
-            session_id = self.device_to_session[device_id]
+        """Send a message to a device by ID, on whichever worker holds it."""
+        session_id = self.device_to_session.get(device_id)
+        if session_id:
             return await self.send_to_session(session_id, message)
+        
+        record = await self.store.lookup(device_id)
+        if not record or record.worker_id == self.worker_id:
+            return False
+        
+        await self.store.post(record.worker_id, device_id, {"op": "send", "message": message.model_dump()})
+        return True
     
     async def broadcast(self, message: ProtocolMessage, authenticated_only: bool = True) -> int:
-        """Broadcast message to all connected devices."""
+        """Broadcast message to all devices connected to this worker."""
         sent_count = 0
-        async with self._lock:
-            for session_id, conn in self.connections.items():
+        for shard in self.shards:
+            for conn in list(shard.connections.values()):
                 if authenticated_only and conn.state != ConnectionState.AUTHENTICATED:
                     continue
-                if await self.send_to_session(session_id, message):
+                conn.touch()
+                if shard.enqueue(conn, message):
                     sent_count += 1
+            # Let the writers start on this shard before filling the next
+            await asyncio.sleep(0)
         return sent_count
     
+    async def deliver_mail(self) -> int:
+        """Act on sends and evictions posted by other workers."""
+        mail = await self.store.take(self.worker_id)
+        for device_id, item in mail:
+            if item.get("op") == "evict":
+                await self.evict(item.get("session_id", ""))
+            elif item.get("op") == "send":
+                session_id = self.device_to_session.get(device_id)
+                if session_id:
+                    await self.send_to_session(session_id, ProtocolMessage(**item["message"]))
+        return len(mail)
+    
     def get_connection(self, session_id: str) -> Optional[DeviceConnection]:
         """Get a connection by session ID."""
-        return self.connections.get(session_id)
+        return self._shard(session_id).connections.get(session_id)
     
     def get_connection_by_device(self, device_id: str) -> Optional[DeviceConnection]:
         """Get a connection by device ID."""
         session_id = self.device_to_session.get(device_id)
         if session_id:
-            return self.connections.get(session_id)
+            return self.get_connection(session_id)
         return None
     
     def get_active_connections(self) -> list:
-        """Get list of active authenticated connections."""
+        """Get list of active authenticated connections on this worker."""
         return [
-            conn for conn in self.connections.values()
+            conn for shard in self.shards for conn in shard.connections.values()
             if conn.state == ConnectionState.AUTHENTICATED
         ]
     
+    def get_stats(self) -> dict:
+        """Send-path counters summed over the shards."""
+        totals = {"queued": 0, "dropped": 0, "sent": 0, "evicted": 0, "send_failures": 0}
+        for shard in self.shards:
+            for key in totals:
+                totals[key] += shard.stats[key]
+        totals["queue_depth"] = sum(shard.queue.qsize() for shard in self.shards)
+        totals["outbox_depth"] = sum(
+            conn.outbox.qsize() for shard in self.shards
+            for conn in shard.connections.values() if conn.outbox
+        )
+        totals["shards"] = len(self.shards)
+        return totals
+    
     async def cleanup_stale(self):
-        """Remove stale connections."""
+        """Remove stale connections, one shard at a time."""
         now = time.time()
-        stale_sessions = []
-        
-        async with self._lock:
-            for session_id, conn in self.connections.items():
-                if now - conn.last_activity > config.session_timeout_seconds:
-                    stale_sessions.append(session_id)
-        
-        for session_id in stale_sessions:
-            logger.info(f"Cleaning up stale session: {session_id}")
-            await self.disconnect(session_id)
-
-
-manager = ConnectionManager()
+        for shard in self.shards:
+            stale_sessions = [
+                session_id for session_id, conn in shard.connections.items()
+                if now - conn.last_activity > config.session_timeout_seconds
+            ]
+            for session_id in stale_sessions:
+                logger.info(f"Cleaning up stale session: {session_id}")
+            await asyncio.gather(*(self.evict(session_id) for session_id in stale_sessions))
+
+
+def create_session_store():
+    """One worker keeps sessions in memory; several share a SQLite file."""
+    if config.workers > 1:
+        return SqliteSessionStore(config.session_store_path)
+    return InProcessSessionStore()
+
+
+manager = ConnectionManager(
+    store=create_session_store(),
+    worker_id=f"{socket.gethostname()}:{os.getpid()}",
+    shard_count=config.shard_count
+)
 
 
 # =============================================================================
@@ -387,25 +713,49 @@ manager = ConnectionManager()
 # =============================================================================
 
 class STTService:
-    """Speech-to-Text service using Whisper or external provider."""
+    """Speech-to-Text service using Whisper or external provider.
+    
+    Local transcription goes through a scheduler that batches utterances
+    from all sessions; the model lives in the pool processes, not here.
+    Each worker process runs its own scheduler and pool, so batches only
+    form from that worker's sessions.
+    """
     
     def __init__(self):
         self.whisper_available = False
-        self.model = None
+        self.scheduler: Optional[TranscriptionScheduler] = None
         self._check_whisper()
     
     def _check_whisper(self):
         """Check if Whisper is available locally."""
-        try:
-            import whisper
+        if config.stt_backend == "stub" or importlib.util.find_spec("whisper"):
             self.whisper_available = True
-            logger.info(f"Loading Whisper model: {config.whisper_model}")
-            self.model = whisper.load_model(config.whisper_model)
-            logger.info("Whisper model loaded successfully")
-        except ImportError:
+            self.scheduler = TranscriptionScheduler(
+                backend=config.stt_backend,
+                model_name=config.whisper_model,
+                workers=config.stt_workers,
+                max_batch_size=config.stt_batch_size,
+                max_wait_ms=config.stt_max_wait_ms
+            )
+        else:
             logger.info("Whisper not available locally, will use external service")
-        except Exception as e:
-            logger.error(f"Failed to load Whisper: {e}")
+    
+    async def start(self):
+        """Start the transcription pool, unless an external service is used."""
+        if self.scheduler and not config.whisper_url:
+            logger.info(f"Starting {config.stt_workers} STT worker(s) ({config.stt_backend}, "
+                        f"model {config.whisper_model}, batches of up to {config.stt_batch_size})")
+            if config.workers > 1:
+                logger.warning(f"STT batching is per worker: {config.workers} workers run "
+                               f"{config.workers * config.stt_workers} STT processes in all, "
+                               f"each batching only its own worker's utterances; size "
+                               f"STT_WORKERS for one worker's share of the cores")
+            await self.scheduler.start()
+    
+    async def stop(self):
+        """Stop the transcription pool."""
+        if self.scheduler:
+            await self.scheduler.stop()
     
     async def transcribe(self, audio_data: bytes, codec: str = "opus") -> Optional[str]:
         """Transcribe audio data to text."""
@@ -413,7 +763,7 @@ class STTService:
             if config.whisper_url:
                 return await self._transcribe_external(audio_data, codec)
             elif self.whisper_available:
-                return await self._transcribe_local(audio_data)
+                return await self._transcribe_local(audio_data, codec)
             else:
                 logger.error("No STT service available")
                 return None
@@ -421,26 +771,12 @@ class STTService:
             logger.error(f"Transcription error: {e}")
             return None
     
-    async def _transcribe_local(self, audio_data: bytes) -> Optional[str]:
-        """Transcribe using local Whisper model."""
-        import tempfile
-        import wave
-        
-        # Write to temporary WAV file
-        with tempfile.NamedTemporaryFile(suffix=".wav", delete=False) as f:
-            wav_path = f.name
-            with wave.open(f, 'wb') as wav:
-                wav.setnchannels(1)
-                wav.setsampwidth(2)
-                wav.setframerate(16000)
-                wav.writeframes(audio_data)
-        
-        try:
-            # Run transcription
-            result = self.model.transcribe(wav_path)
-            return result.get("text", "").strip()
-        finally:
-            os.unlink(wav_path)
+    async def _transcribe_local(self, audio_data: bytes, codec: str) -> Optional[str]:
+        """Transcribe using local Whisper model (16 kHz mono PCM16 only)."""
+        result = await self.scheduler.submit(audio_data, codec)
+        logger.debug(f"Transcribed in batch of {result.batch_size}: "
+                     f"queued {result.queued_ms:.0f} ms, ran {result.run_ms:.0f} ms")
+        return result.text
     
     async def _transcribe_external(self, audio_data: bytes, codec: str) -> Optional[str]:
         """Transcribe using external Whisper service."""
@@ -471,20 +807,26 @@ class OpenClawGateway:
         self.api_key = config.openclaw_api_key
         self.client = httpx.AsyncClient(timeout=60.0)
     
+    def _request(self, device_id: str, message: str, stream: bool) -> tuple[dict, dict]:
+        headers = {}
+        if self.api_key:
+            headers["Authorization"] = f"Bearer {self.api_key}"
+        if stream:
+            headers["Accept"] = "text/event-stream"
+        
+        payload = {
+            "device_id": device_id,
+            "message": message,
+            "source": "cardputer",
+            "stream": stream,
+            "timestamp": int(time.time() * 1000)
+        }
+        return payload, headers
+    
     async def send_message(self, device_id: str, message: str) -> Optional[str]:
         """Send a message to OpenClaw and get response."""
         try:
-            headers = {}
-            if self.api_key:
-                headers["Authorization"] = f"Bearer {self.api_key}"
-            
-            payload = {
-                "device_id": device_id,
-                "message": message,
-                "source": "cardputer",
-                "timestamp": int(time.time() * 1000)
-            }
-            
+            payload, headers = self._request(device_id, message, stream=False)
             response = await self.client.post(
                 f"{self.base_url}/api/v1/message",
                 json=payload,
@@ -502,6 +844,45 @@ class OpenClawGateway:
             logger.error(f"Gateway error: {e}")
             return f"Error: {str(e)}"
     
+    async def stream_message(self, device_id: str, message: str) -> AsyncIterator[str]:
+        """Send a message to OpenClaw and yield the reply as it is generated.
+        
+        Reads server-sent events ("data: {"delta": ...}" until
+        "data: [DONE]"); a gateway that answers with plain JSON yields its
+        whole response once. Errors are yielded as text, like send_message.
+        """
+        try:
+            payload, headers = self._request(device_id, message, stream=True)
+            async with self.client.stream(
+                "POST",
+                f"{self.base_url}/api/v1/message",
+                json=payload,
+                headers=headers
+            ) as response:
+                response.raise_for_status()
+                
+                if not response.headers.get("content-type", "").startswith("text/event-stream"):
+                    result = json.loads(await response.aread())
+                    yield result.get("response", "No response from gateway")
+                    return
+                
+                async for line in response.aiter_lines():
+                    if not line.startswith("data:"):
+                        continue
+                    data = line[5:].strip()
+                    if data == "[DONE]":
+                        return
+                    delta = json.loads(data).get("delta", "")
+                    if delta:
+                        yield delta
+                        
+        except httpx.HTTPError as e:
+            logger.error(f"Gateway HTTP error: {e}")
+            yield f"Gateway error: {str(e)}"
+        except Exception as e:
+            logger.error(f"Gateway error: {e}")
+            yield f"Error: {str(e)}"
+    
     async def close(self):
         """Close the HTTP client."""
         await self.client.aclose()
@@ -517,20 +898,25 @@ gateway = OpenClawGateway()
 @asynccontextmanager
 async def lifespan(app: FastAPI):
     """Application lifespan manager."""
-    logger.info("Starting OpenClaw Gateway Bridge v2.0.0")
+    logger.info(f"Starting OpenClaw Gateway Bridge v2.0.0 (worker {manager.worker_id})")
     
-    # Start cleanup task
-    cleanup_task = asyncio.create_task(cleanup_loop())
+    # Start shard writers and background tasks
+    await manager.start()
+    await stt_service.start()
+    tasks = [asyncio.create_task(cleanup_loop()), asyncio.create_task(mailbox_loop())]
     
     yield
     
     # Cleanup
     logger.info("Shutting down OpenClaw Gateway Bridge")
-    cleanup_task.cancel()
-    try:
-        await cleanup_task
-    except asyncio.CancelledError:
-        pass
+    for task in tasks:
+        task.cancel()
+        try:
+            await task
+        except asyncio.CancelledError:
+            pass
+    await manager.stop()
+    await stt_service.stop()
     await gateway.close()
 
 
@@ -562,6 +948,222 @@ async def cleanup_loop():
             logger.error(f"Cleanup error: {e}")
 
 
+async def mailbox_loop():
+    """Background task delivering other workers' mail and keeping this one alive."""
+    last_heartbeat = time.time()
+    while True:
+        try:
+            await asyncio.sleep(config.mailbox_poll_ms / 1000)
+            await manager.deliver_mail()
+            
+            if time.time() - last_heartbeat >= config.worker_timeout_seconds / 3:
+                last_heartbeat = time.time()
+                dropped = await manager.store.heartbeat(manager.worker_id, config.worker_timeout_seconds)
+                if dropped:
+                    logger.info(f"Dropped {dropped} sessions of workers that stopped responding")
+        except asyncio.CancelledError:
+            break
+        except Exception as e:
+            logger.error(f"Mailbox error: {e}")
+
+
+# =============================================================================
+# Turns
+# =============================================================================
+
+# Bridge-wide turn counters (this worker)
+turn_stats = {"started": 0, "completed": 0, "cancelled": 0, "superseded": 0,
+              "speculative_started": 0, "speculative_used": 0, "speculative_dropped": 0}
+
+
+def start_turn(conn: DeviceConnection, turn: int, work) -> asyncio.Task:
+    """Run a turn's work as a task, off the device's receive loop.
+    
+    The receive loop must stay free to read a CANCEL for this very turn.
+    A device answers one turn at a time, so newer work supersedes any
+    still running, including an earlier utterance sent under the same
+    turn id (older firmware keeps one turn per listening session).
+    """
+    for task in conn.turns.values():
+        if not task.done():
+            task.cancel()
+            turn_stats["superseded"] += 1
+    
+    task = asyncio.create_task(work)
+    conn.turns[turn] = task
+    turn_stats["started"] += 1
+    
+    def finished(done: asyncio.Task):
+        if conn.turns.get(turn) is done:
+            del conn.turns[turn]
+        if done.cancelled():
+            return
+        turn_stats["completed"] += 1
+        if done.exception():
+            logger.error(f"Turn {turn} for {conn.device_id} failed: {done.exception()!r}")
+    
+    task.add_done_callback(finished)
+    return task
+
+
+def cancel_turn(conn: DeviceConnection, turn: int) -> bool:
+    """Abort a turn: its queued transcription is skipped and the upstream
+    request is closed, so neither keeps working for a reply nobody reads."""
+    cancelled = False
+    task = conn.turns.pop(turn, None)
+    if task and not task.done():
+        task.cancel()
+        cancelled = True
+    
+    # An utterance still being recorded for the turn is dropped too
+    if conn.audio_turn == turn and conn.audio_buffer:
+        conn.audio_buffer.clear()
+        cancelled = True
+    if conn.speculation and conn.speculation.turn == turn:
+        drop_speculation(conn)
+    
+    if cancelled:
+        conn.stats["turns_cancelled"] += 1
+        turn_stats["cancelled"] += 1
+        logger.info(f"Cancelled turn {turn} for {conn.device_id}")
+    return cancelled
+
+
+def start_speculation(conn: DeviceConnection, turn: int, codec: str):
+    """Transcribe what has been buffered so far, on the device's hint that
+    the utterance has likely ended. The frames still to come are hangover
+    silence unless the device says the speaker resumed."""
+    drop_speculation(conn)
+    audio = bytes(conn.audio_buffer)
+    conn.speculation = SpeculativeTranscript(
+        turn=turn,
+        audio_length=len(audio),
+        started_at=time.perf_counter(),
+        task=asyncio.create_task(stt_service.transcribe(audio, codec))
+    )
+    turn_stats["speculative_started"] += 1
+
+
+def drop_speculation(conn: DeviceConnection):
+    """Abandon a speculative transcription (speaker resumed, turn ended)."""
+    if not conn.speculation:
+        return
+    conn.speculation.task.cancel()
+    conn.speculation = None
+    turn_stats["speculative_dropped"] += 1
+
+
+def take_speculation(conn: DeviceConnection, turn: int) -> Optional[SpeculativeTranscript]:
+    """Hand a still-valid speculative transcription to the finished turn."""
+    speculation = conn.speculation
+    if not speculation or speculation.turn != turn:
+        drop_speculation(conn)
+        return None
+    conn.speculation = None
+    turn_stats["speculative_used"] += 1
+    head_start_ms = (time.perf_counter() - speculation.started_at) * 1000
+    conn.stats["stt_head_start_ms_last"] = round(head_start_ms, 1)
+    return speculation
+
+
+# =============================================================================
+# Reply Streaming
+# =============================================================================
+
+async def send_reply(session_id: str, text: str, turn: int = 0):
+    """Ask OpenClaw and relay the reply to the device.
+    
+    Devices with the "stream" capability get the reply as it is generated:
+    the first tokens go out at once, then tokens are coalesced into
+    RESPONSE chunks ("append": true) until the window elapses or the chunk
+    reaches its size limit. RESPONSE_FINAL always carries the full text.
+    """
+    conn = manager.get_connection(session_id)
+    if not conn:
+        return
+    
+    if "stream" not in conn.capabilities:
+        response = await gateway.send_message(conn.device_id, text)
+        await manager.send_to_session(session_id, ProtocolMessage(
+            type="response_final",
+            payload={"text": response, "is_final": True, "turn": turn}
+        ))
+        return
+    
+    # Tokens arrive from a producer task so the window can expire between them
+    tokens: asyncio.Queue = asyncio.Queue()
+    
+    async def produce():
+        try:
+            async for delta in gateway.stream_message(conn.device_id, text):
+                await tokens.put(delta)
+        finally:
+            await tokens.put(None)
+    
+    producer = asyncio.create_task(produce())
+    window = config.stream_window_ms / 1000
+    started = time.perf_counter()
+    first_chunk_at = None
+    parts: list[str] = []
+    pending = ""
+    pending_since = 0.0
+    chunks = 0
+    
+    async def flush():
+        nonlocal pending, chunks
+        await manager.send_to_session(session_id, ProtocolMessage(
+            type="response",
+            payload={"text": pending, "is_final": False, "append": True, "turn": turn}
+        ))
+        pending = ""
+        chunks += 1
+    
+    try:
+        while True:
+            timeout = None
+            if pending:
+                timeout = max(0.0, pending_since + window - time.perf_counter())
+            try:
+                delta = await asyncio.wait_for(tokens.get(), timeout)
+            except asyncio.TimeoutError:
+                await flush()
+                continue
+            
+            if delta is None:
+                break
+            parts.append(delta)
+            if not pending:
+                pending_since = time.perf_counter()
+            pending += delta
+            
+            if first_chunk_at is None:
+                first_chunk_at = time.perf_counter()
+                await flush()
+            elif len(pending) >= config.stream_chunk_chars:
+                await flush()
+    finally:
+        producer.cancel()
+    
+    # The remainder rides on the final message, which replaces the chunks
+    await manager.send_to_session(session_id, ProtocolMessage(
+        type="response_final",
+        payload={"text": "".join(parts), "is_final": True, "turn": turn}
+    ))
+    
+    if first_chunk_at is not None:
+        ttft_ms = (first_chunk_at - started) * 1000
+        elapsed = time.perf_counter() - first_chunk_at
+        stats = conn.stats
+        stats["stream_turns"] += 1
+        stats["stream_chunks"] += chunks
+        stats["ttft_ms_last"] = round(ttft_ms, 1)
+        previous_avg = stats["ttft_ms_avg"] or 0.0
+        stats["ttft_ms_avg"] = round(previous_avg + (ttft_ms - previous_avg) / stats["stream_turns"], 1)
+        stats["chunks_per_second_last"] = round(chunks / elapsed, 1) if elapsed > 0 else None
+        logger.info(f"Streamed reply to {conn.device_id}: first token {ttft_ms:.0f} ms, "
+                    f"{chunks} chunks, {len(parts)} tokens")
+
+
 # =============================================================================
 # WebSocket Endpoint
 # =============================================================================
@@ -573,26 +1175,28 @@ async def websocket_endpoint(websocket: WebSocket):
     session_id = None
     
     try:
-        # Wait for auth message before accepting
-        await websocket.accept()
+        # Answer the device's codec offer; without one, binary v1
+        offered = websocket.scope.get("subprotocols", [])
+        chosen = choose_codec(offered)
+        await websocket.accept(subprotocol=chosen)
+        codec = chosen or CODEC_V1
         
-        # Receive auth message (expecting binary protocol)
-        auth_data = await websocket.receive_bytes()
-        auth_msg = ProtocolMessage.from_binary(auth_data)
+        # Receive auth message
+        auth_msg = await receive_message(websocket)
         
         if not auth_msg or auth_msg.type != "auth":
             error_response = ProtocolMessage(
                 type="auth_response",
                 payload={"success": False, "error": "Expected auth message"}
             )
-            await websocket.send_bytes(error_response.to_binary())
+            await send_message(websocket, codec, error_response)
             await websocket.close()
             return
         
         device_id = auth_msg.payload.get("device_id", "unknown")
         
         # Create connection
-        conn = await manager.connect(websocket, device_id)
+        conn = await manager.connect(websocket, device_id, codec)
         session_id = conn.session_id
         
         # Validate API key if required
@@ -602,7 +1206,7 @@ async def websocket_endpoint(websocket: WebSocket):
                     type="auth_response",
                     payload={"success": False, "error": "Invalid API key"}
                 )
-                await websocket.send_bytes(error_response.to_binary())
+                await send_message(websocket, codec, error_response)
                 await websocket.close()
                 return
         
@@ -615,21 +1219,20 @@ async def websocket_endpoint(websocket: WebSocket):
         )
         await manager.authenticate(session_id, device_info)
         
-        # Send auth success
+        # Send auth success; through the shard queue, so it can't race
+        # mail from other workers that arrives once the device is claimed
         auth_response = ProtocolMessage(
             type="auth_response",
             payload={"success": True, "session_id": session_id}
         )
-        await websocket.send_bytes(auth_response.to_binary())
+        await manager.send_to_session(session_id, auth_response)
         
         # Main message loop
         while True:
             try:
-                # Receive message (binary protocol)
-                message_data = await websocket.receive_bytes()
+                message = await receive_message(websocket)
                 conn.touch()
                 
-                message = ProtocolMessage.from_binary(message_data)
                 if not message:
                     logger.warning(f"Failed to parse message from {device_id}")
                     continue
@@ -671,6 +1274,8 @@ async def handle_message(session_id: str, message: ProtocolMessage):
         await handle_ping(session_id, message)
     elif msg_type == "audio_config":
         await handle_audio_config(session_id, message)
+    elif msg_type == "command":
+        await handle_command(session_id, message)
     else:
         logger.warning(f"Unknown message type: {msg_type}")
 
@@ -688,15 +1293,9 @@ async def handle_text_message(session_id: str, message: ProtocolMessage):
     logger.info(f"Text from {conn.device_id}: {text[:50]}...")
     conn.stats["messages_received"] += 1
     
-    # Send to OpenClaw gateway
-    response = await gateway.send_message(conn.device_id, text)
-    
-    # Send response back to device
-    response_msg = ProtocolMessage(
-        type="response_final",
-        payload={"text": response, "is_final": True}
-    )
-    await manager.send_to_session(session_id, response_msg)
+    # Send to OpenClaw gateway and relay the reply
+    turn = message.payload.get("turn", 0)
+    start_turn(conn, turn, send_reply(session_id, text, turn))
 
 
 async def handle_audio_message(session_id: str, message: ProtocolMessage):
@@ -708,6 +1307,14 @@ async def handle_audio_message(session_id: str, message: ProtocolMessage):
     audio_b64 = message.payload.get("data", "")
     is_final = message.payload.get("is_final", False)
     codec = message.payload.get("codec", "opus")
+    turn = message.payload.get("turn", 0)
+    endpoint = message.payload.get("endpoint")
+    
+    # Audio for a new turn: whatever was left of an abandoned one goes
+    if turn != conn.audio_turn:
+        conn.audio_buffer.clear()
+        conn.audio_turn = turn
+        drop_speculation(conn)
     
     if audio_b64:
         # Decode and buffer audio
@@ -719,47 +1326,72 @@ async def handle_audio_message(session_id: str, message: ProtocolMessage):
             logger.error(f"Audio decode error: {e}")
             return
     
+    # The device's endpointer thinks the utterance is over, or takes it back
+    if endpoint == "resumed":
+        drop_speculation(conn)
+    elif endpoint == "likely_final" and not is_final and conn.audio_buffer and config.speculative_stt:
+        start_speculation(conn, turn, codec)
+    
     if is_final and conn.audio_buffer:
         logger.info(f"Processing audio from {conn.device_id} ({len(conn.audio_buffer)} bytes)")
+        audio = bytes(conn.audio_buffer)
+        conn.audio_buffer.clear()
+        speculation = take_speculation(conn, turn)
+        start_turn(conn, turn, run_voice_turn(session_id, audio, codec, turn, speculation))
+
+
+async def run_voice_turn(session_id: str, audio: bytes, codec: str, turn: int,
+                         speculation: Optional[SpeculativeTranscript] = None):
+    """Transcribe a finished utterance and answer it."""
+    # Send processing status
+    status_msg = ProtocolMessage(
+        type="status",
+        payload={"status": "Transcribing...", "turn": turn}
+    )
+    await manager.send_to_session(session_id, status_msg)
+    
+    # Transcribe audio; a speculative transcript covers all but the
+    # hangover silence, so it stands in for the full one
+    text = None
+    if speculation:
+        try:
+            text = await speculation.task
+        except Exception as e:
+            logger.warning(f"Speculative transcription failed, retrying: {e!r}")
+    if text is None:
+        text = await stt_service.transcribe(audio, codec)
+    
+    if text:
+        logger.info(f"Transcribed: {text}")
         
-        # Send processing status
-        status_msg = ProtocolMessage(
-            type="status",
-            payload={"status": "Transcribing..."}
+        # Send transcription to device
+        response_msg = ProtocolMessage(
+            type="response",
+            payload={"text": f"[You said: {text}]", "is_final": False, "turn": turn}
         )
-        await manager.send_to_session(session_id, status_msg)
+        await manager.send_to_session(session_id, response_msg)
         
-        # Transcribe audio
-        text = await stt_service.transcribe(bytes(conn.audio_buffer), codec)
-        
-        # Clear buffer
-        conn.audio_buffer.clear()
-        
-        if text:
-            logger.info(f"Transcribed: {text}")
-            
-            # Send transcription to device
-            response_msg = ProtocolMessage(
-                type="response",
-                payload={"text": f"[You said: {text}]", "is_final": False}
-            )
-            await manager.send_to_session(session_id, response_msg)
-            
-            # Send to OpenClaw
-            response = await gateway.send_message(conn.device_id, text)
-            
-            # Send AI response
-            final_response = ProtocolMessage(
-                type="response_final",
-                payload={"text": response, "is_final": True}
-            )
-            await manager.send_to_session(session_id, final_response)
-        else:
-            error_msg = ProtocolMessage(
-                type="error",
-                payload={"error": "Could not transcribe audio"}
-            )
-            await manager.send_to_session(session_id, error_msg)
+        # Send to OpenClaw and relay the reply
+        await send_reply(session_id, text, turn)
+    else:
+        error_msg = ProtocolMessage(
+            type="error",
+            payload={"error": "Could not transcribe audio", "turn": turn}
+        )
+        await manager.send_to_session(session_id, error_msg)
+
+
+async def handle_command(session_id: str, message: ProtocolMessage):
+    """Handle a control command from the device."""
+    conn = manager.get_connection(session_id)
+    if not conn:
+        return
+    
+    command = message.payload.get("command", "")
+    if command == "cancel":
+        cancel_turn(conn, message.payload.get("turn", 0))
+    else:
+        logger.warning(f"Unknown command from {conn.device_id}: {command}")
 
 
 async def handle_ping(session_id: str, message: ProtocolMessage):
@@ -801,27 +1433,38 @@ async def health_check():
     return {
         "status": "healthy",
         "version": "2.0.0",
+        "worker_id": manager.worker_id,
         "connected_devices": len(manager.get_active_connections()),
+        "transport": manager.get_stats(),
         "whisper_available": stt_service.whisper_available,
+        "stt": stt_service.scheduler.get_stats() if stt_service.scheduler else None,
+        "turns": turn_stats,
         "opus_enabled": config.enable_opus
     }
 
 
 @app.get("/devices")
 async def list_devices():
-    """List connected devices."""
+    """List connected devices across all workers."""
     devices = []
-    for conn in manager.get_active_connections():
-        devices.append({
-            "device_id": conn.device_id,
-            "device_name": conn.device_name,
-            "version": conn.version,
-            "capabilities": conn.capabilities,
-            "connected_at": conn.connected_at,
-            "last_activity": conn.last_activity,
-            "session_id": conn.session_id,
-            "stats": conn.stats
-        })
+    for record in await manager.store.list_sessions():
+        device = {
+            "device_id": record.device_id,
+            "device_name": record.device_name,
+            "connected_at": record.connected_at,
+            "session_id": record.session_id,
+            "worker_id": record.worker_id
+        }
+        # Live details only for devices held by this worker
+        conn = manager.get_connection(record.session_id)
+        if conn:
+            device.update({
+                "version": conn.version,
+                "capabilities": conn.capabilities,
+                "last_activity": conn.last_activity,
+                "stats": conn.stats
+            })
+        devices.append(device)
     return {"devices": devices}
 
 
@@ -849,6 +1492,15 @@ async def get_device_stats(device_id: str):
     """Get device statistics."""
     conn = manager.get_connection_by_device(device_id)
     if not conn:
+        # Held by another worker: say where, without the live counters
+        record = await manager.store.lookup(device_id)
+        if record:
+            return {
+                "device_id": record.device_id,
+                "session_id": record.session_id,
+                "connected_at": record.connected_at,
+                "worker_id": record.worker_id
+            }
         raise HTTPException(
             status_code=status.HTTP_404_NOT_FOUND,
             detail=f"Device {device_id} not connected"
@@ -873,5 +1525,6 @@ if __name__ == "__main__":
         host="0.0.0.0",
         port=config.websocket_port,
         log_level=config.log_level,
+        workers=config.workers,
         reload=False
     )
@@ -0,0 +1,197 @@
+"""
+OpenClaw Gateway Bridge - Session Store
+
+Maps devices to the worker process holding their WebSocket, so that any
+worker can find, message or evict any device. Features:
+- InProcessSessionStore for a single worker (no I/O)
+- SqliteSessionStore for several workers on one host; it stands in for a
+  shared store (e.g. Redis) until the bridge spans hosts
+- Per-worker mailboxes carry cross-worker sends and evictions
+- Worker heartbeats, so sessions of a crashed worker expire
+"""
+
+import asyncio
+import json
+import sqlite3
+import time
+from dataclasses import dataclass
+from typing import Dict, List, Optional, Tuple
+
+
+@dataclass
+class SessionRecord:
+    """Where a device is connected."""
+    device_id: str
+    worker_id: str
+    session_id: str
+    device_name: str
+    connected_at: float
+
+
+class InProcessSessionStore:
+    """Session store for a single worker process."""
+
+    def __init__(self):
+        self.sessions: Dict[str, SessionRecord] = {}
+        self.mailboxes: Dict[str, List[Tuple[str, dict]]] = {}
+
+    async def open(self):
+        pass
+
+    async def close(self):
+        pass
+
+    async def claim(self, record: SessionRecord) -> Optional[SessionRecord]:
+        """Record a device's new session; returns the one it replaces."""
+        previous = self.sessions.get(record.device_id)
+        self.sessions[record.device_id] = record
+        return previous
+
+    async def release(self, device_id: str, session_id: str):
+        """Forget a session, unless the device has already moved on."""
+        record = self.sessions.get(device_id)
+        if record and record.session_id == session_id:
+            del self.sessions[device_id]
+
+    async def lookup(self, device_id: str) -> Optional[SessionRecord]:
+        return self.sessions.get(device_id)
+
+    async def list_sessions(self) -> List[SessionRecord]:
+        return list(self.sessions.values())
+
+    async def post(self, worker_id: str, device_id: str, mail: dict):
+        """Queue work for another worker."""
+        self.mailboxes.setdefault(worker_id, []).append((device_id, mail))
+
+    async def take(self, worker_id: str) -> List[Tuple[str, dict]]:
+        """Collect this worker's mail."""
+        return self.mailboxes.pop(worker_id, [])
+
+    async def heartbeat(self, worker_id: str, timeout_seconds: float) -> int:
+        """Mark this worker alive; returns sessions dropped for dead ones."""
+        return 0
+
+
+class SqliteSessionStore:
+    """Session store shared by worker processes through a SQLite file.
+
+    WAL mode lets readers and one writer proceed together; every call
+    runs in a thread so the event loop never blocks on the file lock.
+    """
+
+    SCHEMA = """
+        CREATE TABLE IF NOT EXISTS sessions (
+            device_id TEXT PRIMARY KEY,
+            worker_id TEXT NOT NULL,
+            session_id TEXT NOT NULL,
+            device_name TEXT NOT NULL,
+            connected_at REAL NOT NULL
+        );
+        CREATE TABLE IF NOT EXISTS workers (
+            worker_id TEXT PRIMARY KEY,
+            last_seen REAL NOT NULL
+        );
+        CREATE TABLE IF NOT EXISTS mailbox (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            worker_id TEXT NOT NULL,
+            device_id TEXT NOT NULL,
+            mail TEXT NOT NULL
+        );
+        CREATE INDEX IF NOT EXISTS mailbox_worker ON mailbox (worker_id);
+    """
+
+    def __init__(self, path: str):
+        self.path = path
+        self.db: Optional[sqlite3.Connection] = None
+        self._lock = asyncio.Lock()
+
+    async def open(self):
+        await asyncio.to_thread(self._open)
+
+    def _open(self):
+        self.db = sqlite3.connect(self.path, timeout=5.0, check_same_thread=False,
+                                  isolation_level=None)
+        self.db.execute("PRAGMA journal_mode=WAL")
+        self.db.execute("PRAGMA synchronous=NORMAL")
+        self.db.executescript(self.SCHEMA)
+
+    async def close(self):
+        if self.db:
+            await asyncio.to_thread(self.db.close)
+            self.db = None
+
+    async def _run(self, fn, *args):
+        # One statement batch at a time per process; sqlite3 connections
+        # are not safe for concurrent use
+        async with self._lock:
+            return await asyncio.to_thread(fn, *args)
+
+    async def claim(self, record: SessionRecord) -> Optional[SessionRecord]:
+        return await self._run(self._claim, record)
+
+    def _claim(self, record: SessionRecord) -> Optional[SessionRecord]:
+        with self.db:
+            self.db.execute("BEGIN IMMEDIATE")
+            row = self.db.execute(
+                "SELECT device_id, worker_id, session_id, device_name, connected_at "
+                "FROM sessions WHERE device_id = ?", (record.device_id,)).fetchone()
+            self.db.execute(
+                "INSERT OR REPLACE INTO sessions VALUES (?, ?, ?, ?, ?)",
+                (record.device_id, record.worker_id, record.session_id,
+                 record.device_name, record.connected_at))
+        return SessionRecord(*row) if row else None
+
+    async def release(self, device_id: str, session_id: str):
+        await self._run(lambda: self.db.execute(
+            "DELETE FROM sessions WHERE device_id = ? AND session_id = ?",
+            (device_id, session_id)))
+
+    async def lookup(self, device_id: str) -> Optional[SessionRecord]:
+        row = await self._run(lambda: self.db.execute(
+            "SELECT device_id, worker_id, session_id, device_name, connected_at "
+            "FROM sessions WHERE device_id = ?", (device_id,)).fetchone())
+        return SessionRecord(*row) if row else None
+
+    async def list_sessions(self) -> List[SessionRecord]:
+        rows = await self._run(lambda: self.db.execute(
+            "SELECT device_id, worker_id, session_id, device_name, connected_at "
+            "FROM sessions").fetchall())
+        return [SessionRecord(*row) for row in rows]
+
+    async def post(self, worker_id: str, device_id: str, mail: dict):
+        await self._run(lambda: self.db.execute(
+            "INSERT INTO mailbox (worker_id, device_id, mail) VALUES (?, ?, ?)",
+            (worker_id, device_id, json.dumps(mail))))
+
+    async def take(self, worker_id: str) -> List[Tuple[str, dict]]:
+        return await self._run(self._take, worker_id)
+
+    def _take(self, worker_id: str) -> List[Tuple[str, dict]]:
+        with self.db:
+            self.db.execute("BEGIN IMMEDIATE")
+            rows = self.db.execute(
+                "SELECT id, device_id, mail FROM mailbox WHERE worker_id = ? ORDER BY id",
+                (worker_id,)).fetchall()
+            if rows:
+                self.db.execute("DELETE FROM mailbox WHERE worker_id = ? AND id <= ?",
+                                (worker_id, rows[-1][0]))
+        return [(device_id, json.loads(mail)) for _, device_id, mail in rows]
+
+    async def heartbeat(self, worker_id: str, timeout_seconds: float) -> int:
+        return await self._run(self._heartbeat, worker_id, timeout_seconds)
+
+    def _heartbeat(self, worker_id: str, timeout_seconds: float) -> int:
+        now = time.time()
+        with self.db:
+            self.db.execute("BEGIN IMMEDIATE")
+            self.db.execute("INSERT OR REPLACE INTO workers VALUES (?, ?)", (worker_id, now))
+            dead = [row[0] for row in self.db.execute(
+                "SELECT worker_id FROM workers WHERE last_seen < ?", (now - timeout_seconds,))]
+            for dead_worker in dead:
+                self.db.execute("DELETE FROM workers WHERE worker_id = ?", (dead_worker,))
+
+            # Also catches rows left by a previous run of the bridge
+            dropped = self.db.execute(
+                "DELETE FROM sessions WHERE worker_id NOT IN (SELECT worker_id FROM workers)").rowcount
+            self.db.execute("DELETE FROM mailbox WHERE worker_id NOT IN (SELECT worker_id FROM workers)")
+        return dropped
@@ -0,0 +1,131 @@
+"""
+OpenClaw Gateway Bridge - Transcription Load Test
+
+Drives the transcription scheduler with a stub model and reports, per
+maximum batch size, throughput and queueing delay. Features:
+- Utterances arrive from all devices as a Poisson stream at a fixed rate
+- The stub burns CPU for a fixed cost per batch plus a cost per utterance,
+  the shape of a batched encoder pass
+- Reports throughput, queueing delay (p50/p99), end-to-end p99, the
+  batch sizes actually formed and the pool CPU time
+- With --cancel-ratio, a share of utterances is cancelled shortly after
+  submission (barge-in); the same arrivals are replayed without
+  cancellation and the difference in pool CPU time is reported
+
+Usage:
+    python stt_loadtest.py --rate 20 --workers 2 --batch-sizes 1,2,4,8,16
+    python stt_loadtest.py --rate 20 --cancel-ratio 0.3 --cancel-after-ms 100
+"""
+
+import argparse
+import asyncio
+import random
+import time
+from typing import List
+
+from stt_scheduler import TranscriptionScheduler
+
+# Two seconds of 16 kHz PCM16, the size of a short voice turn
+UTTERANCE = bytes(2 * 16000 * 2)
+
+
+def percentile(samples: List[float], pct: float) -> float:
+    if not samples:
+        return 0.0
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(round(pct / 100 * (len(ordered) - 1))))]
+
+
+async def run_one(args: argparse.Namespace, batch_size: int, cancel_ratio: float) -> dict:
+    scheduler = TranscriptionScheduler(
+        backend="stub",
+        workers=args.workers,
+        max_batch_size=batch_size,
+        max_wait_ms=args.max_wait_ms,
+        stub_base_ms=args.stub_base_ms,
+        stub_item_ms=args.stub_item_ms
+    )
+    await scheduler.start()
+    # Warm the pool so process start-up isn't counted
+    await asyncio.gather(*(scheduler.submit(UTTERANCE) for _ in range(args.workers)))
+
+    queued: List[float] = []
+    total: List[float] = []
+    sizes: List[int] = []
+
+    async def utterance():
+        submitted = time.perf_counter()
+        result = await scheduler.submit(UTTERANCE)
+        total.append((time.perf_counter() - submitted) * 1000)
+        queued.append(result.queued_ms)
+        sizes.append(result.batch_size)
+
+    async def cancel_later(task: asyncio.Task):
+        await asyncio.sleep(args.cancel_after_ms / 1000)
+        task.cancel()
+
+    # Separate generators, so arrivals match with and without cancellation
+    arrivals = random.Random(args.seed)
+    cancels = random.Random(args.seed + 1)
+    tasks = []
+    start = time.perf_counter()
+    while time.perf_counter() - start < args.duration:
+        task = asyncio.create_task(utterance())
+        tasks.append(task)
+        if cancels.random() < cancel_ratio:
+            asyncio.create_task(cancel_later(task))
+        await asyncio.sleep(arrivals.expovariate(args.rate))
+    await asyncio.gather(*tasks, return_exceptions=True)
+    elapsed = time.perf_counter() - start
+    cpu_seconds = scheduler.stats["cpu_seconds"]
+    await scheduler.stop()
+
+    return {
+        "batch_size": batch_size,
+        "throughput": len(total) / elapsed,
+        "queued_p50": percentile(queued, 50),
+        "queued_p99": percentile(queued, 99),
+        "total_p99": percentile(total, 99),
+        "avg_batch": sum(sizes) / len(sizes) if sizes else 0.0,
+        "cpu_seconds": cpu_seconds
+    }
+
+
+async def main(args: argparse.Namespace):
+    batch_sizes = [int(size) for size in args.batch_sizes.split(",")]
+    print(f"Offered load {args.rate:.1f} utt/s for {args.duration:.0f} s, {args.workers} worker(s), "
+          f"max wait {args.max_wait_ms:.0f} ms, stub {args.stub_base_ms:.0f} ms + "
+          f"{args.stub_item_ms:.0f} ms/utt")
+    if args.cancel_ratio > 0:
+        print(f"Cancelling {args.cancel_ratio:.0%} of utterances {args.cancel_after_ms:.0f} ms "
+              f"after submission")
+    print(f"{'max batch':>9} {'utt/s':>8} {'queue p50':>10} {'queue p99':>10} "
+          f"{'total p99':>10} {'avg batch':>10} {'cpu s':>7}" +
+          (f" {'cpu s (no cancel)':>18} {'reclaimed':>10}" if args.cancel_ratio > 0 else ""))
+    for batch_size in batch_sizes:
+        row = await run_one(args, batch_size, args.cancel_ratio)
+        line = (f"{row['batch_size']:>9} {row['throughput']:>8.1f} {row['queued_p50']:>8.0f}ms "
+                f"{row['queued_p99']:>8.0f}ms {row['total_p99']:>8.0f}ms {row['avg_batch']:>10.2f} "
+                f"{row['cpu_seconds']:>7.1f}")
+        if args.cancel_ratio > 0:
+            baseline = await run_one(args, batch_size, 0.0)
+            reclaimed = baseline["cpu_seconds"] - row["cpu_seconds"]
+            share = reclaimed / baseline["cpu_seconds"] if baseline["cpu_seconds"] else 0.0
+            line += f" {baseline['cpu_seconds']:>18.1f} {reclaimed:>5.1f}s {share:>4.0%}"
+        print(line)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Load-test the transcription scheduler")
+    parser.add_argument("--rate", type=float, default=20.0, help="utterances per second, all devices")
+    parser.add_argument("--duration", type=float, default=20.0, help="seconds per batch size")
+    parser.add_argument("--workers", type=int, default=2, help="pool processes")
+    parser.add_argument("--batch-sizes", default="1,2,4,8,16")
+    parser.add_argument("--max-wait-ms", type=float, default=50.0)
+    parser.add_argument("--stub-base-ms", type=float, default=200.0, help="stub cost per batch")
+    parser.add_argument("--stub-item-ms", type=float, default=40.0, help="stub cost per utterance")
+    parser.add_argument("--cancel-ratio", type=float, default=0.0,
+                        help="fraction of utterances cancelled (barge-in)")
+    parser.add_argument("--cancel-after-ms", type=float, default=100.0)
+    parser.add_argument("--seed", type=int, default=1)
+    asyncio.run(main(parser.parse_args()))
@@ -0,0 +1,280 @@
+"""
+OpenClaw Gateway Bridge - Transcription Scheduler
+
+Queues finished utterances from every session and transcribes them in
+dynamic batches on a process pool, off the event loop. Features:
+- A batch closes when it is full or when its oldest utterance has waited
+  the maximum wait, whichever comes first
+- At most one batch per pool process is in flight; while the pool is busy
+  the queue keeps filling, so batches grow with load
+- Whisper batches decode together (one encoder pass for the batch);
+  utterances over 30 s fall back to a per-utterance transcribe
+- A stub backend with a fixed-plus-per-item cost, for load tests
+- Utterances whose caller has given up (cancelled turn, disconnect) are
+  dropped before dispatch; pool CPU time is counted so the saving shows
+- One scheduler per bridge worker process: with several workers each has
+  its own queue and pool, and batches never mix workers' utterances
+- Only 16 kHz mono PCM16 is accepted; other codecs are refused at submit
+  rather than decoded as noise (a session's audio arrives as one buffer,
+  so Opus packet boundaries are already gone by then)
+"""
+
+import asyncio
+import multiprocessing
+import time
+from collections import deque
+from concurrent.futures import ProcessPoolExecutor
+from dataclasses import dataclass, field
+from typing import List, Optional, Tuple
+
+# Whisper's decoder takes at most 30 s of 16 kHz audio per item
+WHISPER_SAMPLE_RATE = 16000
+WHISPER_MAX_SAMPLES = 30 * WHISPER_SAMPLE_RATE
+
+# Codec names the device and bridge use for raw 16-bit samples
+PCM_CODECS = ("pcm", "pcm_s16le")
+
+# Pool process state, set by _init_worker
+_backend = None
+_model = None
+_stub_base_ms = 0.0
+_stub_item_ms = 0.0
+
+
+def _init_worker(backend: str, model_name: str, stub_base_ms: float, stub_item_ms: float):
+    global _backend, _model, _stub_base_ms, _stub_item_ms
+    _backend = backend
+    _stub_base_ms = stub_base_ms
+    _stub_item_ms = stub_item_ms
+    if backend == "whisper":
+        import whisper
+        _model = whisper.load_model(model_name)
+
+
+def _noop():
+    pass
+
+
+def _busy_wait(ms: float):
+    # Burn CPU rather than sleep, so the stub contends like a real model
+    end = time.perf_counter() + ms / 1000
+    while time.perf_counter() < end:
+        pass
+
+
+def _transcribe_batch(utterances: List[bytes]) -> Tuple[List[str], float]:
+    """Runs in a pool process: 16 kHz mono PCM16 in, one text per utterance
+    out, plus the CPU seconds the batch took."""
+    started = time.process_time()
+    texts = _run_backend(utterances)
+    return texts, time.process_time() - started
+
+
+def _run_backend(utterances: List[bytes]) -> List[str]:
+    if _backend == "stub":
+        _busy_wait(_stub_base_ms + _stub_item_ms * len(utterances))
+        return [f"[stub transcript, {len(pcm)} bytes]" for pcm in utterances]
+
+    import numpy as np
+    import torch
+    import whisper
+
+    texts: List[Optional[str]] = [None] * len(utterances)
+    mels = []
+    batched = []
+
+    for i, pcm in enumerate(utterances):
+        audio = np.frombuffer(pcm, dtype=np.int16).astype(np.float32) / 32768.0
+        if len(audio) > WHISPER_MAX_SAMPLES:
+            texts[i] = _model.transcribe(audio, fp16=False).get("text", "").strip()
+            continue
+        audio = whisper.pad_or_trim(audio)
+        mels.append(whisper.log_mel_spectrogram(audio, n_mels=_model.dims.n_mels))
+        batched.append(i)
+
+    if mels:
+        results = whisper.decode(_model, torch.stack(mels).to(_model.device),
+                                 whisper.DecodingOptions(fp16=False))
+        for i, result in zip(batched, results):
+            texts[i] = result.text.strip()
+
+    return [text or "" for text in texts]
+
+
+@dataclass
+class TranscriptionResult:
+    """A transcript and where its time went."""
+    text: str
+    queued_ms: float        # Submit to batch dispatch
+    run_ms: float           # Batch dispatch to result
+    batch_size: int
+
+
+@dataclass
+class _Job:
+    audio: bytes
+    future: asyncio.Future
+    enqueued_at: float = field(default_factory=time.perf_counter)
+
+
+class TranscriptionScheduler:
+    """Forms batches of utterances and runs them on a process pool."""
+
+    def __init__(self, backend: str = "whisper", model_name: str = "base", workers: int = 1,
+                 max_batch_size: int = 8, max_wait_ms: float = 50.0,
+                 stub_base_ms: float = 200.0, stub_item_ms: float = 40.0):
+        self.backend = backend
+        self.model_name = model_name
+        self.workers = max(1, workers)
+        self.max_batch_size = max(1, max_batch_size)
+        self.max_wait_ms = max_wait_ms
+        self.stub_base_ms = stub_base_ms
+        self.stub_item_ms = stub_item_ms
+
+        self.queue: deque = deque()
+        self.wakeup = asyncio.Event()
+        self.pool: Optional[ProcessPoolExecutor] = None
+        self.slots: Optional[asyncio.Semaphore] = None
+        self.dispatcher: Optional[asyncio.Task] = None
+        self.running: set = set()
+        self.stats = {"submitted": 0, "completed": 0, "failed": 0, "abandoned": 0, "batches": 0,
+                      "cpu_seconds": 0.0}
+        self.recent_queued_ms: deque = deque(maxlen=256)
+        self.recent_batch_sizes: deque = deque(maxlen=256)
+
+    async def start(self):
+        """Start the pool processes and the dispatcher."""
+        # Spawn, not fork: torch does not survive a fork of a threaded parent
+        self.pool = ProcessPoolExecutor(
+            max_workers=self.workers,
+            mp_context=multiprocessing.get_context("spawn"),
+            initializer=_init_worker,
+            initargs=(self.backend, self.model_name, self.stub_base_ms, self.stub_item_ms)
+        )
+        self.slots = asyncio.Semaphore(self.workers)
+        # Start the processes (and load the model) now, not on the first utterance
+        for _ in range(self.workers):
+            self.pool.submit(_noop)
+        self.dispatcher = asyncio.create_task(self._dispatch())
+
+    async def stop(self):
+        """Stop dispatching and shut the pool down; queued utterances fail."""
+        if self.dispatcher:
+            self.dispatcher.cancel()
+            try:
+                await self.dispatcher
+            except asyncio.CancelledError:
+                pass
+            self.dispatcher = None
+        while self.queue:
+            job = self.queue.popleft()
+            if not job.future.done():
+                job.future.set_exception(RuntimeError("Transcription scheduler stopped"))
+        for task in list(self.running):
+            task.cancel()
+        if self.pool:
+            self.pool.shutdown(wait=False, cancel_futures=True)
+            self.pool = None
+
+    async def submit(self, audio: bytes, codec: str = "pcm") -> TranscriptionResult:
+        """Queue one utterance (16 kHz mono PCM16) and wait for its transcript."""
+        if not self.dispatcher:
+            raise RuntimeError("Transcription scheduler not started")
+        if codec.lower() not in PCM_CODECS:
+            raise ValueError(f"Local transcription needs PCM audio, got {codec!r}")
+        job = _Job(audio=audio, future=asyncio.get_running_loop().create_future())
+        self.queue.append(job)
+        self.stats["submitted"] += 1
+        self.wakeup.set()
+        return await job.future
+
+    def get_stats(self) -> dict:
+        """Counters plus recent queueing delay and batch size."""
+        stats = dict(self.stats)
+        stats["queue_depth"] = len(self.queue)
+        stats["batches_in_flight"] = len(self.running)
+        stats["cpu_seconds"] = round(stats["cpu_seconds"], 2)
+        if self.recent_queued_ms:
+            ordered = sorted(self.recent_queued_ms)
+            stats["queued_ms_p50"] = round(ordered[len(ordered) // 2], 1)
+            stats["queued_ms_p99"] = round(ordered[min(len(ordered) - 1, int(len(ordered) * 0.99))], 1)
+            stats["avg_batch_size"] = round(sum(self.recent_batch_sizes) / len(self.recent_batch_sizes), 2)
+        return stats
+
+    def _take_live(self) -> Optional[_Job]:
+        # Callers that were cancelled (disconnects, barge-in) cost nothing
+        while self.queue:
+            job = self.queue.popleft()
+            if not job.future.done():
+                return job
+            self.stats["abandoned"] += 1
+        return None
+
+    async def _dispatch(self):
+        while True:
+            await self.slots.acquire()
+            try:
+                batch = await self._form_batch()
+            except BaseException:
+                self.slots.release()
+                raise
+
+            task = asyncio.create_task(self._run(batch))
+            self.running.add(task)
+            task.add_done_callback(self.running.discard)
+
+    async def _form_batch(self) -> List[_Job]:
+        first = None
+        while first is None:
+            first = self._take_live()
+            if first is None:
+                self.wakeup.clear()
+                await self.wakeup.wait()
+
+        batch = [first]
+        deadline = first.enqueued_at + self.max_wait_ms / 1000
+        while len(batch) < self.max_batch_size:
+            job = self._take_live()
+            if job:
+                batch.append(job)
+                continue
+            remaining = deadline - time.perf_counter()
+            if remaining <= 0:
+                break
+            self.wakeup.clear()
+            try:
+                await asyncio.wait_for(self.wakeup.wait(), remaining)
+            except asyncio.TimeoutError:
+                break
+        return batch
+
+    async def _run(self, batch: List[_Job]):
+        started = time.perf_counter()
+        for job in batch:
+            self.recent_queued_ms.append((started - job.enqueued_at) * 1000)
+        self.recent_batch_sizes.append(len(batch))
+        self.stats["batches"] += 1
+
+        try:
+            texts, cpu_seconds = await asyncio.get_running_loop().run_in_executor(
+                self.pool, _transcribe_batch, [job.audio for job in batch])
+        except Exception as e:
+            self.stats["failed"] += len(batch)
+            for job in batch:
+                if not job.future.done():
+                    job.future.set_exception(e)
+            return
+        finally:
+            self.slots.release()
+
+        run_ms = (time.perf_counter() - started) * 1000
+        self.stats["cpu_seconds"] += cpu_seconds
+        for job, text in zip(batch, texts):
+            self.stats["completed"] += 1
+            if not job.future.done():
+                job.future.set_result(TranscriptionResult(
+                    text=text,
+                    queued_ms=(started - job.enqueued_at) * 1000,
+                    run_ms=run_ms,
+                    batch_size=len(batch)
+                ))
@@ -0,0 +1,338 @@
+"""
+OpenClaw Gateway Bridge - TLS Handshake Stand-in
+
+A local wss:// endpoint for measuring what a TLS connect costs, and what
+certificate pinning and session resumption save. Features:
+- Generates a three-level chain (root -> intermediate -> leaf, RSA-2048,
+  like a public CA) with the openssl CLI, or uses --cert/--key
+- serve: accepts WebSocket upgrades (the firmware's gateway link) and
+  logs the server-side handshake time and whether the session resumed;
+  each session is closed after --hold seconds so the device reconnects,
+  and it logs its own side as "WebSocket connected (..., handshake N ms)"
+- bench: connects repeatedly from this host and reports handshake time
+  (p50/p90/p99) for each way the client can trust the gateway:
+    ca-bundle       full handshake, chain verified against a CA bundle
+    pinned          full handshake, leaf checked against a SHA-256 pin
+    pinned-resumed  pinned, resuming the previous TLS session
+
+TLS 1.2 is used throughout, as negotiated by the device's mbedTLS. Bench
+numbers are this host's OpenSSL, so compare modes with each other rather
+than with the device; serve gives the device's own figures. The firmware
+does not resume sessions (its WiFiClientSecure has no session hook), so
+pinned-resumed is what an esp-tls transport would gain, not what the
+device does today.
+
+Usage:
+    python tls_standin.py bench --handshakes 500
+    python tls_standin.py serve --port 8443
+"""
+
+import argparse
+import base64
+import hashlib
+import os
+import socket
+import ssl
+import subprocess
+import tempfile
+import threading
+import time
+from typing import Dict, List, Optional, Tuple
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+MODES = ("ca-bundle", "pinned", "pinned-resumed")
+
+
+def percentile(samples: List[float], pct: float) -> float:
+    if not samples:
+        return 0.0
+    ordered = sorted(samples)
+    index = min(len(ordered) - 1, int(round(pct / 100 * (len(ordered) - 1))))
+    return ordered[index]
+
+
+def openssl(*args: str):
+    subprocess.run(["openssl", *args], check=True, capture_output=True)
+
+
+def make_chain(directory: str, host: str) -> Dict[str, str]:
+    """Root, intermediate and leaf for host; returns the file paths."""
+    paths = {name: os.path.join(directory, name) for name in
+             ("root.key", "root.pem", "int.key", "int.csr", "int.pem", "int.ext",
+              "leaf.key", "leaf.csr", "leaf.pem", "leaf.ext", "chain.pem")}
+    with open(paths["int.ext"], "w") as f:
+        f.write("basicConstraints=critical,CA:TRUE,pathlen:0\n"
+                "keyUsage=critical,keyCertSign,cRLSign\n")
+    with open(paths["leaf.ext"], "w") as f:
+        f.write(f"subjectAltName=DNS:{host},IP:127.0.0.1\n"
+                "extendedKeyUsage=serverAuth\n")
+
+    openssl("req", "-x509", "-newkey", "rsa:2048", "-nodes", "-days", "30",
+            "-subj", "/CN=OpenClaw Test Root", "-keyout", paths["root.key"],
+            "-out", paths["root.pem"])
+    for name, issuer, subject in (("int", "root", "/CN=OpenClaw Test Intermediate"),
+                                  ("leaf", "int", f"/CN={host}")):
+        openssl("req", "-newkey", "rsa:2048", "-nodes", "-subj", subject,
+                "-keyout", paths[f"{name}.key"], "-out", paths[f"{name}.csr"])
+        openssl("x509", "-req", "-days", "30", "-in", paths[f"{name}.csr"],
+                "-CA", paths[f"{issuer}.pem"], "-CAkey", paths[f"{issuer}.key"],
+                "-CAcreateserial", "-extfile", paths[f"{name}.ext"],
+                "-out", paths[f"{name}.pem"])
+
+    # The server presents leaf + intermediate, as a public gateway would
+    with open(paths["chain.pem"], "w") as out:
+        for name in ("leaf.pem", "int.pem"):
+            with open(paths[name]) as f:
+                out.write(f.read())
+    return paths
+
+
+def fingerprint(der: bytes) -> str:
+    """SHA-256 pin in the form gateway.tls_fingerprint takes."""
+    return ":".join(f"{b:02X}" for b in hashlib.sha256(der).digest())
+
+
+def server_context(cert: str, key: str) -> ssl.SSLContext:
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.minimum_version = ssl.TLSVersion.TLSv1_2
+    context.maximum_version = ssl.TLSVersion.TLSv1_2
+    context.load_cert_chain(cert, key)
+    return context
+
+
+def client_context(mode: str, root: str) -> ssl.SSLContext:
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_CLIENT)
+    context.minimum_version = ssl.TLSVersion.TLSv1_2
+    context.maximum_version = ssl.TLSVersion.TLSv1_2
+    if mode == "ca-bundle":
+        # The system bundle plus the test root: issuer lookup over a
+        # realistic store, then the chain signatures
+        context.load_default_certs()
+        context.load_verify_locations(root)
+    else:
+        context.check_hostname = False
+        context.verify_mode = ssl.CERT_NONE
+    return context
+
+
+def websocket_accept(request: bytes) -> Optional[bytes]:
+    """101 response for a WebSocket upgrade request, echoing one subprotocol."""
+    headers = {}
+    for line in request.decode("latin-1").split("\r\n")[1:]:
+        name, _, value = line.partition(":")
+        headers[name.strip().lower()] = value.strip()
+    key = headers.get("sec-websocket-key")
+    if not key:
+        return None
+    accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+    response = ("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                f"Connection: Upgrade\r\nSec-WebSocket-Accept: {accept}\r\n")
+    offered = headers.get("sec-websocket-protocol", "")
+    if offered:
+        response += f"Sec-WebSocket-Protocol: {offered.split(',')[0].strip()}\r\n"
+    return (response + "\r\n").encode()
+
+
+def parse_frame(buffer: bytes) -> Optional[Tuple[int, bytes, int]]:
+    """(opcode, unmasked payload, bytes used) of the first complete client frame."""
+    if len(buffer) < 2:
+        return None
+    length = buffer[1] & 0x7F
+    pos = 2
+    if length == 126:
+        if len(buffer) < 4:
+            return None
+        length = int.from_bytes(buffer[2:4], "big")
+        pos = 4
+    elif length == 127:
+        if len(buffer) < 10:
+            return None
+        length = int.from_bytes(buffer[2:10], "big")
+        pos = 10
+    mask = buffer[pos:pos + 4] if buffer[1] & 0x80 else b"\0\0\0\0"
+    pos += 4 if buffer[1] & 0x80 else 0
+    if len(buffer) < pos + length:
+        return None
+    payload = bytes(b ^ mask[i % 4] for i, b in enumerate(buffer[pos:pos + length]))
+    return buffer[0] & 0x0F, payload, pos + length
+
+
+class StandinServer:
+    """TLS listener; times each handshake from accept to Finished."""
+
+    def __init__(self, context: ssl.SSLContext, port: int, upgrade: bool, verbose: bool,
+                 hold_s: float = 0):
+        self.context = context
+        self.hold_s = hold_s
+        self.upgrade = upgrade
+        self.verbose = verbose
+        self.listener = socket.create_server(("0.0.0.0", port), backlog=128)
+        self.port = self.listener.getsockname()[1]
+        self.handshakes: List[Tuple[float, bool]] = []
+        self.lock = threading.Lock()
+
+    def serve_forever(self):
+        while True:
+            try:
+                raw, peer = self.listener.accept()
+            except OSError:
+                return      # Closed
+            threading.Thread(target=self.handle, args=(raw, peer), daemon=True).start()
+
+    def handle(self, raw: socket.socket, peer):
+        start = time.perf_counter()
+        try:
+            tls = self.context.wrap_socket(raw, server_side=True)
+        except (ssl.SSLError, OSError) as e:
+            if self.verbose:
+                print(f"{peer[0]}: handshake failed: {e}")
+            raw.close()
+            return
+        elapsed_ms = (time.perf_counter() - start) * 1000
+        with self.lock:
+            self.handshakes.append((elapsed_ms, tls.session_reused))
+        if self.verbose:
+            print(f"{peer[0]}: handshake {elapsed_ms:.1f} ms (server side), "
+                  f"{'resumed' if tls.session_reused else 'full'}, {tls.cipher()[0]}")
+
+        try:
+            if self.upgrade:
+                request = b""
+                while b"\r\n\r\n" not in request and len(request) < 8192:
+                    chunk = tls.recv(4096)
+                    if not chunk:
+                        return
+                    request += chunk
+                response = websocket_accept(request)
+                if response is None:
+                    return
+                tls.sendall(response)
+                self.hold(tls)
+            else:
+                while tls.recv(4096):
+                    pass
+        except OSError:
+            pass
+        finally:
+            tls.close()
+
+    def hold(self, tls: ssl.SSLSocket):
+        """Keep the link up for hold_s, then close it so the device
+        reconnects and takes the next sample. Answers pings and closes."""
+        deadline = time.monotonic() + self.hold_s
+        buffer = b""
+        while True:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                tls.sendall(b"\x88\x02\x03\xe8")     # Close, 1000
+                return
+            tls.settimeout(remaining)
+            try:
+                chunk = tls.recv(4096)
+            except socket.timeout:
+                continue
+            if not chunk:
+                return
+            buffer += chunk
+            while (frame := parse_frame(buffer)) is not None:
+                opcode, payload, used = frame
+                buffer = buffer[used:]
+                if opcode == 0x8:
+                    tls.sendall(b"\x88\x00")
+                    return
+                if opcode == 0x9:
+                    tls.sendall(bytes([0x8A, len(payload)]) + payload)
+
+    def close(self):
+        self.listener.close()
+
+
+def bench(args: argparse.Namespace):
+    with tempfile.TemporaryDirectory() as directory:
+        paths = make_chain(directory, "localhost")
+        server = StandinServer(server_context(paths["chain.pem"], paths["leaf.key"]),
+                               0, upgrade=False, verbose=False)
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+
+        with open(paths["leaf.pem"]) as f:
+            pin = fingerprint(ssl.PEM_cert_to_DER_cert(f.read()))
+        print(f"Leaf pin: {pin}")
+        print(f"{args.handshakes} handshakes per mode, TLS 1.2, RSA-2048 chain of 3\n")
+        print(f"{'mode':<16} {'p50 ms':>8} {'p90 ms':>8} {'p99 ms':>8} {'resumed':>8}")
+
+        results = {}
+        for mode in MODES:
+            context = client_context(mode, paths["root.pem"])
+            samples: List[float] = []
+            resumed = 0
+            session = None
+            for _ in range(args.handshakes):
+                raw = socket.create_connection(("127.0.0.1", server.port))
+                start = time.perf_counter()
+                tls = context.wrap_socket(raw, server_hostname="localhost",
+                                          session=session if mode == "pinned-resumed" else None)
+                if mode != "ca-bundle" and fingerprint(tls.getpeercert(binary_form=True)) != pin:
+                    raise SystemExit("pin mismatch")
+                samples.append((time.perf_counter() - start) * 1000)
+                resumed += tls.session_reused
+                session = tls.session
+                tls.close()
+            results[mode] = percentile(samples, 50)
+            print(f"{mode:<16} {percentile(samples, 50):8.2f} {percentile(samples, 90):8.2f} "
+                  f"{percentile(samples, 99):8.2f} {resumed:8d}")
+        server.close()
+
+        base = results["ca-bundle"]
+        for mode in MODES[1:]:
+            print(f"{mode} saves {base - results[mode]:.2f} ms "
+                  f"({(1 - results[mode] / base) * 100:.0f}%) at p50 over ca-bundle")
+
+
+def serve(args: argparse.Namespace):
+    directory = None
+    if args.cert and args.key:
+        cert, key = args.cert, args.key
+    else:
+        directory = tempfile.mkdtemp(prefix="openclaw-tls-")
+        paths = make_chain(directory, args.host)
+        cert, key = paths["chain.pem"], paths["leaf.key"]
+        print(f"Generated test chain in {directory}")
+
+    with open(cert) as f:
+        pin = fingerprint(ssl.PEM_cert_to_DER_cert(f.read()))
+    print(f"Set gateway.tls_fingerprint to {pin}")
+
+    server = StandinServer(server_context(cert, key), args.port, upgrade=True, verbose=True,
+                           hold_s=args.hold)
+    print(f"Listening on wss://{args.host}:{server.port}/")
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.close()
+        samples = [ms for ms, _ in server.handshakes]
+        if samples:
+            print(f"{len(samples)} handshakes, {sum(r for _, r in server.handshakes)} resumed; "
+                  f"p50 {percentile(samples, 50):.1f} ms, p90 {percentile(samples, 90):.1f} ms "
+                  f"(server side)")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="TLS handshake stand-in for the gateway")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    bench_parser = commands.add_parser("bench", help="Compare trust modes from this host")
+    bench_parser.add_argument("--handshakes", type=int, default=300)
+
+    serve_parser = commands.add_parser("serve", help="wss:// endpoint for the device")
+    serve_parser.add_argument("--port", type=int, default=8443)
+    serve_parser.add_argument("--host", default="localhost",
+                              help="Name (or IP) the device connects to; goes in the leaf")
+    serve_parser.add_argument("--cert", help="PEM chain, leaf first (default: generate one)")
+    serve_parser.add_argument("--key", help="PEM key for the leaf")
+    serve_parser.add_argument("--hold", type=float, default=5.0,
+                              help="Seconds each session stays up before the server closes it")
+
+    args = parser.parse_args()
+    bench(args) if args.command == "bench" else serve(args)
@@ -3,10 +3,11 @@
  * @brief Application state machine for OpenClaw Cardputer
  * 
  * Features:
- * - Hierarchical state machine
- * - Event-driven transitions
- * - State entry/exit actions
- * - Timeout handling
+ * - Event-driven transitions via a flat [state][event] table generated
+ *   at compile time (see state_machine_dsl.h)
+ * - Fixed-capacity ring buffer event queue (no heap, O(1) post/pop)
+ * - Per-state data in arrays indexed by AppState
+ * - State entry/exit actions and timeouts (as TIMEOUT events)
  * - History state support
  */
 
@@ -14,17 +15,14 @@
 #define OPENCLAW_APP_STATE_MACHINE_H
 
 #include <Arduino.h>
-#include <functional>
-#include <vector>
-#include <map>
-#include <memory>
-#include <string>
+#include <array>
+#include "ring_buffer.h"
+#include "timer_wheel.h"
 
 namespace OpenClaw {
 
 // Forward declarations
 class AppStateMachine;
-class State;
 
 // Event types
 enum class AppEvent : uint8_t {
@@ -96,6 +94,11 @@ enum class AppState : uint8_t {
     SHUTTING_DOWN
 };
 
+constexpr size_t APP_STATE_COUNT = static_cast<size_t>(AppState::SHUTTING_DOWN) + 1;
+constexpr size_t APP_EVENT_COUNT = static_cast<size_t>(AppEvent::SHUTDOWN) + 1;
+constexpr size_t EVENT_QUEUE_CAPACITY = 16;
+static_assert(APP_STATE_COUNT <= 32, "failed_mask_ holds one bit per state");
+
 // Event structure
 struct StateMachineEvent {
     AppEvent type;
@@ -110,75 +113,33 @@ struct StateMachineEvent {
         : type(t), data(d), data_size(ds), timestamp(millis()) {}
 };
 
-// State action callbacks
-using StateAction = std::function<void()>;
-using StateEventHandler = std::function<bool(const StateMachineEvent& event)>;
-using GuardCondition = std::function<bool()>;
+// Plain function pointers: resolved at compile time, no heap
+using StateAction = void (*)();
+using TransitionFn = bool (*)();   // Runs guard + action; false if the guard rejects
+using StateChangeCallback = void (*)(AppState from, AppState to);
 
-// Transition definition
-struct Transition {
-    AppEvent event;
-    AppState target_state;
-    GuardCondition guard;
-    StateAction action;
-    
-    Transition(AppEvent e, AppState target, GuardCondition g = nullptr, StateAction a = nullptr)
-        : event(e), target_state(target), guard(g), action(a) {}
+// One [state][event] cell of the dispatch table
+struct TransitionSlot {
+    uint8_t target;       // AppState, or MachineSpec::NO_TRANSITION
+    TransitionFn fire;    // Null when the row has no guard and no action
 };
 
-// State definition
-class State {
-public:
-    State(AppState id, const char* name);
-    
-    // Set actions
-    void setEntryAction(StateAction action) { entry_action_ = action; }
-    void setExitAction(StateAction action) { exit_action_ = action; }
-    void setUpdateAction(StateAction action) { update_action_ = action; }
-    
-    // Add transition
-    void addTransition(const Transition& transition);
-    void addTransition(AppEvent event, AppState target, 
-                       GuardCondition guard = nullptr, StateAction action = nullptr);
-    
-    // Set timeout
-    void setTimeout(uint32_t timeout_ms, AppState timeout_state);
-    void setRetryDelay(uint32_t delay_ms);
-    
-    // Getters
-    AppState getId() const { return id_; }
-    const char* getName() const { return name_; }
-    
-    // Execute actions
-    void onEntry();
-    void onExit();
-    void onUpdate();
-    
-    // Handle event
-    bool handleEvent(const StateMachineEvent& event, AppState& out_target);
-    
-    // Check timeout
-    bool checkTimeout(uint32_t current_time, AppState& out_target);
-    void resetTimeout();
-    
-    // Get time in state
-    uint32_t getTimeInState() const;
-
-private:
-    AppState id_;
-    const char* name_;
-    
-    StateAction entry_action_;
-    StateAction exit_action_;
-    StateAction update_action_;
-    
-    std::vector<Transition> transitions_;
-    
-    uint32_t timeout_ms_;
-    AppState timeout_state_;
-    uint32_t retry_delay_ms_;
-    uint32_t entry_time_;
-    uint32_t last_activity_time_;
+/**
+ * @brief Complete, immutable description of a state machine
+ *
+ * Generated by Fsm::Machine<> (state_machine_dsl.h) as a constexpr
+ * object, so it lives in flash and has already been validated.
+ */
+struct MachineSpec {
+    static constexpr uint8_t NO_TRANSITION = 0xFF;
+    
+    AppState initial;
+    TransitionSlot transitions[APP_STATE_COUNT][APP_EVENT_COUNT];
+    StateAction on_entry[APP_STATE_COUNT];
+    StateAction on_exit[APP_STATE_COUNT];
+    uint32_t timeout_ms[APP_STATE_COUNT];       // 0 = no timeout; fires AppEvent::TIMEOUT
+    uint32_t entry_delay_ms[APP_STATE_COUNT];   // Retry back-off: re-entry after a failed visit is deferred this long
+    bool declared[APP_STATE_COUNT];
 };
 
 // State machine class
@@ -191,25 +152,23 @@ public:
     AppStateMachine(const AppStateMachine&) = delete;
     AppStateMachine& operator=(const AppStateMachine&) = delete;
     
-    // Initialize
-    bool begin();
+    // Initialize with a generated spec and enter its initial state;
+    // state timeouts and retry back-offs are scheduled on timers
+    bool begin(const MachineSpec* spec, TimerWheel* timers);
     
-    // Update (call in main loop)
+    // Process queued events (call in main loop)
     void update();
     
     // Deinitialize
     void end();
     
-    // Add state
-    void addState(std::unique_ptr<State> state);
-    State* getState(AppState id);
-    
-    // Transition to state
+    // Transition to state (deferred, not blocking, while a retry back-off runs).
+    // Targeting the current state restarts its timeout without exit/entry.
     bool transitionTo(AppState target);
     
-    // Post event
-    void postEvent(const StateMachineEvent& event);
-    void postEvent(AppEvent type, void* data = nullptr, size_t data_size = 0);
+    // Post event (returns false and counts a drop if the queue is full)
+    bool postEvent(const StateMachineEvent& event);
+    bool postEvent(AppEvent type, void* data = nullptr, size_t data_size = 0);
     
     // Get current state
     AppState getCurrentState() const { return current_state_id_; }
@@ -220,32 +179,58 @@ public:
     bool isInState(AppState state) const { return current_state_id_ == state; }
     
     // Set global actions
-    void setOnStateChange(std::function<void(AppState from, AppState to)> callback) {
-        on_state_change_ = callback;
-    }
+    void setOnStateChange(StateChangeCallback callback) { on_state_change_ = callback; }
     
     // Get state history
     AppState getPreviousState() const { return previous_state_id_; }
     
-    // Force transition (bypass guards)
+    // Force transition (bypass the table and any retry back-off)
     void forceTransition(AppState target);
+    
+    // Deferred transition waiting out a retry back-off
+    bool isTransitionPending() const { return pending_; }
+    AppState getPendingState() const { return pending_target_; }
+    uint32_t getPendingDelayRemaining() const;
+    
+    // Queue diagnostics
+    size_t getPendingEventCount() const { return event_queue_.size(); }
+    uint32_t getDroppedEventCount() const { return dropped_events_; }
 
 private:
-    std::map<AppState, std::unique_ptr<State>> states_;
+    const MachineSpec* spec_;
     AppState current_state_id_;
     AppState previous_state_id_;
-    State* current_state_;
+    uint32_t entry_time_;
+    uint32_t failed_mask_;      // Bit per state whose last visit ended in an error state
+    
+    RingBuffer<StateMachineEvent, EVENT_QUEUE_CAPACITY> event_queue_;
+    uint32_t dropped_events_;
+    
+    StateChangeCallback on_state_change_;
     
-    std::vector<StateMachineEvent> event_queue_;
+    // Deferred transition (retry back-off); the current state stays active
+    // and keeps handling events until it commits
+    bool pending_;
+    AppState pending_target_;
+    uint32_t pending_due_;
     
-    std::function<void(AppState from, AppState to)> on_state_change_;
+    TimerWheel* timers_;
+    TimerId timeout_timer_;
+    TimerId pending_timer_;
     
     bool transitioning_;
     
     // Private methods
     void processEvents();
-    void executeTransition(State* target, const StateMachineEvent* trigger_event);
-    State* findState(AppState id);
+    bool dispatch(AppEvent event);
+    void commitTransition(AppState target);
+    void handleTimeout();
+    void armTimeout();
+    
+    static void timeoutTimerCallback(void* ctx);
+    static void pendingTimerCallback(void* ctx);
+    void enterState(AppState state);
+    void exitState(AppState state);
 };
 
 // Application context
@@ -266,6 +251,9 @@ struct AppContext {
         bool gateway_connected;
         bool authenticated;
         AppState current_state;
+        uint32_t turn_id;           // Current conversation turn (0 = none yet)
+        uint32_t turn_started_ms;
+        bool turn_answered;         // First reply for the turn has arrived
     } state;
     
     // Statistics
@@ -274,6 +262,8 @@ struct AppContext {
         uint32_t messages_received;
         uint32_t uptime_seconds;
         uint32_t reconnect_count;
+        uint32_t turns_cancelled;
+        uint32_t stale_replies_dropped;
     } stats;
     
     // Input
@@ -292,6 +282,7 @@ struct AppContext {
 };
 
 // Utility functions
+bool isErrorState(AppState state);
 const char* appStateToString(AppState state);
 const char* appEventToString(AppEvent event);
 
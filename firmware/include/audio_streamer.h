@@ -4,7 +4,7 @@
  * 
  * Features:
  * - I2S microphone input with continuous streaming
- * - Voice Activity Detection (VAD)
+ * - Voice Activity Detection (VAD) with adaptive end-of-utterance detection
  * - Opus codec encoding
  * - Real-time streaming to gateway
  * - Configurable sample rates and frame sizes
@@ -22,6 +22,8 @@
 #include <memory>
 #include <functional>
 #include "protocol.h"
+#include "event_loop.h"
+#include "endpointer.h"
 
 namespace OpenClaw {
 
@@ -64,8 +66,12 @@ struct AudioStreamerConfig {
     bool vad_enabled;
     int16_t vad_threshold;      // Amplitude threshold (0-32767)
     uint16_t vad_min_duration_ms;
-    uint16_t vad_silence_ms;
+    uint16_t vad_silence_ms;    // Hangover before the end (start value when adaptive)
     float vad_ratio;            // Voice/silence ratio threshold
+    bool vad_adaptive;          // Fit the hangover to the speaker's pauses
+    uint16_t vad_min_silence_ms;
+    uint16_t vad_max_silence_ms;
+    bool vad_final_hint;        // Mark a "likely final" frame before the end
     
     // Streaming
     bool auto_stream;
@@ -86,6 +92,10 @@ struct AudioStreamerConfig {
           vad_min_duration_ms(200),
           vad_silence_ms(500),
           vad_ratio(0.3f),
+          vad_adaptive(true),
+          vad_min_silence_ms(200),
+          vad_max_silence_ms(900),
+          vad_final_hint(true),
           auto_stream(true),
           stream_queue_size(10) {}
 };
@@ -139,13 +149,17 @@ struct EncodedAudioPacket {
     size_t length;
     uint32_t timestamp;
     bool is_final;
+    EndpointEvent endpoint;     // LIKELY_FINAL / RESUMED hints ride on a frame
     AudioCodec codec;
     
-    EncodedAudioPacket() : length(0), timestamp(0), is_final(false), codec(AudioCodec::OPUS) {}
+    EncodedAudioPacket()
+        : length(0), timestamp(0), is_final(false), endpoint(EndpointEvent::NONE),
+          codec(AudioCodec::OPUS) {}
     
     EncodedAudioPacket(size_t max_size)
         : data(new uint8_t[max_size]),
-          length(0), timestamp(0), is_final(false), codec(AudioCodec::OPUS) {}
+          length(0), timestamp(0), is_final(false), endpoint(EndpointEvent::NONE),
+          codec(AudioCodec::OPUS) {}
     
     // Move constructor
     EncodedAudioPacket(EncodedAudioPacket&& other) noexcept
@@ -153,6 +167,7 @@ struct EncodedAudioPacket {
           length(other.length),
           timestamp(other.timestamp),
           is_final(other.is_final),
+          endpoint(other.endpoint),
           codec(other.codec) {
         other.length = 0;
     }
@@ -164,6 +179,7 @@ struct EncodedAudioPacket {
             length = other.length;
             timestamp = other.timestamp;
             is_final = other.is_final;
+            endpoint = other.endpoint;
             codec = other.codec;
             other.length = 0;
         }
@@ -202,6 +218,12 @@ public:
     // Initialize with configuration
     bool begin(const AudioStreamerConfig& config);
     
+    // Apply new settings without a restart. Gain and VAD take effect on
+    // the next frame; a format change (rate, frame, codec) is applied
+    // now if idle, else when the current capture stops
+    bool reconfigure(const AudioStreamerConfig& config);
+    bool hasPendingFormat() const { return has_pending_config_; }
+    
     // Start streaming
     bool start();
     
@@ -227,6 +249,9 @@ public:
     // Set event callback
     void onEvent(AudioEventCallback callback);
     
+    // Wake the main loop whenever an encoded packet is queued
+    void setNotifier(const LoopNotifier& notifier) { packet_notifier_ = notifier; }
+    
     // Get current state
     AudioStreamState getState() const { return state_; }
     VADState getVADState() const { return vad_state_; }
@@ -255,15 +280,21 @@ public:
     uint32_t getFramesCaptured() const { return frames_captured_; }
     uint32_t getFramesStreamed() const { return frames_streamed_; }
     uint32_t getVoiceEvents() const { return voice_events_; }
+    
+    // End-of-utterance detection (hangover, pause statistics)
+    const Endpointer& getEndpointer() const { return endpointer_; }
 
 private:
     // Configuration
     AudioStreamerConfig config_;
+    AudioStreamerConfig pending_config_;
+    bool has_pending_config_;
     
     // State
     AudioStreamState state_;
     VADState vad_state_;
     AudioEventCallback event_callback_;
+    LoopNotifier packet_notifier_;
     
     // I2S
     i2s_port_t i2s_port_;
@@ -286,6 +317,8 @@ private:
     uint32_t voice_frame_count_;
     uint32_t total_frame_count_;
     float current_rms_;
+    Endpointer endpointer_;
+    EndpointEvent endpoint_event_;  // For the frame just processed
     
     // Statistics
     uint32_t frames_captured_;
@@ -304,6 +337,8 @@ private:
     static AudioStreamer* instance_;
     
     // Private methods
+    bool allocateBuffers();
+    bool applyFormat(const AudioStreamerConfig& config);
     bool setupI2S();
     void teardownI2S();
     bool createQueues();
@@ -317,11 +352,12 @@ private:
     
     void captureLoop();
     void processFrame(const int16_t* samples, size_t count);
-    void encodeAndQueue(const int16_t* samples, size_t count, bool is_final);
+    void encodeAndQueue(const int16_t* samples, size_t count, bool is_final, EndpointEvent endpoint);
     
     float calculateRMS(const int16_t* samples, size_t count);
     void applyGain(int16_t* samples, size_t count);
     VADState updateVAD(float rms);
+    void applyEndpointerConfig();
     
     // Static task wrapper
     static void captureTaskWrapper(void* param);
@@ -13,6 +13,7 @@
 #include <M5Cardputer.h>
 #include <WiFi.h>
 #include "keyboard_handler.h"
+#include "trigger_matcher.h"
 
 namespace Avatar {
 
@@ -104,6 +105,11 @@ public:
      */
     bool checkVoicePhrase(const char* text);
     
+    /**
+     * @brief Same, for triggers already found in the text
+     */
+    bool checkVoiceTriggers(OpenClaw::TriggerMask triggers);
+    
     /**
      * @brief Process key for konami code
      * @param key Key event
@@ -166,19 +172,6 @@ private:
     bool questRequired_ = false;
     bool questCompleted_ = false;
     
-    // Voice phrases
-    static constexpr const char* AWAKEN_PHRASES[] = {
-        "minerva awaken",
-        "minerva, awaken",
-        "awaken minerva",
-        "speak ancient",
-        "ancient wisdom",
-        "owl mode activate",
-        "by the thirty seven claws",
-        "by the thirty-seven claws"
-    };
-    static constexpr uint8_t NUM_AWAKEN_PHRASES = 8;
-    
     // Private methods
     bool detectGesture();
     bool checkTimeTrigger();
@@ -10,6 +10,7 @@
 
 #include <Arduino.h>
 #include <time.h>
+#include "trigger_matcher.h"
 
 namespace Avatar {
 
@@ -81,6 +82,11 @@ public:
      */
     void processText(const char* text);
     
+    /**
+     * @brief Act on triggers already found in a text (see trigger_matcher.h)
+     */
+    void processTriggers(OpenClaw::TriggerMask triggers);
+    
     /**
      * @brief Process typing speed for behavior triggers
      * @param wpm Words per minute
@@ -261,20 +267,11 @@ private:
         "The silence... it echoes..."
     };
     
-    // Insult keywords
-    static constexpr const char* INSULTS[] = {
-        "stupid", "dumb", "idiot", "useless", "broken",
-        "trash", "garbage", "worst", "hate", "suck",
-        "terrible", "awful", "bad code", "buggy"
-    };
-    static constexpr uint8_t NUM_INSULTS = 15;
-    
     // Private methods
     SpecialMood checkDateTriggers();
     SpecialMood checkTimeTriggers();
     SpecialMood checkBehaviorTriggers();
     SpecialMood checkCosmicTriggers();
-    bool containsInsult(const char* text);
     void resetPleaseCounter();
 };
 
@@ -83,37 +83,37 @@ struct Vec2 {
 /**
  * @brief Draw a filled circle with optional gradient
  */
-void drawFilledCircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r, 
+void drawFilledCircle(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t r, 
                        uint16_t color, uint16_t edgeColor = 0, float edgeWidth = 0);
 
 /**
  * @brief Draw an anti-aliased circle outline
  */
-void drawAACircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r, 
+void drawAACircle(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t r, 
                      uint16_t color, float thickness = 1.0f);
 
 /**
  * @brief Draw an ellipse (procedural)
  */
-void drawEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
+void drawEllipse(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
                   uint16_t color, float rotation = 0);
 
 /**
  * @brief Draw a filled ellipse
  */
-void drawFilledEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
+void drawFilledEllipse(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
                         uint16_t color, float rotation = 0);
 
 /**
  * @brief Draw a bezier curve
  */
-void drawBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
+void drawBezier(lgfx::LovyanGFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
                  uint16_t color, float thickness = 1.0f);
 
 /**
  * @brief Draw a filled bezier shape
  */
-void drawFilledBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
+void drawFilledBezier(lgfx::LovyanGFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
                        const Vec2& p3, uint16_t color);
 
 /**
@@ -127,31 +127,31 @@ void drawFilledBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2
  * @param color Base color
  * @param ruffle Amount of ruffle (0-1)
  */
-void drawFeather(M5GFX* gfx, float x, float y, float length, float angle,
+void drawFeather(lgfx::LovyanGFX* gfx, float x, float y, float length, float angle,
                   float width, uint16_t color, float ruffle = 0);
 
 /**
  * @brief Draw multiple feathers as a tuft
  */
-void drawFeatherTuft(M5GFX* gfx, float x, float y, int count, float spread,
+void drawFeatherTuft(lgfx::LovyanGFX* gfx, float x, float y, int count, float spread,
                       float length, uint16_t color, float ruffle = 0);
 
 /**
  * @brief Draw a glowing rune symbol (ancient mode)
  */
-void drawRune(M5GFX* gfx, float x, float y, float size, uint8_t symbol,
+void drawRune(lgfx::LovyanGFX* gfx, float x, float y, float size, uint8_t symbol,
                uint16_t color, float glowIntensity);
 
 /**
  * @brief Apply sepia tint to a region (ancient mode)
  */
-void applySepiaTint(M5GFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
+void applySepiaTint(lgfx::LovyanGFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
                      float intensity);
 
 /**
  * @brief Draw scanline effect (ancient/glitch mode)
  */
-void drawScanlines(M5GFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
+void drawScanlines(lgfx::LovyanGFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
                     float intensity);
 
 } // namespace Avatar
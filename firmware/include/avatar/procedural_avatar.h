@@ -45,10 +45,10 @@ public:
     
     /**
      * @brief Initialize the avatar
-     * @param gfx Pointer to M5GFX display
+     * @param gfx Render target (the display compositor's frame)
      * @return true if initialized successfully
      */
-    bool begin(M5GFX* gfx);
+    bool begin(lgfx::LovyanGFX* gfx);
     
     /**
      * @brief Update animation state
@@ -57,7 +57,9 @@ public:
     void update(float deltaMs);
     
     /**
-     * @brief Render the avatar to display
+     * @brief Render the avatar into the render target
+     *
+     * Only touches the AVATAR_SIZE square at AVATAR_X/AVATAR_Y.
      */
     void render();
     
@@ -155,7 +157,7 @@ public:
 
 private:
     // Display reference
-    M5GFX* gfx_ = nullptr;
+    lgfx::LovyanGFX* gfx_ = nullptr;
     bool initialized_ = false;
     
     // State
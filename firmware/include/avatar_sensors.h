@@ -7,6 +7,7 @@
  * - Detect shake for "annoyed" mood
  * - Detect free-fall for "panic" expression
  * - Detect orientation for "sleep when face-down"
+ * - Low-rate wake-on-motion sampling while the device is in deep idle
  */
 
 #ifndef AVATAR_SENSORS_H
@@ -17,6 +18,14 @@
 
 namespace Avatar {
 
+// Scheduling (driven by the main loop's timer wheel)
+constexpr uint32_t SENSOR_SAMPLE_INTERVAL_MS = 50;      // 20 Hz
+constexpr uint32_t SENSOR_IDLE_SAMPLE_INTERVAL_MS = 100; // 10 Hz, accel only
+constexpr uint32_t BATTERY_CHECK_INTERVAL_MS = 30000;
+
+// Change in acceleration (g) from the reference that counts as motion
+constexpr float MOTION_WAKE_THRESHOLD_G = 0.15f;
+
 class AvatarSensors {
 public:
     AvatarSensors();
@@ -27,10 +36,35 @@ public:
     bool begin();
     
     /**
-     * @brief Update sensor readings (call in loop)
+     * @brief Sample the IMU (call every SENSOR_SAMPLE_INTERVAL_MS)
      */
     void update();
     
+    /**
+     * @brief Switch to wake-on-motion sampling
+     *
+     * In low-power mode update() reads only the accelerometer and compares
+     * it with the reading taken on entry; see hasMotion(). The caller is
+     * expected to sample at SENSOR_IDLE_SAMPLE_INTERVAL_MS meanwhile.
+     */
+    void setLowPowerMode(bool enabled);
+    bool isLowPowerMode() const { return low_power_; }
+    
+    /**
+     * @brief Check if the device moved since low-power mode was entered
+     */
+    bool hasMotion() const { return motion_; }
+    
+    /**
+     * @brief Refresh battery level (call every BATTERY_CHECK_INTERVAL_MS)
+     */
+    void checkBattery();
+    
+    /**
+     * @brief Check if an IMU was detected by begin()
+     */
+    bool isImuAvailable() const { return imu_available_; }
+    
     /**
      * @brief Get current tilt angle (-1 to 1 for each axis)
      */
@@ -80,21 +114,23 @@ private:
     bool face_down_;
     bool free_fall_;
     
+    // Wake-on-motion
+    bool low_power_;
+    bool motion_;
+    float ref_x_, ref_y_, ref_z_;
+    
     // Shake detection
     float shake_intensity_;
     uint32_t last_shake_time_;
     
-    // Update timing
-    uint32_t last_update_;
-    
     // Battery
     uint8_t battery_level_;
-    uint32_t last_battery_check_;
     
     void readSensors();
+    void readAccel();
     void processOrientation();
+    void detectMotion();
     void detectShake();
-    void checkBattery();
 };
 
 // Global instance
@@ -0,0 +1,74 @@
+/**
+ * @file boot_profile.h
+ * @brief Boot-to-ready phase timing for OpenClaw Cardputer
+ *
+ * Features:
+ * - Timestamps each phase from reset to READY (setup, association, IP,
+ *   gateway address, gateway socket, authentication)
+ * - Only the first occurrence of a phase counts, so later reconnects
+ *   don't overwrite the boot numbers
+ * - Records which shortcuts the boot took (cached AP, lease, address)
+ */
+
+#ifndef OPENCLAW_BOOT_PROFILE_H
+#define OPENCLAW_BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+namespace OpenClaw {
+
+// Boot phases, in the order they normally complete
+enum class BootPhase : uint8_t {
+    SETUP,              // setup() finished
+    WIFI_ASSOCIATED,    // Associated with the AP
+    WIFI_IP,            // Holding an IP address
+    GATEWAY_RESOLVED,   // Gateway address known
+    GATEWAY_CONNECTED,  // Gateway socket open
+    READY,              // Authenticated, accepting input
+    COUNT
+};
+
+// Shortcuts taken on the way
+namespace BootFlags {
+    constexpr uint8_t FAST_JOIN = 0x01;     // Joined the cached BSSID/channel
+    constexpr uint8_t CACHED_LEASE = 0x02;  // Skipped DHCP
+    constexpr uint8_t CACHED_DNS = 0x04;    // Skipped the gateway lookup
+}
+
+class BootProfile {
+public:
+    BootProfile();
+
+    // Disable copy
+    BootProfile(const BootProfile&) = delete;
+    BootProfile& operator=(const BootProfile&) = delete;
+
+    /**
+     * @brief Record that a phase completed at at_ms (millis() clock)
+     */
+    void mark(BootPhase phase, uint32_t at_ms);
+    void mark(BootPhase phase) { mark(phase, millis()); }
+
+    bool isMarked(BootPhase phase) const;
+    uint32_t getMs(BootPhase phase) const;
+
+    void setFlags(uint8_t flags) { flags_ |= flags; }
+    uint8_t getFlags() const { return flags_; }
+
+    /**
+     * @brief Print per-phase times and deltas to Serial
+     */
+    void printReport() const;
+
+private:
+    uint32_t marks_[static_cast<size_t>(BootPhase::COUNT)];
+    uint8_t marked_;            // Bit per phase
+    uint8_t flags_;
+};
+
+// Utility functions
+const char* bootPhaseToString(BootPhase phase);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_BOOT_PROFILE_H
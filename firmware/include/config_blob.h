@@ -0,0 +1,127 @@
+/**
+ * @file config_blob.h
+ * @brief Binary configuration image for OpenClaw Cardputer
+ *
+ * Features:
+ * - Fixed-layout struct: scalars, then a string table addressed by offset
+ * - Versioned and CRC32-protected; loaded with a single file read
+ * - Records which /config.json it was imported from, so an edited JSON
+ *   file is picked up again on the next boot
+ * - Base image for the delta log (config_log.h): only a log with the same
+ *   generation is replayed on top of it
+ */
+
+#ifndef OPENCLAW_CONFIG_BLOB_H
+#define OPENCLAW_CONFIG_BLOB_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenClaw {
+
+struct AppConfig;
+
+constexpr uint32_t CONFIG_BLOB_MAGIC = 0x42434F43;  // "OCCB"
+constexpr uint16_t CONFIG_BLOB_VERSION = 3;
+constexpr size_t CONFIG_STRING_TABLE_SIZE = 1024;
+
+// String table slots
+enum class ConfigString : uint8_t {
+    WIFI_SSID,
+    WIFI_PASSWORD,
+    WIFI_STATIC_IP,
+    WIFI_GATEWAY,
+    WIFI_SUBNET,
+    GATEWAY_WEBSOCKET_URL,
+    GATEWAY_FALLBACK_URL,
+    GATEWAY_API_KEY,
+    DEVICE_ID,
+    DEVICE_NAME,
+    DEVICE_FIRMWARE_VERSION,
+    AUDIO_CODEC,
+    GATEWAY_TLS_FINGERPRINT,
+    COUNT
+};
+
+// Boolean settings
+namespace ConfigFlags {
+    constexpr uint8_t WIFI_DHCP = 0x01;
+    constexpr uint8_t AUTO_CONNECT = 0x02;
+    constexpr uint8_t SAVE_HISTORY = 0x04;
+    constexpr uint8_t NOISE_SUPPRESSION = 0x08;
+    constexpr uint8_t AUTO_GAIN_CONTROL = 0x10;
+}
+
+// Identifies the JSON file a blob was imported from (size + mtime)
+struct ConfigJsonStamp {
+    uint32_t size;
+    uint32_t mtime;
+
+    bool operator==(const ConfigJsonStamp& other) const {
+        return size == other.size && mtime == other.mtime;
+    }
+};
+
+/**
+ * @brief On-flash configuration image
+ *
+ * Written and read as raw bytes; layout changes must bump
+ * CONFIG_BLOB_VERSION. The CRC covers everything after the header.
+ */
+struct ConfigBlob {
+    // Header
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;              // sizeof(ConfigBlob)
+    uint32_t crc32;
+
+    ConfigJsonStamp json_stamp;
+    uint32_t log_generation;    // /config.log generation built on this image
+
+    // Scalars
+    uint16_t reconnect_interval_ms;
+    uint16_t ping_interval_ms;
+    uint16_t connection_timeout_ms;
+    uint16_t sample_rate;
+    uint8_t frame_duration_ms;
+    uint8_t mic_gain;
+    uint8_t display_brightness;
+    uint8_t flags;              // ConfigFlags
+
+    // Strings: NUL-terminated, at string_offset[] within strings[]
+    uint16_t string_offset[static_cast<size_t>(ConfigString::COUNT)];
+    uint16_t string_bytes;
+    char strings[CONFIG_STRING_TABLE_SIZE];
+
+    const char* getString(ConfigString id) const {
+        return strings + string_offset[static_cast<size_t>(id)];
+    }
+};
+
+/**
+ * @brief Pack a configuration (fills header and CRC)
+ * @return false if the strings do not fit the table
+ */
+bool packConfigBlob(const AppConfig& config, const ConfigJsonStamp& stamp,
+                    uint32_t log_generation, ConfigBlob& blob);
+
+/**
+ * @brief Unpack a blob that passed validateConfigBlob()
+ */
+void unpackConfigBlob(const ConfigBlob& blob, AppConfig& config);
+
+/**
+ * @brief Check magic, version, size, CRC and string bounds
+ */
+bool validateConfigBlob(const ConfigBlob& blob);
+
+/**
+ * @brief Convert an image written by the previous version (new settings
+ *        take their defaults), so an update keeps logged changes
+ * @return false if data is not a valid previous-version image
+ */
+bool upgradeConfigBlob(const uint8_t* data, size_t length, ConfigBlob& blob);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_CONFIG_BLOB_H
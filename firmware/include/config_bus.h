@@ -0,0 +1,100 @@
+/**
+ * @file config_bus.h
+ * @brief Configuration change notifications for OpenClaw Cardputer
+ *
+ * Features:
+ * - Subscribers register for the settings they care about (ConfigKeyMask)
+ * - ConfigManager publishes once per successful save, with the keys that
+ *   actually changed, so components apply diffs live instead of needing
+ *   a reboot
+ * - Fixed subscriber table, no allocation; main loop context only
+ */
+
+#ifndef OPENCLAW_CONFIG_BUS_H
+#define OPENCLAW_CONFIG_BUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "config_log.h"
+
+namespace OpenClaw {
+
+// Settings grouped by what has to happen when they change
+namespace ConfigGroups {
+    constexpr ConfigKeyMask WIFI =
+        configKeyBit(ConfigKey::WIFI_SSID) | configKeyBit(ConfigKey::WIFI_PASSWORD) |
+        configKeyBit(ConfigKey::WIFI_DHCP) | configKeyBit(ConfigKey::WIFI_STATIC_IP) |
+        configKeyBit(ConfigKey::WIFI_GATEWAY) | configKeyBit(ConfigKey::WIFI_SUBNET);
+
+    // Bound when the gateway session is opened
+    constexpr ConfigKeyMask GATEWAY_SESSION =
+        configKeyBit(ConfigKey::GATEWAY_WEBSOCKET_URL) | configKeyBit(ConfigKey::GATEWAY_FALLBACK_URL) |
+        configKeyBit(ConfigKey::GATEWAY_API_KEY) | configKeyBit(ConfigKey::GATEWAY_TLS_FINGERPRINT) |
+        configKeyBit(ConfigKey::DEVICE_ID) | configKeyBit(ConfigKey::DEVICE_NAME);
+
+    constexpr ConfigKeyMask GATEWAY_TIMING =
+        configKeyBit(ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS) |
+        configKeyBit(ConfigKey::GATEWAY_PING_INTERVAL_MS) |
+        configKeyBit(ConfigKey::GATEWAY_CONNECTION_TIMEOUT_MS);
+
+    constexpr ConfigKeyMask GATEWAY = GATEWAY_SESSION | GATEWAY_TIMING;
+
+    // Stream format, negotiated with the gateway via AUDIO_CONFIG
+    constexpr ConfigKeyMask AUDIO_FORMAT =
+        configKeyBit(ConfigKey::AUDIO_SAMPLE_RATE) | configKeyBit(ConfigKey::AUDIO_FRAME_DURATION_MS) |
+        configKeyBit(ConfigKey::AUDIO_CODEC);
+
+    constexpr ConfigKeyMask AUDIO_PROCESSING =
+        configKeyBit(ConfigKey::AUDIO_MIC_GAIN) | configKeyBit(ConfigKey::AUDIO_NOISE_SUPPRESSION) |
+        configKeyBit(ConfigKey::AUDIO_AUTO_GAIN_CONTROL);
+
+    constexpr ConfigKeyMask AUDIO = AUDIO_FORMAT | AUDIO_PROCESSING;
+
+    constexpr ConfigKeyMask DISPLAY = configKeyBit(ConfigKey::DEVICE_DISPLAY_BRIGHTNESS);
+}
+
+/**
+ * @brief Change handler
+ * @param changed Keys that changed (already filtered by the subscription)
+ * @param config The new configuration
+ */
+using ConfigListener = void (*)(ConfigKeyMask changed, const AppConfig& config, void* ctx);
+
+class ConfigBus {
+public:
+    static constexpr size_t MAX_SUBSCRIBERS = 8;
+
+    ConfigBus();
+
+    // Disable copy
+    ConfigBus(const ConfigBus&) = delete;
+    ConfigBus& operator=(const ConfigBus&) = delete;
+
+    /**
+     * @brief Call listener whenever a key in mask changes
+     * @return false if the subscriber table is full
+     */
+    bool subscribe(ConfigKeyMask mask, ConfigListener listener, void* ctx = nullptr);
+
+    /**
+     * @brief Notify every subscriber whose mask overlaps changed
+     * @return Number of listeners called
+     */
+    size_t publish(ConfigKeyMask changed, const AppConfig& config);
+
+    size_t getSubscriberCount() const { return count_; }
+
+private:
+    struct Subscriber {
+        ConfigKeyMask mask;
+        ConfigListener listener;
+        void* ctx;
+    };
+
+    Subscriber subscribers_[MAX_SUBSCRIBERS];
+    size_t count_;
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_CONFIG_BUS_H
@@ -0,0 +1,124 @@
+/**
+ * @file config_log.h
+ * @brief Append-only configuration delta log for OpenClaw Cardputer
+ *
+ * Features:
+ * - One record per changed setting, so a save costs O(changed keys)
+ * - Records are grouped into batches closed by a commit record
+ *   (sequence + CRC32); a batch only counts once its commit is intact,
+ *   and the previous commit stays valid until then
+ * - Generation number ties the log to one base image (config_blob.h);
+ *   compaction bumps it, which retires the old log atomically
+ * - Pure byte-level encode/replay; ConfigManager does the file I/O
+ *
+ * Log layout:
+ *   ConfigLogHeader
+ *   { [key u8][len u8][value] ... [COMMIT][8][sequence u32][crc32 u32] } ...
+ */
+
+#ifndef OPENCLAW_CONFIG_LOG_H
+#define OPENCLAW_CONFIG_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenClaw {
+
+struct AppConfig;
+
+constexpr uint32_t CONFIG_LOG_MAGIC = 0x4C434F43;   // "OCCL"
+constexpr uint16_t CONFIG_LOG_VERSION = 1;
+constexpr size_t CONFIG_LOG_COMPACT_BYTES = 4096;   // Compact once the log passes this
+constexpr size_t CONFIG_LOG_MAX_BYTES = 16384;      // Larger logs are treated as corrupt
+constexpr size_t CONFIG_LOG_BATCH_MAX = 2048;
+constexpr uint8_t CONFIG_LOG_COMMIT = 0xFF;
+
+// Persisted settings, one log record each (values never reorder)
+enum class ConfigKey : uint8_t {
+    WIFI_SSID,
+    WIFI_PASSWORD,
+    WIFI_DHCP,
+    WIFI_STATIC_IP,
+    WIFI_GATEWAY,
+    WIFI_SUBNET,
+    GATEWAY_WEBSOCKET_URL,
+    GATEWAY_FALLBACK_URL,
+    GATEWAY_API_KEY,
+    GATEWAY_RECONNECT_INTERVAL_MS,
+    GATEWAY_PING_INTERVAL_MS,
+    GATEWAY_CONNECTION_TIMEOUT_MS,
+    DEVICE_ID,
+    DEVICE_NAME,
+    DEVICE_FIRMWARE_VERSION,
+    DEVICE_AUTO_CONNECT,
+    DEVICE_SAVE_HISTORY,
+    DEVICE_DISPLAY_BRIGHTNESS,
+    AUDIO_SAMPLE_RATE,
+    AUDIO_FRAME_DURATION_MS,
+    AUDIO_CODEC,
+    AUDIO_MIC_GAIN,
+    AUDIO_NOISE_SUPPRESSION,
+    AUDIO_AUTO_GAIN_CONTROL,
+    GATEWAY_TLS_FINGERPRINT,
+    COUNT
+};
+
+// One bit per ConfigKey
+using ConfigKeyMask = uint32_t;
+
+constexpr ConfigKeyMask configKeyBit(ConfigKey key) {
+    return ConfigKeyMask(1) << static_cast<uint8_t>(key);
+}
+
+static_assert(static_cast<uint8_t>(ConfigKey::COUNT) <= 32, "ConfigKeyMask is 32 bits");
+
+struct ConfigLogHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t generation;
+    uint32_t crc32;         // Over the fields above
+};
+
+// Outcome of replaying a log
+struct ConfigLogReplay {
+    uint32_t sequence;      // Last committed batch (0 = none)
+    size_t batches;         // Batches applied
+    size_t valid_bytes;     // Bytes up to the last good commit
+};
+
+/**
+ * @brief Fill a header for a new log
+ */
+void makeConfigLogHeader(uint32_t generation, ConfigLogHeader& header);
+
+/**
+ * @brief Encode the settings that differ between two configurations
+ * @param length Bytes written (0 if nothing changed)
+ * @return false if the batch does not fit (caller should compact)
+ */
+bool buildConfigLogBatch(const AppConfig& from, const AppConfig& to, uint32_t sequence,
+                         uint8_t* out, size_t capacity, size_t& length);
+
+/**
+ * @brief Apply every committed batch of a log onto config
+ *
+ * Stops at the first torn, corrupt or out-of-order batch; everything
+ * before it is applied. valid_bytes < size means the tail must be
+ * discarded before appending again.
+ * @return false if the header is missing, corrupt or of another generation
+ */
+bool replayConfigLog(const uint8_t* data, size_t size, uint32_t generation,
+                     AppConfig& config, ConfigLogReplay& result);
+
+/**
+ * @brief Settings that differ between two configurations
+ */
+ConfigKeyMask diffConfig(const AppConfig& from, const AppConfig& to);
+
+// Utility functions
+const char* configKeyToString(ConfigKey key);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_CONFIG_LOG_H
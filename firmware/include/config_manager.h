@@ -4,6 +4,13 @@
  * 
  * Handles WiFi credentials, gateway settings, and device configuration
  * stored in LittleFS filesystem.
+ *
+ * Boot reads a CRC-protected binary image (/config.bin, see
+ * config_blob.h) with one file read. Saves append only the changed keys
+ * to /config.log (config_log.h), which is replayed on top of the image;
+ * once the log grows past CONFIG_LOG_COMPACT_BYTES it is folded back into
+ * a fresh image. /config.json remains the user-facing format: it is
+ * imported whenever it changes and rewritten on compaction.
  */
 
 #ifndef CONFIG_MANAGER_H
@@ -12,6 +19,9 @@
 #include <Arduino.h>
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include "config_blob.h"
+#include "config_bus.h"
+#include "config_log.h"
 
 namespace OpenClaw {
 
@@ -46,6 +56,7 @@ struct GatewayConfig {
     String websocket_url;
     String fallback_http_url;
     String api_key;
+    String tls_fingerprint;     // SHA-256 of the gateway certificate (wss pin)
     uint16_t reconnect_interval_ms = 5000;
     uint16_t ping_interval_ms = 30000;
     uint16_t connection_timeout_ms = 10000;
@@ -103,6 +114,13 @@ struct AppConfig {
     }
 };
 
+// Where the running configuration came from
+enum class ConfigSource : uint8_t {
+    DEFAULTS,
+    BINARY,     // /config.bin
+    JSON        // /config.json (imported; /config.bin rewritten)
+};
+
 /**
  * @brief Configuration manager class
  * 
@@ -126,16 +144,39 @@ public:
     
     /**
      * @brief Load configuration from filesystem
+     *
+     * Uses /config.bin plus the committed part of /config.log when the
+     * image is valid and was built from the current /config.json;
+     * otherwise parses the JSON and rebuilds the binary image.
      * @return true if loaded successfully
      */
     bool load();
     
     /**
-     * @brief Save current configuration to filesystem
+     * @brief Persist the settings changed since the last load/save
+     *
+     * Appends one committed batch to /config.log; a power cut at any
+     * point leaves either the old or the new configuration. Once the
+     * batch is durable the changed keys are published on getBus().
      * @return true if saved successfully
      */
     bool save();
     
+    /**
+     * @brief Rewrite /config.json and /config.bin and drop the log
+     * @return true if compacted successfully
+     */
+    bool compact();
+    
+    /**
+     * @brief Change notifications, published by save()
+     */
+    ConfigBus& getBus() { return bus_; }
+    
+    // Boot instrumentation for the last load()
+    ConfigSource getLoadSource() const { return load_source_; }
+    uint32_t getLoadTimeUs() const { return load_time_us_; }
+    
     /**
      * @brief Reset to default configuration
      */
@@ -179,19 +220,43 @@ public:
 
 private:
     static constexpr const char* CONFIG_FILE = "/config.json";
+    static constexpr const char* CONFIG_BLOB_FILE = "/config.bin";
+    static constexpr const char* CONFIG_BLOB_TEMP_FILE = "/config.bin.tmp";
+    static constexpr const char* CONFIG_TEMP_FILE = "/config.json.tmp";
+    static constexpr const char* CONFIG_LOG_FILE = "/config.log";
     static constexpr size_t JSON_BUFFER_SIZE = 2048;
     
     AppConfig config_;
+    ConfigBus bus_;
     char last_error_[128];
     bool initialized_ = false;
+    ConfigSource load_source_ = ConfigSource::DEFAULTS;
+    uint32_t load_time_us_ = 0;
+    
+    // Delta log state
+    AppConfig persisted_;           // What /config.bin + /config.log hold
+    bool log_ready_ = false;        // A base image for log_generation_ exists
+    uint32_t log_generation_ = 0;
+    uint32_t log_sequence_ = 0;
+    size_t log_bytes_ = 0;
     
     bool loadFromFile(const char* path);
     bool saveToFile(const char* path);
+    bool loadBlob(const ConfigJsonStamp& json_stamp);
+    bool saveBlob(const ConfigJsonStamp& json_stamp, uint32_t log_generation);
+    bool persist();
+    bool replayLog();
+    bool appendLog(const uint8_t* batch, size_t length);
+    void resetLog(uint32_t generation);
+    ConfigJsonStamp getJsonStamp() const;
     void setDefaults();
     bool parseJson(const JsonDocument& doc);
     bool serializeToJson(JsonDocument& doc) const;
 };
 
+// Utility functions
+const char* configSourceToString(ConfigSource source);
+
 } // namespace OpenClaw
 
 #endif // CONFIG_MANAGER_H
@@ -0,0 +1,208 @@
+/**
+ * @file display_compositor.h
+ * @brief Layered display compositor for OpenClaw Cardputer
+ *
+ * Features:
+ * - Single off-screen frame buffer shared by every UI component
+ * - Z-ordered layers (avatar, messages, status, input, menu overlay)
+ * - Per-layer damage tracking, coalesced into a few dirty regions
+ * - Occlusion culling for opaque layers (e.g. the settings menu)
+ * - One SPI transaction per frame covering only the dirty regions
+ * - Freeze (no panel writes, damage kept) while the screen is off
+ */
+
+#ifndef OPENCLAW_DISPLAY_COMPOSITOR_H
+#define OPENCLAW_DISPLAY_COMPOSITOR_H
+
+#include <Arduino.h>
+#include <M5GFX.h>
+#include <functional>
+
+namespace OpenClaw {
+
+// Layers in z-order, bottom to top
+enum class DisplayLayer : uint8_t {
+    AVATAR,
+    MESSAGES,
+    STATUS,
+    INPUT,
+    MENU_OVERLAY,
+    SPLASH,         // Boot/connection/error screens
+    COUNT
+};
+
+constexpr size_t DISPLAY_LAYER_COUNT = static_cast<size_t>(DisplayLayer::COUNT);
+
+// Screen-space rectangle (empty when w or h <= 0)
+struct DisplayRect {
+    int16_t x;
+    int16_t y;
+    int16_t w;
+    int16_t h;
+
+    constexpr DisplayRect() : x(0), y(0), w(0), h(0) {}
+    constexpr DisplayRect(int16_t x_, int16_t y_, int16_t w_, int16_t h_)
+        : x(x_), y(y_), w(w_), h(h_) {}
+
+    bool isEmpty() const { return w <= 0 || h <= 0; }
+    int16_t right() const { return x + w; }
+    int16_t bottom() const { return y + h; }
+    uint32_t area() const { return isEmpty() ? 0 : (uint32_t)w * (uint32_t)h; }
+
+    bool intersects(const DisplayRect& other) const;
+    bool touches(const DisplayRect& other) const;
+    bool contains(const DisplayRect& other) const;
+    DisplayRect intersection(const DisplayRect& other) const;
+    DisplayRect united(const DisplayRect& other) const;
+};
+
+// Layer render callback; draws into the shared frame (clip is preset)
+using LayerRenderFn = std::function<void(lgfx::LovyanGFX& gfx)>;
+
+// Compositor statistics
+struct CompositorStats {
+    uint32_t frames_composed;
+    uint32_t frames_skipped;
+    uint32_t regions_flushed;
+    uint32_t pixels_flushed;
+    uint32_t layers_rendered;
+    uint32_t layers_occluded;
+    uint32_t last_compose_us;
+
+    CompositorStats()
+        : frames_composed(0), frames_skipped(0), regions_flushed(0),
+          pixels_flushed(0), layers_rendered(0), layers_occluded(0),
+          last_compose_us(0) {}
+};
+
+/**
+ * @brief Composites UI layers into one frame and flushes dirty regions
+ *
+ * Components never touch the panel directly. They register a layer with
+ * a bounding rectangle and a render callback, then call damage() when
+ * their content changes. compose() re-renders every visible layer that
+ * intersects a dirty region (bottom to top, clipped to the region) and
+ * pushes only those regions to the panel in a single write transaction.
+ */
+class DisplayCompositor {
+public:
+    DisplayCompositor();
+    ~DisplayCompositor();
+
+    // Disable copy
+    DisplayCompositor(const DisplayCompositor&) = delete;
+    DisplayCompositor& operator=(const DisplayCompositor&) = delete;
+
+    /**
+     * @brief Allocate the frame buffer for the given panel
+     * @param display Target panel
+     * @param background Color used where no opaque layer covers a region
+     * @return true if the frame buffer was allocated
+     */
+    bool begin(M5GFX* display, uint16_t background = 0x0000);
+
+    /**
+     * @brief Release the frame buffer
+     */
+    void end();
+
+    /**
+     * @brief Register (or replace) a layer
+     * @param layer Layer slot
+     * @param bounds Screen area the layer may draw into
+     * @param render Render callback
+     * @param opaque True if the layer fully covers its bounds
+     */
+    void setLayer(DisplayLayer layer, const DisplayRect& bounds,
+                  LayerRenderFn render, bool opaque = false);
+
+    /**
+     * @brief Show or hide a layer (damages its bounds on change)
+     */
+    void setLayerVisible(DisplayLayer layer, bool visible);
+    bool isLayerVisible(DisplayLayer layer) const;
+
+    /**
+     * @brief Mark a layer's whole bounds dirty
+     */
+    void damage(DisplayLayer layer);
+
+    /**
+     * @brief Mark part of a layer dirty (clipped to the layer bounds)
+     */
+    void damage(DisplayLayer layer, const DisplayRect& rect);
+
+    /**
+     * @brief Mark the whole screen dirty
+     */
+    void damageAll();
+
+    /**
+     * @brief Check if any visible layer has pending damage
+     */
+    bool hasDamage() const;
+
+    /**
+     * @brief Render dirty regions and flush them to the panel
+     * @return true if anything was pushed to the panel
+     */
+    bool compose();
+
+    /**
+     * @brief Stop flushing to the panel; damage keeps accumulating and is
+     *        composed on the first frame after unfreezing
+     */
+    void setFrozen(bool frozen) { frozen_ = frozen; }
+    bool isFrozen() const { return frozen_; }
+
+    /**
+     * @brief Get the shared frame (for components that keep a target)
+     */
+    lgfx::LovyanGFX* getCanvas() { return initialized_ ? &frame_ : nullptr; }
+
+    int16_t width() const { return width_; }
+    int16_t height() const { return height_; }
+
+    const CompositorStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = CompositorStats(); }
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    struct Layer {
+        DisplayRect bounds;
+        DisplayRect damage;
+        LayerRenderFn render;
+        bool visible;
+        bool opaque;
+
+        Layer() : visible(true), opaque(false) {}
+    };
+
+    static constexpr size_t MAX_DIRTY_REGIONS = DISPLAY_LAYER_COUNT;
+
+    M5GFX* display_;
+    M5Canvas frame_;
+    Layer layers_[DISPLAY_LAYER_COUNT];
+    uint16_t background_;
+    int16_t width_;
+    int16_t height_;
+    bool frozen_;
+    bool initialized_;
+
+    CompositorStats stats_;
+    char last_error_[128];
+
+    size_t collectDirtyRegions(DisplayRect* regions);
+    void renderRegion(const DisplayRect& region);
+
+    Layer& layerAt(DisplayLayer layer) { return layers_[static_cast<size_t>(layer)]; }
+    const Layer& layerAt(DisplayLayer layer) const { return layers_[static_cast<size_t>(layer)]; }
+};
+
+// Utility functions
+const char* displayLayerToString(DisplayLayer layer);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_DISPLAY_COMPOSITOR_H
@@ -4,8 +4,11 @@
  * 
  * Features:
  * - Optimized rendering for 240x135 display
+ * - Layered compositing with per-layer damage (see display_compositor.h)
  * - Message history with scrolling
  * - Status bar with connection/audio indicators
+ * - Input line viewed through a scrolling window; edits redraw only the
+ *   affected glyph span
  * - Avatar animation area
  * - Text wrapping and formatting
  */
@@ -20,6 +23,8 @@
 #include <string>
 #include <memory>
 #include "protocol.h"
+#include "display_compositor.h"
+#include "input_buffer.h"
 
 namespace OpenClaw {
 
@@ -33,8 +38,25 @@ constexpr int16_t MESSAGE_AREA_Y = STATUS_BAR_HEIGHT + AVATAR_AREA_HEIGHT;
 constexpr int16_t MESSAGE_AREA_HEIGHT = DISPLAY_HEIGHT - MESSAGE_AREA_Y - INPUT_AREA_HEIGHT;
 constexpr int16_t INPUT_AREA_Y = DISPLAY_HEIGHT - INPUT_AREA_HEIGHT;
 
+constexpr int16_t MESSAGE_LINE_HEIGHT = 10;
+constexpr int16_t SCROLLBAR_WIDTH = 3;
+
+// Input line (default font, fixed 6 px pitch)
+constexpr int16_t INPUT_TEXT_X = 4;
+constexpr int16_t INPUT_TEXT_Y = INPUT_AREA_Y + 4;
+constexpr int16_t INPUT_GLYPH_WIDTH = 6;
+constexpr int16_t INPUT_CURSOR_WIDTH = 8;
+constexpr size_t INPUT_VISIBLE_COLS =
+    (DISPLAY_WIDTH - 2 * INPUT_TEXT_X - INPUT_CURSOR_WIDTH) / INPUT_GLYPH_WIDTH;
+
 constexpr uint8_t MAX_MESSAGE_HISTORY = 50;
-constexpr uint8_t VISIBLE_MESSAGES = 4;
+constexpr uint8_t VISIBLE_MESSAGES = MESSAGE_AREA_HEIGHT / MESSAGE_LINE_HEIGHT;
+
+// Layer bounds
+constexpr DisplayRect STATUS_BAR_RECT(0, 0, DISPLAY_WIDTH, STATUS_BAR_HEIGHT);
+constexpr DisplayRect MESSAGE_AREA_RECT(0, MESSAGE_AREA_Y, DISPLAY_WIDTH, MESSAGE_AREA_HEIGHT);
+constexpr DisplayRect INPUT_AREA_RECT(0, INPUT_AREA_Y, DISPLAY_WIDTH, INPUT_AREA_HEIGHT);
+constexpr DisplayRect FULL_SCREEN_RECT(0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
 
 // Colors
 namespace Colors {
@@ -136,7 +158,7 @@ struct StatusBarData {
 // Text rendering helper
 class TextRenderer {
 public:
-    TextRenderer(M5Canvas* canvas);
+    TextRenderer(lgfx::LovyanGFX* canvas);
     
     // Text measurement
     int16_t getTextWidth(const char* text);
@@ -154,7 +176,7 @@ public:
     void renderLine(const char* text, int16_t x, int16_t y, uint16_t color);
 
 private:
-    M5Canvas* canvas_;
+    lgfx::LovyanGFX* canvas_;
 };
 
 // Display renderer class
@@ -167,7 +189,7 @@ public:
     DisplayRenderer(const DisplayRenderer&) = delete;
     DisplayRenderer& operator=(const DisplayRenderer&) = delete;
     
-    // Initialize
+    // Initialize (allocates the compositor frame and registers UI layers)
     bool begin(const DisplayConfig& config = DisplayConfig());
     
     // Update (call in main loop for animations)
@@ -183,6 +205,12 @@ public:
     void addMessage(const char* text, DisplayMessageType type);
     void addMessage(const String& text, DisplayMessageType type);
     void updateLastMessage(const char* text, bool is_final);
+    
+    // Streamed replies: chunks extend the last message while it is an
+    // unfinished one of the same type (else start one); finishing sets
+    // the full text, or adds the message if nothing was streamed
+    void appendToLastMessage(const char* text, DisplayMessageType type);
+    void finishLastMessage(const char* text, DisplayMessageType type);
     void clearMessages();
     
     // Scrolling
@@ -192,8 +220,8 @@ public:
     void setScrollPosition(uint8_t position);
     
     // Input display
-    void setInputText(const char* text, size_t cursor_pos);
-    void clearInput();
+    void setInputBuffer(const InputBuffer* buffer);
+    void onInputChanged(const InputChange& change);
     void showInputCursor(bool show);
     
     // Status bar
@@ -203,18 +231,17 @@ public:
     void setBatteryStatus(uint8_t percent, bool charging);
     void setStatusText(const char* text);
     
-    // Avatar area (for external avatar renderer)
-    void clearAvatarArea();
-    M5Canvas* getAvatarCanvas() { return avatar_canvas_; }
-    
-    // Screen rendering
+    // Full-screen pages (drawn on the SPLASH layer above everything else)
     void renderBootScreen(const char* firmware_version);
     void renderConnectionScreen(const char* ssid);
     void renderErrorScreen(const char* error);
-    void renderMainScreen();
-    void renderStatusBar();
-    void renderMessages();
-    void renderInputArea();
+    void showMainScreen();
+    
+    // Composite dirty layers and flush them (call once per frame)
+    bool render();
+    
+    // Shared compositor (avatar and settings menu register layers here)
+    DisplayCompositor& getCompositor() { return compositor_; }
     
     // Configuration
     void setBrightness(uint8_t brightness);
@@ -222,6 +249,18 @@ public:
     void setConfig(const DisplayConfig& config);
     const DisplayConfig& getConfig() const { return config_; }
     
+    // Backlight override for idle dimming; the configured brightness is
+    // kept and restored by restoreBacklight()
+    void setBacklightLevel(uint8_t level);
+    void restoreBacklight();
+    uint8_t getBacklightLevel() const { return panel_asleep_ ? 0 : backlight_level_; }
+    
+    // Panel sleep: backlight off, panel in sleep mode, compositor frozen.
+    // Panel RAM keeps the last frame, so wake needs no full redraw.
+    void sleepPanel();
+    void wakePanel();
+    bool isPanelAsleep() const { return panel_asleep_; }
+    
     // Force redraw
     void redraw();
     
@@ -232,23 +271,30 @@ public:
     int16_t getAvatarAreaHeight() const { return AVATAR_AREA_HEIGHT; }
 
 private:
+    // Full-screen page currently shown on the SPLASH layer
+    enum class SplashScreen : uint8_t {
+        NONE,
+        BOOT,
+        CONNECTING,
+        ERROR
+    };
+    
     // Configuration
     DisplayConfig config_;
     
-    // Canvas for off-screen rendering
-    M5Canvas* main_canvas_;
-    M5Canvas* avatar_canvas_;
-    M5Canvas* message_canvas_;
+    // Layer compositor (owns the off-screen frame)
+    DisplayCompositor compositor_;
     
-    // Text renderer
+    // Text renderer (bound to the compositor frame)
     std::unique_ptr<TextRenderer> text_renderer_;
     
     // Message history
     std::vector<DisplayMessage> messages_;
     uint8_t scroll_position_;
     
-    // Input state
-    String input_text_;
+    // Input state (text lives in the keyboard's buffer)
+    const InputBuffer* input_;
+    size_t input_scroll_;       // First visible character
     size_t input_cursor_pos_;
     bool show_cursor_;
     uint32_t cursor_blink_time_;
@@ -256,27 +302,37 @@ private:
     
     // Status bar state
     StatusBarData status_data_;
-    uint32_t last_status_update_;
+    
+    // Splash state
+    SplashScreen splash_;
+    String splash_text_;
     
     // Display state
-    bool needs_redraw_;
+    uint8_t backlight_level_;   // Currently applied (may differ from config)
+    bool panel_asleep_;
     bool initialized_;
     
-    // Private methods
-    bool createCanvases();
-    void destroyCanvases();
+    // Layer callbacks
+    void registerLayers();
+    void renderStatusBar(lgfx::LovyanGFX& gfx);
+    void renderMessages(lgfx::LovyanGFX& gfx);
+    void renderInputArea(lgfx::LovyanGFX& gfx);
+    bool scrollInputToCursor();
+    void damageInputColumns(size_t first, size_t last);
+    void renderSplash(lgfx::LovyanGFX& gfx);
+    void showSplash(SplashScreen screen, const char* text);
     
-    void drawMessage(const DisplayMessage& msg, int16_t y, int16_t max_height);
-    uint16_t getMessageColor(MessageType type) const;
-    const char* getMessagePrefix(MessageType type) const;
+    void drawMessage(lgfx::LovyanGFX& gfx, const DisplayMessage& msg, int16_t y);
+    void drawScrollbar(lgfx::LovyanGFX& gfx);
+    const char* getMessagePrefix(DisplayMessageType type) const;
     
-    void drawStatusIcon(int16_t x, int16_t y, ConnectionIndicator status);
-    void drawAudioIcon(int16_t x, int16_t y, AudioIndicator status);
-    void drawWiFiIcon(int16_t x, int16_t y, int8_t rssi);
-    void drawBatteryIcon(int16_t x, int16_t y, uint8_t percent, bool charging);
+    void drawStatusIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, ConnectionIndicator status);
+    void drawAudioIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, AudioIndicator status);
+    void drawWiFiIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, int8_t rssi);
+    void drawBatteryIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, uint8_t percent, bool charging);
     
     void updateCursorBlink();
-    void markDirty() { needs_redraw_ = true; }
+    uint8_t maxScrollPosition() const;
 };
 
 // Utility functions
@@ -284,6 +340,7 @@ const char* displayMessageTypeToString(DisplayMessageType type);
 const char* connectionIndicatorToString(ConnectionIndicator status);
 const char* audioIndicatorToString(AudioIndicator status);
 uint16_t colorForDisplayMessageType(DisplayMessageType type);
+int8_t wifiSignalBars(int8_t rssi);
 
 } // namespace OpenClaw
 
@@ -0,0 +1,145 @@
+/**
+ * @file endpointer.h
+ * @brief End-of-utterance detection for OpenClaw Cardputer
+ *
+ * Features:
+ * - Adaptive hangover: the silence that ends an utterance follows the
+ *   speaker's own pauses (a pause well beyond nearly all of their
+ *   mid-utterance pauses is taken as the end)
+ * - Energy slope: speech that trails off before a pause ends sooner than
+ *   speech that stops abruptly mid-phrase
+ * - Early "likely final" hint part-way into the hangover, withdrawn if
+ *   speech resumes, so the gateway can start transcribing speculatively
+ * - An utterance resumed right after it was ended counts as truncated and
+ *   teaches the endpointer that pause length
+ * - No Arduino or ESP-IDF dependencies (builds on the host)
+ *
+ * The VAD around it (threshold, minimum voice duration) lives in
+ * AudioStreamer (audio_streamer.h).
+ */
+
+#ifndef OPENCLAW_ENDPOINTER_H
+#define OPENCLAW_ENDPOINTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenClaw {
+
+// What a frame means for the utterance it belongs to
+enum class EndpointEvent : uint8_t {
+    NONE,
+    LIKELY_FINAL,   // hint_fraction of the hangover elapsed, whatever the slope
+    RESUMED,        // Speech came back after a LIKELY_FINAL
+    FINAL           // Hangover elapsed: the utterance is over
+};
+
+// Endpointer tuning
+struct EndpointerConfig {
+    uint16_t hangover_ms;           // Fixed hangover, or the start value when adaptive
+    uint16_t min_hangover_ms;
+    uint16_t max_hangover_ms;
+    bool adaptive;
+    bool hint;                      // Emit LIKELY_FINAL
+    float pause_quantile;           // Share of the speaker's pauses the hangover must outlast
+    float pause_margin;             // Hangover = margin x that pause length
+    uint16_t slope_window_ms;       // Voiced audio before the pause in the slope fit
+    float falling_db_per_100ms;     // Energy falling faster than this is trailing off
+    float falling_scale;            // Hangover factor after trailing-off speech
+    float hint_fraction;            // LIKELY_FINAL at this share of the hangover
+
+    EndpointerConfig()
+        : hangover_ms(500), min_hangover_ms(200), max_hangover_ms(900),
+          adaptive(true), hint(true), pause_quantile(0.95f), pause_margin(1.5f),
+          slope_window_ms(240), falling_db_per_100ms(4.0f), falling_scale(0.7f),
+          hint_fraction(0.5f) {}
+};
+
+/**
+ * @brief Decides when a voiced utterance has ended
+ *
+ * Feed it every frame from the moment the VAD declares voice until it
+ * returns FINAL. Pause statistics carry over between utterances.
+ */
+class Endpointer {
+public:
+    static constexpr size_t PAUSE_HISTORY = 32;     // Mid-utterance pauses kept
+    static constexpr size_t MIN_PAUSES = 4;         // Before the hangover adapts
+    static constexpr size_t ENERGY_HISTORY = 16;    // Voiced frames kept for the slope fit
+
+    explicit Endpointer(const EndpointerConfig& config = EndpointerConfig());
+
+    const EndpointerConfig& getConfig() const { return config_; }
+    void setConfig(const EndpointerConfig& config) { config_ = config; }
+
+    /**
+     * @brief Start an utterance (the VAD has just confirmed voice)
+     * @param now_ms Time of the frame
+     */
+    void startUtterance(uint32_t now_ms);
+
+    /**
+     * @brief Feed one frame of the utterance
+     * @param is_speech Frame is above the VAD threshold
+     * @param rms Frame RMS level (0-32767)
+     * @param frame_ms Frame duration
+     * @param now_ms Time of the frame
+     */
+    EndpointEvent update(bool is_speech, float rms, uint16_t frame_ms, uint32_t now_ms);
+
+    // Hangover for the pause in progress, or the next one
+    uint32_t getHangoverMs() const { return hangover_ms_; }
+
+    // Pause length (at pause_quantile) of the speaker's recent
+    // mid-utterance pauses, 0 until learned
+    uint32_t getLongPauseMs() const;
+
+    // Forget the speaker (new user, different room)
+    void resetStats();
+
+    // Statistics
+    uint32_t getUtterances() const { return utterances_; }
+    uint32_t getHints() const { return hints_; }
+    uint32_t getHintsWithdrawn() const { return hints_withdrawn_; }
+    uint32_t getTruncations() const { return truncations_; }
+
+private:
+    EndpointerConfig config_;
+
+    // Speaker statistics
+    uint16_t pauses_[PAUSE_HISTORY];
+    size_t pause_count_;
+    size_t pause_next_;
+
+    // Current utterance
+    float energy_db_[ENERGY_HISTORY];
+    size_t energy_count_;
+    size_t energy_next_;
+    bool in_pause_;
+    bool hint_sent_;
+    uint32_t pause_start_ms_;
+    uint32_t hangover_ms_;
+    uint32_t hint_ms_;
+    uint16_t frame_ms_;
+
+    // Last ended utterance, to spot one that carries on
+    bool ended_;
+    uint32_t ended_at_ms_;
+    uint32_t ended_pause_ms_;
+
+    uint32_t utterances_;
+    uint32_t hints_;
+    uint32_t hints_withdrawn_;
+    uint32_t truncations_;
+
+    void recordPause(uint32_t pause_ms);
+    void beginPause(uint32_t now_ms);
+    float energySlopePer100ms() const;
+};
+
+// Utility functions
+const char* endpointEventToString(EndpointEvent event);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_ENDPOINTER_H
@@ -0,0 +1,136 @@
+/**
+ * @file event_loop.h
+ * @brief Event-driven main loop wake-up for OpenClaw Cardputer
+ *
+ * Features:
+ * - Producers on other tasks (keyboard scan, audio capture, WiFi events,
+ *   the gateway RX watcher) set a signal bit
+ * - The main loop blocks on a FreeRTOS event group until a signal
+ *   arrives or the next timer deadline passes, instead of polling
+ * - Wake-up and idle-time statistics
+ *
+ * Known gap: the IMU has no signal. Its interrupt is not used, so
+ * sensors are still sampled on a timer (20 Hz, 10 Hz in deep idle).
+ */
+
+#ifndef OPENCLAW_EVENT_LOOP_H
+#define OPENCLAW_EVENT_LOOP_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+namespace OpenClaw {
+
+// Wake reasons (event group bits)
+enum LoopSignal : uint32_t {
+    LOOP_SIGNAL_AUDIO   = 1UL << 0,   // Encoded audio packet queued
+    LOOP_SIGNAL_NETWORK = 1UL << 1,   // Gateway socket readable
+    LOOP_SIGNAL_INPUT   = 1UL << 2,   // Key event queued
+    LOOP_SIGNAL_WIFI    = 1UL << 4,   // WiFi link or scan event queued
+};
+
+constexpr uint32_t LOOP_SIGNAL_ALL = LOOP_SIGNAL_AUDIO | LOOP_SIGNAL_NETWORK |
+                                     LOOP_SIGNAL_INPUT | LOOP_SIGNAL_WIFI;
+
+// Passed to wait() to block until a signal arrives (same value as
+// TIMER_WHEEL_NO_DEADLINE, so an empty timer wheel means "no timeout")
+constexpr uint32_t LOOP_WAIT_FOREVER = 0xFFFFFFFF;
+
+/**
+ * @brief Handle a producer keeps to wake the main loop
+ *
+ * Cheap to copy; a default-constructed notifier does nothing, so
+ * components work unchanged when nobody is listening.
+ */
+class LoopNotifier {
+public:
+    LoopNotifier() : group_(nullptr), bits_(0) {}
+    LoopNotifier(EventGroupHandle_t group, uint32_t bits) : group_(group), bits_(bits) {}
+
+    // Task context
+    void notify() const {
+        if (group_) xEventGroupSetBits(group_, bits_);
+    }
+
+    // ISR context (deferred to the timer daemon task)
+    void notifyFromISR(BaseType_t* higher_priority_woken) const {
+        if (group_) xEventGroupSetBitsFromISR(group_, bits_, higher_priority_woken);
+    }
+
+    bool isAttached() const { return group_ != nullptr; }
+
+private:
+    EventGroupHandle_t group_;
+    uint32_t bits_;
+};
+
+// Loop statistics
+struct EventLoopStats {
+    uint32_t wakeups;
+    uint32_t signal_wakeups;    // Woken by a producer
+    uint32_t timeout_wakeups;   // Woken by a timer deadline
+    uint64_t idle_us;           // Time spent blocked in wait()
+    uint64_t busy_us;           // Time between waits
+
+    EventLoopStats()
+        : wakeups(0), signal_wakeups(0), timeout_wakeups(0),
+          idle_us(0), busy_us(0) {}
+
+    // Share of loop time spent blocked (0-100)
+    uint8_t idlePercent() const {
+        uint64_t total = idle_us + busy_us;
+        return total ? (uint8_t)((idle_us * 100) / total) : 0;
+    }
+};
+
+/**
+ * @brief Main-loop reactor: sleep until signalled or timed out
+ */
+class EventLoop {
+public:
+    EventLoop();
+    ~EventLoop();
+
+    // Disable copy
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Create the event group
+     */
+    bool begin();
+
+    /**
+     * @brief Delete the event group (notifiers become inert only if
+     *        their owners are stopped first)
+     */
+    void end();
+
+    /**
+     * @brief Notifier that sets the given signal bits
+     */
+    LoopNotifier notifier(uint32_t signals) const { return LoopNotifier(group_, signals); }
+
+    /**
+     * @brief Block until any signal is set or timeout_ms elapses
+     * @param timeout_ms Milliseconds, or LOOP_WAIT_FOREVER
+     * @return Signals that were set (cleared on return); 0 on timeout
+     */
+    uint32_t wait(uint32_t timeout_ms);
+
+    const EventLoopStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = EventLoopStats(); }
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    EventGroupHandle_t group_;
+    uint32_t last_wake_us_;
+    EventLoopStats stats_;
+    char last_error_[64];
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_EVENT_LOOP_H
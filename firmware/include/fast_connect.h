@@ -0,0 +1,110 @@
+/**
+ * @file fast_connect.h
+ * @brief Boot fast-connect cache for OpenClaw Cardputer
+ *
+ * Features:
+ * - Remembers the last good AP (BSSID, channel), its DHCP lease and the
+ *   resolved gateway address across restarts
+ * - RTC memory copy survives software and watchdog resets and deep sleep;
+ *   an NVS copy (without the lease) survives power cycles
+ * - A lease is only handed back before its renewal time (T1), measured
+ *   on the RTC clock, so it is never reused after a power cycle
+ * - NVS is written only when the AP or the gateway address changes
+ * - Everything here is a hint: the caller falls back to a scan, DHCP or
+ *   a lookup when a cached value doesn't work
+ */
+
+#ifndef OPENCLAW_FAST_CONNECT_H
+#define OPENCLAW_FAST_CONNECT_H
+
+#include <Arduino.h>
+#include "wifi_manager.h"
+
+namespace OpenClaw {
+
+constexpr uint32_t FAST_CONNECT_MAGIC = 0x43464F43;    // "OCFC"
+constexpr uint16_t FAST_CONNECT_VERSION = 1;
+
+// Where begin() found the cache
+enum class FastConnectSource : uint8_t {
+    NONE,
+    RTC,
+    NVS
+};
+
+struct FastConnectRecord {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+
+    // Last good AP (channel 0 = none)
+    char ssid[WIFI_SSID_MAX + 1];
+    uint8_t bssid[6];
+    uint8_t channel;
+
+    // Gateway address, as last resolved (0 = none)
+    char gateway_host[WIFI_HOST_MAX + 1];
+    uint32_t gateway_ip;
+
+    // DHCP lease of the last join (ip 0 = none); RTC copy only
+    WiFiLease lease;
+    int64_t lease_obtained_s;   // RTC clock
+
+    uint32_t crc32;             // Over the fields above
+};
+
+class FastConnectCache {
+public:
+    FastConnectCache();
+
+    // Disable copy
+    FastConnectCache(const FastConnectCache&) = delete;
+    FastConnectCache& operator=(const FastConnectCache&) = delete;
+
+    /**
+     * @brief Restore the cache from RTC memory, else from NVS
+     * @return true if anything was restored
+     */
+    bool begin();
+
+    FastConnectSource getSource() const { return source_; }
+
+    // Cached values for ssid/host; false (or 0) if there is none
+    bool getLink(const char* ssid, uint8_t* bssid, uint8_t& channel) const;
+    bool getLease(const char* ssid, WiFiLease& lease) const;   // renew_s = time left
+    uint32_t getGatewayIp(const char* host) const;
+
+    /**
+     * @brief Record a successful join; a different SSID drops the lease
+     */
+    void saveLink(const char* ssid, const uint8_t* bssid, uint8_t channel);
+
+    /**
+     * @brief Record the lease of the current link (RTC only)
+     */
+    void saveLease(const WiFiLease& lease);
+
+    void saveGatewayIp(const char* host, uint32_t ip);
+
+    /**
+     * @brief Forget everything, in RTC memory and NVS
+     */
+    void clear();
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    FastConnectRecord record_;
+    FastConnectSource source_;
+    char last_error_[64];
+
+    void storeRtc();
+    bool storeNvs();
+};
+
+// Utility functions
+const char* fastConnectSourceToString(FastConnectSource source);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_FAST_CONNECT_H
@@ -0,0 +1,127 @@
+/**
+ * @file idle_manager.h
+ * @brief Deep idle staging for OpenClaw Cardputer
+ *
+ * Features:
+ * - Tracks user activity and face-down orientation
+ * - Steps AWAKE -> DROWSY -> ASLEEP on inactivity, faster when face-down
+ * - Wakes immediately on key, motion or gateway push
+ * - Pure logic (time passed in); main.cpp applies each stage to the
+ *   display, sensors and timers from the stage callback
+ */
+
+#ifndef OPENCLAW_IDLE_MANAGER_H
+#define OPENCLAW_IDLE_MANAGER_H
+
+#include <cstdint>
+
+namespace OpenClaw {
+
+constexpr uint32_t IDLE_CHECK_INTERVAL_MS = 500;
+
+// Idle stages, shallowest first
+enum class IdleStage : uint8_t {
+    AWAKE,      // Normal rendering and sampling
+    DROWSY,     // Final "sleeping" frame shown, compositor frozen, backlight dimmed
+    ASLEEP      // Backlight and panel off, IMU at wake-on-motion rate
+};
+
+// What ended (or prevented) idle
+enum class WakeSource : uint8_t {
+    NONE,
+    KEYBOARD,
+    MOTION,
+    GATEWAY,
+    SYSTEM
+};
+
+// Idle thresholds
+struct IdleConfig {
+    uint32_t drowsy_after_ms;       // No activity for this long -> DROWSY
+    uint32_t asleep_after_ms;       // No activity for this long -> ASLEEP
+    uint32_t face_down_drowsy_ms;   // Face-down for this long -> DROWSY
+    uint32_t face_down_asleep_ms;   // Face-down for this long -> ASLEEP
+
+    IdleConfig()
+        : drowsy_after_ms(60000), asleep_after_ms(120000),
+          face_down_drowsy_ms(1000), face_down_asleep_ms(5000) {}
+};
+
+// Stage change callback (from == to never happens)
+using IdleStageCallback = void (*)(IdleStage from, IdleStage to, WakeSource source);
+
+/**
+ * @brief Decides when the device drops into and out of deep idle
+ *
+ * Stages only deepen from update(), one step per callback, so the
+ * DROWSY work always runs before ASLEEP. Any wake returns straight to
+ * AWAKE with a single callback.
+ */
+class IdleManager {
+public:
+    IdleManager();
+
+    // Disable copy
+    IdleManager(const IdleManager&) = delete;
+    IdleManager& operator=(const IdleManager&) = delete;
+
+    /**
+     * @brief Start tracking from now (stage AWAKE)
+     */
+    void begin(uint32_t now, const IdleConfig& config = IdleConfig());
+
+    /**
+     * @brief Deepen the stage if a threshold has passed (call periodically)
+     * @return Current stage
+     */
+    IdleStage update(uint32_t now);
+
+    /**
+     * @brief Record activity and leave idle if in it
+     * @return true if this woke the device
+     */
+    bool wake(WakeSource source, uint32_t now);
+
+    /**
+     * @brief Feed the IMU orientation; turning face-up wakes the device
+     */
+    void setFaceDown(bool face_down, uint32_t now);
+
+    /**
+     * @brief Hold the device awake (e.g. during a voice capture)
+     */
+    void setInhibited(bool inhibited, uint32_t now);
+
+    void setOnStageChange(IdleStageCallback callback) { on_stage_change_ = callback; }
+
+    IdleStage getStage() const { return stage_; }
+    bool isIdle() const { return stage_ != IdleStage::AWAKE; }
+    bool isInhibited() const { return inhibited_; }
+    WakeSource getLastWakeSource() const { return last_wake_source_; }
+    uint32_t getWakeCount() const { return wake_count_; }
+    const IdleConfig& getConfig() const { return config_; }
+
+private:
+    IdleConfig config_;
+    IdleStage stage_;
+    IdleStageCallback on_stage_change_;
+
+    uint32_t last_activity_;
+    uint32_t face_down_since_;
+    bool face_down_;
+    bool inhibited_;
+
+    WakeSource last_wake_source_;
+    uint32_t wake_count_;
+
+    IdleStage targetStage(uint32_t now) const;
+    void enterStage(IdleStage stage, WakeSource source);
+};
+
+// Utility functions
+const char* idleStageToString(IdleStage stage);
+const char* wakeSourceToString(WakeSource source);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_IDLE_MANAGER_H
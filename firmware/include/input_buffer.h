@@ -0,0 +1,107 @@
+/**
+ * @file input_buffer.h
+ * @brief Gap-buffer text editor for the prompt line
+ *
+ * Features:
+ * - Gap buffer: typing and deleting at the cursor are O(1), independent
+ *   of prompt length; moving the edit point costs the distance moved, once
+ * - Grows on demand up to INPUT_BUFFER_MAX_LENGTH, in PSRAM when present
+ * - Every edit records an InputChange (position, removed, inserted) so
+ *   views can redraw only what changed
+ * - Random access (charAt/copyRange) for views that show a window
+ */
+
+#ifndef OPENCLAW_INPUT_BUFFER_H
+#define OPENCLAW_INPUT_BUFFER_H
+
+#include <Arduino.h>
+
+namespace OpenClaw {
+
+constexpr size_t INPUT_BUFFER_INITIAL_CAPACITY = 256;
+constexpr size_t INPUT_BUFFER_MAX_LENGTH = 8192;
+
+// Last edit applied to an InputBuffer (character offsets)
+struct InputChange {
+    size_t pos;             // First affected character
+    size_t removed;         // Characters removed at pos
+    size_t inserted;        // Characters inserted at pos
+    size_t old_cursor;
+    size_t new_cursor;
+
+    InputChange() : pos(0), removed(0), inserted(0), old_cursor(0), new_cursor(0) {}
+
+    bool isCursorOnly() const { return removed == 0 && inserted == 0; }
+};
+
+// Input buffer for text entry
+class InputBuffer {
+public:
+    InputBuffer();
+    ~InputBuffer();
+
+    // Disable copy
+    InputBuffer(const InputBuffer&) = delete;
+    InputBuffer& operator=(const InputBuffer&) = delete;
+
+    // Buffer operations
+    bool insert(char c);
+    bool backspace();
+    bool deleteChar();
+    bool insertString(const char* str);
+    void clear();
+
+    // Cursor movement
+    void moveCursorLeft();
+    void moveCursorRight();
+    void moveCursorHome();
+    void moveCursorEnd();
+    void moveCursorTo(size_t pos);
+
+    // Getters
+    size_t getLength() const { return capacity_ - gapSize(); }
+    size_t getCursor() const { return cursor_; }
+    bool isEmpty() const { return getLength() == 0; }
+    bool isFull() const { return getLength() >= INPUT_BUFFER_MAX_LENGTH; }
+
+    /**
+     * @brief Whole text, NUL-terminated
+     *
+     * Closes the gap at the end of the text (O(n) once; typing at the end
+     * afterwards stays O(1)). Valid until the next edit.
+     */
+    const char* getText() const;
+
+    // Random access
+    char charAt(size_t index) const;
+    size_t copyRange(size_t start, size_t count, char* out) const;
+
+    // Most recent edit (valid after any mutating call)
+    const InputChange& getLastChange() const { return last_change_; }
+
+    // Text manipulation
+    String getTextBeforeCursor() const;
+    String getTextAfterCursor() const;
+    bool setText(const char* text);
+
+private:
+    // Text is data_[0, gap_start_) followed by data_[gap_end_, capacity_).
+    // The gap is kept at least one byte wide so getText() can terminate.
+    mutable char* data_;
+    size_t capacity_;
+    mutable size_t gap_start_;
+    mutable size_t gap_end_;
+    size_t cursor_;               // Logical cursor; the gap follows it lazily
+    InputChange last_change_;
+
+    size_t gapSize() const { return gap_end_ - gap_start_; }
+    void moveGapTo(size_t pos) const;
+    bool reserve(size_t extra);
+    void recordChange(size_t pos, size_t removed, size_t inserted, size_t old_cursor);
+
+    static char* allocate(size_t size);
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_INPUT_BUFFER_H
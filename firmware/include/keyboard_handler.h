@@ -3,10 +3,14 @@
  * @brief Cardputer keyboard input handling for OpenClaw
  * 
  * Features:
- * - Full keyboard matrix scanning
+ * - Matrix scanning in a dedicated high-priority task, independent of
+ *   main loop and render load
+ * - Per-key debouncing and n-key rollover (every key edge is reported)
  * - Modifier key support (Shift, Fn, Ctrl, Opt)
  * - Key repeat with configurable delay/rate
- * - Input buffering with cursor support
+ * - Type-ahead: events wait in a lock-free ring until the UI drains it
+ * - Gap-buffer prompt editing with per-edit change notifications
+ * - Prompt history recall (Up/Down) and Tab completion of frequent phrases
  * - Event-based architecture
  */
 
@@ -16,11 +20,16 @@
 #include <Arduino.h>
 #include <M5Cardputer.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
-#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <atomic>
 #include <memory>
 #include <functional>
 #include <string>
+#include "ring_buffer.h"
+#include "input_buffer.h"
+#include "prompt_history.h"
+#include "phrase_trie.h"
+#include "event_loop.h"
 
 namespace OpenClaw {
 
@@ -28,11 +37,19 @@ namespace OpenClaw {
 class KeyboardHandler;
 
 // Keyboard constants
-constexpr size_t KEYBOARD_BUFFER_SIZE = 256;
-constexpr size_t KEYBOARD_QUEUE_SIZE = 32;
+constexpr size_t KEYBOARD_RING_SIZE = 128;               // Type-ahead depth (power of two)
 constexpr uint32_t DEFAULT_KEY_REPEAT_DELAY_MS = 400;
 constexpr uint32_t DEFAULT_KEY_REPEAT_RATE_MS = 50;
-constexpr uint32_t KEYBOARD_POLL_INTERVAL_MS = 10;
+
+// Scan task
+constexpr uint8_t KEYBOARD_ROWS = 4;
+constexpr uint8_t KEYBOARD_COLS = 14;
+constexpr uint8_t KEYBOARD_KEY_COUNT = KEYBOARD_ROWS * KEYBOARD_COLS;
+constexpr uint32_t KEYBOARD_SCAN_INTERVAL_MS = 5;
+constexpr uint32_t KEYBOARD_IDLE_SCAN_INTERVAL_MS = 25;  // While the screen is off
+constexpr uint8_t KEYBOARD_DEBOUNCE_SCANS = 2;           // Stable scans before an edge counts
+constexpr uint32_t KEYBOARD_TASK_STACK = 3072;
+constexpr UBaseType_t KEYBOARD_TASK_PRIORITY = 5;        // Above the loop and audio capture
 
 // Special key codes
 enum class SpecialKey : uint8_t {
@@ -92,11 +109,12 @@ struct KeyEvent {
     bool fn;                  // Fn modifier active
     uint32_t timestamp;       // Event timestamp
     uint8_t repeat_count;     // Repeat counter (0 = first press)
+    uint8_t key_index;        // Matrix position (row * KEYBOARD_COLS + col)
     
     KeyEvent()
         : character(0), special(SpecialKey::NONE), pressed(false),
           shift(false), ctrl(false), opt(false), fn(false),
-          timestamp(0), repeat_count(0) {}
+          timestamp(0), repeat_count(0), key_index(0) {}
     
     bool isPrintable() const {
         return character >= 32 && character < 127;
@@ -127,43 +145,6 @@ struct KeyEvent {
     }
 };
 
-// Input buffer for text entry
-class InputBuffer {
-public:
-    InputBuffer();
-    
-    // Buffer operations
-    bool insert(char c);
-    bool backspace();
-    bool deleteChar();
-    bool insertString(const char* str);
-    void clear();
-    
-    // Cursor movement
-    void moveCursorLeft();
-    void moveCursorRight();
-    void moveCursorHome();
-    void moveCursorEnd();
-    void moveCursorTo(size_t pos);
-    
-    // Getters
-    const char* getText() const { return buffer_; }
-    size_t getLength() const { return length_; }
-    size_t getCursor() const { return cursor_; }
-    bool isEmpty() const { return length_ == 0; }
-    bool isFull() const { return length_ >= KEYBOARD_BUFFER_SIZE - 1; }
-    
-    // Text manipulation
-    String getTextBeforeCursor() const;
-    String getTextAfterCursor() const;
-    bool setText(const char* text);
-    
-private:
-    char buffer_[KEYBOARD_BUFFER_SIZE];
-    size_t length_;
-    size_t cursor_;
-};
-
 // Keyboard event types
 enum class KeyboardEvent {
     KEY_PRESSED,
@@ -180,6 +161,10 @@ enum class KeyboardEvent {
 using KeyboardEventCallback = std::function<void(KeyboardEvent event, const void* data)>;
 
 // Keyboard handler class
+//
+// Threading: the scan task produces KeyEvents into an SPSC ring; update()
+// consumes them on the main loop, edits the input buffer and runs the
+// callback. Everything except the scan task itself is main-loop only.
 class KeyboardHandler {
 public:
     KeyboardHandler();
@@ -189,17 +174,21 @@ public:
     KeyboardHandler(const KeyboardHandler&) = delete;
     KeyboardHandler& operator=(const KeyboardHandler&) = delete;
     
-    // Initialize
+    // Initialize and start the scan task
     bool begin();
     
-    // Update (call in main loop)
+    // Process queued key events (call when LOOP_SIGNAL_INPUT is set)
     void update();
     
-    // Deinitialize
+    // Stop the scan task
     void end();
     
-    // Read key event (non-blocking)
-    bool readEvent(KeyEvent& event);
+    // Wake the main loop when key events are queued (set before begin())
+    void setNotifier(const LoopNotifier& notifier) { notifier_ = notifier; }
+    
+    // Scan period; slower while idle saves wakeups (safe from any task)
+    void setScanInterval(uint32_t interval_ms) { scan_interval_ms_.store(interval_ms); }
+    uint32_t getScanInterval() const { return scan_interval_ms_.load(); }
     
     // Get current input buffer
     const InputBuffer& getInputBuffer() const { return input_buffer_; }
@@ -210,10 +199,20 @@ public:
     void submitInput();
     bool setInputText(const char* text);
     
+    // When disabled, key events are still reported but do not edit the
+    // input buffer (e.g. while another UI owns the keyboard)
+    void setTextInputEnabled(bool enabled) { text_input_enabled_ = enabled; }
+    bool isTextInputEnabled() const { return text_input_enabled_; }
+    
+    // Up/Down recall and Tab completion sources; optional, not owned.
+    // Submitted prompts are added to both.
+    void setHistory(PromptHistory* history) { history_ = history; }
+    void setPhraseIndex(PhraseTrie* phrases) { phrases_ = phrases; }
+    
     // Set event callback
     void onEvent(KeyboardEventCallback callback);
     
-    // Key repeat configuration
+    // Key repeat configuration (read by the scan task)
     void setKeyRepeatEnabled(bool enabled) { key_repeat_enabled_ = enabled; }
     bool isKeyRepeatEnabled() const { return key_repeat_enabled_; }
     
@@ -223,7 +222,7 @@ public:
     void setKeyRepeatRate(uint32_t rate_ms) { key_repeat_rate_ms_ = rate_ms; }
     uint32_t getKeyRepeatRate() const { return key_repeat_rate_ms_; }
     
-    // Modifier state
+    // Modifier state (as of the last processed event)
     bool isShiftPressed() const { return shift_pressed_; }
     bool isFnPressed() const { return fn_pressed_; }
     bool isCtrlPressed() const { return ctrl_pressed_; }
@@ -236,77 +235,95 @@ public:
     // Statistics
     uint32_t getKeyPressCount() const { return key_press_count_; }
     uint32_t getInputSubmitCount() const { return input_submit_count_; }
+    uint32_t getScanCount() const { return scan_count_; }
+    uint32_t getDeferredEdgeCount() const { return deferred_edges_; }
+    size_t getPendingEventCount() const { return ring_.size(); }
 
 private:
+    // Modifier role of a matrix position (from the key map)
+    enum class KeyRole : uint8_t {
+        NORMAL,
+        SHIFT,
+        FN,
+        CTRL,
+        OPT
+    };
+    
     // State
     bool initialized_;
     KeyboardEventCallback event_callback_;
+    LoopNotifier notifier_;
     
-    // Input buffer
+    // Input buffer (main loop)
     InputBuffer input_buffer_;
+    bool text_input_enabled_;
+    PromptHistory* history_;
+    PhraseTrie* phrases_;
+    String history_draft_;        // Unsent text, restored after recall
     
-    // Key state
+    // Last processed key (main loop)
     bool key_pressed_;
     char last_character_;
-    uint32_t key_press_time_;
-    uint32_t last_repeat_time_;
-    uint8_t repeat_count_;
-    KeyEvent last_key_event_;
-    
-    // Modifier state
     bool shift_pressed_;
     bool fn_pressed_;
     bool ctrl_pressed_;
     bool opt_pressed_;
-    bool last_shift_state_;
-    bool last_fn_state_;
-    bool last_ctrl_state_;
-    bool last_opt_state_;
-    
-    // Key repeat
-    bool key_repeat_enabled_;
-    uint32_t key_repeat_delay_ms_;
-    uint32_t key_repeat_rate_ms_;
-    
-    // Event queue
-    QueueHandle_t event_queue_;
-    SemaphoreHandle_t state_mutex_;
     
-    // Timing
-    uint32_t last_poll_time_;
+    // Key repeat configuration
+    volatile bool key_repeat_enabled_;
+    volatile uint32_t key_repeat_delay_ms_;
+    volatile uint32_t key_repeat_rate_ms_;
+    
+    // Scan task -> main loop
+    TaskHandle_t scan_task_;
+    SpscRingBuffer<KeyEvent, KEYBOARD_RING_SIZE> ring_;
+    std::atomic<uint32_t> scan_interval_ms_;
+    
+    // Key map, cached at begin() (read-only afterwards)
+    char base_char_[KEYBOARD_KEY_COUNT];
+    char shift_char_[KEYBOARD_KEY_COUNT];
+    KeyRole role_[KEYBOARD_KEY_COUNT];
+    uint64_t modifier_mask_;
+    
+    // Scan task state
+    uint64_t stable_;                            // Debounced pressed keys
+    uint8_t debounce_[KEYBOARD_KEY_COUNT];       // Consecutive scans differing from stable_
+    uint8_t repeat_key_;                         // Last pressed non-modifier key
+    bool repeat_active_;
+    uint32_t repeat_due_;
+    uint8_t repeat_count_;
     
     // Statistics
     uint32_t key_press_count_;
     uint32_t input_submit_count_;
+    volatile uint32_t scan_count_;
+    volatile uint32_t deferred_edges_;           // Edges held back by a full ring
     
     // Private methods
-    bool createQueue();
-    void destroyQueue();
-    bool createMutexes();
-    void destroyMutexes();
-    
-    void pollKeyboard();
-    void processKeyState();
-    void handleKeyPress(char key, bool shift, bool fn, bool ctrl, bool opt);
-    void handleKeyRelease();
-    void processKeyRepeat();
-    void updateModifiers();
-    
-    KeyEvent translateKey(char key, bool shift, bool fn, bool ctrl, bool opt);
-    SpecialKey getSpecialKey(char key, bool shift, bool fn, bool ctrl, bool opt);
-    void postEvent(const KeyEvent& event);
+    void loadKeyMap();
+    bool startScanTask();
+    void stopScanTask();
+    
+    void scanLoop();
+    void scanOnce(uint32_t now);
+    uint64_t readMatrix();
+    bool emitEdge(uint8_t key, bool pressed, uint64_t keys, uint32_t now);
+    bool processKeyRepeat(uint32_t now);
+    KeyEvent translateKey(uint8_t key, uint64_t keys) const;
+    bool isModifierHeld(uint64_t keys, KeyRole role) const;
+    
+    void processEvent(const KeyEvent& event);
+    void applyEdit(const KeyEvent& event);
+    bool recallHistory(bool older);
+    bool completeInput();
     void notifyEvent(KeyboardEvent event, const void* data);
     
-    // Character translation
-    char applyShift(char c) const;
-    char applyFn(char c) const;
-    char applyCtrl(char c) const;
+    static void scanTaskWrapper(void* param);
 };
 
 // Utility functions
 const char* specialKeyToString(SpecialKey key);
 const char* keyboardEventToString(KeyboardEvent event);
-bool isAncientModeTrigger(const char* text);
 
 } // namespace OpenClaw
 
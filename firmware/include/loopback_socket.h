@@ -0,0 +1,207 @@
+/**
+ * @file loopback_socket.h
+ * @brief In-process gateway link for OpenClaw Cardputer
+ *
+ * Features:
+ * - Stands in for GatewaySocket (same WebSocketsClient surface) when
+ *   built with OPENCLAW_LOOPBACK_GATEWAY, so WebSocketClient, the codecs
+ *   and the audio path run end to end without an AP or a bridge
+ * - A stand-in gateway answers auth, ping, text and audio in whichever
+ *   codec the handshake negotiated
+ * - Scripted link: one-way latency, jitter, frame loss, fragmentation, a
+ *   bandwidth cap and refused handshakes, from a seeded PRNG so runs
+ *   repeat exactly
+ * - Frames are delivered in due order and never reordered within one
+ *   direction (it models TCP); a full in-flight queue refuses the send,
+ *   which shows up as backpressure
+ * - Fragmented frames travel as separately paced and jittered pieces and
+ *   are reassembled on delivery; losing any piece loses the frame
+ * - Prints frame, byte, drop and round-trip counters every few seconds
+ *
+ * Link parameters default to the build flags below (LOOPBACK_LATENCY_MS
+ * and friends); setLink() replaces them at run time, e.g. from a test.
+ */
+
+#ifndef OPENCLAW_LOOPBACK_SOCKET_H
+#define OPENCLAW_LOOPBACK_SOCKET_H
+
+#ifdef OPENCLAW_LOOPBACK_GATEWAY
+
+#include <Arduino.h>
+#include <WebSocketsClient.h>
+#include <functional>
+#include <memory>
+
+// One-way delay, and uniform jitter on top of it
+#ifndef LOOPBACK_LATENCY_MS
+#define LOOPBACK_LATENCY_MS 20
+#endif
+#ifndef LOOPBACK_JITTER_MS
+#define LOOPBACK_JITTER_MS 0
+#endif
+
+// Frames dropped, per direction
+#ifndef LOOPBACK_LOSS_PERCENT
+#define LOOPBACK_LOSS_PERCENT 0
+#endif
+
+// Largest piece a frame is split into on the wire (0 = never split)
+#ifndef LOOPBACK_FRAGMENT_BYTES
+#define LOOPBACK_FRAGMENT_BYTES 0
+#endif
+
+// Bits per second each way (0 = unlimited)
+#ifndef LOOPBACK_BANDWIDTH_BPS
+#define LOOPBACK_BANDWIDTH_BPS 0
+#endif
+
+// Handshakes that never complete (drives reconnect storms)
+#ifndef LOOPBACK_CONNECT_FAIL_PERCENT
+#define LOOPBACK_CONNECT_FAIL_PERCENT 0
+#endif
+
+// Subprotocol the stand-in accepts ("" = an old gateway ignoring the offer)
+#ifndef LOOPBACK_SUBPROTOCOL
+#define LOOPBACK_SUBPROTOCOL "openclaw.v2"
+#endif
+
+#ifndef LOOPBACK_SEED
+#define LOOPBACK_SEED 1
+#endif
+
+namespace OpenClaw {
+
+// Link script; a change takes effect from the next frame or handshake
+struct LoopbackLink {
+    uint32_t latency_ms;
+    uint32_t jitter_ms;
+    uint8_t loss_percent;
+    size_t fragment_bytes;
+    uint32_t bandwidth_bps;
+    uint8_t connect_fail_percent;
+    const char* subprotocol;
+    uint32_t seed;
+    uint32_t report_interval_ms;    // Counters to Serial (0 = never)
+
+    LoopbackLink()
+        : latency_ms(LOOPBACK_LATENCY_MS), jitter_ms(LOOPBACK_JITTER_MS),
+          loss_percent(LOOPBACK_LOSS_PERCENT), fragment_bytes(LOOPBACK_FRAGMENT_BYTES),
+          bandwidth_bps(LOOPBACK_BANDWIDTH_BPS),
+          connect_fail_percent(LOOPBACK_CONNECT_FAIL_PERCENT),
+          subprotocol(LOOPBACK_SUBPROTOCOL), seed(LOOPBACK_SEED),
+          report_interval_ms(10000) {}
+};
+
+struct LoopbackStats {
+    uint32_t frames_up;         // Device to gateway, delivered
+    uint32_t frames_down;       // Gateway to device, delivered
+    uint32_t bytes_up;
+    uint32_t bytes_down;
+    uint32_t frames_lost;       // Dropped by the loss setting (per piece)
+    uint32_t fragments;         // Pieces sent by frames that were split
+    uint32_t frames_refused;    // In-flight queue full
+    uint32_t handshakes;
+    uint32_t handshakes_refused;
+    uint32_t rtt_count;         // Request/reply round trips
+    uint32_t rtt_min_ms;
+    uint32_t rtt_max_ms;
+    uint32_t rtt_total_ms;
+
+    LoopbackStats() { memset(this, 0, sizeof(*this)); }
+};
+
+class LoopbackSocket {
+public:
+    using EventCallback = std::function<void(WStype_t type, uint8_t* payload, size_t length)>;
+
+    LoopbackSocket();
+
+    // Disable copy
+    LoopbackSocket(const LoopbackSocket&) = delete;
+    LoopbackSocket& operator=(const LoopbackSocket&) = delete;
+
+    // WebSocketsClient surface used by WebSocketClient
+    void begin(const char* host, uint16_t port, const char* url, const char* protocol);
+    void beginSSL(const char* host, uint16_t port, const char* url, const char* fingerprint,
+                  const char* protocol);
+    void onEvent(EventCallback callback) { callback_ = callback; }
+    void setReconnectInterval(unsigned long) {}
+    void enableHeartbeat(uint32_t, uint32_t, uint8_t) {}
+    void disableHeartbeat() {}
+    void loop();
+    void disconnect();
+    bool sendTXT(uint8_t* payload, size_t length, bool header_to_payload = false);
+    bool sendBIN(uint8_t* payload, size_t length, bool header_to_payload = false);
+
+    // GatewaySocket extras
+    bool verifyPeer(const char*) { return true; }
+    const char* getSubprotocol() const { return subprotocol_; }
+
+    // Replace the link script; reseeds the PRNG
+    void setLink(const LoopbackLink& link);
+    const LoopbackLink& getLink() const { return link_; }
+
+    const LoopbackStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = LoopbackStats(); }
+    void printReport() const;
+
+private:
+    static constexpr size_t QUEUE_SIZE = 32;
+
+    // One piece on the wire: a whole frame, or a fragment of one
+    struct Frame {
+        uint32_t due_ms;
+        uint32_t sent_ms;           // When the request that caused it was sent
+        uint32_t seq;               // Send order, breaks ties in due_ms
+        uint32_t frame_id;          // Frame the piece belongs to
+        bool to_device;
+        bool is_text;
+        bool last;                  // Final piece of its frame
+        size_t offset;              // Of this piece within the frame
+        size_t total;               // Length of the whole frame
+        size_t length;
+        std::unique_ptr<uint8_t[]> data;
+    };
+
+    // Frame being put back together, per direction
+    struct Reassembly {
+        std::unique_ptr<uint8_t[]> data;
+        uint32_t frame_id;
+        size_t length;              // Bytes received so far
+    };
+
+    EventCallback callback_;
+    LoopbackLink link_;
+    Frame queue_[QUEUE_SIZE];
+    bool connected_;
+    bool connecting_;
+    bool use_ssl_;
+    uint32_t handshake_due_ms_;
+    const char* subprotocol_;
+    uint32_t link_free_ms_[2];      // Per direction: bandwidth cap
+    uint32_t last_due_ms_[2];       // Per direction: keeps frames in order
+    Reassembly partial_[2];
+    uint32_t next_seq_;
+    uint32_t next_frame_id_;
+    uint32_t rng_;
+    uint32_t last_report_ms_;
+    LoopbackStats stats_;
+
+    void startHandshake(bool use_ssl, const char* protocol);
+    bool enqueue(const uint8_t* data, size_t length, bool is_text, bool to_device, uint32_t sent_ms);
+    bool enqueuePiece(const uint8_t* data, uint32_t frame_id, size_t offset, size_t length,
+                      size_t total, bool is_text, bool to_device, uint32_t sent_ms);
+    Frame* nextDue(uint32_t now);
+    void deliver(Frame& frame);
+    void dispatch(const uint8_t* data, size_t length, bool is_text, bool to_device, uint32_t sent_ms);
+    void answer(const uint8_t* data, size_t length, bool is_text, uint32_t sent_ms);
+    void clearQueue();
+    uint32_t nextRandom();
+    bool roll(uint8_t percent);
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_LOOPBACK_GATEWAY
+
+#endif // OPENCLAW_LOOPBACK_SOCKET_H
@@ -0,0 +1,83 @@
+/**
+ * @file message_codec.h
+ * @brief Wire codecs for the gateway transport
+ *
+ * Features:
+ * - One interface for every wire format; the transport encodes and
+ *   decodes through whichever codec the connection negotiated
+ * - JSON: flat text frames ({"type": "...", ...}) for older gateways
+ * - Binary v1: ProtocolMessage frames with a JSON payload
+ * - Binary v2: v1 framing with the payload packed as MessagePack
+ *   (COMPRESSED flag), falling back to JSON when that isn't smaller
+ * - Negotiated through the WebSocket subprotocol; a gateway that doesn't
+ *   answer the offer gets binary v1, which every bridge speaks
+ * - Codecs are stateless singletons; encoding writes straight into the
+ *   caller's buffer
+ */
+
+#ifndef OPENCLAW_MESSAGE_CODEC_H
+#define OPENCLAW_MESSAGE_CODEC_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+namespace OpenClaw {
+
+// Wire formats, in order of preference
+enum class CodecId : uint8_t {
+    BINARY_V2,
+    BINARY_V1,
+    JSON,
+    COUNT
+};
+
+// Sec-WebSocket-Protocol offer, most preferred first
+constexpr const char* CODEC_SUBPROTOCOL_OFFER = "openclaw.v2, openclaw.v1, openclaw.json";
+
+// Largest encoded frame (JSON adds the type field to the payload)
+constexpr size_t CODEC_MAX_FRAME_SIZE = PROTOCOL_MAX_MESSAGE_SIZE + 32;
+
+class MessageCodec {
+public:
+    virtual ~MessageCodec() = default;
+
+    virtual CodecId getId() const = 0;
+    virtual const char* getSubprotocol() const = 0;
+
+    // true if frames go out as WebSocket text, false for binary
+    virtual bool isText() const = 0;
+
+    /**
+     * @brief Encode a message into buffer
+     * @return false if it doesn't fit or the payload is malformed
+     */
+    virtual bool encode(const ProtocolMessage& message, uint8_t* buffer, size_t size,
+                        size_t& out_length) const = 0;
+
+    /**
+     * @brief Decode one frame; the result always carries a JSON payload
+     */
+    virtual bool decode(const uint8_t* data, size_t length, ProtocolMessage& out_message) const = 0;
+};
+
+/**
+ * @brief Codec for an id
+ */
+const MessageCodec& getMessageCodec(CodecId id);
+
+/**
+ * @brief Codec for the subprotocol the server accepted
+ *
+ * Empty or unrecognised (an older gateway ignoring the offer) means
+ * binary v1.
+ */
+const MessageCodec& getMessageCodec(const char* subprotocol);
+
+// Utility functions
+const char* codecIdToString(CodecId id);
+const char* messageTypeToName(MessageType type);       // JSON "type" value
+MessageType messageTypeFromName(const char* name);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_MESSAGE_CODEC_H
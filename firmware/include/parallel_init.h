@@ -0,0 +1,99 @@
+/**
+ * @file parallel_init.h
+ * @brief Concurrent component initialization for OpenClaw Cardputer
+ *
+ * Features:
+ * - Runs independent begin() steps on their own FreeRTOS tasks
+ * - Joins on an event group (one bit per job) with optional timeout
+ * - Per-job result and duration for boot-time instrumentation
+ */
+
+#ifndef OPENCLAW_PARALLEL_INIT_H
+#define OPENCLAW_PARALLEL_INIT_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+#include <freertos/task.h>
+
+namespace OpenClaw {
+
+constexpr size_t PARALLEL_INIT_MAX_JOBS = 8;
+constexpr uint32_t PARALLEL_INIT_DEFAULT_STACK = 4096;
+
+// Init step; returns false on failure
+using InitJobFn = bool (*)();
+
+struct InitJob {
+    const char* name;
+    InitJobFn fn;
+    uint32_t stack_size;
+    bool ok;
+    bool done;
+    uint32_t duration_ms;
+
+    InitJob()
+        : name(nullptr), fn(nullptr), stack_size(PARALLEL_INIT_DEFAULT_STACK),
+          ok(false), done(false), duration_ms(0) {}
+};
+
+/**
+ * @brief Fork/join runner for boot-time init steps
+ *
+ * Jobs must not share a bus or any unsynchronised state with each other
+ * (e.g. display on SPI, config on flash, IMU on I2C). Results are written
+ * from the job tasks, so the runner must outlive any job that timed out.
+ */
+class ParallelInit {
+public:
+    ParallelInit();
+    ~ParallelInit();
+
+    // Disable copy
+    ParallelInit(const ParallelInit&) = delete;
+    ParallelInit& operator=(const ParallelInit&) = delete;
+
+    /**
+     * @brief Queue a job for the next run()
+     * @return false if the job table is full
+     */
+    bool add(const char* name, InitJobFn fn, uint32_t stack_size = PARALLEL_INIT_DEFAULT_STACK);
+
+    /**
+     * @brief Start every queued job and wait for all of them
+     * @param timeout_ms Join timeout (0 = wait forever)
+     * @return true if every job finished and succeeded
+     */
+    bool run(uint32_t timeout_ms = 0);
+
+    size_t getJobCount() const { return job_count_; }
+    const InitJob& getJob(size_t index) const { return jobs_[index]; }
+    uint32_t getElapsedMs() const { return elapsed_ms_; }
+
+    /**
+     * @brief Print per-job results to Serial
+     */
+    void printReport() const;
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    struct JobContext {
+        ParallelInit* owner;
+        size_t index;
+    };
+
+    InitJob jobs_[PARALLEL_INIT_MAX_JOBS];
+    JobContext contexts_[PARALLEL_INIT_MAX_JOBS];
+    size_t job_count_;
+    EventGroupHandle_t done_group_;
+    uint32_t elapsed_ms_;
+
+    char last_error_[128];
+
+    static void jobTaskWrapper(void* param);
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_PARALLEL_INIT_H
@@ -0,0 +1,129 @@
+/**
+ * @file phrase_trie.h
+ * @brief Compact radix trie for prompt autocomplete
+ *
+ * Features:
+ * - Radix (path-compressed) trie of phrases weighted by use count
+ * - Nodes and edge labels live in two arenas that start small and
+ *   double on demand up to a fixed cap; nodes refer to each other by
+ *   16-bit index, so growing moves nothing that points into them
+ * - Arenas go to PSRAM; without it they grow in internal RAM only up to a
+ *   small limit, past which add() fails
+ * - Every node caches the best weight in its subtree, so completing a
+ *   prefix walks a single path: no subtree search
+ * - The arenas are saved to and loaded from LittleFS as one blob
+ */
+
+#ifndef OPENCLAW_PHRASE_TRIE_H
+#define OPENCLAW_PHRASE_TRIE_H
+
+#include <Arduino.h>
+
+namespace OpenClaw {
+
+constexpr size_t PHRASE_TRIE_MAX_NODES = 8192;
+constexpr size_t PHRASE_TRIE_MAX_LABEL_BYTES = 65536;
+constexpr size_t PHRASE_TRIE_INITIAL_NODES = 256;             // 6 KB with the labels
+constexpr size_t PHRASE_TRIE_INITIAL_LABEL_BYTES = 2048;
+constexpr size_t PHRASE_TRIE_INTERNAL_MAX_NODES = 1024;       // 24 KB with the labels
+constexpr size_t PHRASE_TRIE_INTERNAL_MAX_LABEL_BYTES = 8192;
+constexpr size_t PHRASE_MAX_LENGTH = 128;     // Longer prompts are not indexed
+constexpr const char* PHRASE_TRIE_FILE = "/phrases.bin";
+
+/**
+ * @brief Weighted phrase index with prefix completion
+ *
+ * Phrases are case-sensitive byte strings. add() bumps a phrase's
+ * weight; when a weight saturates, all weights are halved so recent
+ * use keeps counting. Phrases are never removed: once an arena is at
+ * its cap (or can't grow) add() fails until clear().
+ */
+class PhraseTrie {
+public:
+    PhraseTrie();
+    ~PhraseTrie();
+
+    // Disable copy
+    PhraseTrie(const PhraseTrie&) = delete;
+    PhraseTrie& operator=(const PhraseTrie&) = delete;
+
+    /**
+     * @brief Allocate the initial arenas (empty trie)
+     */
+    bool begin();
+
+    /**
+     * @brief Free the arenas; the trie is inert until begin()
+     */
+    void end();
+
+    /**
+     * @brief Add a phrase or bump its weight
+     * @return false if the phrase is empty, too long, or the arenas are
+     *         at their cap or can't grow
+     */
+    bool add(const char* phrase, uint16_t count = 1);
+
+    /**
+     * @brief Weight of an exact phrase (0 if absent)
+     */
+    uint16_t getWeight(const char* phrase) const;
+
+    /**
+     * @brief Most used phrase starting with prefix
+     * @param out Receives the whole phrase, NUL-terminated
+     * @return Phrase length, or 0 if none is longer than the prefix
+     */
+    size_t complete(const char* prefix, char* out, size_t out_size) const;
+
+    void clear();
+
+    // Persistence (LittleFS must be mounted)
+    bool load(const char* path = PHRASE_TRIE_FILE);
+    bool save(const char* path = PHRASE_TRIE_FILE);
+    bool isDirty() const { return dirty_; }
+
+    // Statistics
+    size_t getPhraseCount() const { return phrase_count_; }
+    size_t getNodeCount() const { return node_count_; }
+    size_t getLabelBytes() const { return label_bytes_; }
+    size_t getArenaBytes() const { return node_capacity_ * sizeof(Node) + label_capacity_; }
+    bool isFull() const { return node_count_ + 2 > PHRASE_TRIE_MAX_NODES; }
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    static constexpr uint16_t NIL = 0xFFFF;
+
+    // 16 bytes; the root is node 0 with an empty label. Index order says
+    // nothing about depth: an edge split hangs older children under the
+    // new tail node.
+    struct Node {
+        uint32_t label;         // Offset of the edge label in labels_
+        uint16_t label_len;
+        uint16_t weight;        // Use count of the phrase ending here (0 = none)
+        uint16_t best;          // Highest weight in this subtree
+        uint16_t first_child;
+        uint16_t next_sibling;
+        uint16_t reserved;
+    };
+
+    Node* nodes_;
+    char* labels_;
+    size_t node_capacity_;
+    size_t label_capacity_;
+    size_t node_count_;
+    size_t label_bytes_;
+    size_t phrase_count_;
+    bool dirty_;
+    char last_error_[64];
+
+    bool reserve(size_t nodes, size_t label_bytes);
+    uint16_t findChild(uint16_t parent, char c) const;
+    uint16_t newNode(uint32_t label, uint16_t label_len);
+    void decay();
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_PHRASE_TRIE_H
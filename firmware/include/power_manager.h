@@ -0,0 +1,127 @@
+/**
+ * @file power_manager.h
+ * @brief Power management for OpenClaw Cardputer
+ *
+ * Features:
+ * - Dynamic frequency scaling via ESP-IDF power management locks
+ * - Automatic light sleep when idle (if the build supports it)
+ * - CPU boost for audio capture/encode and rendering
+ * - WiFi modem sleep between beacons
+ * - Current-draw estimate from the policy's power model
+ *
+ * Decisions come from PowerPolicy; this class only applies them.
+ */
+
+#ifndef OPENCLAW_POWER_MANAGER_H
+#define OPENCLAW_POWER_MANAGER_H
+
+#include <Arduino.h>
+#include <esp_pm.h>
+#include "power_policy.h"
+#include "event_loop.h"
+
+namespace OpenClaw {
+
+constexpr uint32_t POWER_UPDATE_INTERVAL_MS = 250;
+
+class PowerManager {
+public:
+    PowerManager();
+    ~PowerManager();
+
+    // Disable copy
+    PowerManager(const PowerManager&) = delete;
+    PowerManager& operator=(const PowerManager&) = delete;
+
+    /**
+     * @brief Configure DFS/light sleep and create PM locks
+     * @return false if power management is unavailable (device still runs
+     *         at the fixed boot clock)
+     */
+    bool begin(const PowerPolicyConfig& config = PowerPolicyConfig());
+
+    /**
+     * @brief Release locks and restore full power
+     */
+    void end();
+
+    /**
+     * @brief Re-evaluate the policy and apply changes (call periodically)
+     * @param loop_stats Main loop statistics, for CPU busy share
+     */
+    void update(const EventLoopStats& loop_stats);
+
+    // Boost sources; the max-clock lock is held while any is requested
+    void requestBoost(PowerBoost source);
+    void releaseBoost(PowerBoost source);
+
+    // Activity inputs
+    void noteUserActivity() { last_activity_ = millis(); }
+    void setAudioStreaming(bool streaming) { inputs_.audio_streaming = streaming; }
+    void setWifiConnected(bool connected) { inputs_.wifi_connected = connected; }
+    void setFaceDown(bool face_down) { inputs_.face_down = face_down; }
+    void setBacklight(uint8_t level) { inputs_.backlight = level; }
+
+    // State
+    PowerMode getMode() const { return decision_.mode; }
+    const PowerDecision& getDecision() const { return decision_; }
+    const PowerInputs& getInputs() const { return inputs_; }
+    bool isPowerManagementEnabled() const { return pm_enabled_; }
+    bool isLightSleepAvailable() const { return light_sleep_available_; }
+
+    /**
+     * @brief Estimated average current draw (mA)
+     */
+    float getEstimatedCurrentMa() const;
+
+    const char* getLastError() const { return last_error_; }
+
+    /**
+     * @brief Holds a boost for the lifetime of the object
+     */
+    class ScopedBoost {
+    public:
+        ScopedBoost(PowerManager& pm, PowerBoost source) : pm_(pm), source_(source) {
+            pm_.requestBoost(source_);
+        }
+        ~ScopedBoost() { pm_.releaseBoost(source_); }
+
+        ScopedBoost(const ScopedBoost&) = delete;
+        ScopedBoost& operator=(const ScopedBoost&) = delete;
+
+    private:
+        PowerManager& pm_;
+        PowerBoost source_;
+    };
+
+private:
+    PowerPolicy policy_;
+    PowerInputs inputs_;
+    PowerDecision decision_;
+
+    esp_pm_lock_handle_t cpu_max_lock_;     // Held while boosted
+    esp_pm_lock_handle_t no_sleep_lock_;    // Held unless the policy allows light sleep
+    bool cpu_max_held_;
+    bool no_sleep_held_;
+    bool pm_enabled_;
+    bool light_sleep_available_;
+    WifiPowerSave applied_wifi_ps_;
+    bool wifi_ps_applied_;
+
+    uint32_t last_activity_;
+    uint64_t last_idle_us_;
+    uint64_t last_busy_us_;
+
+    bool initialized_;
+    char last_error_[128];
+
+    bool configurePm(const PowerPolicyConfig& config);
+    void apply(const PowerDecision& decision);
+    void applyWifiPowerSave(WifiPowerSave ps);
+    void setCpuMaxLock(bool held);
+    void setNoSleepLock(bool held);
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_POWER_MANAGER_H
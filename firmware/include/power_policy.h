@@ -0,0 +1,144 @@
+/**
+ * @file power_policy.h
+ * @brief Power policy engine for OpenClaw Cardputer
+ *
+ * Features:
+ * - Pure decision logic: activity in, CPU/sleep/WiFi settings out
+ * - No Arduino or ESP-IDF dependencies (builds on the host)
+ * - Simple current-draw model for battery estimates
+ *
+ * The hardware side lives in PowerManager (power_manager.h).
+ */
+
+#ifndef OPENCLAW_POWER_POLICY_H
+#define OPENCLAW_POWER_POLICY_H
+
+#include <cstdint>
+
+namespace OpenClaw {
+
+// Overall power mode
+enum class PowerMode : uint8_t {
+    BOOST,      // Max CPU clock (audio capture/encode, rendering)
+    ACTIVE,     // Min CPU clock, no light sleep (user is interacting)
+    IDLE        // Min CPU clock, automatic light sleep
+};
+
+// WiFi power save (mirrors wifi_ps_type_t)
+enum class WifiPowerSave : uint8_t {
+    NONE,       // Radio always on
+    MIN_MODEM,  // Sleep between DTIM beacons
+    MAX_MODEM   // Sleep for the listen interval
+};
+
+// Work that needs the max CPU clock while it runs (bit flags)
+enum PowerBoost : uint8_t {
+    POWER_BOOST_AUDIO   = 1 << 0,
+    POWER_BOOST_RENDER  = 1 << 1,
+    POWER_BOOST_NETWORK = 1 << 2,
+};
+
+// Snapshot of what the device is doing
+struct PowerInputs {
+    uint8_t boost_mask;         // PowerBoost bits currently held
+    bool audio_streaming;       // Mic session open (latency-sensitive)
+    bool wifi_connected;
+    bool face_down;
+    uint32_t ms_since_input;    // Since last key press or gateway push
+    uint8_t backlight;          // 0-255
+    uint8_t cpu_busy_percent;   // Share of loop time not blocked
+
+    PowerInputs()
+        : boost_mask(0), audio_streaming(false), wifi_connected(false),
+          face_down(false), ms_since_input(0), backlight(0),
+          cpu_busy_percent(0) {}
+};
+
+// What the hardware layer should apply
+struct PowerDecision {
+    PowerMode mode;
+    uint16_t cpu_mhz;
+    bool light_sleep;
+    WifiPowerSave wifi_ps;
+
+    PowerDecision()
+        : mode(PowerMode::ACTIVE), cpu_mhz(80), light_sleep(false),
+          wifi_ps(WifiPowerSave::NONE) {}
+
+    bool operator==(const PowerDecision& o) const {
+        return mode == o.mode && cpu_mhz == o.cpu_mhz &&
+               light_sleep == o.light_sleep && wifi_ps == o.wifi_ps;
+    }
+    bool operator!=(const PowerDecision& o) const { return !(*this == o); }
+};
+
+// Policy tuning
+struct PowerPolicyConfig {
+    uint16_t max_cpu_mhz;
+    uint16_t min_cpu_mhz;
+    uint32_t idle_after_ms;     // No input for this long -> IDLE
+    bool allow_light_sleep;
+
+    PowerPolicyConfig()
+        : max_cpu_mhz(240), min_cpu_mhz(80), idle_after_ms(30000),
+          allow_light_sleep(true) {}
+};
+
+// Approximate per-component draw (mA at 3.7 V), ESP32-S3 + Cardputer
+struct PowerModel {
+    float cpu_active_ma_max;    // Running at max clock
+    float cpu_active_ma_min;    // Running at min clock
+    float cpu_idle_ma;          // Clock-gated idle, no light sleep
+    float cpu_light_sleep_ma;
+    float wifi_on_ma;           // PS NONE, associated
+    float wifi_min_modem_ma;
+    float wifi_max_modem_ma;
+    float backlight_ma_full;    // At brightness 255
+    float audio_ma;             // Mic + I2S
+    float base_ma;              // Regulators, PSRAM, keyboard, IMU
+
+    PowerModel()
+        : cpu_active_ma_max(45.0f), cpu_active_ma_min(22.0f),
+          cpu_idle_ma(12.0f), cpu_light_sleep_ma(1.5f),
+          wifi_on_ma(95.0f), wifi_min_modem_ma(22.0f),
+          wifi_max_modem_ma(8.0f), backlight_ma_full(28.0f),
+          audio_ma(2.0f), base_ma(6.0f) {}
+};
+
+/**
+ * @brief Maps device activity to power settings
+ */
+class PowerPolicy {
+public:
+    explicit PowerPolicy(const PowerPolicyConfig& config = PowerPolicyConfig(),
+                         const PowerModel& model = PowerModel())
+        : config_(config), model_(model) {}
+
+    /**
+     * @brief Decide CPU clock, light sleep and WiFi power save
+     * @param inputs Current activity
+     * @param light_sleep_available False if the platform cannot light sleep
+     */
+    PowerDecision evaluate(const PowerInputs& inputs, bool light_sleep_available = true) const;
+
+    /**
+     * @brief Estimate average current for a decision (mA)
+     */
+    float estimateCurrentMa(const PowerInputs& inputs, const PowerDecision& decision) const;
+
+    const PowerPolicyConfig& getConfig() const { return config_; }
+    void setConfig(const PowerPolicyConfig& config) { config_ = config; }
+    const PowerModel& getModel() const { return model_; }
+
+private:
+    PowerPolicyConfig config_;
+    PowerModel model_;
+};
+
+// Utility functions
+const char* powerModeToString(PowerMode mode);
+const char* wifiPowerSaveToString(WifiPowerSave ps);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_POWER_POLICY_H
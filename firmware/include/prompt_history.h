@@ -0,0 +1,71 @@
+/**
+ * @file prompt_history.h
+ * @brief Submitted prompt history with up/down recall
+ *
+ * Features:
+ * - Ring of the most recent PROMPT_HISTORY_SIZE submitted prompts
+ * - Shell-style recall: older()/newer() step through entries, newest first
+ * - Saved to LittleFS as one prompt per line, oldest first
+ */
+
+#ifndef OPENCLAW_PROMPT_HISTORY_H
+#define OPENCLAW_PROMPT_HISTORY_H
+
+#include <Arduino.h>
+
+namespace OpenClaw {
+
+constexpr size_t PROMPT_HISTORY_SIZE = 32;
+constexpr const char* PROMPT_HISTORY_FILE = "/history.txt";
+
+class PromptHistory {
+public:
+    PromptHistory();
+
+    // Disable copy
+    PromptHistory(const PromptHistory&) = delete;
+    PromptHistory& operator=(const PromptHistory&) = delete;
+
+    /**
+     * @brief Record a submitted prompt and end any recall in progress
+     *
+     * Empty prompts and repeats of the newest entry are not stored.
+     */
+    void add(const char* text);
+
+    /**
+     * @brief Step back one entry
+     * @return Entry text, or nullptr if already at the oldest
+     */
+    const char* older();
+
+    /**
+     * @brief Step forward one entry
+     * @return Entry text, or nullptr once past the newest (recall ends)
+     */
+    const char* newer();
+
+    void resetNavigation() { nav_age_ = -1; }
+    bool isNavigating() const { return nav_age_ >= 0; }
+
+    // Entry by age (0 = newest); nullptr if out of range
+    const char* get(size_t age) const;
+    size_t getCount() const { return count_; }
+    void clear();
+
+    // Persistence (LittleFS must be mounted)
+    bool load(const char* path = PROMPT_HISTORY_FILE);
+    bool save(const char* path = PROMPT_HISTORY_FILE);
+    bool isDirty() const { return dirty_; }
+
+private:
+    String entries_[PROMPT_HISTORY_SIZE];
+    size_t head_;       // Next slot to write
+    size_t count_;
+    int nav_age_;       // Entry being shown, -1 when not recalling
+    bool dirty_;
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_PROMPT_HISTORY_H
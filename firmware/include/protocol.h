@@ -6,6 +6,8 @@
  * the Cardputer device and the OpenClaw gateway bridge.
  * 
  * Protocol Format:
+ * - 1 byte: Magic ('O')
+ * - 1 byte: Version (1 = JSON payload, 2 = JSON or MessagePack payload)
  * - 1 byte: Message type
  * - 1 byte: Flags
  * - 2 bytes: Payload length (little-endian)
@@ -26,8 +28,9 @@ namespace OpenClaw {
 
 // Protocol constants
 constexpr uint8_t PROTOCOL_VERSION = 1;
+constexpr uint8_t PROTOCOL_VERSION_V2 = 2;  // Adds MessagePack payloads (COMPRESSED flag)
 constexpr uint8_t PROTOCOL_MAGIC = 0x4F; // 'O' for OpenClaw
-constexpr size_t PROTOCOL_HEADER_SIZE = 8;
+constexpr size_t PROTOCOL_HEADER_SIZE = 10;
 constexpr size_t PROTOCOL_FOOTER_SIZE = 2;
 constexpr size_t PROTOCOL_MAX_PAYLOAD_SIZE = 8192;
 constexpr size_t PROTOCOL_MAX_MESSAGE_SIZE = PROTOCOL_HEADER_SIZE + PROTOCOL_MAX_PAYLOAD_SIZE + PROTOCOL_FOOTER_SIZE;
@@ -109,7 +112,8 @@ struct __attribute__((packed)) ProtocolHeader {
         payload_length = buffer[4] | (buffer[5] << 8);
         timestamp = buffer[6] | (buffer[7] << 8) | (buffer[8] << 16) | (buffer[9] << 24);
         
-        return magic == PROTOCOL_MAGIC && version == PROTOCOL_VERSION;
+        return magic == PROTOCOL_MAGIC &&
+               (version == PROTOCOL_VERSION || version == PROTOCOL_VERSION_V2);
     }
 };
 
@@ -130,9 +134,12 @@ public:
     static ProtocolMessage createAuth(const char* device_id, const char* device_name, 
                                        const char* version, const char* api_key = nullptr);
     static ProtocolMessage createAuthResponse(bool success, const char* error = nullptr);
-    static ProtocolMessage createText(const char* text, const char* device_id);
+    static ProtocolMessage createText(const char* text, const char* device_id, uint32_t turn = 0);
+    // endpoint: optional end-of-utterance hint ("likely_final", "resumed")
     static ProtocolMessage createAudio(const uint8_t* data, size_t length, bool is_final,
-                                        const char* codec = "opus");
+                                        const char* codec = "opus", uint32_t turn = 0,
+                                        const char* endpoint = nullptr);
+    static ProtocolMessage createCommand(const char* command, uint32_t turn = 0);
     static ProtocolMessage createResponse(const char* text, bool is_final);
     static ProtocolMessage createStatus(const char* status);
     static ProtocolMessage createError(const char* error, int error_code = 0);
@@ -142,7 +149,8 @@ public:
                                               uint8_t bits_per_sample, const char* codec);
     
     // Serialization
-    bool serialize(uint8_t* buffer, size_t buffer_size, size_t& out_length) const;
+    bool serialize(uint8_t* buffer, size_t buffer_size, size_t& out_length,
+                   uint8_t version = PROTOCOL_VERSION) const;
     bool deserialize(const uint8_t* buffer, size_t buffer_length);
     
     // Getters
@@ -167,15 +175,15 @@ public:
     bool getJsonPayload(String& json_string) const;
     bool setJsonPayload(const String& json_string);
     
+    // CRC16 calculation (CCITT-FALSE), over header and payload
+    static uint16_t calculateCRC16(const uint8_t* data, size_t length);
+    
 private:
     MessageType type_;
     MessageFlags flags_;
     std::unique_ptr<uint8_t[]> payload_;
     size_t payload_length_;
     uint32_t timestamp_;
-    
-    // CRC16 calculation (CCITT-FALSE)
-    static uint16_t calculateCRC16(const uint8_t* data, size_t length);
 };
 
 // Protocol parser for streaming data
@@ -0,0 +1,121 @@
+/**
+ * @file ring_buffer.h
+ * @brief Fixed-capacity FIFO ring buffer for OpenClaw Cardputer
+ *
+ * Features:
+ * - No heap allocation; storage is an inline std::array
+ * - O(1) push/pop with power-of-two index masking
+ * - RingBuffer: single-context use only (no locking)
+ * - SpscRingBuffer: lock-free hand-off from one producer task to one
+ *   consumer task
+ */
+
+#ifndef OPENCLAW_RING_BUFFER_H
+#define OPENCLAW_RING_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace OpenClaw {
+
+template <typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "RingBuffer capacity must be a power of two");
+
+public:
+    RingBuffer() : head_(0), tail_(0) {}
+
+    // Append an item; returns false (item dropped) when full
+    bool push(const T& item) {
+        if (full()) return false;
+        items_[tail_ & MASK] = item;
+        tail_++;
+        return true;
+    }
+
+    // Remove the oldest item; returns false when empty
+    bool pop(T& out) {
+        if (empty()) return false;
+        out = items_[head_ & MASK];
+        head_++;
+        return true;
+    }
+
+    // Peek at the oldest item without removing it
+    const T* front() const {
+        return empty() ? nullptr : &items_[head_ & MASK];
+    }
+
+    void clear() { head_ = tail_ = 0; }
+
+    size_t size() const { return (size_t)(tail_ - head_); }
+    bool empty() const { return head_ == tail_; }
+    bool full() const { return size() == N; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    std::array<T, N> items_;
+    uint32_t head_;   // Free-running read counter
+    uint32_t tail_;   // Free-running write counter
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring
+ *
+ * Exactly one task may push and exactly one (other) task may pop. Each
+ * side owns one free-running index and publishes it with a release
+ * store; the other side reads it with an acquire load, so an item is
+ * fully written before the consumer can see it. Not ISR-safe.
+ */
+template <typename T, size_t N>
+class SpscRingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRingBuffer capacity must be a power of two");
+
+public:
+    SpscRingBuffer() : head_(0), tail_(0) {}
+
+    // Disable copy
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side; returns false (nothing written) when full
+    bool push(const T& item) {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == N) return false;
+        items_[tail & MASK] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; returns false when empty
+    bool pop(T& out) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return false;
+        out = items_[head & MASK];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Snapshot; exact only when called from one of the two sides
+    size_t size() const {
+        return (size_t)(tail_.load(std::memory_order_acquire) -
+                        head_.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    std::array<T, N> items_;
+    std::atomic<uint32_t> head_;   // Written by the consumer only
+    std::atomic<uint32_t> tail_;   // Written by the producer only
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_RING_BUFFER_H
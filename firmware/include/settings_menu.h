@@ -7,6 +7,7 @@
  * - Edit WiFi, Gateway, Device, and Audio settings
  * - Save to SPIFFS /config.json
  * - Live validation and testing
+ * - WiFi scan runs in the background; the link stays up while scanning
  */
 
 #ifndef OPENCLAW_SETTINGS_MENU_H
@@ -17,6 +18,7 @@
 #include "config_manager.h"
 #include "display_renderer.h"
 #include "keyboard_handler.h"
+#include "wifi_manager.h"
 
 namespace OpenClaw {
 
@@ -78,8 +80,9 @@ public:
     SettingsMenu(const SettingsMenu&) = delete;
     SettingsMenu& operator=(const SettingsMenu&) = delete;
 
-    // Initialize with dependencies
-    bool begin(ConfigManager* config_mgr, DisplayRenderer* display);
+    // Initialize with dependencies (wifi may be null: no scanning)
+    bool begin(ConfigManager* config_mgr, DisplayRenderer* display,
+               WiFiManager* wifi = nullptr);
 
     // Open/close menu
     void open();
@@ -89,9 +92,14 @@ public:
     // Handle input events (call from main loop)
     void onKeyEvent(const KeyEvent& event);
 
-    // Update and render (call from main loop when menu is open)
+    // Update (call from main loop when menu is open)
     void update();
-    void render();
+
+    // Background scan finished (WiFiManagerEvent::SCAN_DONE)
+    void onWiFiScanDone();
+
+    // Render into the compositor's MENU_OVERLAY layer
+    void render(lgfx::LovyanGFX& canvas);
 
     // Get current state
     MenuState getState() const { return state_; }
@@ -103,6 +111,7 @@ private:
     // Dependencies
     ConfigManager* config_mgr_;
     DisplayRenderer* display_;
+    WiFiManager* wifi_;
     AppConfig config_copy_;  // Working copy of config
 
     // State
@@ -165,12 +174,14 @@ private:
     void showMessage(const char* msg, uint32_t timeout_ms = 2000);
     void clearMessage();
 
-    void renderMainMenu();
-    void renderEditScreen();
-    void renderConfirmDialog();
-    void renderMessage();
-    void renderWiFiScan();
-    void renderDeviceInfo();
+    void invalidate();
+
+    void renderMainMenu(lgfx::LovyanGFX& canvas);
+    void renderEditScreen(lgfx::LovyanGFX& canvas);
+    void renderConfirmDialog(lgfx::LovyanGFX& canvas);
+    void renderMessage(lgfx::LovyanGFX& canvas);
+    void renderWiFiScan(lgfx::LovyanGFX& canvas);
+    void renderDeviceInfo(lgfx::LovyanGFX& canvas);
 
     const char* getCategoryName(MenuCategory cat) const;
     const char* getValueDisplay(const MenuItem* item) const;
@@ -0,0 +1,79 @@
+/**
+ * @file socket_watcher.h
+ * @brief Gateway socket receive watcher for OpenClaw Cardputer
+ *
+ * Features:
+ * - A small task blocks in lwIP select() on the gateway socket and wakes
+ *   the main loop (LOOP_SIGNAL_NETWORK) when it turns readable, so an
+ *   idle session costs no polling
+ * - One wake per burst: after signalling, the task waits to be re-armed
+ *   by the loop before looking at the socket again
+ * - A closed or replaced socket is picked up on the next watch()
+ */
+
+#ifndef OPENCLAW_SOCKET_WATCHER_H
+#define OPENCLAW_SOCKET_WATCHER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "event_loop.h"
+
+namespace OpenClaw {
+
+class SocketWatcher {
+public:
+    SocketWatcher();
+    ~SocketWatcher();
+
+    // Disable copy
+    SocketWatcher(const SocketWatcher&) = delete;
+    SocketWatcher& operator=(const SocketWatcher&) = delete;
+
+    /**
+     * @brief Start the watcher task; it idles until watch() gives it a socket
+     */
+    bool begin(const LoopNotifier& notifier);
+
+    /**
+     * @brief Stop the task (waits for its current select() to return)
+     */
+    void end();
+
+    /**
+     * @brief Watch fd (-1 for none) and re-arm after the loop has read
+     *        what was there. Main loop context.
+     */
+    void watch(int fd);
+
+    // Task running and a socket to watch
+    bool isWatching() const { return task_ != nullptr && fd_.load() >= 0; }
+
+    uint32_t getWakeCount() const { return wake_count_.load(); }
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    LoopNotifier notifier_;
+    TaskHandle_t task_;
+    std::atomic<int> fd_;
+    std::atomic<bool> running_;
+    std::atomic<uint32_t> wake_count_;
+    char last_error_[64];
+
+    static constexpr uint32_t TASK_STACK_SIZE = 2560;
+    static constexpr UBaseType_t TASK_PRIORITY = 4;
+
+    // select() gives up this often to notice a new fd or end()
+    static constexpr uint32_t SELECT_TIMEOUT_MS = 1000;
+    // Re-armed by the loop within a few ms; this only bounds a missed re-arm
+    static constexpr uint32_t REARM_TIMEOUT_MS = 100;
+
+    static void watchTask(void* param);
+    void watchLoop();
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_SOCKET_WATCHER_H
@@ -0,0 +1,247 @@
+/**
+ * @file state_machine_dsl.h
+ * @brief Compile-time transition table DSL for AppStateMachine
+ *
+ * Features:
+ * - Declarative state and transition lists checked by static_assert
+ * - Rejects duplicate handlers, duplicate/undeclared states, timeouts
+ *   without a TIMEOUT row, and states unreachable from the initial one
+ * - Guards and actions are template arguments, so each row compiles to
+ *   a direct call (no std::function, no heap)
+ * - Produces a constexpr MachineSpec that lives in flash
+ *
+ * Example:
+ *   using Spec = Fsm::Machine<AppState::BOOT,
+ *       Fsm::States<
+ *           Fsm::StateDef<AppState::BOOT, 2000>,
+ *           Fsm::StateDef<AppState::READY, 0, onReadyEnter>>,
+ *       Fsm::Rows<
+ *           Fsm::Row<AppState::BOOT, AppEvent::BOOT_COMPLETE, AppState::READY>,
+ *           Fsm::Row<AppState::BOOT, AppEvent::TIMEOUT, AppState::READY>>>;
+ *   state_machine.begin(&Spec::spec, &timers);
+ */
+
+#ifndef OPENCLAW_STATE_MACHINE_DSL_H
+#define OPENCLAW_STATE_MACHINE_DSL_H
+
+#include <array>
+#include "app_state_machine.h"
+
+namespace OpenClaw {
+namespace Fsm {
+
+using Guard = bool (*)();
+using Action = void (*)();
+
+/**
+ * @brief State declaration
+ * @tparam Id State
+ * @tparam TimeoutMs Post AppEvent::TIMEOUT after this long in the state (0 = never)
+ * @tparam OnEntry Called after entering
+ * @tparam OnExit Called before leaving
+ * @tparam RetryDelayMs Re-entering the state after a visit that ended in an
+ *         error state is deferred this long (retry back-off)
+ */
+template <AppState Id, uint32_t TimeoutMs = 0,
+          Action OnEntry = nullptr, Action OnExit = nullptr,
+          uint32_t RetryDelayMs = 0>
+struct StateDef {
+    static constexpr AppState id = Id;
+    static constexpr uint32_t timeout_ms = TimeoutMs;
+    static constexpr Action on_entry = OnEntry;
+    static constexpr Action on_exit = OnExit;
+    static constexpr uint32_t retry_delay_ms = RetryDelayMs;
+};
+
+/**
+ * @brief Transition row: in From, Event moves to To if Guard passes
+ *
+ * A row with To == From is an internal transition: the action runs and
+ * the state's timeout restarts, but exit and entry actions do not.
+ */
+template <AppState From, AppEvent Event, AppState To,
+          Guard G = nullptr, Action A = nullptr>
+struct Row {
+    static constexpr AppState from = From;
+    static constexpr AppEvent event = Event;
+    static constexpr AppState to = To;
+
+    static bool fire() {
+        if constexpr (G != nullptr) {
+            if (!G()) return false;
+        }
+        if constexpr (A != nullptr) {
+            A();
+        }
+        return true;
+    }
+
+    // Rows without guard or action need no call at all
+    static constexpr TransitionFn fn = (G == nullptr && A == nullptr) ? nullptr : &fire;
+};
+
+template <typename... S> struct States {};
+template <typename... R> struct Rows {};
+
+namespace Detail {
+
+struct StateInfo {
+    AppState id;
+    uint32_t timeout_ms;
+};
+
+struct RowInfo {
+    AppState from;
+    AppEvent event;
+    AppState to;
+};
+
+constexpr size_t idx(AppState s) { return static_cast<size_t>(s); }
+
+template <size_t NS>
+constexpr bool isDeclared(AppState s, const std::array<StateInfo, NS>& states) {
+    for (size_t i = 0; i < NS; i++) {
+        if (states[i].id == s) return true;
+    }
+    return false;
+}
+
+template <size_t NS>
+constexpr bool noDuplicateStates(const std::array<StateInfo, NS>& states) {
+    for (size_t i = 0; i < NS; i++) {
+        for (size_t j = i + 1; j < NS; j++) {
+            if (states[i].id == states[j].id) return false;
+        }
+    }
+    return true;
+}
+
+template <size_t NS, size_t NR>
+constexpr bool rowsUseDeclaredStates(const std::array<StateInfo, NS>& states,
+                                     const std::array<RowInfo, NR>& rows) {
+    for (size_t i = 0; i < NR; i++) {
+        if (!isDeclared(rows[i].from, states) || !isDeclared(rows[i].to, states)) return false;
+    }
+    return true;
+}
+
+template <size_t NR>
+constexpr bool noDuplicateHandlers(const std::array<RowInfo, NR>& rows) {
+    for (size_t i = 0; i < NR; i++) {
+        for (size_t j = i + 1; j < NR; j++) {
+            if (rows[i].from == rows[j].from && rows[i].event == rows[j].event) return false;
+        }
+    }
+    return true;
+}
+
+template <size_t NR>
+constexpr bool hasRow(AppState from, AppEvent event, const std::array<RowInfo, NR>& rows) {
+    for (size_t i = 0; i < NR; i++) {
+        if (rows[i].from == from && rows[i].event == event) return true;
+    }
+    return false;
+}
+
+// A timeout needs a TIMEOUT row, and a TIMEOUT row needs a timeout
+template <size_t NS, size_t NR>
+constexpr bool timeoutsConsistent(const std::array<StateInfo, NS>& states,
+                                  const std::array<RowInfo, NR>& rows) {
+    for (size_t i = 0; i < NS; i++) {
+        bool has_timeout = states[i].timeout_ms > 0;
+        if (has_timeout != hasRow(states[i].id, AppEvent::TIMEOUT, rows)) return false;
+    }
+    return true;
+}
+
+// Fixed-point flood fill over the rows from the initial state
+template <size_t NS, size_t NR>
+constexpr bool allReachable(AppState initial, const std::array<StateInfo, NS>& states,
+                            const std::array<RowInfo, NR>& rows) {
+    bool reached[APP_STATE_COUNT] = {};
+    reached[idx(initial)] = true;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < NR; i++) {
+            if (reached[idx(rows[i].from)] && !reached[idx(rows[i].to)]) {
+                reached[idx(rows[i].to)] = true;
+                changed = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < NS; i++) {
+        if (!reached[idx(states[i].id)]) return false;
+    }
+    return true;
+}
+
+template <typename SD>
+constexpr void addState(MachineSpec& m) {
+    size_t s = idx(SD::id);
+    m.declared[s] = true;
+    m.timeout_ms[s] = SD::timeout_ms;
+    m.on_entry[s] = SD::on_entry;
+    m.on_exit[s] = SD::on_exit;
+    m.entry_delay_ms[s] = SD::retry_delay_ms;
+}
+
+template <typename RD>
+constexpr void addRow(MachineSpec& m) {
+    m.transitions[idx(RD::from)][static_cast<size_t>(RD::event)] =
+        TransitionSlot{static_cast<uint8_t>(RD::to), RD::fn};
+}
+
+template <AppState Initial, typename... S, typename... R>
+constexpr MachineSpec buildSpec(States<S...>, Rows<R...>) {
+    MachineSpec m{};
+    m.initial = Initial;
+    for (size_t s = 0; s < APP_STATE_COUNT; s++) {
+        for (size_t e = 0; e < APP_EVENT_COUNT; e++) {
+            m.transitions[s][e] = TransitionSlot{MachineSpec::NO_TRANSITION, nullptr};
+        }
+    }
+    (addState<S>(m), ...);
+    (addRow<R>(m), ...);
+    return m;
+}
+
+} // namespace Detail
+
+template <AppState Initial, typename StateList, typename RowList>
+struct Machine;
+
+/**
+ * @brief Validated machine definition; exposes the generated spec
+ */
+template <AppState Initial, typename... S, typename... R>
+struct Machine<Initial, States<S...>, Rows<R...>> {
+    static constexpr std::array<Detail::StateInfo, sizeof...(S)> state_info = {{
+        Detail::StateInfo{S::id, S::timeout_ms}...
+    }};
+    static constexpr std::array<Detail::RowInfo, sizeof...(R)> row_info = {{
+        Detail::RowInfo{R::from, R::event, R::to}...
+    }};
+
+    static_assert(Detail::isDeclared(Initial, state_info),
+                  "Initial state has no StateDef");
+    static_assert(Detail::noDuplicateStates(state_info),
+                  "State declared more than once");
+    static_assert(Detail::rowsUseDeclaredStates(state_info, row_info),
+                  "Transition references a state with no StateDef");
+    static_assert(Detail::noDuplicateHandlers(row_info),
+                  "Duplicate handler: two rows for the same (state, event)");
+    static_assert(Detail::timeoutsConsistent(state_info, row_info),
+                  "State timeout without a TIMEOUT row (or TIMEOUT row without a timeout)");
+    static_assert(Detail::allReachable(Initial, state_info, row_info),
+                  "Declared state is unreachable from the initial state");
+
+    static constexpr MachineSpec spec = Detail::buildSpec<Initial>(States<S...>{}, Rows<R...>{});
+};
+
+} // namespace Fsm
+} // namespace OpenClaw
+
+#endif // OPENCLAW_STATE_MACHINE_DSL_H
@@ -0,0 +1,145 @@
+/**
+ * @file timer_wheel.h
+ * @brief Hierarchical timer wheel for OpenClaw Cardputer
+ *
+ * Features:
+ * - One-shot and periodic timers with 1 ms resolution
+ * - O(1) schedule and cancel (intrusive lists, fixed pool, no heap)
+ * - Four 64-slot levels: covers ~4.6 hours, longer delays are clamped
+ * - Occupancy bitmaps so idle stretches are skipped, not ticked through
+ * - Exact time-to-next-deadline so the main loop can sleep until then
+ *
+ * Not thread-safe; owned and driven by the main loop.
+ */
+
+#ifndef OPENCLAW_TIMER_WHEEL_H
+#define OPENCLAW_TIMER_WHEEL_H
+
+#include <Arduino.h>
+
+namespace OpenClaw {
+
+constexpr size_t TIMER_WHEEL_MAX_TIMERS = 32;
+constexpr uint32_t TIMER_WHEEL_NO_DEADLINE = 0xFFFFFFFF;
+
+// Timer handle; 0 is never a valid id
+using TimerId = uint32_t;
+constexpr TimerId INVALID_TIMER_ID = 0;
+
+using TimerCallback = void (*)(void* ctx);
+
+/**
+ * @brief Timer wheel (Varghese & Lauck scheme 6, with cascading)
+ *
+ * Level 0 holds timers due within 64 ms, one slot per millisecond. Each
+ * higher level covers 64x the span of the one below; when level 0 wraps,
+ * the matching slot of level 1 is cascaded down, and so on upward.
+ */
+class TimerWheel {
+public:
+    TimerWheel();
+
+    // Disable copy
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /**
+     * @brief Fire once after delay_ms
+     * @return Timer id, or INVALID_TIMER_ID if the pool is exhausted
+     */
+    TimerId schedule(uint32_t delay_ms, TimerCallback callback, void* ctx = nullptr);
+
+    /**
+     * @brief Fire every period_ms (first after one period); drift-free
+     */
+    TimerId scheduleEvery(uint32_t period_ms, TimerCallback callback, void* ctx = nullptr);
+
+    /**
+     * @brief Move an active timer to fire delay_ms from now
+     * @return false if the timer is no longer active
+     */
+    bool reschedule(TimerId id, uint32_t delay_ms);
+
+    /**
+     * @brief Cancel a timer (safe on stale ids and from callbacks)
+     * @return true if the timer was active
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * @brief Cancel a timer and clear the caller's handle
+     */
+    void cancel(TimerId* id);
+
+    bool isActive(TimerId id) const;
+
+    /**
+     * @brief Run every timer due at or before now
+     * @return Number of callbacks fired
+     */
+    size_t advance(uint32_t now);
+    size_t advance() { return advance(millis()); }
+
+    /**
+     * @brief Time until the earliest pending deadline
+     * @return 0 if already due, TIMER_WHEEL_NO_DEADLINE if nothing is pending
+     */
+    uint32_t msUntilNextDeadline(uint32_t now) const;
+    uint32_t msUntilNextDeadline() const { return msUntilNextDeadline(millis()); }
+
+    size_t getActiveCount() const { return active_count_; }
+    uint32_t getFiredCount() const { return fired_count_; }
+
+private:
+    static constexpr uint8_t LEVELS = 4;
+    static constexpr uint8_t SLOT_BITS = 6;
+    static constexpr uint8_t SLOTS = 1 << SLOT_BITS;
+    static constexpr uint8_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint8_t NIL = 0xFF;
+    // Keeps every deadline within 63 slots of the top level
+    static constexpr uint32_t MAX_DELAY_MS =
+        (1UL << (SLOT_BITS * LEVELS)) - (1UL << (SLOT_BITS * (LEVELS - 1))) - 1;
+
+    static_assert(TIMER_WHEEL_MAX_TIMERS < NIL, "Timer index must fit in uint8_t");
+
+    struct Timer {
+        uint32_t expires;
+        uint32_t period;       // 0 = one-shot
+        TimerCallback callback;
+        void* ctx;
+        uint32_t generation;
+        uint8_t prev;
+        uint8_t next;
+        uint8_t level;
+        uint8_t slot;
+        bool active;
+    };
+
+    Timer timers_[TIMER_WHEEL_MAX_TIMERS];
+    uint8_t slots_[LEVELS][SLOTS];     // List heads
+    uint64_t occupied_[LEVELS];        // Bit per non-empty slot
+    uint8_t free_head_;
+    uint32_t now_tick_;                // Last tick processed
+    uint32_t advance_target_;          // 'now' of the advance() in progress
+    size_t active_count_;
+    uint32_t fired_count_;
+
+    TimerId add(uint32_t delay_ms, uint32_t period_ms, TimerCallback callback, void* ctx);
+    uint32_t deadlineFromNow(uint32_t delay_ms) const;
+    void insert(uint8_t index);
+    void unlink(uint8_t index);
+    void release(uint8_t index);
+    void cascade(uint8_t level);
+    size_t expireSlot(uint8_t slot);
+    uint32_t nextTick() const;
+    uint32_t earliestInLevel(uint8_t level, bool& found) const;
+    uint8_t findIndex(TimerId id) const;
+
+    static TimerId makeId(uint8_t index, uint32_t generation) {
+        return (generation << 8) | index;
+    }
+};
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_TIMER_WHEEL_H
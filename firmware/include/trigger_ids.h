@@ -0,0 +1,27 @@
+/**
+ * @file trigger_ids.h
+ * @brief Trigger phrase IDs
+ *
+ * Generated by scripts/gen_trigger_matcher.py from
+ * scripts/trigger_phrases.txt. Do not edit.
+ */
+
+#ifndef OPENCLAW_TRIGGER_IDS_H
+#define OPENCLAW_TRIGGER_IDS_H
+
+#include <cstdint>
+
+namespace OpenClaw {
+
+enum class TriggerId : uint8_t {
+    ANCIENT_MODE,
+    RITUAL_AWAKEN,
+    INSULT,
+    PLEASE,
+};
+
+constexpr uint8_t TRIGGER_ID_COUNT = 4;
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_TRIGGER_IDS_H
@@ -0,0 +1,60 @@
+/**
+ * @file trigger_matcher.h
+ * @brief Multi-pattern trigger phrase matcher for OpenClaw Cardputer
+ *
+ * Features:
+ * - One Aho-Corasick automaton for every trigger phrase (ancient mode,
+ *   ritual awakening, insults, politeness), compiled at build time from
+ *   scripts/trigger_phrases.txt
+ * - Single pass per text, case-insensitive, no copies or allocation
+ * - Streaming: phrases split across response chunks still match
+ * - Returns a bitmask of matched TriggerIds for each owner to test
+ */
+
+#ifndef OPENCLAW_TRIGGER_MATCHER_H
+#define OPENCLAW_TRIGGER_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "trigger_ids.h"
+
+namespace OpenClaw {
+
+using TriggerMask = uint32_t;
+
+constexpr TriggerMask triggerBit(TriggerId id) {
+    return TriggerMask(1) << static_cast<uint8_t>(id);
+}
+
+/**
+ * @brief Incremental matcher; keeps its place between feeds
+ */
+class TriggerScanner {
+public:
+    TriggerScanner() : state_(0) {}
+
+    // Forget any partial match (start of a new text)
+    void reset() { state_ = 0; }
+
+    /**
+     * @brief Scan more text
+     * @return Triggers whose phrases ended inside this chunk
+     */
+    TriggerMask feed(const char* data, size_t length);
+    TriggerMask feed(const char* text);
+
+private:
+    uint16_t state_;
+};
+
+/**
+ * @brief Scan one complete text
+ */
+TriggerMask scanTriggers(const char* text);
+
+// Utility functions
+const char* triggerIdToString(TriggerId id);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_TRIGGER_MATCHER_H
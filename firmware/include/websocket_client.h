@@ -1,14 +1,19 @@
 /**
  * @file websocket_client.h
- * @brief Improved WebSocket client for OpenClaw gateway
+ * @brief Gateway transport for OpenClaw Cardputer
  * 
  * Features:
  * - Automatic reconnection with exponential backoff
- * - Binary protocol support
+ * - Wire format negotiated at connect (binary v2, binary v1 or JSON, see
+ *   message_codec.h); callers only ever see ProtocolMessage
  * - Connection state machine
- * - Message queuing
+ * - Single send path: messages are encoded in place behind room for the
+ *   WebSocket header, so a send makes no copy and no allocation
+ * - Certificate pinning for wss gateways
  * - Ping/pong keepalive
- * - Thread-safe operation
+ * - Wakes the main loop when gateway data arrives (socket_watcher.h), so
+ *   an authenticated session needs update() only for its keepalive
+ * - Main loop context only
  */
 
 #ifndef OPENCLAW_WEBSOCKET_CLIENT_H
@@ -18,16 +23,18 @@
 #include <WebSocketsClient.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
-#include <freertos/semphr.h>
 #include <memory>
 #include <functional>
+#include "event_loop.h"
+#include "loopback_socket.h"
+#include "message_codec.h"
 #include "protocol.h"
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+#include "socket_watcher.h"
+#endif
 
 namespace OpenClaw {
 
-// Forward declarations
-class WebSocketClient;
-
 // Connection state
 enum class ConnectionState {
     DISCONNECTED,
@@ -41,9 +48,13 @@ enum class ConnectionState {
 // Connection configuration
 struct WebSocketConfig {
     String host;
+    uint32_t host_ip;       // Pre-resolved host address (0 = look up at
+                            // connect); wss always connects by name for SNI
     uint16_t port;
     String path;
     bool use_ssl;
+    String tls_fingerprint; // SHA-256 pin of the gateway certificate
+                            // (empty = unpinned)
     String api_key;
     String device_id;
     String device_name;
@@ -57,17 +68,16 @@ struct WebSocketConfig {
     uint32_t pong_timeout_ms;
     uint8_t max_reconnect_attempts;
     
-    // Queue sizes
-    size_t send_queue_size;
+    // Queue size
     size_t receive_queue_size;
     
     WebSocketConfig()
-        : host(""), port(8765), path("/ws"), use_ssl(false),
+        : host(""), host_ip(0), port(8765), path("/ws"), use_ssl(false),
           api_key(""), device_id(""), device_name("Cardputer"), firmware_version("2.0.0"),
           connect_timeout_ms(10000), reconnect_interval_ms(1000),
           reconnect_max_interval_ms(60000), ping_interval_ms(30000),
           pong_timeout_ms(5000), max_reconnect_attempts(0), // 0 = unlimited
-          send_queue_size(16), receive_queue_size(16) {}
+          receive_queue_size(16) {}
 };
 
 // Connection statistics
@@ -80,29 +90,59 @@ struct ConnectionStats {
     uint32_t pong_count;
     uint32_t errors;
     uint32_t connection_duration_ms;
+    uint32_t bytes_sent;            // Encoded frames, before WebSocket framing
+    uint32_t bytes_received;
+    uint32_t handshake_ms;          // connect() to socket open, last connection
     int8_t last_rssi;
     
     ConnectionStats()
         : messages_sent(0), messages_received(0), messages_dropped(0),
           reconnect_count(0), ping_count(0), pong_count(0), errors(0),
-          connection_duration_ms(0), last_rssi(0) {}
+          connection_duration_ms(0), bytes_sent(0), bytes_received(0),
+          handshake_ms(0), last_rssi(0) {}
 };
 
-// Event types
+// Event types. Received messages are read with receive(), not delivered
+// as events.
 enum class WebSocketEvent {
-    CONNECTED,
-    DISCONNECTED,
+    CONNECTED,          // Socket open; data: const MessageCodec*
+    DISCONNECTED,       // An open socket closed; reconnecting
     AUTHENTICATED,
-    AUTH_FAILED,
-    MESSAGE_RECEIVED,
-    ERROR,
-    STATE_CHANGED
+    AUTH_FAILED,        // data: error text
+    ERROR,              // Gave up (max_reconnect_attempts); data: error text
+    STATE_CHANGED       // data: const ConnectionState*
 };
 
 // Event callback type
 using WebSocketEventCallback = std::function<void(WebSocketEvent event, const void* data)>;
 
-// WebSocket client class
+#ifdef OPENCLAW_LOOPBACK_GATEWAY
+// No network: an in-process gateway over a scripted link
+using GatewaySocket = LoopbackSocket;
+#else
+// WebSocketsClient with access to the connection the library keeps protected.
+// Its WiFiClientSecure can't save or restore a TLS session, so every wss
+// connect is a full handshake; resuming needs an esp-tls based socket.
+class GatewaySocket : public WebSocketsClient {
+public:
+    // Check the TLS peer against a SHA-256 fingerprint (hex, bytes
+    // optionally separated by ':' or ' ')
+    bool verifyPeer(const char* fingerprint);
+    
+    // Subprotocol the server accepted; after a handshake without one the
+    // library leaves our own offer here
+    const char* getSubprotocol() const { return _client.cProtocol.c_str(); }
+    
+    // Descriptor of the open socket, -1 if none
+    int getFd() const;
+    
+    // Received bytes select() can't see: TLS records already read off the
+    // socket and decrypted into the library's buffer
+    bool hasBufferedInput() const;
+};
+#endif
+
+// Gateway transport
 class WebSocketClient {
 public:
     WebSocketClient();
@@ -115,7 +155,13 @@ public:
     // Initialize with configuration
     bool begin(const WebSocketConfig& config);
     
-    // Connect to server
+    // Apply new settings without a restart. Timing changes take effect
+    // in place; endpoint or credential changes reconnect an open session.
+    // The queue size is fixed at begin(). Returns true if it reconnected.
+    bool reconfigure(const WebSocketConfig& config);
+    
+    // Connect to server; restarts a pending retry straight away. No-op
+    // while connecting or connected (use reconnect() to force a new session)
     bool connect();
     
     // Disconnect from server
@@ -124,13 +170,23 @@ public:
     // Update client (call in main loop)
     void update();
     
+    // Wake the main loop when gateway data arrives. Without a notifier
+    // (and over the loopback link) update() has to be polled.
+    void setNotifier(const LoopNotifier& notifier);
+    
+    // True while an authenticated session signals its own traffic, so
+    // update() is needed only for heartbeats and timeouts
+    bool isEventDriven() const;
+    
     // Deinitialize
     void end();
     
     // Send message
     bool send(const ProtocolMessage& message);
-    bool sendText(const char* text);
-    bool sendAudio(const uint8_t* data, size_t length, bool is_final);
+    bool sendText(const char* text, uint32_t turn = 0);
+    bool sendAudio(const uint8_t* data, size_t length, bool is_final, const char* codec,
+                   uint32_t turn = 0, const char* endpoint = nullptr);
+    bool sendCommand(const char* command, uint32_t turn = 0);
     bool sendPing();
     
     // Receive message (non-blocking)
@@ -155,16 +211,30 @@ public:
     // Get connection info
     uint32_t getConnectionTime() const;
     uint32_t getReconnectDelay() const { return current_reconnect_delay_; }
+    const WebSocketConfig& getConfig() const { return config_; }
+
+    // Codec of the current connection (binary v1 until one is negotiated)
+    const MessageCodec& getCodec() const { return *codec_; }
     
     // Force reconnection
     void reconnect();
     
+#ifdef OPENCLAW_LOOPBACK_GATEWAY
+    // The in-process link, to script it and read its counters
+    LoopbackSocket& getLoopback() { return ws_client_; }
+#endif
+    
 private:
     // Configuration
     WebSocketConfig config_;
     
     // WebSocket client
-    WebSocketsClient ws_client_;
+    GatewaySocket ws_client_;
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+    SocketWatcher rx_watcher_;
+    LoopNotifier notifier_;
+#endif
+    const MessageCodec* codec_;
     
     // State
     ConnectionState state_;
@@ -172,28 +242,23 @@ private:
     
     // Timing
     uint32_t last_connect_attempt_;
-    uint32_t last_ping_time_;
-    uint32_t last_pong_time_;
     uint32_t connection_start_time_;
     uint32_t current_reconnect_delay_;
     uint8_t reconnect_attempts_;
     
     // Statistics
     ConnectionStats stats_;
-    SemaphoreHandle_t stats_mutex_;
     
-    // Message queues
-    QueueHandle_t send_queue_;
+    // Received messages (owned pointers)
     QueueHandle_t receive_queue_;
     
-    // Protocol parser for incoming data
-    ProtocolParser parser_;
+    // Encode buffer, with room for the WebSocket header in front
+    std::unique_ptr<uint8_t[]> tx_buffer_;
     
     // Error buffer
     char last_error_[128];
     
     // Authentication state
-    bool auth_sent_;
     uint32_t auth_sent_time_;
     
     // Static instance for callback
@@ -202,22 +267,20 @@ private:
     // Private methods
     bool createQueues();
     void destroyQueues();
-    bool createMutexes();
-    void destroyMutexes();
     
     void setState(ConnectionState new_state);
+    void emit(WebSocketEvent event, const void* data = nullptr);
+    void startAttempt();
+    void scheduleRetry();
+    void closeSocket();
+    void watchSocket();
     void handleConnect();
-    void handleDisconnect(uint16_t code);
-    void handleMessage(const uint8_t* data, size_t length);
+    void handleDisconnect();
+    void handleMessage(const uint8_t* data, size_t length, bool is_text);
     void handleError(const char* error);
     void handleAuthResponse(const ProtocolMessage& msg);
     
-    void processSendQueue();
     void sendAuthMessage();
-    void updateReconnectLogic();
-    void updatePingPong();
-    
-    void updateStats(const std::function<void(ConnectionStats&)>& updater);
     
     // WebSocket event handler (static)
     static void webSocketEvent(WStype_t type, uint8_t* payload, size_t length);
@@ -0,0 +1,291 @@
+/**
+ * @file wifi_manager.h
+ * @brief Asynchronous WiFi scan and connect pipeline for OpenClaw Cardputer
+ *
+ * Features:
+ * - Driven by WiFi system events (queued from the event task, handled on
+ *   the main loop); nothing blocks on association, DHCP or scans
+ * - Background scans keep the current link up; results are cached per
+ *   BSSID with a short RSSI history
+ * - Several known networks, ranked by averaged signal and past failures
+ * - Fast reconnect: after a link drop the last good BSSID and channel are
+ *   tried straight away, skipping the channel scan
+ * - Exponential back-off once every known network has failed a round
+ * - Boot fast path: a BSSID/channel and DHCP lease handed in from a
+ *   previous boot skip the scan and the DHCP exchange on the first join
+ * - Asynchronous DNS lookups, reported like any other link event
+ */
+
+#ifndef OPENCLAW_WIFI_MANAGER_H
+#define OPENCLAW_WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <lwip/ip_addr.h>
+#include <functional>
+#include "event_loop.h"
+#include "timer_wheel.h"
+
+namespace OpenClaw {
+
+constexpr size_t WIFI_MAX_NETWORKS = 4;
+constexpr size_t WIFI_SCAN_CACHE_SIZE = 16;
+constexpr size_t WIFI_RSSI_HISTORY = 4;
+constexpr size_t WIFI_SSID_MAX = 32;
+constexpr size_t WIFI_PASSWORD_MAX = 64;
+constexpr size_t WIFI_HOST_MAX = 63;
+
+// Link state
+enum class WiFiLinkState : uint8_t {
+    IDLE,           // Not trying to connect
+    CONNECTING,     // First connection since connect()
+    CONNECTED,      // Associated and holding an IP
+    RECONNECTING,   // Link dropped; retrying
+    BACKOFF         // Every network failed this round; waiting to retry
+};
+
+// Events reported to the application
+enum class WiFiManagerEvent : uint8_t {
+    STATE_CHANGED,
+    CONNECTED,
+    DISCONNECTED,
+    SCAN_DONE,
+    HOST_RESOLVED
+};
+
+using WiFiManagerCallback = std::function<void(WiFiManagerEvent event)>;
+
+/**
+ * @brief One access point seen by a scan
+ */
+struct WiFiScanEntry {
+    char ssid[WIFI_SSID_MAX + 1];
+    uint8_t bssid[6];
+    uint8_t channel;
+    wifi_auth_mode_t encryption;
+    int8_t rssi_history[WIFI_RSSI_HISTORY];     // Newest at rssi_head - 1
+    uint8_t rssi_count;
+    uint8_t rssi_head;
+    uint32_t last_seen_ms;
+
+    int8_t getRssi() const;
+    int8_t getAverageRssi() const;
+};
+
+/**
+ * @brief Addresses from a DHCP lease, for reuse without a DHCP exchange
+ */
+struct WiFiLease {
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    uint32_t renew_s;           // Seconds until renewal is due (T1)
+};
+
+/**
+ * @brief A network the device may join
+ */
+struct WiFiNetworkProfile {
+    char ssid[WIFI_SSID_MAX + 1];
+    char password[WIFI_PASSWORD_MAX + 1];
+
+    // Fast-reconnect target, learned from the last successful join
+    bool has_fast_path;
+    uint8_t bssid[6];
+    uint8_t channel;
+
+    // Lease for the next fast join only (skips DHCP)
+    bool has_lease;
+    WiFiLease lease;
+
+    uint8_t failures;           // Consecutive failed joins
+    uint32_t last_connected_ms;
+};
+
+class WiFiManager {
+public:
+    WiFiManager();
+    ~WiFiManager();
+
+    // Disable copy
+    WiFiManager(const WiFiManager&) = delete;
+    WiFiManager& operator=(const WiFiManager&) = delete;
+
+    /**
+     * @brief Put the radio in station mode and subscribe to WiFi events
+     * @param timers Wheel used for connect timeouts and retry back-off
+     */
+    bool begin(TimerWheel* timers);
+    void end();
+
+    // Wake the main loop when a system event is queued
+    void setNotifier(const LoopNotifier& notifier) { notifier_ = notifier; }
+    void onEvent(WiFiManagerCallback callback) { event_callback_ = callback; }
+
+    /**
+     * @brief Add a known network, or update the password of one
+     * @return false if the list is full or the SSID is invalid
+     */
+    bool addNetwork(const char* ssid, const char* password);
+    void clearNetworks();
+    size_t getNetworkCount() const { return network_count_; }
+    const WiFiNetworkProfile* getNetwork(size_t index) const;
+
+    /**
+     * @brief Seed the fast-reconnect target of a known network (e.g. from
+     *        the boot cache), so its first join skips the channel scan
+     */
+    bool setFastPath(const char* ssid, const uint8_t* bssid, uint8_t channel);
+
+    /**
+     * @brief Offer a still-valid lease for the next fast join of ssid
+     *
+     * The join then holds the address statically instead of running DHCP,
+     * and rejoins through DHCP once the lease is due for renewal. Used
+     * once; a failed fast join falls back to DHCP.
+     */
+    bool setCachedLease(const char* ssid, const WiFiLease& lease);
+
+    /**
+     * @brief Lease of the current link, if it was obtained through DHCP
+     */
+    bool getLease(WiFiLease& lease) const;
+    bool isUsingCachedLease() const { return static_ip_; }
+
+    /**
+     * @brief If the link is on a cached lease, rejoin through DHCP (e.g.
+     *        when nothing is reachable with the cached addresses)
+     */
+    void renewLease();
+
+    /**
+     * @brief Start joining the best known network (no-op if already
+     *        connected or connecting)
+     *
+     * Returns true without emitting CONNECTED again when the link is
+     * already up; callers waiting for that event must check isConnected().
+     */
+    bool connect();
+
+    /**
+     * @brief Drop the link and stop retrying
+     */
+    void disconnect();
+
+    /**
+     * @brief Start a background scan; SCAN_DONE is reported when finished
+     * @return false if a scan cannot start now (e.g. mid-association)
+     */
+    bool startScan();
+    bool isScanning() const { return scanning_; }
+
+    /**
+     * @brief Start a DNS lookup; HOST_RESOLVED is reported when it ends
+     * @return false if a lookup is already running or can't be started
+     */
+    bool resolveHost(const char* host);
+    const char* getResolvedHost() const { return resolve_host_; }
+    uint32_t getResolvedIp() const { return resolved_ip_; }    // 0 = failed
+
+    // Scan cache, strongest (averaged) first
+    size_t getScanCount() const { return scan_count_; }
+    const WiFiScanEntry* getScanEntry(size_t index) const;
+
+    /**
+     * @brief Handle queued system events (call on LOOP_SIGNAL_WIFI)
+     */
+    void update();
+
+    WiFiLinkState getState() const { return state_; }
+    bool isConnected() const { return state_ == WiFiLinkState::CONNECTED; }
+    const char* getSsid() const;
+    int8_t getRssi() const;
+
+    // Time from connect()/link loss to association and to holding an IP,
+    // for the last join
+    uint32_t getLastAssocMs() const { return last_assoc_ms_; }
+    uint32_t getLastJoinMs() const { return last_join_ms_; }
+    bool isLastJoinFast() const { return last_join_fast_; }     // Cached BSSID/channel
+    uint32_t getReconnectCount() const { return reconnect_count_; }
+
+    const char* getLastError() const { return last_error_; }
+
+private:
+    // System event, as queued by the event task
+    struct SystemEvent {
+        arduino_event_id_t id;
+        uint8_t reason;         // Disconnect reason
+        uint32_t address;       // Lookup result
+    };
+
+    WiFiNetworkProfile networks_[WIFI_MAX_NETWORKS];
+    size_t network_count_;
+    uint8_t rank_[WIFI_MAX_NETWORKS];   // Indices into networks_, best first
+
+    WiFiScanEntry scan_cache_[WIFI_SCAN_CACHE_SIZE];
+    size_t scan_count_;
+    bool scanning_;
+
+    WiFiLinkState state_;
+    size_t target_;             // Position in rank_ being tried
+    uint8_t attempt_;           // Attempts on the current target
+    uint8_t round_;             // Full passes over rank_ without success
+    bool fast_attempt_;
+    bool static_ip_;            // Joined on a cached lease
+    bool last_join_fast_;
+    uint32_t lease_renew_s_;
+    uint32_t link_lost_ms_;
+    uint32_t last_assoc_ms_;
+    uint32_t last_join_ms_;
+    uint32_t reconnect_count_;
+
+    TimerWheel* timers_;
+    TimerId attempt_timer_;
+    TimerId retry_timer_;
+    TimerId renew_timer_;
+
+    char resolve_host_[WIFI_HOST_MAX + 1];
+    uint32_t resolved_ip_;
+    bool resolving_;
+
+    QueueHandle_t event_queue_;
+    wifi_event_id_t event_handle_;
+    LoopNotifier notifier_;
+    WiFiManagerCallback event_callback_;
+    char last_error_[64];
+
+    static WiFiManager* instance_;
+
+    void setState(WiFiLinkState state);
+    void emit(WiFiManagerEvent event);
+
+    void rankNetworks();
+    int scoreNetwork(const WiFiNetworkProfile& network) const;
+    WiFiNetworkProfile& currentNetwork() { return networks_[rank_[target_]]; }
+
+    void startAttempt();
+    void attemptFailed(uint8_t reason);
+    void handleGotIp();
+    void handleDisconnected(uint8_t reason);
+    void handleScanDone();
+    void mergeScanResults(int16_t count);
+    WiFiNetworkProfile* findNetwork(const char* ssid);
+
+    static void systemEventHandler(arduino_event_t* event);
+    static void attemptTimeout(void* ctx);
+    static void retryTimer(void* ctx);
+    static void renewTimer(void* ctx);
+    static void startLookup(void* ctx);
+    static void lookupDone(const char* name, const ip_addr_t* address, void* ctx);
+};
+
+// Utility functions
+const char* wifiLinkStateToString(WiFiLinkState state);
+const char* wifiManagerEventToString(WiFiManagerEvent event);
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_WIFI_MANAGER_H
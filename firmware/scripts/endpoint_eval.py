@@ -0,0 +1,331 @@
+#!/usr/bin/env python3
+"""
+End-of-utterance evaluation
+Replays a corpus of voice turns through the firmware's Endpointer
+(src/endpointer.cpp, built for the host and loaded with ctypes) behind the
+same VAD as AudioStreamer, and compares hangover settings:
+  end latency     speech end to the final frame
+  STT start       speech end to the surviving "likely final" hint (or the
+                  final frame when there is none): when the bridge can
+                  start transcribing
+  ready           speech end until the turn is closed and its transcript
+                  is in, for transcription taking --stt-ms
+  truncated       turns cut in two by a final frame in a mid-turn pause
+  hints withdrawn speculative transcriptions thrown away per turn
+
+Corpus: a directory with one subdirectory per speaker, each holding one
+16-bit WAV per turn (16 kHz mono, or the first channel is used). A
+speaker's turns are replayed in name order so pause statistics carry over.
+Without --corpus a synthetic corpus of frame energies is generated.
+
+Run from the firmware directory:
+  python scripts/endpoint_eval.py --corpus ~/turns
+  python scripts/endpoint_eval.py --speakers 30 --turns 25
+"""
+
+import argparse
+import array
+import ctypes
+import math
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import wave
+
+ENDPOINTER_SOURCE = "src/endpointer.cpp"
+INCLUDE_DIR = "include"
+
+# EndpointEvent values (include/endpointer.h)
+EVENT_NONE, EVENT_LIKELY_FINAL, EVENT_RESUMED, EVENT_FINAL = range(4)
+
+SHIM = r"""
+#include "endpointer.h"
+using namespace OpenClaw;
+
+extern "C" {
+void* ep_new(int hangover, int min_hangover, int max_hangover, int adaptive, int hint) {
+    EndpointerConfig config;
+    config.hangover_ms = hangover;
+    config.min_hangover_ms = min_hangover;
+    config.max_hangover_ms = max_hangover;
+    config.adaptive = adaptive != 0;
+    config.hint = hint != 0;
+    return new Endpointer(config);
+}
+void ep_free(void* ep) { delete static_cast<Endpointer*>(ep); }
+void ep_start(void* ep, uint32_t now_ms) { static_cast<Endpointer*>(ep)->startUtterance(now_ms); }
+int ep_update(void* ep, int is_speech, float rms, int frame_ms, uint32_t now_ms) {
+    return static_cast<int>(static_cast<Endpointer*>(ep)->update(is_speech != 0, rms, frame_ms, now_ms));
+}
+}
+"""
+
+# (name, hangover_ms, adaptive, hint)
+SETTINGS = [
+    ("fixed 300", 300, False, False),
+    ("fixed 400", 400, False, False),
+    ("fixed 500", 500, False, False),
+    ("fixed 600", 600, False, False),
+    ("fixed 700", 700, False, False),
+    ("fixed 500+hint", 500, False, True),
+    ("adaptive", 500, True, False),
+    ("adaptive+hint", 500, True, True),
+]
+
+
+def build_library(workdir):
+    """Compile the endpointer and the C shim into a shared library."""
+    shim_path = os.path.join(workdir, "endpointer_shim.cpp")
+    lib_path = os.path.join(workdir, "libendpointer.so")
+    with open(shim_path, "w") as f:
+        f.write(SHIM)
+    compiler = os.environ.get("CXX", "c++")
+    cmd = [compiler, "-std=c++17", "-O2", "-shared", "-fPIC", "-I", INCLUDE_DIR,
+           ENDPOINTER_SOURCE, shim_path, "-o", lib_path]
+    result = subprocess.run(cmd, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.exit(f"Building the endpointer failed:\n{result.stderr}")
+
+    lib = ctypes.CDLL(lib_path)
+    lib.ep_new.restype = ctypes.c_void_p
+    lib.ep_new.argtypes = [ctypes.c_int] * 5
+    lib.ep_free.argtypes = [ctypes.c_void_p]
+    lib.ep_start.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    lib.ep_update.restype = ctypes.c_int
+    lib.ep_update.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_float, ctypes.c_int, ctypes.c_uint32]
+    return lib
+
+
+# -----------------------------------------------------------------------------
+# Corpus
+# -----------------------------------------------------------------------------
+
+def wav_frame_rms(path, frame_ms):
+    """Per-frame RMS of a WAV file (first channel)."""
+    with wave.open(path, "rb") as w:
+        if w.getsampwidth() != 2:
+            sys.exit(f"{path}: only 16-bit WAV is supported")
+        if w.getframerate() != 16000:
+            print(f"Warning: {path} is {w.getframerate()} Hz, expected 16000", file=sys.stderr)
+        channels = w.getnchannels()
+        samples = array.array("h", w.readframes(w.getnframes()))
+        rate = w.getframerate()
+    if sys.byteorder == "big":
+        samples.byteswap()
+    if channels > 1:
+        samples = samples[::channels]
+
+    per_frame = rate * frame_ms // 1000
+    rms = []
+    for start in range(0, len(samples) - per_frame + 1, per_frame):
+        chunk = samples[start:start + per_frame]
+        rms.append(math.sqrt(sum(s * s for s in chunk) / per_frame))
+    return rms
+
+
+def load_corpus(root, frame_ms):
+    """{speaker: [frame RMS list per turn]}"""
+    corpus = {}
+    for speaker in sorted(os.listdir(root)):
+        folder = os.path.join(root, speaker)
+        if not os.path.isdir(folder):
+            continue
+        turns = [wav_frame_rms(os.path.join(folder, name), frame_ms)
+                 for name in sorted(os.listdir(folder)) if name.lower().endswith(".wav")]
+        if turns:
+            corpus[speaker] = turns
+    if not corpus:
+        sys.exit(f"{root}: no speaker directories with WAV files")
+    return corpus
+
+
+def synthetic_corpus(speakers, turns, frame_ms, seed):
+    """Frame energies of made-up turns: words with level jitter, gamma
+    pauses whose mean differs per speaker, occasional hesitations and
+    sentence breaks, and words that often trail off before a pause."""
+    rng = random.Random(seed)
+    tick_ms = 10
+    corpus = {}
+
+    for s in range(speakers):
+        pause_mean = rng.uniform(60, 240)
+        hesitation_rate = rng.uniform(0.01, 0.05)
+        level_db = rng.uniform(62, 72)
+        noise_db = rng.uniform(38, 46)
+        speaker_turns = []
+
+        for _ in range(turns):
+            ticks = []
+
+            def silence(ms):
+                for _ in range(int(ms / tick_ms)):
+                    ticks.append(noise_db + rng.uniform(-3, 3))
+
+            def word(trails_off):
+                length = int(rng.uniform(180, 520) / tick_ms)
+                level = level_db + rng.gauss(0, 3)
+                fade = int(rng.uniform(150, 300) / tick_ms) if trails_off else 0
+                drop = rng.uniform(15, 25)
+                for i in range(length):
+                    db = level + rng.uniform(-3, 3)
+                    into_fade = i - (length - fade)
+                    if fade and into_fade >= 0:
+                        db -= drop * (into_fade + 1) / fade
+                    ticks.append(max(db, noise_db))
+
+            silence(300)
+            sentences = 1 if rng.random() < 0.85 else 2
+            for sentence in range(sentences):
+                words = rng.randint(3, 10)
+                for w in range(words):
+                    last_word = w == words - 1
+                    word(trails_off=rng.random() < (0.75 if last_word else 0.2))
+                    if last_word:
+                        if sentence < sentences - 1:
+                            silence(rng.uniform(pause_mean + 100, pause_mean + 500))
+                    elif rng.random() < hesitation_rate:
+                        silence(min(rng.uniform(pause_mean + 200, pause_mean + 550), 800))
+                    else:
+                        silence(rng.gammavariate(3.0, pause_mean / 3.0))
+            silence(2000)
+
+            # Ticks to frames: mean power over the frame, as RMS
+            per_frame = max(1, frame_ms // tick_ms)
+            frames = []
+            for start in range(0, len(ticks) - per_frame + 1, per_frame):
+                power = sum(10 ** (db / 10) for db in ticks[start:start + per_frame]) / per_frame
+                frames.append(math.sqrt(power))
+            speaker_turns.append(frames)
+
+        corpus[f"synthetic-{s:02d}"] = speaker_turns
+    return corpus
+
+
+# -----------------------------------------------------------------------------
+# Replay
+# -----------------------------------------------------------------------------
+
+def percentile(samples, pct):
+    if not samples:
+        return 0.0
+    ordered = sorted(samples)
+    return ordered[min(len(ordered) - 1, int(round(pct / 100 * (len(ordered) - 1))))]
+
+
+def replay(lib, corpus, setting, args):
+    """Run every speaker's turns through one endpointer per speaker."""
+    _, hangover, adaptive, hint = setting
+    frame_ms = args.frame_ms
+    end_latency = []
+    stt_start = []
+    ready = []
+    truncated = 0
+    withdrawn = 0
+    turn_count = 0
+
+    for turns in corpus.values():
+        ep = lib.ep_new(hangover, args.min_hangover_ms, args.max_hangover_ms, int(adaptive), int(hint))
+        now = 0
+        for frames in turns:
+            voiced = [i for i, rms in enumerate(frames) if rms > args.threshold]
+            if not voiced:
+                now += len(frames) * frame_ms
+                continue
+            true_end = now + (voiced[-1] + 1) * frame_ms
+            turn_count += 1
+
+            # AudioStreamer::updateVAD, with the endpointer behind it
+            state = "silence"
+            voice_start = 0
+            finals = []
+            hint_at = None
+            for rms in frames:
+                is_speech = rms > args.threshold
+                if state == "silence":
+                    if is_speech:
+                        state, voice_start = "start", now
+                elif state == "start":
+                    if not is_speech:
+                        state = "silence"
+                    elif now - voice_start >= args.min_voice_ms:
+                        state = "active"
+                        lib.ep_start(ep, voice_start)
+                else:
+                    event = lib.ep_update(ep, int(is_speech), rms, frame_ms, now)
+                    if event == EVENT_FINAL:
+                        state = "silence"
+                        finals.append(now)
+                    elif event == EVENT_LIKELY_FINAL:
+                        hint_at = now
+                    elif event == EVENT_RESUMED:
+                        hint_at = None
+                        withdrawn += 1
+                now += frame_ms
+
+            if any(t < true_end for t in finals):
+                truncated += 1
+            ending = [t for t in finals if t >= true_end]
+            if not ending:
+                continue
+            end_latency.append(ending[0] - true_end)
+            if hint_at is not None and hint_at >= true_end:
+                stt_start.append(hint_at - true_end)
+            else:
+                stt_start.append(ending[0] - true_end)
+            ready.append(max(end_latency[-1], stt_start[-1] + args.stt_ms))
+        lib.ep_free(ep)
+
+    return {
+        "turns": turn_count,
+        "truncated": truncated / turn_count if turn_count else 0.0,
+        "end_p50": percentile(end_latency, 50),
+        "end_p90": percentile(end_latency, 90),
+        "stt_p50": percentile(stt_start, 50),
+        "stt_p90": percentile(stt_start, 90),
+        "ready_p50": percentile(ready, 50),
+        "ready_p90": percentile(ready, 90),
+        "withdrawn": withdrawn / turn_count if turn_count else 0.0,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Evaluate end-of-utterance detection")
+    parser.add_argument("--corpus", help="directory of speaker directories of WAV turns")
+    parser.add_argument("--speakers", type=int, default=30, help="synthetic speakers")
+    parser.add_argument("--turns", type=int, default=25, help="synthetic turns per speaker")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--frame-ms", type=int, default=60)
+    parser.add_argument("--threshold", type=float, default=500.0, help="VAD RMS threshold")
+    parser.add_argument("--min-voice-ms", type=int, default=200)
+    parser.add_argument("--min-hangover-ms", type=int, default=200)
+    parser.add_argument("--max-hangover-ms", type=int, default=900)
+    parser.add_argument("--stt-ms", type=int, default=400, help="transcription time for 'ready'")
+    args = parser.parse_args()
+
+    if not os.path.exists(ENDPOINTER_SOURCE):
+        sys.exit("Run from the firmware directory")
+
+    if args.corpus:
+        corpus = load_corpus(args.corpus, args.frame_ms)
+        source = args.corpus
+    else:
+        corpus = synthetic_corpus(args.speakers, args.turns, args.frame_ms, args.seed)
+        source = f"synthetic (seed {args.seed})"
+
+    with tempfile.TemporaryDirectory() as workdir:
+        lib = build_library(workdir)
+        total = sum(len(turns) for turns in corpus.values())
+        print(f"Corpus: {source}, {len(corpus)} speakers, {total} turns, {args.frame_ms} ms frames")
+        print(f"{'setting':<15} {'truncated':>9} {'end p50':>8} {'end p90':>8} "
+              f"{'STT p50':>8} {'STT p90':>8} {'ready p50':>10} {'ready p90':>10} {'withdrawn':>10}")
+        for setting in SETTINGS:
+            row = replay(lib, corpus, setting, args)
+            print(f"{setting[0]:<15} {row['truncated']:>8.1%} {row['end_p50']:>6.0f}ms "
+                  f"{row['end_p90']:>6.0f}ms {row['stt_p50']:>6.0f}ms {row['stt_p90']:>6.0f}ms "
+                  f"{row['ready_p50']:>8.0f}ms {row['ready_p90']:>8.0f}ms {row['withdrawn']:>10.2f}")
+
+
+if __name__ == "__main__":
+    main()
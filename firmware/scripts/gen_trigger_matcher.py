@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""
+Trigger matcher generator
+Compiles scripts/trigger_phrases.txt into an Aho-Corasick DFA:
+  include/trigger_ids.h     TriggerId enum
+  src/trigger_tables.inc    character classes, transitions, outputs
+
+Run from the firmware directory (pre_build.py does this before every
+build; outputs are only rewritten when the table or this script change).
+"""
+
+import os
+import sys
+from collections import OrderedDict, deque
+
+PHRASES_SOURCE = "scripts/trigger_phrases.txt"
+IDS_DEST = "include/trigger_ids.h"
+TABLES_DEST = "src/trigger_tables.inc"
+
+MAX_TRIGGER_IDS = 32    # TriggerMask is 32 bits
+
+
+def parse_phrases(path):
+    """Return an ordered {trigger_id: [phrase, ...]} map."""
+    triggers = OrderedDict()
+    with open(path) as f:
+        for line_no, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            parts = line.split(None, 1)
+            if len(parts) != 2:
+                sys.exit(f"{path}:{line_no}: expected '<TRIGGER_ID> <phrase>'")
+            trigger_id, phrase = parts[0], parts[1].lower()
+            if not trigger_id.isidentifier() or not trigger_id.isupper():
+                sys.exit(f"{path}:{line_no}: trigger ID must be UPPER_CASE")
+            if any(ord(c) > 126 for c in phrase):
+                sys.exit(f"{path}:{line_no}: phrases must be ASCII")
+            triggers.setdefault(trigger_id, []).append(phrase)
+    if len(triggers) > MAX_TRIGGER_IDS:
+        sys.exit(f"{path}: at most {MAX_TRIGGER_IDS} trigger IDs")
+    return triggers
+
+
+def build_automaton(triggers):
+    """Build the DFA over character classes.
+
+    Class 0 is every byte that appears in no phrase; upper-case letters
+    share the class of their lower-case form.
+    """
+    alphabet = sorted({c for phrases in triggers.values() for p in phrases for c in p})
+    char_class = [0] * 256
+    for i, c in enumerate(alphabet, 1):
+        char_class[ord(c)] = i
+        if c.isalpha():
+            char_class[ord(c.upper())] = i
+    class_count = len(alphabet) + 1
+
+    # Trie of all phrases
+    goto = [{}]
+    output = [0]
+    for bit, phrases in enumerate(triggers.values()):
+        for phrase in phrases:
+            state = 0
+            for c in phrase:
+                cls = char_class[ord(c)]
+                if cls not in goto[state]:
+                    goto.append({})
+                    output.append(0)
+                    goto[state][cls] = len(goto) - 1
+                state = goto[state][cls]
+            output[state] |= 1 << bit
+
+    # Failure links in BFS order, folded straight into full transitions
+    state_count = len(goto)
+    fail = [0] * state_count
+    delta = [[0] * class_count for _ in range(state_count)]
+    queue = deque()
+    for cls in range(class_count):
+        nxt = goto[0].get(cls)
+        if nxt is not None:
+            delta[0][cls] = nxt
+            queue.append(nxt)
+    while queue:
+        state = queue.popleft()
+        output[state] |= output[fail[state]]
+        for cls in range(class_count):
+            nxt = goto[state].get(cls)
+            if nxt is None:
+                delta[state][cls] = delta[fail[state]][cls]
+            else:
+                fail[nxt] = delta[fail[state]][cls]
+                delta[state][cls] = nxt
+                queue.append(nxt)
+
+    return char_class, class_count, delta, output
+
+
+def c_array(values, per_line=16, width=0):
+    lines = []
+    for i in range(0, len(values), per_line):
+        chunk = values[i:i + per_line]
+        lines.append("    " + ", ".join(str(v).rjust(width) for v in chunk) + ",")
+    return "\n".join(lines)
+
+
+def smallest_uint(max_value):
+    for bits in (8, 16, 32):
+        if max_value < (1 << bits):
+            return f"uint{bits}_t"
+    sys.exit("value too large for the tables")
+
+
+def render_ids(triggers):
+    enumerators = "\n".join(f"    {name}," for name in triggers)
+    return f"""/**
+ * @file trigger_ids.h
+ * @brief Trigger phrase IDs
+ *
+ * Generated by scripts/gen_trigger_matcher.py from
+ * scripts/trigger_phrases.txt. Do not edit.
+ */
+
+#ifndef OPENCLAW_TRIGGER_IDS_H
+#define OPENCLAW_TRIGGER_IDS_H
+
+#include <cstdint>
+
+namespace OpenClaw {{
+
+enum class TriggerId : uint8_t {{
+{enumerators}
+}};
+
+constexpr uint8_t TRIGGER_ID_COUNT = {len(triggers)};
+
+}} // namespace OpenClaw
+
+#endif // OPENCLAW_TRIGGER_IDS_H
+"""
+
+
+def render_tables(triggers, char_class, class_count, delta, output):
+    state_count = len(delta)
+    state_type = smallest_uint(state_count - 1)
+    output_type = smallest_uint(max(output))
+    phrase_count = sum(len(p) for p in triggers.values())
+    rows = "\n".join("    {" + ", ".join(str(v) for v in row) + "},"
+                     for row in delta)
+    names = "\n".join(f'    "{name}",' for name in triggers)
+    return f"""// Generated by scripts/gen_trigger_matcher.py from
+// scripts/trigger_phrases.txt. Do not edit.
+//
+// Aho-Corasick DFA for {phrase_count} phrases: {state_count} states x {class_count} character classes.
+// Included by trigger_matcher.cpp only.
+
+using TriggerState = {state_type};
+using TriggerOutput = {output_type};
+
+static constexpr size_t TRIGGER_STATE_COUNT = {state_count};
+static constexpr size_t TRIGGER_CLASS_COUNT = {class_count};
+
+// Byte -> character class (upper case folded onto lower case)
+static const uint8_t TRIGGER_CHAR_CLASS[256] = {{
+{c_array(char_class, 16, 2)}
+}};
+
+// Next state for each (state, class)
+static const TriggerState TRIGGER_NEXT[TRIGGER_STATE_COUNT][TRIGGER_CLASS_COUNT] = {{
+{rows}
+}};
+
+// Trigger bits completed on entering each state
+static const TriggerOutput TRIGGER_OUTPUT[TRIGGER_STATE_COUNT] = {{
+{c_array(output, 16)}
+}};
+
+static const char* const TRIGGER_NAMES[TRIGGER_ID_COUNT] = {{
+{names}
+}};
+"""
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path):
+        with open(path) as f:
+            if f.read() == text:
+                return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(text)
+    return True
+
+
+def generate():
+    triggers = parse_phrases(PHRASES_SOURCE)
+    char_class, class_count, delta, output = build_automaton(triggers)
+
+    changed = write_if_changed(IDS_DEST, render_ids(triggers))
+    changed |= write_if_changed(
+        TABLES_DEST, render_tables(triggers, char_class, class_count, delta, output))
+    if changed:
+        print(f"Generated trigger matcher: {len(triggers)} IDs, {len(delta)} states")
+
+
+if __name__ == "__main__":
+    generate()
@@ -1,11 +1,13 @@
 #!/usr/bin/env python3
 """
 Pre-build script for PlatformIO
-Copies config.json to the firmware filesystem image
+Copies config.json to the firmware filesystem image and regenerates the
+trigger phrase matcher tables
 """
 
 import os
 import shutil
+import subprocess
 import sys
 
 Import("env")
@@ -26,4 +28,9 @@ def copy_config():
         with open(CONFIG_DEST, "w") as f:
             f.write('{}')
 
+def generate_trigger_matcher():
+    """Compile trigger_phrases.txt into the Aho-Corasick tables."""
+    subprocess.check_call([sys.executable, "scripts/gen_trigger_matcher.py"])
+
 copy_config()
+generate_trigger_matcher()
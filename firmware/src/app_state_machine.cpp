@@ -1,211 +1,237 @@
 /**
  * @file app_state_machine.cpp
- * @brief Application state machine implementation (stub)
+ * @brief Application state machine implementation
  */
 
 #include "app_state_machine.h"
 
 namespace OpenClaw {
 
-// State class implementation
-State::State(AppState id, const char* name)
-    : id_(id),
-      name_(name),
-      entry_action_(nullptr),
-      exit_action_(nullptr),
-      update_action_(nullptr),
-      timeout_ms_(0),
-      timeout_state_(AppState::BOOT),
+AppStateMachine::AppStateMachine()
+    : spec_(nullptr),
+      current_state_id_(AppState::BOOT),
+      previous_state_id_(AppState::BOOT),
       entry_time_(0),
-      last_activity_time_(0) {
+      failed_mask_(0),
+      dropped_events_(0),
+      on_state_change_(nullptr),
+      pending_(false),
+      pending_target_(AppState::BOOT),
+      pending_due_(0),
+      timers_(nullptr),
+      timeout_timer_(INVALID_TIMER_ID),
+      pending_timer_(INVALID_TIMER_ID),
+      transitioning_(false) {
 }
 
-void State::addTransition(const Transition& transition) {
-    transitions_.push_back(transition);
-}
+AppStateMachine::~AppStateMachine() = default;
 
-void State::addTransition(AppEvent event, AppState target, 
-                          GuardCondition guard, StateAction action) {
-    transitions_.emplace_back(event, target, guard, action);
+bool AppStateMachine::begin(const MachineSpec* spec, TimerWheel* timers) {
+    if (!spec || !timers || !spec->declared[static_cast<size_t>(spec->initial)]) return false;
+    
+    spec_ = spec;
+    timers_ = timers;
+    failed_mask_ = 0;
+    pending_ = false;
+    current_state_id_ = spec_->initial;
+    previous_state_id_ = spec_->initial;
+    enterState(current_state_id_);
+    return true;
 }
 
-void State::setTimeout(uint32_t timeout_ms, AppState timeout_state) {
-    timeout_ms_ = timeout_ms;
-    timeout_state_ = timeout_state;
+void AppStateMachine::end() {
+    if (spec_) {
+        exitState(current_state_id_);
+    }
+    if (timers_) {
+        timers_->cancel(&timeout_timer_);
+        timers_->cancel(&pending_timer_);
+    }
+    spec_ = nullptr;
+    pending_ = false;
 }
 
-void State::setRetryDelay(uint32_t delay_ms) {
-    retry_delay_ms_ = delay_ms;
+void AppStateMachine::update() {
+    if (!spec_ || transitioning_) return;
+    
+    processEvents();
 }
 
-void State::onEntry() {
-    entry_time_ = millis();
-    last_activity_time_ = entry_time_;
-    
-    // Apply retry delay
-    if (retry_delay_ms_ > 0) {
-        delay(retry_delay_ms_);
-        retry_delay_ms_ = 0;
+bool AppStateMachine::transitionTo(AppState target) {
+    if (!spec_ || transitioning_) return false;
+    if (target == current_state_id_) {
+        // Internal transition: no exit/entry, but the timeout starts over
+        // (a second prompt while AI_PROCESSING gets its own deadline)
+        entry_time_ = millis();
+        armTimeout();
+        return true;
     }
+    size_t t = static_cast<size_t>(target);
+    if (!spec_->declared[t]) return false;
     
-    if (entry_action_) {
-        entry_action_();
+    // Retry back-off: re-entering a state with an entry delay, after its
+    // last visit ended in an error state, is deferred to a timer instead
+    // of stalling the loop. The first reconnect after a drop is not held.
+    // A later transition to a different state replaces it; a repeat keeps
+    // the original deadline.
+    if ((failed_mask_ & (1UL << t)) && spec_->entry_delay_ms[t] > 0) {
+        if (!pending_ || pending_target_ != target) {
+            timers_->cancel(&pending_timer_);
+            pending_ = true;
+            pending_target_ = target;
+            pending_due_ = millis() + spec_->entry_delay_ms[t];
+            pending_timer_ = timers_->schedule(spec_->entry_delay_ms[t],
+                                               pendingTimerCallback, this);
+        }
+        return true;
     }
+    
+    commitTransition(target);
+    return true;
 }
 
-void State::onExit() {
-    if (exit_action_) {
-        exit_action_();
+void AppStateMachine::commitTransition(AppState target) {
+    transitioning_ = true;
+    pending_ = false;
+    timers_->cancel(&pending_timer_);
+    timers_->cancel(&timeout_timer_);
+    
+    // Remember whether this visit failed, for the retry back-off
+    uint32_t bit = 1UL << static_cast<size_t>(current_state_id_);
+    if (isErrorState(target)) {
+        failed_mask_ |= bit;
+    } else {
+        failed_mask_ &= ~bit;
     }
-}
-
-void State::onUpdate() {
-    if (update_action_) {
-        update_action_();
+    
+    exitState(current_state_id_);
+    
+    previous_state_id_ = current_state_id_;
+    current_state_id_ = target;
+    
+    enterState(current_state_id_);
+    
+    if (on_state_change_) {
+        on_state_change_(previous_state_id_, current_state_id_);
     }
+    
+    transitioning_ = false;
 }
 
-bool State::handleEvent(const StateMachineEvent& event, AppState& out_target) {
-    for (auto& t : transitions_) {
-        if (t.event == event.type) {
-            if (!t.guard || t.guard()) {
-                if (t.action) {
-                    t.action();
-                }
-                out_target = t.target_state;
-                return true;
-            }
-        }
+bool AppStateMachine::postEvent(const StateMachineEvent& event) {
+    if (!event_queue_.push(event)) {
+        dropped_events_++;
+        return false;
     }
-    return false;
+    return true;
 }
 
-bool State::checkTimeout(uint32_t current_time, AppState& out_target) {
-    if (timeout_ms_ > 0 && (current_time - entry_time_) >= timeout_ms_) {
-        out_target = timeout_state_;
-        return true;
-    }
-    return false;
+bool AppStateMachine::postEvent(AppEvent type, void* data, size_t data_size) {
+    return postEvent(StateMachineEvent(type, data, data_size));
 }
 
-void State::resetTimeout() {
-    entry_time_ = millis();
+const char* AppStateMachine::getCurrentStateName() const {
+    return appStateToString(current_state_id_);
 }
 
-uint32_t State::getTimeInState() const {
+uint32_t AppStateMachine::getTimeInCurrentState() const {
     return millis() - entry_time_;
 }
 
-// AppStateMachine implementation
-AppStateMachine::AppStateMachine()
-    : current_state_id_(AppState::BOOT),
-      previous_state_id_(AppState::BOOT),
-      current_state_(nullptr),
-      transitioning_(false) {
+uint32_t AppStateMachine::getPendingDelayRemaining() const {
+    if (!pending_) return 0;
+    int32_t remaining = (int32_t)(pending_due_ - millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
 }
 
-AppStateMachine::~AppStateMachine() = default;
-
-bool AppStateMachine::begin() {
-    current_state_ = findState(current_state_id_);
-    if (current_state_) {
-        current_state_->onEntry();
-    }
-    return true;
+void AppStateMachine::forceTransition(AppState target) {
+    if (!spec_ || transitioning_ || target == current_state_id_) return;
+    if (!spec_->declared[static_cast<size_t>(target)]) return;
+    commitTransition(target);
 }
 
-void AppStateMachine::end() {
-    if (current_state_) {
-        current_state_->onExit();
+void AppStateMachine::processEvents() {
+    if (!spec_) return;
+    
+    StateMachineEvent event;
+    while (event_queue_.pop(event)) {
+        dispatch(event.type);
     }
 }
 
-void AppStateMachine::update() {
-    if (!current_state_ || transitioning_) return;
-    
-    current_state_->onUpdate();
+bool AppStateMachine::dispatch(AppEvent event) {
+    size_t e = static_cast<size_t>(event);
+    if (e >= APP_EVENT_COUNT) return false;
     
-    // Check timeout
-    AppState timeout_target;
-    if (current_state_->checkTimeout(millis(), timeout_target)) {
-        transitionTo(timeout_target);
-    }
+    const TransitionSlot& slot = spec_->transitions[static_cast<size_t>(current_state_id_)][e];
+    if (slot.target == MachineSpec::NO_TRANSITION) return false;
+    if (slot.fire && !slot.fire()) return false;
     
-    processEvents();
+    return transitionTo(static_cast<AppState>(slot.target));
 }
 
-void AppStateMachine::addState(std::unique_ptr<State> state) {
-    if (state) {
-        states_[state->getId()] = std::move(state);
+void AppStateMachine::enterState(AppState state) {
+    size_t s = static_cast<size_t>(state);
+    entry_time_ = millis();
+    armTimeout();
+    
+    if (spec_->on_entry[s]) {
+        spec_->on_entry[s]();
     }
 }
 
-State* AppStateMachine::getState(AppState id) {
-    return findState(id);
+void AppStateMachine::armTimeout() {
+    timers_->cancel(&timeout_timer_);
+    uint32_t timeout = spec_->timeout_ms[static_cast<size_t>(current_state_id_)];
+    if (timeout > 0) {
+        timeout_timer_ = timers_->schedule(timeout, timeoutTimerCallback, this);
+    }
 }
 
-bool AppStateMachine::transitionTo(AppState target) {
-    if (transitioning_) return false;
-    if (target == current_state_id_) return true;
-    
-    State* target_state = findState(target);
-    if (!target_state) return false;
-    
-    transitioning_ = true;
-    
-    if (current_state_) {
-        current_state_->onExit();
-    }
+void AppStateMachine::handleTimeout() {
+    timeout_timer_ = INVALID_TIMER_ID;
     
-    previous_state_id_ = current_state_id_;
-    current_state_id_ = target;
-    current_state_ = target_state;
-    
-    current_state_->onEntry();
+    // A state already on its way out does not time out again
+    if (!spec_ || transitioning_ || pending_) return;
     
-    if (on_state_change_) {
-        on_state_change_(previous_state_id_, current_state_id_);
+    // Timeouts are ordinary TIMEOUT rows in the table
+    AppState before = current_state_id_;
+    dispatch(AppEvent::TIMEOUT);
+    if (current_state_id_ == before && !pending_ && timeout_timer_ == INVALID_TIMER_ID) {
+        entry_time_ = millis();  // Guarded; re-arm (a self-row already has)
+        armTimeout();
     }
-    
-    transitioning_ = false;
-    return true;
-}
-
-void AppStateMachine::postEvent(const StateMachineEvent& event) {
-    event_queue_.push_back(event);
-}
-
-void AppStateMachine::postEvent(AppEvent type, void* data, size_t data_size) {
-    event_queue_.emplace_back(type, data, data_size);
-}
-
-const char* AppStateMachine::getCurrentStateName() const {
-    return current_state_ ? current_state_->getName() : "UNKNOWN";
 }
 
-uint32_t AppStateMachine::getTimeInCurrentState() const {
-    return current_state_ ? current_state_->getTimeInState() : 0;
+void AppStateMachine::timeoutTimerCallback(void* ctx) {
+    static_cast<AppStateMachine*>(ctx)->handleTimeout();
 }
 
-void AppStateMachine::forceTransition(AppState target) {
-    transitionTo(target);
+void AppStateMachine::pendingTimerCallback(void* ctx) {
+    AppStateMachine* self = static_cast<AppStateMachine*>(ctx);
+    self->pending_timer_ = INVALID_TIMER_ID;
+    if (self->spec_ && self->pending_ && !self->transitioning_) {
+        self->commitTransition(self->pending_target_);
+    }
 }
 
-void AppStateMachine::processEvents() {
-    while (!event_queue_.empty()) {
-        StateMachineEvent event = event_queue_.front();
-        event_queue_.erase(event_queue_.begin());
-        
-        AppState target;
-        if (current_state_ && current_state_->handleEvent(event, target)) {
-            transitionTo(target);
-        }
+void AppStateMachine::exitState(AppState state) {
+    size_t s = static_cast<size_t>(state);
+    if (spec_->on_exit[s]) {
+        spec_->on_exit[s]();
     }
 }
 
-State* AppStateMachine::findState(AppState id) {
-    auto it = states_.find(id);
-    return (it != states_.end()) ? it->second.get() : nullptr;
+bool isErrorState(AppState state) {
+    switch (state) {
+        case AppState::CONFIG_ERROR_STATE:
+        case AppState::WIFI_ERROR_STATE:
+        case AppState::GATEWAY_ERROR_STATE:
+        case AppState::ERROR_STATE:
+            return true;
+        default:
+            return false;
+    }
 }
 
 const char* appStateToString(AppState state) {
@@ -17,8 +17,19 @@ static constexpr gpio_num_t I2S_BCLK = GPIO_NUM_6;
 static constexpr gpio_num_t I2S_WS = GPIO_NUM_7;
 static constexpr gpio_num_t I2S_DIN = GPIO_NUM_8;
 
+// Encoded queue item; the queue is sized from it so no field is cut off
+struct QueuePacket {
+    uint8_t data[2048];
+    size_t length;
+    uint32_t timestamp;
+    bool is_final;
+    EndpointEvent endpoint;
+    AudioCodec codec;
+};
+
 AudioStreamer::AudioStreamer()
     : config_(),
+      has_pending_config_(false),
       state_(AudioStreamState::IDLE),
       vad_state_(VADState::SILENCE),
       event_callback_(nullptr),
@@ -34,6 +45,8 @@ AudioStreamer::AudioStreamer()
       voice_frame_count_(0),
       total_frame_count_(0),
       current_rms_(0.0f),
+      endpointer_(),
+      endpoint_event_(EndpointEvent::NONE),
       frames_captured_(0),
       frames_streamed_(0),
       voice_events_(0),
@@ -51,6 +64,7 @@ AudioStreamer::~AudioStreamer() {
 
 bool AudioStreamer::begin(const AudioStreamerConfig& config) {
     config_ = config;
+    applyEndpointerConfig();
     
     if (!createQueues()) {
         strcpy(last_error_, "Failed to create queues");
@@ -62,16 +76,7 @@ bool AudioStreamer::begin(const AudioStreamerConfig& config) {
         return false;
     }
     
-    // Allocate buffers
-    size_t i2s_buffer_samples = config_.dma_buf_len * config_.dma_buf_count;
-    i2s_buffer_.reset(new int16_t[i2s_buffer_samples]);
-    
-    size_t frame_samples = (config_.sample_rate * config_.frame_duration_ms) / 1000;
-    frame_buffer_.reset(new int16_t[frame_samples]);
-    frame_buffer_pos_ = 0;
-    
-    if (!i2s_buffer_ || !frame_buffer_) {
-        strcpy(last_error_, "Failed to allocate buffers");
+    if (!allocateBuffers()) {
         return false;
     }
     
@@ -79,6 +84,42 @@ bool AudioStreamer::begin(const AudioStreamerConfig& config) {
     return true;
 }
 
+bool AudioStreamer::reconfigure(const AudioStreamerConfig& config) {
+    // Read per frame by the capture task
+    config_.mic_gain = config.mic_gain;
+    config_.vad_enabled = config.vad_enabled;
+    config_.vad_threshold = config.vad_threshold;
+    config_.vad_min_duration_ms = config.vad_min_duration_ms;
+    config_.vad_silence_ms = config.vad_silence_ms;
+    config_.vad_ratio = config.vad_ratio;
+    config_.vad_adaptive = config.vad_adaptive;
+    config_.vad_min_silence_ms = config.vad_min_silence_ms;
+    config_.vad_max_silence_ms = config.vad_max_silence_ms;
+    config_.vad_final_hint = config.vad_final_hint;
+    applyEndpointerConfig();
+    
+    bool format_changed =
+        config.sample_rate != config_.sample_rate ||
+        config.frame_duration_ms != config_.frame_duration_ms ||
+        config.codec != config_.codec ||
+        config.bits_per_sample != config_.bits_per_sample ||
+        config.channel_format != config_.channel_format ||
+        config.dma_buf_count != config_.dma_buf_count ||
+        config.dma_buf_len != config_.dma_buf_len;
+    if (!format_changed) {
+        has_pending_config_ = false;
+        return true;
+    }
+    
+    // The capture task sizes its frames at start; swap between captures
+    if (state_ != AudioStreamState::IDLE) {
+        pending_config_ = config;
+        has_pending_config_ = true;
+        return true;
+    }
+    return applyFormat(config);
+}
+
 void AudioStreamer::end() {
     stop();
     teardownI2S();
@@ -125,6 +166,11 @@ void AudioStreamer::stop() {
     if (event_callback_) {
         event_callback_(AudioEvent::STREAM_STOPPED, nullptr);
     }
+    
+    if (has_pending_config_) {
+        has_pending_config_ = false;
+        applyFormat(pending_config_);
+    }
 }
 
 void AudioStreamer::pause() {
@@ -156,7 +202,7 @@ bool AudioStreamer::readFrame(AudioFrame& frame) {
         float rms_level;
     } qframe;
     
-    if (xQueueReceive(raw_queue_, &qframe, pdMS_TO_TICKS(10)) == pdTRUE) {
+    if (xQueueReceive(raw_queue_, &qframe, 0) == pdTRUE) {
         frame = AudioFrame(qframe.num_samples);
         memcpy(frame.samples.get(), qframe.samples, qframe.num_samples * sizeof(int16_t));
         frame.num_samples = qframe.num_samples;
@@ -171,20 +217,15 @@ bool AudioStreamer::readFrame(AudioFrame& frame) {
 bool AudioStreamer::readEncodedPacket(EncodedAudioPacket& packet) {
     if (!encoded_queue_) return false;
     
-    struct QueuePacket {
-        uint8_t data[2048];
-        size_t length;
-        uint32_t timestamp;
-        bool is_final;
-        AudioCodec codec;
-    } qpacket;
+    QueuePacket qpacket;
     
-    if (xQueueReceive(encoded_queue_, &qpacket, pdMS_TO_TICKS(10)) == pdTRUE) {
+    if (xQueueReceive(encoded_queue_, &qpacket, 0) == pdTRUE) {
         packet = EncodedAudioPacket(qpacket.length);
         memcpy(packet.data.get(), qpacket.data, qpacket.length);
         packet.length = qpacket.length;
         packet.timestamp = qpacket.timestamp;
         packet.is_final = qpacket.is_final;
+        packet.endpoint = qpacket.endpoint;
         packet.codec = qpacket.codec;
         return true;
     }
@@ -207,6 +248,32 @@ void AudioStreamer::setVADThreshold(int16_t threshold) {
     config_.vad_threshold = threshold;
 }
 
+bool AudioStreamer::allocateBuffers() {
+    size_t i2s_buffer_samples = config_.dma_buf_len * config_.dma_buf_count;
+    i2s_buffer_.reset(new int16_t[i2s_buffer_samples]);
+    
+    size_t frame_samples = (config_.sample_rate * config_.frame_duration_ms) / 1000;
+    frame_buffer_.reset(new int16_t[frame_samples]);
+    frame_buffer_pos_ = 0;
+    
+    if (!i2s_buffer_ || !frame_buffer_) {
+        strcpy(last_error_, "Failed to allocate buffers");
+        return false;
+    }
+    return true;
+}
+
+bool AudioStreamer::applyFormat(const AudioStreamerConfig& config) {
+    // Queues keep their begin() sizes
+    size_t stream_queue_size = config_.stream_queue_size;
+    config_ = config;
+    config_.stream_queue_size = stream_queue_size;
+    applyEndpointerConfig();
+    
+    // I2S is installed per capture, so the next start() picks up the rate
+    return allocateBuffers();
+}
+
 bool AudioStreamer::setupI2S() {
     if (i2s_initialized_) {
         return true;
@@ -260,7 +327,7 @@ void AudioStreamer::teardownI2S() {
 
 bool AudioStreamer::createQueues() {
     raw_queue_ = xQueueCreate(config_.stream_queue_size, 2048);  // Fixed size for QueueFrame
-    encoded_queue_ = xQueueCreate(config_.stream_queue_size, 2056);  // Fixed size for QueuePacket
+    encoded_queue_ = xQueueCreate(config_.stream_queue_size, sizeof(QueuePacket));
     return raw_queue_ != nullptr && encoded_queue_ != nullptr;
 }
 
@@ -372,8 +439,9 @@ void AudioStreamer::processFrame(const int16_t* samples, size_t count) {
     current_rms_ = rms;
     total_frame_count_++;
     
-    // Update VAD
+    // Update VAD (sets endpoint_event_ for this frame)
     VADState new_vad_state = updateVAD(rms);
+    bool utterance_ended = endpoint_event_ == EndpointEvent::FINAL;
     
     // Copy to frame buffer
     if (frame_buffer_pos_ + count <= (config_.sample_rate * config_.frame_duration_ms) / 1000) {
@@ -384,8 +452,9 @@ void AudioStreamer::processFrame(const int16_t* samples, size_t count) {
     // Check if we have a complete frame
     size_t frame_samples = (config_.sample_rate * config_.frame_duration_ms) / 1000;
     if (frame_buffer_pos_ >= frame_samples) {
-        // Send to queue if voice detected
-        if (vad_state_ == VADState::VOICE_ACTIVE || vad_state_ == VADState::VOICE_END) {
+        // Send to queue if voice detected, through the frame that ends it
+        if (vad_state_ == VADState::VOICE_ACTIVE || vad_state_ == VADState::VOICE_END ||
+            utterance_ended) {
             struct QueueFrame {
                 int16_t samples[640];
                 size_t num_samples;
@@ -400,27 +469,24 @@ void AudioStreamer::processFrame(const int16_t* samples, size_t count) {
             qframe.vad_state = vad_state_;
             qframe.rms_level = current_rms_;
             
-            if (xQueueSend(raw_queue_, &qframe, pdMS_TO_TICKS(10)) == pdTRUE) {
+            // Raw frames are best-effort for local consumers; a full raw
+            // queue must not hold up (or drop) the encoded stream
+            if (xQueueSend(raw_queue_, &qframe, 0) == pdTRUE) {
                 frames_captured_++;
-                
-                // Also encode and queue
-                encodeAndQueue(frame_buffer_.get(), frame_samples, vad_state_ == VADState::VOICE_END);
             }
+            // Only the closing frame is final; hangover frames may still
+            // turn out to be a mid-utterance pause
+            encodeAndQueue(frame_buffer_.get(), frame_samples, utterance_ended, endpoint_event_);
         }
         
         frame_buffer_pos_ = 0;
     }
 }
 
-void AudioStreamer::encodeAndQueue(const int16_t* samples, size_t count, bool is_final) {
+void AudioStreamer::encodeAndQueue(const int16_t* samples, size_t count, bool is_final,
+                                   EndpointEvent endpoint) {
     // For now, just copy PCM data (no Opus encoding)
-    struct QueuePacket {
-        uint8_t data[2048];
-        size_t length;
-        uint32_t timestamp;
-        bool is_final;
-        AudioCodec codec;
-    } qpacket;
+    QueuePacket qpacket;
     
     size_t pcm_bytes = count * sizeof(int16_t);
     if (pcm_bytes > 2048) pcm_bytes = 2048;
@@ -429,10 +495,16 @@ void AudioStreamer::encodeAndQueue(const int16_t* samples, size_t count, bool is
     qpacket.length = pcm_bytes;
     qpacket.timestamp = millis();
     qpacket.is_final = is_final;
+    qpacket.endpoint = endpoint;
     qpacket.codec = AudioCodec::PCM_S16LE;  // PCM fallback
     
-    if (xQueueSend(encoded_queue_, &qpacket, pdMS_TO_TICKS(10)) == pdTRUE) {
+    // One frame per utterance carries the end (or the hint); it waits
+    // longer for room than an ordinary frame
+    bool marked = is_final || endpoint != EndpointEvent::NONE;
+    TickType_t wait = pdMS_TO_TICKS(marked ? 100 : 10);
+    if (xQueueSend(encoded_queue_, &qpacket, wait) == pdTRUE) {
         frames_streamed_++;
+        packet_notifier_.notify();
         if (event_callback_) {
             event_callback_(AudioEvent::ENCODED_PACKET_READY, nullptr);
         }
@@ -468,6 +540,7 @@ void AudioStreamer::applyGain(int16_t* samples, size_t count) {
 VADState AudioStreamer::updateVAD(float rms) {
     uint32_t now = millis();
     bool is_speech = rms > config_.vad_threshold;
+    endpoint_event_ = EndpointEvent::NONE;
     
     switch (vad_state_) {
         case VADState::SILENCE:
@@ -482,6 +555,7 @@ VADState AudioStreamer::updateVAD(float rms) {
             if (is_speech) {
                 if (now - voice_start_time_ >= config_.vad_min_duration_ms) {
                     vad_state_ = VADState::VOICE_ACTIVE;
+                    endpointer_.startUtterance(voice_start_time_);
                     voice_events_++;
                     if (event_callback_) {
                         event_callback_(AudioEvent::VOICE_DETECTED, nullptr);
@@ -493,23 +567,23 @@ VADState AudioStreamer::updateVAD(float rms) {
             break;
             
         case VADState::VOICE_ACTIVE:
-            if (!is_speech) {
-                vad_state_ = VADState::VOICE_END;
-                silence_start_time_ = now;
-            } else {
-                voice_frame_count_++;
-            }
-            break;
-            
         case VADState::VOICE_END:
-            if (is_speech) {
-                vad_state_ = VADState::VOICE_ACTIVE;
-            } else if (now - silence_start_time_ >= config_.vad_silence_ms) {
+            // The endpointer decides how long a pause may run
+            endpoint_event_ = endpointer_.update(is_speech, rms, config_.frame_duration_ms, now);
+            if (endpoint_event_ == EndpointEvent::FINAL) {
                 vad_state_ = VADState::SILENCE;
                 if (event_callback_) {
                     event_callback_(AudioEvent::VOICE_LOST, nullptr);
                 }
                 voice_frame_count_ = 0;
+            } else if (is_speech) {
+                if (vad_state_ == VADState::VOICE_ACTIVE) {
+                    voice_frame_count_++;
+                }
+                vad_state_ = VADState::VOICE_ACTIVE;
+            } else if (vad_state_ == VADState::VOICE_ACTIVE) {
+                vad_state_ = VADState::VOICE_END;
+                silence_start_time_ = now;
             }
             break;
     }
@@ -517,6 +591,16 @@ VADState AudioStreamer::updateVAD(float rms) {
     return vad_state_;
 }
 
+void AudioStreamer::applyEndpointerConfig() {
+    EndpointerConfig endpointer_config = endpointer_.getConfig();
+    endpointer_config.hangover_ms = config_.vad_silence_ms;
+    endpointer_config.min_hangover_ms = config_.vad_min_silence_ms;
+    endpointer_config.max_hangover_ms = config_.vad_max_silence_ms;
+    endpointer_config.adaptive = config_.vad_adaptive;
+    endpointer_config.hint = config_.vad_final_hint;
+    endpointer_.setConfig(endpointer_config);
+}
+
 const char* audioStreamStateToString(AudioStreamState state) {
     switch (state) {
         case AudioStreamState::IDLE: return "IDLE";
@@ -105,17 +105,15 @@ float AncientRitual::getRitualProgress() const {
 
 bool AncientRitual::checkVoicePhrase(const char* text) {
     if (!text) return false;
-    
-    String t = String(text);
-    t.toLowerCase();
-    
-    for (uint8_t i = 0; i < NUM_AWAKEN_PHRASES; i++) {
-        if (t.indexOf(AWAKEN_PHRASES[i]) >= 0) {
-            ritualState_ = RitualState::PHRASE_CONFIRMED;
-            return true;
-        }
+    return checkVoiceTriggers(OpenClaw::scanTriggers(text));
+}
+
+bool AncientRitual::checkVoiceTriggers(OpenClaw::TriggerMask triggers) {
+    // Phrases live in scripts/trigger_phrases.txt (RITUAL_AWAKEN)
+    if (triggers & OpenClaw::triggerBit(OpenClaw::TriggerId::RITUAL_AWAKEN)) {
+        ritualState_ = RitualState::PHRASE_CONFIRMED;
+        return true;
     }
-    
     return false;
 }
 
@@ -101,12 +101,12 @@ SpecialMood EasterEggManager::checkTriggers() {
 
 void EasterEggManager::processText(const char* text) {
     if (!text) return;
-    
-    String t = String(text);
-    t.toLowerCase();
-    
+    processTriggers(OpenClaw::scanTriggers(text));
+}
+
+void EasterEggManager::processTriggers(OpenClaw::TriggerMask triggers) {
     // Check for insults
-    if (containsInsult(text)) {
+    if (triggers & OpenClaw::triggerBit(OpenClaw::TriggerId::INSULT)) {
         currentMood_ = SpecialMood::OFFENDED;
         moodStartTime_ = millis();
         isOffended_ = true;
@@ -115,7 +115,7 @@ void EasterEggManager::processText(const char* text) {
     }
     
     // Check for "please"
-    if (t.indexOf("please") >= 0) {
+    if (triggers & OpenClaw::triggerBit(OpenClaw::TriggerId::PLEASE)) {
         uint32_t now = millis();
         if (now - lastPleaseTime_ > PLEASE_WINDOW_MS) {
             pleaseCount_ = 0;
@@ -428,21 +428,6 @@ SpecialMood EasterEggManager::checkCosmicTriggers() {
     return SpecialMood::NONE;
 }
 
-bool EasterEggManager::containsInsult(const char* text) {
-    if (!text) return false;
-    
-    String t = String(text);
-    t.toLowerCase();
-    
-    for (uint8_t i = 0; i < NUM_INSULTS; i++) {
-        if (t.indexOf(INSULTS[i]) >= 0) {
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 void EasterEggManager::resetPleaseCounter() {
     pleaseCount_ = 0;
     lastPleaseTime_ = 0;
@@ -7,7 +7,7 @@
 
 namespace Avatar {
 
-void drawFilledCircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r, 
+void drawFilledCircle(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t r, 
                        uint16_t color, uint16_t edgeColor, float edgeWidth) {
     if (!gfx) return;
     
@@ -30,7 +30,7 @@ void drawFilledCircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r,
     }
 }
 
-void drawAACircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r, 
+void drawAACircle(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t r, 
                      uint16_t color, float thickness) {
     if (!gfx) return;
     
@@ -45,7 +45,7 @@ void drawAACircle(M5GFX* gfx, int16_t cx, int16_t cy, int16_t r,
     }
 }
 
-void drawEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
+void drawEllipse(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
                   uint16_t color, float rotation) {
     if (!gfx) return;
     
@@ -76,7 +76,7 @@ void drawEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
     }
 }
 
-void drawFilledEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
+void drawFilledEllipse(lgfx::LovyanGFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
                         uint16_t color, float rotation) {
     if (!gfx) return;
     
@@ -92,7 +92,7 @@ void drawFilledEllipse(M5GFX* gfx, int16_t cx, int16_t cy, int16_t rx, int16_t r
     }
 }
 
-void drawBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
+void drawBezier(lgfx::LovyanGFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
                  uint16_t color, float thickness) {
     if (!gfx) return;
     
@@ -115,7 +115,7 @@ void drawBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, const Vec2& p2,
     }
 }
 
-void drawFilledBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1, 
+void drawFilledBezier(lgfx::LovyanGFX* gfx, const Vec2& p0, const Vec2& p1, 
                        const Vec2& p2, const Vec2& p3, uint16_t color) {
     // Simplified: draw as polygon
     const int steps = 10;
@@ -145,7 +145,7 @@ void drawFilledBezier(M5GFX* gfx, const Vec2& p0, const Vec2& p1,
     gfx->fillTriangle(x[0], y[0], x[steps*2-1], y[steps*2-1], x[1], y[1], color);
 }
 
-void drawFeather(M5GFX* gfx, float x, float y, float length, float angle,
+void drawFeather(lgfx::LovyanGFX* gfx, float x, float y, float length, float angle,
                   float width, uint16_t color, float ruffle) {
     if (!gfx) return;
     
@@ -182,7 +182,7 @@ void drawFeather(M5GFX* gfx, float x, float y, float length, float angle,
                    lerpColor(color, 0x0000, 0.3f));
 }
 
-void drawFeatherTuft(M5GFX* gfx, float x, float y, int count, float spread,
+void drawFeatherTuft(lgfx::LovyanGFX* gfx, float x, float y, int count, float spread,
                       float length, uint16_t color, float ruffle) {
     if (!gfx) return;
     
@@ -198,7 +198,7 @@ void drawFeatherTuft(M5GFX* gfx, float x, float y, int count, float spread,
     }
 }
 
-void drawRune(M5GFX* gfx, float x, float y, float size, uint8_t symbol,
+void drawRune(lgfx::LovyanGFX* gfx, float x, float y, float size, uint8_t symbol,
                uint16_t color, float glowIntensity) {
     if (!gfx) return;
     
@@ -268,7 +268,7 @@ void drawRune(M5GFX* gfx, float x, float y, float size, uint8_t symbol,
     }
 }
 
-void applySepiaTint(M5GFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
+void applySepiaTint(lgfx::LovyanGFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
                      float intensity) {
     if (!gfx || intensity <= 0) return;
     
@@ -299,7 +299,7 @@ void applySepiaTint(M5GFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
     }
 }
 
-void drawScanlines(M5GFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
+void drawScanlines(lgfx::LovyanGFX* gfx, int16_t x, int16_t y, int16_t w, int16_t h,
                     float intensity) {
     if (!gfx || intensity <= 0) return;
     
@@ -19,7 +19,7 @@ ProceduralAvatar::ProceduralAvatar()
 ProceduralAvatar::~ProceduralAvatar() {
 }
 
-bool ProceduralAvatar::begin(M5GFX* gfx) {
+bool ProceduralAvatar::begin(lgfx::LovyanGFX* gfx) {
     gfx_ = gfx;
     if (!gfx_) return false;
     
@@ -16,8 +16,10 @@ AvatarSensors::AvatarSensors()
       gyro_x_(0), gyro_y_(0), gyro_z_(0),
       tilt_x_(0), tilt_y_(0),
       shaking_(false), face_down_(false), free_fall_(false),
-      shake_intensity_(0), last_shake_time_(0), last_update_(0),
-      battery_level_(100), last_battery_check_(0) {
+      low_power_(false), motion_(false),
+      ref_x_(0), ref_y_(0), ref_z_(0),
+      shake_intensity_(0), last_shake_time_(0),
+      battery_level_(100) {
 }
 
 bool AvatarSensors::begin() {
@@ -37,30 +39,40 @@ bool AvatarSensors::begin() {
 void AvatarSensors::update() {
     if (!imu_available_) return;
     
-    uint32_t now = millis();
-    if (now - last_update_ < 50) return;  // Update at 20Hz max
-    last_update_ = now;
+    if (low_power_) {
+        // Orientation still matters (turning face-up wakes); gyro does not
+        readAccel();
+        processOrientation();
+        detectMotion();
+        return;
+    }
     
     readSensors();
     processOrientation();
     detectShake();
+}
+
+void AvatarSensors::setLowPowerMode(bool enabled) {
+    if (enabled == low_power_) return;
+    low_power_ = enabled;
+    motion_ = false;
     
-    // Check battery every 30 seconds
-    if (now - last_battery_check_ > 30000) {
-        checkBattery();
-        last_battery_check_ = now;
+    if (enabled) {
+        // Measure motion against where the device is resting now
+        if (imu_available_) readAccel();
+        ref_x_ = accel_x_;
+        ref_y_ = accel_y_;
+        ref_z_ = accel_z_;
+    } else {
+        shake_intensity_ = 0;
+        shaking_ = false;
     }
 }
 
 void AvatarSensors::readSensors() {
-    float ax, ay, az;
     float gx, gy, gz;
     
-    if (M5.Imu.getAccel(&ax, &ay, &az)) {
-        accel_x_ = ax;
-        accel_y_ = ay;
-        accel_z_ = az;
-    }
+    readAccel();
     
     if (M5.Imu.getGyro(&gx, &gy, &gz)) {
         gyro_x_ = gx;
@@ -69,6 +81,16 @@ void AvatarSensors::readSensors() {
     }
 }
 
+void AvatarSensors::readAccel() {
+    float ax, ay, az;
+    
+    if (M5.Imu.getAccel(&ax, &ay, &az)) {
+        accel_x_ = ax;
+        accel_y_ = ay;
+        accel_z_ = az;
+    }
+}
+
 void AvatarSensors::processOrientation() {
     // Calculate tilt from accelerometer
     // When flat: Z = 1.0, X = 0, Y = 0
@@ -103,6 +125,17 @@ void AvatarSensors::detectShake() {
     shaking_ = (shake_intensity_ > 0.3f);
 }
 
+void AvatarSensors::detectMotion() {
+    float dx = accel_x_ - ref_x_;
+    float dy = accel_y_ - ref_y_;
+    float dz = accel_z_ - ref_z_;
+    
+    // Latches until low-power mode is left
+    if (std::sqrt(dx*dx + dy*dy + dz*dz) > MOTION_WAKE_THRESHOLD_G) {
+        motion_ = true;
+    }
+}
+
 const char* AvatarSensors::getOrientation() const {
     if (face_down_) return "face_down";
     if (std::abs(tilt_x_) < 0.3f && std::abs(tilt_y_) < 0.3f) return "flat";
@@ -0,0 +1,70 @@
+/**
+ * @file boot_profile.cpp
+ * @brief Boot phase timing implementation
+ */
+
+#include "boot_profile.h"
+
+namespace OpenClaw {
+
+static_assert(static_cast<size_t>(BootPhase::COUNT) <= 8, "marked_ holds one bit per phase");
+
+BootProfile::BootProfile() : marked_(0), flags_(0) {
+    memset(marks_, 0, sizeof(marks_));
+}
+
+void BootProfile::mark(BootPhase phase, uint32_t at_ms) {
+    if (phase >= BootPhase::COUNT || isMarked(phase)) return;
+    marks_[static_cast<size_t>(phase)] = at_ms;
+    marked_ |= 1 << static_cast<uint8_t>(phase);
+}
+
+bool BootProfile::isMarked(BootPhase phase) const {
+    return phase < BootPhase::COUNT && (marked_ & (1 << static_cast<uint8_t>(phase)));
+}
+
+uint32_t BootProfile::getMs(BootPhase phase) const {
+    return isMarked(phase) ? marks_[static_cast<size_t>(phase)] : 0;
+}
+
+void BootProfile::printReport() const {
+    Serial.printf("[Boot] READY in %lu ms (fast join: %s, cached lease: %s, cached DNS: %s)\n",
+                  (unsigned long)getMs(BootPhase::READY),
+                  (flags_ & BootFlags::FAST_JOIN) ? "yes" : "no",
+                  (flags_ & BootFlags::CACHED_LEASE) ? "yes" : "no",
+                  (flags_ & BootFlags::CACHED_DNS) ? "yes" : "no");
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < static_cast<size_t>(BootPhase::COUNT); i++) {
+        BootPhase phase = static_cast<BootPhase>(i);
+        if (!isMarked(phase)) {
+            Serial.printf("  %-18s -\n", bootPhaseToString(phase));
+            continue;
+        }
+
+        // Phases can overlap (DNS may finish before the join is reported)
+        uint32_t at = marks_[i];
+        uint32_t delta = at > previous ? at - previous : 0;
+        Serial.printf("  %-18s %6lu ms  +%lu\n", bootPhaseToString(phase),
+                      (unsigned long)at, (unsigned long)delta);
+        if (at > previous) previous = at;
+    }
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* bootPhaseToString(BootPhase phase) {
+    switch (phase) {
+        case BootPhase::SETUP: return "SETUP";
+        case BootPhase::WIFI_ASSOCIATED: return "WIFI_ASSOCIATED";
+        case BootPhase::WIFI_IP: return "WIFI_IP";
+        case BootPhase::GATEWAY_RESOLVED: return "GATEWAY_RESOLVED";
+        case BootPhase::GATEWAY_CONNECTED: return "GATEWAY_CONNECTED";
+        case BootPhase::READY: return "READY";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
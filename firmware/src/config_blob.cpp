@@ -0,0 +1,181 @@
+/**
+ * @file config_blob.cpp
+ * @brief Binary configuration image implementation
+ */
+
+#include "config_blob.h"
+#include "config_manager.h"
+#include <esp_rom_crc.h>
+#include <cstring>
+
+namespace OpenClaw {
+
+static constexpr size_t CONFIG_BLOB_CRC_START = offsetof(ConfigBlob, json_stamp);
+
+// Version 2 image: no gateway.tls_fingerprint slot
+struct ConfigBlobV2 {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t crc32;
+    ConfigJsonStamp json_stamp;
+    uint32_t log_generation;
+    uint16_t reconnect_interval_ms;
+    uint16_t ping_interval_ms;
+    uint16_t connection_timeout_ms;
+    uint16_t sample_rate;
+    uint8_t frame_duration_ms;
+    uint8_t mic_gain;
+    uint8_t display_brightness;
+    uint8_t flags;
+    uint16_t string_offset[static_cast<size_t>(ConfigString::GATEWAY_TLS_FINGERPRINT)];
+    uint16_t string_bytes;
+    char strings[CONFIG_STRING_TABLE_SIZE];
+};
+
+static uint32_t blobCrc(const ConfigBlob& blob) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&blob);
+    return esp_rom_crc32_le(0, bytes + CONFIG_BLOB_CRC_START,
+                            sizeof(ConfigBlob) - CONFIG_BLOB_CRC_START);
+}
+
+static bool packString(ConfigBlob& blob, ConfigString id, const String& value) {
+    size_t len = value.length();
+    if (blob.string_bytes + len + 1 > CONFIG_STRING_TABLE_SIZE) return false;
+
+    blob.string_offset[static_cast<size_t>(id)] = blob.string_bytes;
+    memcpy(blob.strings + blob.string_bytes, value.c_str(), len + 1);
+    blob.string_bytes += len + 1;
+    return true;
+}
+
+bool packConfigBlob(const AppConfig& config, const ConfigJsonStamp& stamp,
+                    uint32_t log_generation, ConfigBlob& blob) {
+    // Zeroed first so padding bytes are covered by the CRC deterministically
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = CONFIG_BLOB_MAGIC;
+    blob.version = CONFIG_BLOB_VERSION;
+    blob.size = sizeof(ConfigBlob);
+    blob.json_stamp = stamp;
+    blob.log_generation = log_generation;
+
+    blob.reconnect_interval_ms = config.gateway.reconnect_interval_ms;
+    blob.ping_interval_ms = config.gateway.ping_interval_ms;
+    blob.connection_timeout_ms = config.gateway.connection_timeout_ms;
+    blob.sample_rate = config.audio.sample_rate;
+    blob.frame_duration_ms = config.audio.frame_duration_ms;
+    blob.mic_gain = config.audio.mic_gain;
+    blob.display_brightness = config.device.display_brightness;
+    if (config.wifi.dhcp) blob.flags |= ConfigFlags::WIFI_DHCP;
+    if (config.device.auto_connect) blob.flags |= ConfigFlags::AUTO_CONNECT;
+    if (config.device.save_history) blob.flags |= ConfigFlags::SAVE_HISTORY;
+    if (config.audio.noise_suppression) blob.flags |= ConfigFlags::NOISE_SUPPRESSION;
+    if (config.audio.auto_gain_control) blob.flags |= ConfigFlags::AUTO_GAIN_CONTROL;
+
+    bool ok = packString(blob, ConfigString::WIFI_SSID, config.wifi.ssid) &&
+              packString(blob, ConfigString::WIFI_PASSWORD, config.wifi.password) &&
+              packString(blob, ConfigString::WIFI_STATIC_IP, config.wifi.static_ip) &&
+              packString(blob, ConfigString::WIFI_GATEWAY, config.wifi.gateway) &&
+              packString(blob, ConfigString::WIFI_SUBNET, config.wifi.subnet) &&
+              packString(blob, ConfigString::GATEWAY_WEBSOCKET_URL, config.gateway.websocket_url) &&
+              packString(blob, ConfigString::GATEWAY_FALLBACK_URL, config.gateway.fallback_http_url) &&
+              packString(blob, ConfigString::GATEWAY_API_KEY, config.gateway.api_key) &&
+              packString(blob, ConfigString::DEVICE_ID, config.device.id) &&
+              packString(blob, ConfigString::DEVICE_NAME, config.device.name) &&
+              packString(blob, ConfigString::DEVICE_FIRMWARE_VERSION, config.device.firmware_version) &&
+              packString(blob, ConfigString::AUDIO_CODEC, config.audio.codec) &&
+              packString(blob, ConfigString::GATEWAY_TLS_FINGERPRINT, config.gateway.tls_fingerprint);
+    if (!ok) return false;
+
+    blob.crc32 = blobCrc(blob);
+    return true;
+}
+
+void unpackConfigBlob(const ConfigBlob& blob, AppConfig& config) {
+    config.wifi.ssid = blob.getString(ConfigString::WIFI_SSID);
+    config.wifi.password = blob.getString(ConfigString::WIFI_PASSWORD);
+    config.wifi.dhcp = (blob.flags & ConfigFlags::WIFI_DHCP) != 0;
+    config.wifi.static_ip = blob.getString(ConfigString::WIFI_STATIC_IP);
+    config.wifi.gateway = blob.getString(ConfigString::WIFI_GATEWAY);
+    config.wifi.subnet = blob.getString(ConfigString::WIFI_SUBNET);
+
+    config.gateway.websocket_url = blob.getString(ConfigString::GATEWAY_WEBSOCKET_URL);
+    config.gateway.fallback_http_url = blob.getString(ConfigString::GATEWAY_FALLBACK_URL);
+    config.gateway.api_key = blob.getString(ConfigString::GATEWAY_API_KEY);
+    config.gateway.tls_fingerprint = blob.getString(ConfigString::GATEWAY_TLS_FINGERPRINT);
+    config.gateway.reconnect_interval_ms = blob.reconnect_interval_ms;
+    config.gateway.ping_interval_ms = blob.ping_interval_ms;
+    config.gateway.connection_timeout_ms = blob.connection_timeout_ms;
+
+    config.device.id = blob.getString(ConfigString::DEVICE_ID);
+    config.device.name = blob.getString(ConfigString::DEVICE_NAME);
+    config.device.firmware_version = blob.getString(ConfigString::DEVICE_FIRMWARE_VERSION);
+    config.device.auto_connect = (blob.flags & ConfigFlags::AUTO_CONNECT) != 0;
+    config.device.save_history = (blob.flags & ConfigFlags::SAVE_HISTORY) != 0;
+    config.device.display_brightness = blob.display_brightness;
+
+    config.audio.sample_rate = blob.sample_rate;
+    config.audio.frame_duration_ms = blob.frame_duration_ms;
+    config.audio.codec = blob.getString(ConfigString::AUDIO_CODEC);
+    config.audio.mic_gain = blob.mic_gain;
+    config.audio.noise_suppression = (blob.flags & ConfigFlags::NOISE_SUPPRESSION) != 0;
+    config.audio.auto_gain_control = (blob.flags & ConfigFlags::AUTO_GAIN_CONTROL) != 0;
+}
+
+bool validateConfigBlob(const ConfigBlob& blob) {
+    if (blob.magic != CONFIG_BLOB_MAGIC ||
+        blob.version != CONFIG_BLOB_VERSION ||
+        blob.size != sizeof(ConfigBlob)) {
+        return false;
+    }
+    if (blob.crc32 != blobCrc(blob)) return false;
+
+    // The table must end in a terminator and every slot must point into it
+    if (blob.string_bytes == 0 || blob.string_bytes > CONFIG_STRING_TABLE_SIZE ||
+        blob.strings[blob.string_bytes - 1] != '\0') {
+        return false;
+    }
+    for (size_t i = 0; i < static_cast<size_t>(ConfigString::COUNT); i++) {
+        if (blob.string_offset[i] >= blob.string_bytes) return false;
+    }
+    return true;
+}
+
+bool upgradeConfigBlob(const uint8_t* data, size_t length, ConfigBlob& blob) {
+    ConfigBlobV2 old;
+    if (length != sizeof(old)) return false;
+    memcpy(&old, data, sizeof(old));
+
+    constexpr size_t old_crc_start = offsetof(ConfigBlobV2, json_stamp);
+    if (old.magic != CONFIG_BLOB_MAGIC || old.version != 2 || old.size != sizeof(old) ||
+        old.crc32 != esp_rom_crc32_le(0, data + old_crc_start, sizeof(old) - old_crc_start)) {
+        return false;
+    }
+    if (old.string_bytes == 0 || old.string_bytes > CONFIG_STRING_TABLE_SIZE) return false;
+
+    memset(&blob, 0, sizeof(blob));
+    blob.magic = CONFIG_BLOB_MAGIC;
+    blob.version = CONFIG_BLOB_VERSION;
+    blob.size = sizeof(ConfigBlob);
+    blob.json_stamp = old.json_stamp;
+    blob.log_generation = old.log_generation;
+    blob.reconnect_interval_ms = old.reconnect_interval_ms;
+    blob.ping_interval_ms = old.ping_interval_ms;
+    blob.connection_timeout_ms = old.connection_timeout_ms;
+    blob.sample_rate = old.sample_rate;
+    blob.frame_duration_ms = old.frame_duration_ms;
+    blob.mic_gain = old.mic_gain;
+    blob.display_brightness = old.display_brightness;
+    blob.flags = old.flags;
+
+    // New slots point at the table's final terminator (empty string)
+    memcpy(blob.string_offset, old.string_offset, sizeof(old.string_offset));
+    blob.string_offset[static_cast<size_t>(ConfigString::GATEWAY_TLS_FINGERPRINT)] = old.string_bytes - 1;
+    blob.string_bytes = old.string_bytes;
+    memcpy(blob.strings, old.strings, sizeof(blob.strings));
+
+    blob.crc32 = blobCrc(blob);
+    return validateConfigBlob(blob);
+}
+
+} // namespace OpenClaw
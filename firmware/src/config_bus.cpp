@@ -0,0 +1,30 @@
+/**
+ * @file config_bus.cpp
+ * @brief Configuration change notification implementation
+ */
+
+#include "config_bus.h"
+
+namespace OpenClaw {
+
+ConfigBus::ConfigBus() : count_(0) {}
+
+bool ConfigBus::subscribe(ConfigKeyMask mask, ConfigListener listener, void* ctx) {
+    if (!listener || count_ >= MAX_SUBSCRIBERS) return false;
+    subscribers_[count_++] = {mask, listener, ctx};
+    return true;
+}
+
+size_t ConfigBus::publish(ConfigKeyMask changed, const AppConfig& config) {
+    size_t called = 0;
+    for (size_t i = 0; i < count_; i++) {
+        ConfigKeyMask relevant = changed & subscribers_[i].mask;
+        if (relevant) {
+            subscribers_[i].listener(relevant, config, subscribers_[i].ctx);
+            called++;
+        }
+    }
+    return called;
+}
+
+} // namespace OpenClaw
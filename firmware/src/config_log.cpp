@@ -0,0 +1,293 @@
+/**
+ * @file config_log.cpp
+ * @brief Configuration delta log implementation
+ */
+
+#include "config_log.h"
+#include "config_manager.h"
+#include <esp_rom_crc.h>
+#include <cstring>
+
+namespace OpenClaw {
+
+static constexpr size_t RECORD_HEADER_SIZE = 2;
+static constexpr size_t COMMIT_VALUE_SIZE = 8;
+static constexpr size_t MAX_VALUE_SIZE = 255;
+
+static uint32_t crc32(const void* data, size_t length) {
+    return esp_rom_crc32_le(0, static_cast<const uint8_t*>(data), length);
+}
+
+// =============================================================================
+// Key encoding
+// =============================================================================
+
+static size_t encodeString(const String& value, uint8_t* out) {
+    size_t len = value.length();
+    if (len > MAX_VALUE_SIZE) return SIZE_MAX;
+    memcpy(out, value.c_str(), len);
+    return len;
+}
+
+static size_t encodeU16(uint16_t value, uint8_t* out) {
+    memcpy(out, &value, sizeof(value));
+    return sizeof(value);
+}
+
+static size_t encodeU8(uint8_t value, uint8_t* out) {
+    out[0] = value;
+    return 1;
+}
+
+/**
+ * @brief Current value of one key (SIZE_MAX if too long to log)
+ */
+static size_t encodeKey(const AppConfig& config, ConfigKey key, uint8_t* out) {
+    switch (key) {
+        case ConfigKey::WIFI_SSID: return encodeString(config.wifi.ssid, out);
+        case ConfigKey::WIFI_PASSWORD: return encodeString(config.wifi.password, out);
+        case ConfigKey::WIFI_DHCP: return encodeU8(config.wifi.dhcp, out);
+        case ConfigKey::WIFI_STATIC_IP: return encodeString(config.wifi.static_ip, out);
+        case ConfigKey::WIFI_GATEWAY: return encodeString(config.wifi.gateway, out);
+        case ConfigKey::WIFI_SUBNET: return encodeString(config.wifi.subnet, out);
+        case ConfigKey::GATEWAY_WEBSOCKET_URL: return encodeString(config.gateway.websocket_url, out);
+        case ConfigKey::GATEWAY_FALLBACK_URL: return encodeString(config.gateway.fallback_http_url, out);
+        case ConfigKey::GATEWAY_API_KEY: return encodeString(config.gateway.api_key, out);
+        case ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS: return encodeU16(config.gateway.reconnect_interval_ms, out);
+        case ConfigKey::GATEWAY_PING_INTERVAL_MS: return encodeU16(config.gateway.ping_interval_ms, out);
+        case ConfigKey::GATEWAY_CONNECTION_TIMEOUT_MS: return encodeU16(config.gateway.connection_timeout_ms, out);
+        case ConfigKey::DEVICE_ID: return encodeString(config.device.id, out);
+        case ConfigKey::DEVICE_NAME: return encodeString(config.device.name, out);
+        case ConfigKey::DEVICE_FIRMWARE_VERSION: return encodeString(config.device.firmware_version, out);
+        case ConfigKey::DEVICE_AUTO_CONNECT: return encodeU8(config.device.auto_connect, out);
+        case ConfigKey::DEVICE_SAVE_HISTORY: return encodeU8(config.device.save_history, out);
+        case ConfigKey::DEVICE_DISPLAY_BRIGHTNESS: return encodeU8(config.device.display_brightness, out);
+        case ConfigKey::AUDIO_SAMPLE_RATE: return encodeU16(config.audio.sample_rate, out);
+        case ConfigKey::AUDIO_FRAME_DURATION_MS: return encodeU8(config.audio.frame_duration_ms, out);
+        case ConfigKey::AUDIO_CODEC: return encodeString(config.audio.codec, out);
+        case ConfigKey::AUDIO_MIC_GAIN: return encodeU8(config.audio.mic_gain, out);
+        case ConfigKey::AUDIO_NOISE_SUPPRESSION: return encodeU8(config.audio.noise_suppression, out);
+        case ConfigKey::AUDIO_AUTO_GAIN_CONTROL: return encodeU8(config.audio.auto_gain_control, out);
+        case ConfigKey::GATEWAY_TLS_FINGERPRINT: return encodeString(config.gateway.tls_fingerprint, out);
+        default: return SIZE_MAX;
+    }
+}
+
+static bool decodeString(String& value, const uint8_t* data, size_t len) {
+    char text[MAX_VALUE_SIZE + 1];
+    memcpy(text, data, len);
+    text[len] = '\0';
+    value = text;
+    return true;
+}
+
+static bool decodeU16(uint16_t& value, const uint8_t* data, size_t len) {
+    if (len != sizeof(value)) return false;
+    memcpy(&value, data, sizeof(value));
+    return true;
+}
+
+static bool decodeU8(uint8_t& value, const uint8_t* data, size_t len) {
+    if (len != 1) return false;
+    value = data[0];
+    return true;
+}
+
+static bool decodeBool(bool& value, const uint8_t* data, size_t len) {
+    if (len != 1) return false;
+    value = data[0] != 0;
+    return true;
+}
+
+static bool decodeKey(AppConfig& config, ConfigKey key, const uint8_t* data, size_t len) {
+    switch (key) {
+        case ConfigKey::WIFI_SSID: return decodeString(config.wifi.ssid, data, len);
+        case ConfigKey::WIFI_PASSWORD: return decodeString(config.wifi.password, data, len);
+        case ConfigKey::WIFI_DHCP: return decodeBool(config.wifi.dhcp, data, len);
+        case ConfigKey::WIFI_STATIC_IP: return decodeString(config.wifi.static_ip, data, len);
+        case ConfigKey::WIFI_GATEWAY: return decodeString(config.wifi.gateway, data, len);
+        case ConfigKey::WIFI_SUBNET: return decodeString(config.wifi.subnet, data, len);
+        case ConfigKey::GATEWAY_WEBSOCKET_URL: return decodeString(config.gateway.websocket_url, data, len);
+        case ConfigKey::GATEWAY_FALLBACK_URL: return decodeString(config.gateway.fallback_http_url, data, len);
+        case ConfigKey::GATEWAY_API_KEY: return decodeString(config.gateway.api_key, data, len);
+        case ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS: return decodeU16(config.gateway.reconnect_interval_ms, data, len);
+        case ConfigKey::GATEWAY_PING_INTERVAL_MS: return decodeU16(config.gateway.ping_interval_ms, data, len);
+        case ConfigKey::GATEWAY_CONNECTION_TIMEOUT_MS: return decodeU16(config.gateway.connection_timeout_ms, data, len);
+        case ConfigKey::DEVICE_ID: return decodeString(config.device.id, data, len);
+        case ConfigKey::DEVICE_NAME: return decodeString(config.device.name, data, len);
+        case ConfigKey::DEVICE_FIRMWARE_VERSION: return decodeString(config.device.firmware_version, data, len);
+        case ConfigKey::DEVICE_AUTO_CONNECT: return decodeBool(config.device.auto_connect, data, len);
+        case ConfigKey::DEVICE_SAVE_HISTORY: return decodeBool(config.device.save_history, data, len);
+        case ConfigKey::DEVICE_DISPLAY_BRIGHTNESS: return decodeU8(config.device.display_brightness, data, len);
+        case ConfigKey::AUDIO_SAMPLE_RATE: return decodeU16(config.audio.sample_rate, data, len);
+        case ConfigKey::AUDIO_FRAME_DURATION_MS: return decodeU8(config.audio.frame_duration_ms, data, len);
+        case ConfigKey::AUDIO_CODEC: return decodeString(config.audio.codec, data, len);
+        case ConfigKey::AUDIO_MIC_GAIN: return decodeU8(config.audio.mic_gain, data, len);
+        case ConfigKey::AUDIO_NOISE_SUPPRESSION: return decodeBool(config.audio.noise_suppression, data, len);
+        case ConfigKey::AUDIO_AUTO_GAIN_CONTROL: return decodeBool(config.audio.auto_gain_control, data, len);
+        case ConfigKey::GATEWAY_TLS_FINGERPRINT: return decodeString(config.gateway.tls_fingerprint, data, len);
+        default: return false;
+    }
+}
+
+// =============================================================================
+// Log
+// =============================================================================
+
+void makeConfigLogHeader(uint32_t generation, ConfigLogHeader& header) {
+    memset(&header, 0, sizeof(header));
+    header.magic = CONFIG_LOG_MAGIC;
+    header.version = CONFIG_LOG_VERSION;
+    header.generation = generation;
+    header.crc32 = crc32(&header, offsetof(ConfigLogHeader, crc32));
+}
+
+ConfigKeyMask diffConfig(const AppConfig& from, const AppConfig& to) {
+    uint8_t old_value[MAX_VALUE_SIZE];
+    uint8_t new_value[MAX_VALUE_SIZE];
+    ConfigKeyMask changed = 0;
+
+    for (uint8_t k = 0; k < static_cast<uint8_t>(ConfigKey::COUNT); k++) {
+        ConfigKey key = static_cast<ConfigKey>(k);
+        size_t old_len = encodeKey(from, key, old_value);
+        size_t new_len = encodeKey(to, key, new_value);
+        // Values too long to encode are reported as changed
+        if (old_len != new_len || new_len == SIZE_MAX ||
+            memcmp(old_value, new_value, new_len) != 0) {
+            changed |= configKeyBit(key);
+        }
+    }
+    return changed;
+}
+
+bool buildConfigLogBatch(const AppConfig& from, const AppConfig& to, uint32_t sequence,
+                         uint8_t* out, size_t capacity, size_t& length) {
+    uint8_t old_value[MAX_VALUE_SIZE];
+    uint8_t new_value[MAX_VALUE_SIZE];
+    size_t pos = 0;
+
+    for (uint8_t k = 0; k < static_cast<uint8_t>(ConfigKey::COUNT); k++) {
+        ConfigKey key = static_cast<ConfigKey>(k);
+        size_t new_len = encodeKey(to, key, new_value);
+        if (new_len == SIZE_MAX) return false;
+        size_t old_len = encodeKey(from, key, old_value);
+        if (old_len == new_len && memcmp(old_value, new_value, new_len) == 0) continue;
+
+        if (pos + RECORD_HEADER_SIZE + new_len > capacity) return false;
+        out[pos++] = k;
+        out[pos++] = (uint8_t)new_len;
+        memcpy(out + pos, new_value, new_len);
+        pos += new_len;
+    }
+
+    if (pos == 0) {
+        length = 0;
+        return true;
+    }
+
+    // Commit: sequence and CRC of the records above
+    if (pos + RECORD_HEADER_SIZE + COMMIT_VALUE_SIZE > capacity) return false;
+    uint32_t crc = crc32(out, pos);
+    out[pos++] = CONFIG_LOG_COMMIT;
+    out[pos++] = COMMIT_VALUE_SIZE;
+    memcpy(out + pos, &sequence, sizeof(sequence));
+    memcpy(out + pos + sizeof(sequence), &crc, sizeof(crc));
+    pos += COMMIT_VALUE_SIZE;
+
+    length = pos;
+    return true;
+}
+
+bool replayConfigLog(const uint8_t* data, size_t size, uint32_t generation,
+                     AppConfig& config, ConfigLogReplay& result) {
+    result.sequence = 0;
+    result.batches = 0;
+    result.valid_bytes = 0;
+
+    ConfigLogHeader header;
+    if (size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != CONFIG_LOG_MAGIC ||
+        header.version != CONFIG_LOG_VERSION ||
+        header.crc32 != crc32(&header, offsetof(ConfigLogHeader, crc32)) ||
+        header.generation != generation) {
+        return false;
+    }
+
+    size_t pos = sizeof(header);
+    size_t batch_start = pos;
+    result.valid_bytes = pos;
+
+    while (pos + RECORD_HEADER_SIZE <= size) {
+        uint8_t key = data[pos];
+        size_t len = data[pos + 1];
+        size_t value = pos + RECORD_HEADER_SIZE;
+        if (value + len > size) break;          // Torn record
+
+        if (key != CONFIG_LOG_COMMIT) {
+            if (key >= static_cast<uint8_t>(ConfigKey::COUNT)) break;
+            pos = value + len;
+            continue;
+        }
+
+        uint32_t sequence;
+        uint32_t crc;
+        if (len != COMMIT_VALUE_SIZE) break;
+        memcpy(&sequence, data + value, sizeof(sequence));
+        memcpy(&crc, data + value + sizeof(sequence), sizeof(crc));
+        if (sequence != result.sequence + 1 ||
+            crc != crc32(data + batch_start, pos - batch_start)) {
+            break;
+        }
+
+        // Batch is intact: apply its records in order
+        for (size_t r = batch_start; r < pos; r += RECORD_HEADER_SIZE + data[r + 1]) {
+            decodeKey(config, static_cast<ConfigKey>(data[r]), data + r + RECORD_HEADER_SIZE, data[r + 1]);
+        }
+
+        pos = value + len;
+        batch_start = pos;
+        result.sequence = sequence;
+        result.batches++;
+        result.valid_bytes = pos;
+    }
+
+    return true;
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* configKeyToString(ConfigKey key) {
+    switch (key) {
+        case ConfigKey::WIFI_SSID: return "wifi.ssid";
+        case ConfigKey::WIFI_PASSWORD: return "wifi.password";
+        case ConfigKey::WIFI_DHCP: return "wifi.dhcp";
+        case ConfigKey::WIFI_STATIC_IP: return "wifi.static_ip";
+        case ConfigKey::WIFI_GATEWAY: return "wifi.gateway";
+        case ConfigKey::WIFI_SUBNET: return "wifi.subnet";
+        case ConfigKey::GATEWAY_WEBSOCKET_URL: return "gateway.websocket_url";
+        case ConfigKey::GATEWAY_FALLBACK_URL: return "gateway.fallback_url";
+        case ConfigKey::GATEWAY_API_KEY: return "gateway.api_key";
+        case ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS: return "gateway.reconnect_interval_ms";
+        case ConfigKey::GATEWAY_PING_INTERVAL_MS: return "gateway.ping_interval_ms";
+        case ConfigKey::GATEWAY_CONNECTION_TIMEOUT_MS: return "gateway.connection_timeout_ms";
+        case ConfigKey::DEVICE_ID: return "device.id";
+        case ConfigKey::DEVICE_NAME: return "device.name";
+        case ConfigKey::DEVICE_FIRMWARE_VERSION: return "device.firmware_version";
+        case ConfigKey::DEVICE_AUTO_CONNECT: return "device.auto_connect";
+        case ConfigKey::DEVICE_SAVE_HISTORY: return "device.save_history";
+        case ConfigKey::DEVICE_DISPLAY_BRIGHTNESS: return "device.display_brightness";
+        case ConfigKey::AUDIO_SAMPLE_RATE: return "audio.sample_rate";
+        case ConfigKey::AUDIO_FRAME_DURATION_MS: return "audio.frame_duration_ms";
+        case ConfigKey::AUDIO_CODEC: return "audio.codec";
+        case ConfigKey::AUDIO_MIC_GAIN: return "audio.mic_gain";
+        case ConfigKey::AUDIO_NOISE_SUPPRESSION: return "audio.noise_suppression";
+        case ConfigKey::AUDIO_AUTO_GAIN_CONTROL: return "audio.auto_gain_control";
+        case ConfigKey::GATEWAY_TLS_FINGERPRINT: return "gateway.tls_fingerprint";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
@@ -5,6 +5,7 @@
 
 #include "config_manager.h"
 #include <Arduino.h>
+#include <memory>
 
 namespace OpenClaw {
 
@@ -37,7 +38,7 @@ bool ConfigManager::begin() {
     if (config_file) config_file.close();
     
     if (!config_exists) {
-        save();
+        compact();
     }
     
     return true;
@@ -49,7 +50,31 @@ bool ConfigManager::load() {
         return false;
     }
     
-    return loadFromFile(CONFIG_FILE);
+    uint32_t start = micros();
+    ConfigJsonStamp json_stamp = getJsonStamp();
+    bool ok = true;
+    
+    if (loadBlob(json_stamp)) {
+        load_source_ = ConfigSource::BINARY;
+        if (!replayLog()) {
+            // Fold whatever survived into a fresh image before appending again
+            compact();
+        }
+    } else {
+        ok = loadFromFile(CONFIG_FILE);
+        if (ok) {
+            load_source_ = ConfigSource::JSON;
+            // The log belongs to the old image; cache the import so the
+            // next boot skips the parse
+            LittleFS.remove(CONFIG_LOG_FILE);
+            resetLog(log_generation_ + 1);
+            log_ready_ = saveBlob(json_stamp, log_generation_);
+        }
+    }
+    
+    persisted_ = config_;
+    load_time_us_ = micros() - start;
+    return ok;
 }
 
 bool ConfigManager::save() {
@@ -58,7 +83,74 @@ bool ConfigManager::save() {
         return false;
     }
     
-    return saveToFile(CONFIG_FILE);
+    ConfigKeyMask changed = diffConfig(persisted_, config_);
+    if (changed == 0) {
+        return true;
+    }
+    if (!persist()) {
+        return false;
+    }
+    bus_.publish(changed, config_);
+    return true;
+}
+
+bool ConfigManager::persist() {
+    // Without a base image there is nothing to append to
+    if (!log_ready_) {
+        return compact();
+    }
+    
+    std::unique_ptr<uint8_t[]> batch(new uint8_t[CONFIG_LOG_BATCH_MAX]);
+    size_t length = 0;
+    if (!buildConfigLogBatch(persisted_, config_, log_sequence_ + 1,
+                             batch.get(), CONFIG_LOG_BATCH_MAX, length)) {
+        return compact();
+    }
+    if (length == 0) {
+        persisted_ = config_;
+        return true;
+    }
+    
+    if (!appendLog(batch.get(), length)) {
+        // The tail may be torn; a fresh image makes the log appendable again
+        return compact();
+    }
+    log_sequence_++;
+    persisted_ = config_;
+    
+    // The change is already durable, so a failed compaction is not an error
+    if (log_bytes_ > CONFIG_LOG_COMPACT_BYTES) {
+        compact();
+    }
+    return true;
+}
+
+bool ConfigManager::compact() {
+    if (!initialized_) {
+        strncpy(last_error_, "ConfigManager not initialized", sizeof(last_error_) - 1);
+        return false;
+    }
+    
+    // 1. JSON via rename: once it lands, the old image no longer matches
+    //    its stamp and boot re-imports the (complete) JSON
+    if (!saveToFile(CONFIG_TEMP_FILE) || !LittleFS.rename(CONFIG_TEMP_FILE, CONFIG_FILE)) {
+        LittleFS.remove(CONFIG_TEMP_FILE);
+        return false;
+    }
+    
+    // 2. New image under the next generation; the old log stops matching
+    uint32_t generation = log_generation_ + 1;
+    log_ready_ = saveBlob(getJsonStamp(), generation);
+    if (!log_ready_) {
+        // A stale image would shadow the new JSON, so drop it
+        LittleFS.remove(CONFIG_BLOB_FILE);
+    }
+    
+    // 3. The old log is unreachable now
+    LittleFS.remove(CONFIG_LOG_FILE);
+    resetLog(generation);
+    persisted_ = config_;
+    return true;
 }
 
 void ConfigManager::resetToDefaults() {
@@ -79,6 +171,7 @@ void ConfigManager::printConfig() const {
     Serial.println("\n[Gateway]");
     Serial.printf("  WebSocket URL: %s\n", config_.gateway.websocket_url.c_str());
     Serial.printf("  Fallback URL: %s\n", config_.gateway.fallback_http_url.c_str());
+    Serial.printf("  TLS pin: %s\n", config_.gateway.tls_fingerprint.length() > 0 ? "set" : "none");
     
     Serial.println("\n[Device]");
     Serial.printf("  ID: %s\n", config_.device.id.c_str());
@@ -107,6 +200,7 @@ void ConfigManager::setDefaults() {
     config_.gateway.websocket_url = DEFAULT_GATEWAY_URL;
     config_.gateway.fallback_http_url = DEFAULT_FALLBACK_URL;
     config_.gateway.api_key = "";
+    config_.gateway.tls_fingerprint = "";
     config_.gateway.reconnect_interval_ms = 5000;
     config_.gateway.ping_interval_ms = 30000;
     config_.gateway.connection_timeout_ms = 10000;
@@ -206,6 +300,7 @@ bool ConfigManager::parseJson(const JsonDocument& doc) {
         config_.gateway.websocket_url = gateway["websocket_url"] | DEFAULT_GATEWAY_URL;
         config_.gateway.fallback_http_url = gateway["fallback_url"] | DEFAULT_FALLBACK_URL;
         config_.gateway.api_key = gateway["api_key"] | "";
+        config_.gateway.tls_fingerprint = gateway["tls_fingerprint"] | "";
         config_.gateway.reconnect_interval_ms = gateway["reconnect_interval_ms"] | 5000;
         config_.gateway.ping_interval_ms = gateway["ping_interval_ms"] | 30000;
         config_.gateway.connection_timeout_ms = gateway["connection_timeout_ms"] | 10000;
@@ -251,6 +346,7 @@ bool ConfigManager::serializeToJson(JsonDocument& doc) const {
     gateway["websocket_url"] = config_.gateway.websocket_url;
     gateway["fallback_url"] = config_.gateway.fallback_http_url;
     gateway["api_key"] = config_.gateway.api_key;
+    gateway["tls_fingerprint"] = config_.gateway.tls_fingerprint;
     gateway["reconnect_interval_ms"] = config_.gateway.reconnect_interval_ms;
     gateway["ping_interval_ms"] = config_.gateway.ping_interval_ms;
     gateway["connection_timeout_ms"] = config_.gateway.connection_timeout_ms;
@@ -276,4 +372,152 @@ bool ConfigManager::serializeToJson(JsonDocument& doc) const {
     return true;
 }
 
+bool ConfigManager::loadBlob(const ConfigJsonStamp& json_stamp) {
+    File file = LittleFS.open(CONFIG_BLOB_FILE, "r");
+    if (!file) return false;
+    
+    // One read straight into the fixed layout
+    std::unique_ptr<ConfigBlob> blob(new ConfigBlob);
+    size_t size = file.size();
+    bool ok = size <= sizeof(ConfigBlob) &&
+              file.read(reinterpret_cast<uint8_t*>(blob.get()), size) == size;
+    file.close();
+    
+    if (ok && (size != sizeof(ConfigBlob) || blob->version != CONFIG_BLOB_VERSION)) {
+        // Image from the previous firmware; rewritten at the next compaction
+        std::unique_ptr<ConfigBlob> upgraded(new ConfigBlob);
+        ok = upgradeConfigBlob(reinterpret_cast<const uint8_t*>(blob.get()), size, *upgraded);
+        blob = std::move(upgraded);
+    }
+    
+    if (!ok || !validateConfigBlob(*blob)) {
+        strncpy(last_error_, "Binary config invalid, importing JSON", sizeof(last_error_) - 1);
+        return false;
+    }
+    if (!(blob->json_stamp == json_stamp)) {
+        // config.json was replaced or edited since the image was built
+        return false;
+    }
+    
+    unpackConfigBlob(*blob, config_);
+    log_generation_ = blob->log_generation;
+    log_ready_ = true;
+    return true;
+}
+
+bool ConfigManager::saveBlob(const ConfigJsonStamp& json_stamp, uint32_t log_generation) {
+    std::unique_ptr<ConfigBlob> blob(new ConfigBlob);
+    if (!packConfigBlob(config_, json_stamp, log_generation, *blob)) {
+        strncpy(last_error_, "Config strings too long for binary image", sizeof(last_error_) - 1);
+        return false;
+    }
+    
+    // Write then rename, so a power cut never leaves a torn image
+    File file = LittleFS.open(CONFIG_BLOB_TEMP_FILE, "w");
+    if (!file) {
+        strncpy(last_error_, "Failed to open binary config for writing", sizeof(last_error_) - 1);
+        return false;
+    }
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(blob.get()), sizeof(ConfigBlob)) == sizeof(ConfigBlob);
+    file.close();
+    
+    if (!ok || !LittleFS.rename(CONFIG_BLOB_TEMP_FILE, CONFIG_BLOB_FILE)) {
+        strncpy(last_error_, "Failed to write binary config", sizeof(last_error_) - 1);
+        LittleFS.remove(CONFIG_BLOB_TEMP_FILE);
+        return false;
+    }
+    return true;
+}
+
+bool ConfigManager::replayLog() {
+    File file = LittleFS.open(CONFIG_LOG_FILE, "r");
+    if (!file) {
+        resetLog(log_generation_);  // Nothing saved since the image was built
+        return true;
+    }
+    
+    size_t size = file.size();
+    if (size > CONFIG_LOG_MAX_BYTES) {
+        strncpy(last_error_, "Config log too large, discarding", sizeof(last_error_) - 1);
+        file.close();
+        return false;
+    }
+    
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    bool ok = file.read(data.get(), size) == size;
+    file.close();
+    
+    ConfigLogReplay replay;
+    if (!ok || !replayConfigLog(data.get(), size, log_generation_, config_, replay)) {
+        // Empty, corrupt, or left over from a compaction cut short
+        strncpy(last_error_, "Config log invalid, discarding", sizeof(last_error_) - 1);
+        return false;
+    }
+    
+    log_sequence_ = replay.sequence;
+    log_bytes_ = replay.valid_bytes;
+    if (replay.valid_bytes < size) {
+        strncpy(last_error_, "Config log has a torn tail", sizeof(last_error_) - 1);
+        return false;
+    }
+    return true;
+}
+
+bool ConfigManager::appendLog(const uint8_t* batch, size_t length) {
+    bool fresh = log_bytes_ == 0;
+    File file = LittleFS.open(CONFIG_LOG_FILE, fresh ? "w" : "a");
+    if (!file) {
+        strncpy(last_error_, "Failed to open config log", sizeof(last_error_) - 1);
+        return false;
+    }
+    
+    size_t expected = length;
+    size_t written = 0;
+    if (fresh) {
+        ConfigLogHeader header;
+        makeConfigLogHeader(log_generation_, header);
+        expected += sizeof(header);
+        written += file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+    }
+    written += file.write(batch, length);
+    file.close();   // LittleFS commits the appended bytes here
+    
+    if (written != expected) {
+        strncpy(last_error_, "Failed to append config log", sizeof(last_error_) - 1);
+        return false;
+    }
+    log_bytes_ += expected;
+    return true;
+}
+
+void ConfigManager::resetLog(uint32_t generation) {
+    log_generation_ = generation;
+    log_sequence_ = 0;
+    log_bytes_ = 0;
+}
+
+ConfigJsonStamp ConfigManager::getJsonStamp() const {
+    ConfigJsonStamp stamp = {0, 0};
+    File file = LittleFS.open(CONFIG_FILE, "r");
+    if (file) {
+        stamp.size = file.size();
+        stamp.mtime = (uint32_t)file.getLastWrite();
+        file.close();
+    }
+    return stamp;
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* configSourceToString(ConfigSource source) {
+    switch (source) {
+        case ConfigSource::DEFAULTS: return "DEFAULTS";
+        case ConfigSource::BINARY: return "BINARY";
+        case ConfigSource::JSON: return "JSON";
+        default: return "UNKNOWN";
+    }
+}
+
 } // namespace OpenClaw
@@ -0,0 +1,283 @@
+/**
+ * @file display_compositor.cpp
+ * @brief Layered display compositor implementation
+ */
+
+#include "display_compositor.h"
+#include <algorithm>
+
+namespace OpenClaw {
+
+// =============================================================================
+// DisplayRect
+// =============================================================================
+
+bool DisplayRect::intersects(const DisplayRect& other) const {
+    return !isEmpty() && !other.isEmpty() &&
+           x < other.right() && other.x < right() &&
+           y < other.bottom() && other.y < bottom();
+}
+
+bool DisplayRect::touches(const DisplayRect& other) const {
+    return !isEmpty() && !other.isEmpty() &&
+           x <= other.right() && other.x <= right() &&
+           y <= other.bottom() && other.y <= bottom();
+}
+
+bool DisplayRect::contains(const DisplayRect& other) const {
+    return !isEmpty() && !other.isEmpty() &&
+           other.x >= x && other.right() <= right() &&
+           other.y >= y && other.bottom() <= bottom();
+}
+
+DisplayRect DisplayRect::intersection(const DisplayRect& other) const {
+    int16_t l = std::max(x, other.x);
+    int16_t t = std::max(y, other.y);
+    int16_t r = std::min(right(), other.right());
+    int16_t b = std::min(bottom(), other.bottom());
+    if (r <= l || b <= t) return DisplayRect();
+    return DisplayRect(l, t, r - l, b - t);
+}
+
+DisplayRect DisplayRect::united(const DisplayRect& other) const {
+    if (isEmpty()) return other;
+    if (other.isEmpty()) return *this;
+    int16_t l = std::min(x, other.x);
+    int16_t t = std::min(y, other.y);
+    int16_t r = std::max(right(), other.right());
+    int16_t b = std::max(bottom(), other.bottom());
+    return DisplayRect(l, t, r - l, b - t);
+}
+
+// =============================================================================
+// DisplayCompositor
+// =============================================================================
+
+DisplayCompositor::DisplayCompositor()
+    : display_(nullptr),
+      background_(0x0000),
+      width_(0),
+      height_(0),
+      frozen_(false),
+      initialized_(false) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+DisplayCompositor::~DisplayCompositor() {
+    end();
+}
+
+bool DisplayCompositor::begin(M5GFX* display, uint16_t background) {
+    if (initialized_) return true;
+
+    if (!display) {
+        strncpy(last_error_, "No display", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    display_ = display;
+    background_ = background;
+    width_ = display_->width();
+    height_ = display_->height();
+
+    // Full-frame RGB565 buffer; prefer PSRAM, fall back to internal RAM
+    frame_.setColorDepth(16);
+    frame_.setPsram(psramFound());
+    if (!frame_.createSprite(width_, height_)) {
+        frame_.setPsram(false);
+        if (!frame_.createSprite(width_, height_)) {
+            snprintf(last_error_, sizeof(last_error_),
+                     "Frame buffer alloc failed (%dx%d)", width_, height_);
+            return false;
+        }
+    }
+    frame_.fillSprite(background_);
+
+    initialized_ = true;
+    damageAll();
+    return true;
+}
+
+void DisplayCompositor::end() {
+    if (!initialized_) return;
+
+    frame_.deleteSprite();
+    display_ = nullptr;
+    initialized_ = false;
+}
+
+void DisplayCompositor::setLayer(DisplayLayer layer, const DisplayRect& bounds,
+                                 LayerRenderFn render, bool opaque) {
+    if (layer >= DisplayLayer::COUNT) return;
+
+    Layer& l = layerAt(layer);
+
+    // Old area must be repaired if the layer moves or shrinks
+    if (l.visible && l.render) {
+        layers_[0].damage = layers_[0].damage.united(l.bounds);
+    }
+
+    l.bounds = bounds;
+    l.render = std::move(render);
+    l.opaque = opaque;
+    l.damage = l.damage.united(bounds);
+}
+
+void DisplayCompositor::setLayerVisible(DisplayLayer layer, bool visible) {
+    if (layer >= DisplayLayer::COUNT) return;
+
+    Layer& l = layerAt(layer);
+    if (l.visible == visible) return;
+
+    l.visible = visible;
+    // Hiding exposes whatever lies underneath; showing covers it
+    l.damage = l.bounds;
+}
+
+bool DisplayCompositor::isLayerVisible(DisplayLayer layer) const {
+    if (layer >= DisplayLayer::COUNT) return false;
+    return layerAt(layer).visible;
+}
+
+void DisplayCompositor::damage(DisplayLayer layer) {
+    if (layer >= DisplayLayer::COUNT) return;
+
+    Layer& l = layerAt(layer);
+    if (!l.visible) return;
+    l.damage = l.bounds;
+}
+
+void DisplayCompositor::damage(DisplayLayer layer, const DisplayRect& rect) {
+    if (layer >= DisplayLayer::COUNT) return;
+
+    Layer& l = layerAt(layer);
+    if (!l.visible) return;
+    l.damage = l.damage.united(rect.intersection(l.bounds));
+}
+
+void DisplayCompositor::damageAll() {
+    // Regions are layer-agnostic once collected, so park it on the bottom
+    layers_[0].damage = DisplayRect(0, 0, width_, height_);
+}
+
+bool DisplayCompositor::hasDamage() const {
+    for (const auto& l : layers_) {
+        if (!l.damage.isEmpty()) return true;
+    }
+    return false;
+}
+
+bool DisplayCompositor::compose() {
+    if (!initialized_ || frozen_) return false;
+
+    DisplayRect regions[MAX_DIRTY_REGIONS];
+    size_t count = collectDirtyRegions(regions);
+
+    if (count == 0) {
+        stats_.frames_skipped++;
+        return false;
+    }
+
+    uint32_t start_us = micros();
+
+    // Render every dirty region into the frame first...
+    for (size_t i = 0; i < count; i++) {
+        frame_.setClipRect(regions[i].x, regions[i].y, regions[i].w, regions[i].h);
+        renderRegion(regions[i]);
+    }
+    frame_.clearClipRect();
+
+    // ...then push them all in one bus transaction
+    display_->startWrite();
+    for (size_t i = 0; i < count; i++) {
+        display_->setClipRect(regions[i].x, regions[i].y, regions[i].w, regions[i].h);
+        frame_.pushSprite(display_, 0, 0);
+        stats_.pixels_flushed += regions[i].area();
+    }
+    display_->clearClipRect();
+    display_->endWrite();
+
+    stats_.frames_composed++;
+    stats_.regions_flushed += count;
+    stats_.last_compose_us = micros() - start_us;
+    return true;
+}
+
+size_t DisplayCompositor::collectDirtyRegions(DisplayRect* regions) {
+    const DisplayRect screen(0, 0, width_, height_);
+    size_t count = 0;
+
+    for (auto& l : layers_) {
+        DisplayRect d = l.damage.intersection(screen);
+        l.damage = DisplayRect();
+        if (d.isEmpty()) continue;
+
+        // Merge with any region it touches; repeat until stable so the
+        // result is a set of disjoint rectangles
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            for (size_t i = 0; i < count; i++) {
+                if (regions[i].touches(d)) {
+                    d = d.united(regions[i]);
+                    regions[i] = regions[--count];
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        regions[count++] = d;
+    }
+
+    return count;
+}
+
+void DisplayCompositor::renderRegion(const DisplayRect& region) {
+    // Start from the topmost opaque layer that covers the region;
+    // everything below it would be overdrawn anyway
+    size_t first = 0;
+    bool covered = false;
+    for (size_t i = DISPLAY_LAYER_COUNT; i-- > 0;) {
+        const Layer& l = layers_[i];
+        if (l.visible && l.render && l.opaque && l.bounds.contains(region)) {
+            first = i;
+            covered = true;
+            break;
+        }
+    }
+
+    if (!covered) {
+        frame_.fillRect(region.x, region.y, region.w, region.h, background_);
+    }
+
+    for (size_t i = 0; i < DISPLAY_LAYER_COUNT; i++) {
+        Layer& l = layers_[i];
+        if (!l.visible || !l.render || !l.bounds.intersects(region)) continue;
+
+        if (i < first) {
+            stats_.layers_occluded++;
+            continue;
+        }
+
+        l.render(frame_);
+        stats_.layers_rendered++;
+    }
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* displayLayerToString(DisplayLayer layer) {
+    switch (layer) {
+        case DisplayLayer::AVATAR: return "AVATAR";
+        case DisplayLayer::MESSAGES: return "MESSAGES";
+        case DisplayLayer::STATUS: return "STATUS";
+        case DisplayLayer::INPUT: return "INPUT";
+        case DisplayLayer::MENU_OVERLAY: return "MENU_OVERLAY";
+        case DisplayLayer::SPLASH: return "SPLASH";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
@@ -1,13 +1,14 @@
 /**
  * @file display_renderer.cpp
- * @brief Display renderer implementation (stub)
+ * @brief Display renderer implementation
  */
 
 #include "display_renderer.h"
+#include <algorithm>
 
 namespace OpenClaw {
 
-TextRenderer::TextRenderer(M5Canvas* canvas) : canvas_(canvas) {
+TextRenderer::TextRenderer(lgfx::LovyanGFX* canvas) : canvas_(canvas) {
 }
 
 int16_t TextRenderer::getTextWidth(const char* text) {
@@ -41,17 +42,17 @@ void TextRenderer::renderLine(const char* text, int16_t x, int16_t y, uint16_t c
 }
 
 DisplayRenderer::DisplayRenderer()
-    : main_canvas_(nullptr),
-      avatar_canvas_(nullptr),
-      message_canvas_(nullptr),
-      text_renderer_(nullptr),
+    : text_renderer_(nullptr),
       scroll_position_(0),
+      input_(nullptr),
+      input_scroll_(0),
       input_cursor_pos_(0),
       show_cursor_(true),
       cursor_blink_time_(0),
       cursor_visible_(true),
-      last_status_update_(0),
-      needs_redraw_(true),
+      splash_(SplashScreen::NONE),
+      backlight_level_(0),
+      panel_asleep_(false),
       initialized_(false) {
 }
 
@@ -60,13 +61,29 @@ DisplayRenderer::~DisplayRenderer() {
 }
 
 bool DisplayRenderer::begin(const DisplayConfig& config) {
+    if (initialized_) return true;
+    
     config_ = config;
+    
+    if (!compositor_.begin(&M5Cardputer.Display, Colors::BACKGROUND)) {
+        Serial.printf("Compositor init failed: %s\n", compositor_.getLastError());
+        return false;
+    }
+    
+    text_renderer_.reset(new TextRenderer(compositor_.getCanvas()));
+    registerLayers();
+    M5Cardputer.Display.setBrightness(config_.brightness);
+    backlight_level_ = config_.brightness;
+    
     initialized_ = true;
-    return createCanvases();
+    return true;
 }
 
 void DisplayRenderer::end() {
-    destroyCanvases();
+    if (!initialized_) return;
+    
+    text_renderer_.reset();
+    compositor_.end();
     initialized_ = false;
 }
 
@@ -75,10 +92,20 @@ void DisplayRenderer::update() {
 }
 
 void DisplayRenderer::clear() {
-    if (main_canvas_) {
-        main_canvas_->fillSprite(Colors::BACKGROUND);
-    }
-    markDirty();
+    showMainScreen();
+    compositor_.damageAll();
+}
+
+void DisplayRenderer::registerLayers() {
+    compositor_.setLayer(DisplayLayer::MESSAGES, MESSAGE_AREA_RECT,
+        [this](lgfx::LovyanGFX& gfx) { renderMessages(gfx); });
+    compositor_.setLayer(DisplayLayer::STATUS, STATUS_BAR_RECT,
+        [this](lgfx::LovyanGFX& gfx) { renderStatusBar(gfx); }, true);
+    compositor_.setLayer(DisplayLayer::INPUT, INPUT_AREA_RECT,
+        [this](lgfx::LovyanGFX& gfx) { renderInputArea(gfx); }, true);
+    compositor_.setLayer(DisplayLayer::SPLASH, FULL_SCREEN_RECT,
+        [this](lgfx::LovyanGFX& gfx) { renderSplash(gfx); }, true);
+    compositor_.setLayerVisible(DisplayLayer::SPLASH, false);
 }
 
 void DisplayRenderer::addMessage(const char* text, DisplayMessageType type) {
@@ -87,7 +114,10 @@ void DisplayRenderer::addMessage(const char* text, DisplayMessageType type) {
     if (messages_.size() > MAX_MESSAGE_HISTORY) {
         messages_.erase(messages_.begin());
     }
-    markDirty();
+    if (config_.auto_scroll) {
+        scrollToBottom();
+    }
+    compositor_.damage(DisplayLayer::MESSAGES);
 }
 
 void DisplayRenderer::addMessage(const String& text, DisplayMessageType type) {
@@ -98,237 +128,450 @@ void DisplayRenderer::updateLastMessage(const char* text, bool is_final) {
     if (!messages_.empty()) {
         messages_.back().text = text;
         messages_.back().is_final = is_final;
-        markDirty();
+        compositor_.damage(DisplayLayer::MESSAGES);
+    }
+}
+
+void DisplayRenderer::appendToLastMessage(const char* text, DisplayMessageType type) {
+    if (messages_.empty() || messages_.back().is_final || messages_.back().type != type) {
+        addMessage(text, type);
+        messages_.back().is_final = false;
+        return;
     }
+    messages_.back().text += text;
+    compositor_.damage(DisplayLayer::MESSAGES);
+}
+
+void DisplayRenderer::finishLastMessage(const char* text, DisplayMessageType type) {
+    if (messages_.empty() || messages_.back().is_final || messages_.back().type != type) {
+        addMessage(text, type);
+        return;
+    }
+    updateLastMessage(text, true);
 }
 
 void DisplayRenderer::clearMessages() {
     messages_.clear();
-    markDirty();
+    scroll_position_ = 0;
+    compositor_.damage(DisplayLayer::MESSAGES);
 }
 
 void DisplayRenderer::scrollUp() {
     if (scroll_position_ > 0) {
         scroll_position_--;
-        markDirty();
+        compositor_.damage(DisplayLayer::MESSAGES);
     }
 }
 
 void DisplayRenderer::scrollDown() {
-    if (scroll_position_ < messages_.size() - VISIBLE_MESSAGES) {
+    if (scroll_position_ < maxScrollPosition()) {
         scroll_position_++;
-        markDirty();
+        compositor_.damage(DisplayLayer::MESSAGES);
     }
 }
 
 void DisplayRenderer::scrollToBottom() {
-    if (messages_.size() > VISIBLE_MESSAGES) {
-        scroll_position_ = messages_.size() - VISIBLE_MESSAGES;
-    } else {
-        scroll_position_ = 0;
-    }
-    markDirty();
+    setScrollPosition(maxScrollPosition());
 }
 
 void DisplayRenderer::setScrollPosition(uint8_t position) {
-    scroll_position_ = position;
-    markDirty();
+    if (position > maxScrollPosition()) {
+        position = maxScrollPosition();
+    }
+    if (position != scroll_position_) {
+        scroll_position_ = position;
+        compositor_.damage(DisplayLayer::MESSAGES);
+    }
+}
+
+uint8_t DisplayRenderer::maxScrollPosition() const {
+    return messages_.size() > VISIBLE_MESSAGES ? messages_.size() - VISIBLE_MESSAGES : 0;
 }
 
-void DisplayRenderer::setInputText(const char* text, size_t cursor_pos) {
-    input_text_ = text;
-    input_cursor_pos_ = cursor_pos;
-    markDirty();
+void DisplayRenderer::setInputBuffer(const InputBuffer* buffer) {
+    input_ = buffer;
+    input_scroll_ = 0;
+    input_cursor_pos_ = buffer ? buffer->getCursor() : 0;
+    scrollInputToCursor();
+    compositor_.damage(DisplayLayer::INPUT);
 }
 
-void DisplayRenderer::clearInput() {
-    input_text_ = "";
-    input_cursor_pos_ = 0;
-    markDirty();
+void DisplayRenderer::onInputChanged(const InputChange& change) {
+    if (!input_) return;
+
+    size_t old_cursor = input_cursor_pos_;
+    input_cursor_pos_ = change.new_cursor;
+    // Keep the cursor solid while typing
+    cursor_visible_ = true;
+    cursor_blink_time_ = millis();
+
+    if (scrollInputToCursor()) {
+        compositor_.damage(DisplayLayer::INPUT);
+        return;
+    }
+
+    if (!change.isCursorOnly()) {
+        // A same-length replacement stays put; anything else shifts the tail
+        size_t end = (change.removed == change.inserted)
+            ? change.pos + change.inserted
+            : input_scroll_ + INPUT_VISIBLE_COLS;
+        damageInputColumns(change.pos, end);
+    }
+    damageInputColumns(old_cursor, old_cursor + 1);
+    damageInputColumns(input_cursor_pos_, input_cursor_pos_ + 1);
 }
 
 void DisplayRenderer::showInputCursor(bool show) {
+    if (show_cursor_ == show) return;
     show_cursor_ = show;
-    markDirty();
+    compositor_.damage(DisplayLayer::INPUT);
 }
 
 void DisplayRenderer::setConnectionStatus(ConnectionIndicator status) {
+    if (status_data_.connection == status) return;
     status_data_.connection = status;
-    markDirty();
+    compositor_.damage(DisplayLayer::STATUS);
 }
 
 void DisplayRenderer::setAudioStatus(AudioIndicator status) {
+    if (status_data_.audio == status) return;
     status_data_.audio = status;
-    markDirty();
+    compositor_.damage(DisplayLayer::STATUS);
 }
 
 void DisplayRenderer::setWiFiSignal(int8_t rssi) {
+    // Only the bar count is visible; ignore RSSI jitter within a bar
+    bool changed = wifiSignalBars(rssi) != wifiSignalBars(status_data_.wifi_rssi);
     status_data_.wifi_rssi = rssi;
-    markDirty();
+    if (changed) {
+        compositor_.damage(DisplayLayer::STATUS);
+    }
 }
 
 void DisplayRenderer::setBatteryStatus(uint8_t percent, bool charging) {
+    if (status_data_.battery_percent == percent && status_data_.charging == charging) return;
     status_data_.battery_percent = percent;
     status_data_.charging = charging;
-    markDirty();
+    compositor_.damage(DisplayLayer::STATUS);
 }
 
 void DisplayRenderer::setStatusText(const char* text) {
+    if (strncmp(status_data_.status_text, text, sizeof(status_data_.status_text) - 1) == 0) return;
     strncpy(status_data_.status_text, text, sizeof(status_data_.status_text) - 1);
     status_data_.status_text[sizeof(status_data_.status_text) - 1] = '\0';
-    markDirty();
-}
-
-void DisplayRenderer::clearAvatarArea() {
-    if (avatar_canvas_) {
-        avatar_canvas_->fillSprite(Colors::BACKGROUND);
-    }
-    markDirty();
+    compositor_.damage(DisplayLayer::STATUS);
 }
 
 void DisplayRenderer::renderBootScreen(const char* firmware_version) {
-    M5Cardputer.Display.fillScreen(Colors::BACKGROUND);
-    M5Cardputer.Display.setTextColor(Colors::TEXT_USER);
-    M5Cardputer.Display.drawString("OpenClaw Cardputer", 10, 10);
-    M5Cardputer.Display.drawString(String("v") + firmware_version, 10, 30);
-    M5Cardputer.Display.drawString("Booting...", 10, 60);
+    showSplash(SplashScreen::BOOT, firmware_version);
+    // Shown during setup(), before the main loop starts composing
+    compositor_.compose();
 }
 
 void DisplayRenderer::renderConnectionScreen(const char* ssid) {
-    M5Cardputer.Display.fillScreen(Colors::BACKGROUND);
-    M5Cardputer.Display.setTextColor(Colors::TEXT_USER);
-    M5Cardputer.Display.drawString("Connecting to WiFi", 10, 10);
-    M5Cardputer.Display.drawString(String("SSID: ") + ssid, 10, 30);
+    showSplash(SplashScreen::CONNECTING, ssid);
 }
 
 void DisplayRenderer::renderErrorScreen(const char* error) {
-    M5Cardputer.Display.fillScreen(Colors::BACKGROUND);
-    M5Cardputer.Display.setTextColor(Colors::TEXT_ERROR);
-    M5Cardputer.Display.drawString("Error", 10, 10);
-    M5Cardputer.Display.drawString(error, 10, 30);
+    showSplash(SplashScreen::ERROR, error);
+    compositor_.compose();
+}
+
+void DisplayRenderer::showMainScreen() {
+    splash_ = SplashScreen::NONE;
+    compositor_.setLayerVisible(DisplayLayer::SPLASH, false);
+}
+
+void DisplayRenderer::showSplash(SplashScreen screen, const char* text) {
+    splash_ = screen;
+    splash_text_ = text ? text : "";
+    compositor_.setLayerVisible(DisplayLayer::SPLASH, true);
+    compositor_.damage(DisplayLayer::SPLASH);
 }
 
-void DisplayRenderer::renderMainScreen() {
-    if (!needs_redraw_) return;
+bool DisplayRenderer::render() {
+    if (!initialized_) return false;
+    return compositor_.compose();
+}
+
+void DisplayRenderer::renderSplash(lgfx::LovyanGFX& gfx) {
+    gfx.fillScreen(Colors::BACKGROUND);
+    gfx.setTextSize(1);
     
-    // Clear screen before rendering
-    M5Cardputer.Display.fillScreen(Colors::BACKGROUND);
+    switch (splash_) {
+        case SplashScreen::BOOT:
+            gfx.setTextColor(Colors::TEXT_USER);
+            gfx.drawString("OpenClaw Cardputer", 10, 10);
+            gfx.drawString(String("v") + splash_text_, 10, 30);
+            gfx.drawString("Booting...", 10, 60);
+            break;
+        case SplashScreen::CONNECTING:
+            gfx.setTextColor(Colors::TEXT_USER);
+            gfx.drawString("Connecting to WiFi", 10, 10);
+            gfx.drawString(String("SSID: ") + splash_text_, 10, 30);
+            break;
+        case SplashScreen::ERROR:
+            gfx.setTextColor(Colors::TEXT_ERROR);
+            gfx.drawString("Error", 10, 10);
+            gfx.drawString(splash_text_, 10, 30);
+            break;
+        default:
+            break;
+    }
+}
+
+void DisplayRenderer::renderStatusBar(lgfx::LovyanGFX& gfx) {
+    gfx.fillRect(0, 0, DISPLAY_WIDTH, STATUS_BAR_HEIGHT, Colors::STATUS_BAR_BG);
+    gfx.setTextSize(1);
+    
+    drawWiFiIcon(gfx, 2, 3, status_data_.wifi_rssi);
+    drawStatusIcon(gfx, 22, 4, status_data_.connection);
+    drawAudioIcon(gfx, 112, 4, status_data_.audio);
+    
+    // Free-form status text, right-aligned before the battery
+    if (status_data_.status_text[0] != '\0') {
+        int16_t text_x = DISPLAY_WIDTH - 30 - gfx.textWidth(status_data_.status_text);
+        gfx.setTextColor(Colors::STATUS_WARN, Colors::STATUS_BAR_BG);
+        gfx.setCursor(text_x, 4);
+        gfx.print(status_data_.status_text);
+    }
     
-    renderStatusBar();
-    renderMessages();
-    renderInputArea();
-    needs_redraw_ = false;
+    drawBatteryIcon(gfx, DISPLAY_WIDTH - 24, 4, status_data_.battery_percent, status_data_.charging);
 }
 
-void DisplayRenderer::renderStatusBar() {
-    // Draw status bar background
-    M5Cardputer.Display.fillRect(0, 0, DISPLAY_WIDTH, STATUS_BAR_HEIGHT, Colors::STATUS_BAR_BG);
+void DisplayRenderer::renderMessages(lgfx::LovyanGFX& gfx) {
+    // Transparent layer: the avatar shows through between lines
+    gfx.setTextSize(1);
     
-    // Connection status
-    const char* conn_text = "Disconnected";
-    uint16_t conn_color = Colors::STATUS_BAD;
-    if (status_data_.connection == ConnectionIndicator::CONNECTED) {
-        conn_text = "Connected";
-        conn_color = Colors::STATUS_GOOD;
-    } else if (status_data_.connection == ConnectionIndicator::CONNECTING) {
-        conn_text = "Connecting...";
-        conn_color = Colors::STATUS_WARN;
+    int16_t y = MESSAGE_AREA_Y + 1;
+    size_t end = std::min(messages_.size(), (size_t)scroll_position_ + VISIBLE_MESSAGES);
+    for (size_t i = scroll_position_; i < end; i++) {
+        drawMessage(gfx, messages_[i], y);
+        y += MESSAGE_LINE_HEIGHT;
     }
     
-    M5Cardputer.Display.setCursor(2, 4);
-    M5Cardputer.Display.setTextColor(conn_color);
-    M5Cardputer.Display.setTextSize(1);
-    M5Cardputer.Display.print(conn_text);
+    if (messages_.size() > VISIBLE_MESSAGES) {
+        drawScrollbar(gfx);
+    }
 }
 
-void DisplayRenderer::renderMessages() {
-    // Show last few messages
-    int16_t y = MESSAGE_AREA_Y;
-    for (const auto& msg : messages_) {
-        if (y + 16 > MESSAGE_AREA_Y + MESSAGE_AREA_HEIGHT) break;
-        
-        uint16_t color = Colors::TEXT_SYSTEM;
-        if (msg.type == DisplayMessageType::USER_MSG) color = Colors::TEXT_USER;
-        else if (msg.type == DisplayMessageType::AI_MSG) color = Colors::TEXT_AI;
+void DisplayRenderer::drawMessage(lgfx::LovyanGFX& gfx, const DisplayMessage& msg, int16_t y) {
+    uint16_t color;
+    switch (msg.type) {
+        case DisplayMessageType::USER_MSG: color = config_.text_color_user; break;
+        case DisplayMessageType::AI_MSG: color = config_.text_color_ai; break;
+        case DisplayMessageType::ERROR_MSG: color = config_.text_color_error; break;
+        default: color = config_.text_color_system; break;
+    }
+    
+    gfx.setTextColor(color);
+    gfx.setCursor(4, y);
+    gfx.print(getMessagePrefix(msg.type));
+    
+    // Single line per message; truncate to the area width
+    int16_t max_width = DISPLAY_WIDTH - gfx.getCursorX() - SCROLLBAR_WIDTH - 2;
+    if (gfx.textWidth(msg.text.c_str()) <= max_width) {
+        gfx.print(msg.text.c_str());
+    } else {
+        String text = msg.text;
+        int16_t ellipsis_width = gfx.textWidth("...");
+        while (text.length() > 0 && gfx.textWidth(text.c_str()) + ellipsis_width > max_width) {
+            text.remove(text.length() - 1);
+        }
+        gfx.print(text.c_str());
+        gfx.print("...");
+    }
+}
+
+void DisplayRenderer::drawScrollbar(lgfx::LovyanGFX& gfx) {
+    int16_t x = DISPLAY_WIDTH - SCROLLBAR_WIDTH;
+    
+    int16_t thumb_h = (int16_t)(MESSAGE_AREA_HEIGHT * VISIBLE_MESSAGES / messages_.size());
+    if (thumb_h < 4) thumb_h = 4;
+    int16_t thumb_y = MESSAGE_AREA_Y +
+        (int16_t)((MESSAGE_AREA_HEIGHT - thumb_h) * scroll_position_ / maxScrollPosition());
+    
+    gfx.fillRect(x, thumb_y, SCROLLBAR_WIDTH, thumb_h, Colors::SCROLLBAR);
+}
+
+void DisplayRenderer::renderInputArea(lgfx::LovyanGFX& gfx) {
+    gfx.fillRect(0, INPUT_AREA_Y, DISPLAY_WIDTH, INPUT_AREA_HEIGHT, Colors::BACKGROUND);
+    gfx.drawRect(0, INPUT_AREA_Y, DISPLAY_WIDTH, INPUT_AREA_HEIGHT, Colors::TEXT_SYSTEM);
+    
+    if (!input_) return;
+    
+    // Only the visible columns that fall inside the clip are drawn
+    int32_t clip_x, clip_y, clip_w, clip_h;
+    gfx.getClipRect(&clip_x, &clip_y, &clip_w, &clip_h);
+    int32_t left = clip_x - INPUT_TEXT_X;
+    int32_t right = clip_x + clip_w - INPUT_TEXT_X;
+    size_t first = left > 0 ? left / INPUT_GLYPH_WIDTH : 0;
+    size_t last = right > 0 ? (right + INPUT_GLYPH_WIDTH - 1) / INPUT_GLYPH_WIDTH : 0;
+    if (last > INPUT_VISIBLE_COLS) last = INPUT_VISIBLE_COLS;
+    
+    if (first < last) {
+        char glyphs[INPUT_VISIBLE_COLS + 1];
+        size_t count = input_->copyRange(input_scroll_ + first, last - first, glyphs);
+        glyphs[count] = '\0';
         
-        M5Cardputer.Display.setCursor(4, y);
-        M5Cardputer.Display.setTextColor(color);
-        M5Cardputer.Display.setTextSize(1);
-        M5Cardputer.Display.print(msg.text.c_str());
-        y += 16;
+        gfx.setCursor(INPUT_TEXT_X + first * INPUT_GLYPH_WIDTH, INPUT_TEXT_Y);
+        gfx.setTextColor(Colors::TEXT_INPUT);
+        gfx.setTextSize(1);
+        gfx.print(glyphs);
+    }
+    
+    if (show_cursor_ && cursor_visible_) {
+        int16_t cursor_x = INPUT_TEXT_X + (input_cursor_pos_ - input_scroll_) * INPUT_GLYPH_WIDTH;
+        gfx.fillRect(cursor_x, INPUT_AREA_Y + 2, INPUT_CURSOR_WIDTH, 10, Colors::CURSOR);
     }
 }
 
-void DisplayRenderer::renderInputArea() {
-    // Draw input area background
-    M5Cardputer.Display.fillRect(0, INPUT_AREA_Y, DISPLAY_WIDTH, INPUT_AREA_HEIGHT, Colors::BACKGROUND);
-    M5Cardputer.Display.drawRect(0, INPUT_AREA_Y, DISPLAY_WIDTH, INPUT_AREA_HEIGHT, Colors::TEXT_SYSTEM);
+bool DisplayRenderer::scrollInputToCursor() {
+    size_t old_scroll = input_scroll_;
+    if (input_cursor_pos_ < input_scroll_) {
+        input_scroll_ = input_cursor_pos_ > INPUT_VISIBLE_COLS / 2
+            ? input_cursor_pos_ - INPUT_VISIBLE_COLS / 2 : 0;
+    } else if (input_cursor_pos_ >= input_scroll_ + INPUT_VISIBLE_COLS) {
+        // Jump half a window so typing at the end scrolls (and fully
+        // redraws) only every few characters
+        input_scroll_ = input_cursor_pos_ - INPUT_VISIBLE_COLS / 2;
+    }
+    return input_scroll_ != old_scroll;
+}
+
+void DisplayRenderer::damageInputColumns(size_t first, size_t last) {
+    if (first < input_scroll_) first = input_scroll_;
+    if (last > input_scroll_ + INPUT_VISIBLE_COLS) last = input_scroll_ + INPUT_VISIBLE_COLS;
+    if (first >= last) return;
     
-    // Show current input
-    M5Cardputer.Display.setCursor(4, INPUT_AREA_Y + 4);
-    M5Cardputer.Display.setTextColor(Colors::TEXT_INPUT);
-    M5Cardputer.Display.setTextSize(1);
-    M5Cardputer.Display.print(input_text_.c_str());
+    // The cursor block is wider than a glyph, so pad the span to cover it
+    int16_t x = INPUT_TEXT_X + (first - input_scroll_) * INPUT_GLYPH_WIDTH;
+    int16_t w = (last - first) * INPUT_GLYPH_WIDTH + (INPUT_CURSOR_WIDTH - INPUT_GLYPH_WIDTH);
+    compositor_.damage(DisplayLayer::INPUT, DisplayRect(x, INPUT_AREA_Y + 1, w, INPUT_AREA_HEIGHT - 2));
+}
+
+void DisplayRenderer::drawStatusIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, ConnectionIndicator status) {
+    const char* text = "Disconnected";
+    uint16_t color = Colors::STATUS_BAD;
+    switch (status) {
+        case ConnectionIndicator::CONNECTED:
+            text = "Connected";
+            color = Colors::STATUS_GOOD;
+            break;
+        case ConnectionIndicator::CONNECTING:
+            text = "Connecting...";
+            color = Colors::STATUS_WARN;
+            break;
+        case ConnectionIndicator::ERROR:
+            text = "Error";
+            break;
+        default:
+            break;
+    }
     
-    // Cursor
-    if (cursor_visible_) {
-        int16_t cursor_x = 4 + text_renderer_->getTextWidth(input_text_.substring(0, input_cursor_pos_).c_str());
-        M5Cardputer.Display.fillRect(cursor_x, INPUT_AREA_Y + 2, 8, 10, Colors::CURSOR);
+    gfx.setTextColor(color, Colors::STATUS_BAR_BG);
+    gfx.setCursor(x, y);
+    gfx.print(text);
+}
+
+void DisplayRenderer::drawAudioIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, AudioIndicator status) {
+    const char* text = nullptr;
+    uint16_t color = Colors::STATUS_GOOD;
+    switch (status) {
+        case AudioIndicator::LISTENING: text = "[oo]"; break;
+        case AudioIndicator::PROCESSING: text = "[~~]"; color = Colors::STATUS_WARN; break;
+        case AudioIndicator::SPEAKING: text = "[<>]"; break;
+        case AudioIndicator::ERROR: text = "[!!]"; color = Colors::STATUS_BAD; break;
+        default: break;
+    }
+    if (!text) return;
+    
+    gfx.setTextColor(color, Colors::STATUS_BAR_BG);
+    gfx.setCursor(x, y);
+    gfx.print(text);
+}
+
+void DisplayRenderer::drawWiFiIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, int8_t rssi) {
+    int8_t bars = wifiSignalBars(rssi);
+    for (int8_t i = 0; i < 4; i++) {
+        int16_t h = 3 + i * 3;
+        uint16_t color = (i < bars) ? Colors::STATUS_GOOD : Colors::SCROLLBAR;
+        gfx.fillRect(x + i * 4, y + 10 - h, 3, h, color);
+    }
+}
+
+void DisplayRenderer::drawBatteryIcon(lgfx::LovyanGFX& gfx, int16_t x, int16_t y, uint8_t percent, bool charging) {
+    uint16_t color = (percent > 50) ? Colors::STATUS_GOOD
+                   : (percent > 20) ? Colors::STATUS_WARN : Colors::STATUS_BAD;
+    
+    gfx.drawRect(x, y, 18, 8, Colors::TEXT_USER);
+    gfx.fillRect(x + 18, y + 2, 2, 4, Colors::TEXT_USER);
+    gfx.fillRect(x + 1, y + 1, (int16_t)(16 * (percent > 100 ? 100 : percent) / 100), 6,
+                 charging ? Colors::TEXT_INPUT : color);
+}
+
+const char* DisplayRenderer::getMessagePrefix(DisplayMessageType type) const {
+    switch (type) {
+        case DisplayMessageType::USER_MSG: return "> ";
+        case DisplayMessageType::AI_MSG: return "< ";
+        case DisplayMessageType::ERROR_MSG: return "! ";
+        case DisplayMessageType::STATUS_MSG: return "* ";
+        case DisplayMessageType::SYSTEM_MSG: return "# ";
+        default: return "";
     }
 }
 
 void DisplayRenderer::setBrightness(uint8_t brightness) {
     config_.brightness = brightness;
-    M5Cardputer.Display.setBrightness(brightness);
+    setBacklightLevel(brightness);
 }
 
 void DisplayRenderer::setConfig(const DisplayConfig& config) {
     config_ = config;
-    markDirty();
+    setBacklightLevel(config_.brightness);
+    compositor_.damageAll();
 }
 
-void DisplayRenderer::redraw() {
-    markDirty();
-    renderMainScreen();
+void DisplayRenderer::setBacklightLevel(uint8_t level) {
+    backlight_level_ = level;
+    if (!panel_asleep_) {
+        M5Cardputer.Display.setBrightness(level);
+    }
 }
 
-bool DisplayRenderer::createCanvases() {
-    // Stub - would create off-screen canvases
-    return true;
+void DisplayRenderer::restoreBacklight() {
+    setBacklightLevel(config_.brightness);
+}
+
+void DisplayRenderer::sleepPanel() {
+    if (panel_asleep_) return;
+    compositor_.setFrozen(true);
+    M5Cardputer.Display.setBrightness(0);
+    M5Cardputer.Display.sleep();
+    panel_asleep_ = true;
 }
 
-void DisplayRenderer::destroyCanvases() {
-    // Stub
+void DisplayRenderer::wakePanel() {
+    if (!panel_asleep_) return;
+    M5Cardputer.Display.wakeup();
+    panel_asleep_ = false;
+    M5Cardputer.Display.setBrightness(backlight_level_);
+    compositor_.setFrozen(false);
+}
+
+void DisplayRenderer::redraw() {
+    compositor_.damageAll();
+    render();
 }
 
 void DisplayRenderer::updateCursorBlink() {
+    if (!show_cursor_) return;
+    
     uint32_t now = millis();
     if (now - cursor_blink_time_ >= 500) {
         cursor_blink_time_ = now;
         cursor_visible_ = !cursor_visible_;
-        markDirty();
-    }
-}
-
-uint16_t DisplayRenderer::getMessageColor(MessageType type) const {
-    switch (type) {
-        case MessageType::TEXT: return Colors::TEXT_USER;
-        case MessageType::RESPONSE:
-        case MessageType::RESPONSE_FINAL: return Colors::TEXT_AI;
-        case MessageType::ERROR: return Colors::TEXT_ERROR;
-        case MessageType::STATUS: return Colors::TEXT_SYSTEM;
-        default: return Colors::TEXT_USER;
-    }
-}
-
-const char* DisplayRenderer::getMessagePrefix(MessageType type) const {
-    switch (type) {
-        case MessageType::TEXT: return "> ";
-        case MessageType::RESPONSE:
-        case MessageType::RESPONSE_FINAL: return "< ";
-        case MessageType::ERROR: return "! ";
-        case MessageType::STATUS: return "* ";
-        default: return "";
+        damageInputColumns(input_cursor_pos_, input_cursor_pos_ + 1);
     }
 }
 
@@ -364,6 +607,14 @@ const char* audioIndicatorToString(AudioIndicator status) {
     }
 }
 
+int8_t wifiSignalBars(int8_t rssi) {
+    if (rssi >= -50) return 4;
+    if (rssi >= -60) return 3;
+    if (rssi >= -70) return 2;
+    if (rssi >= -80) return 1;
+    return 0;
+}
+
 uint16_t colorForDisplayMessageType(DisplayMessageType type) {
     switch (type) {
         case DisplayMessageType::USER_MSG: return Colors::TEXT_USER;
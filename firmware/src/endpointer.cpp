@@ -0,0 +1,186 @@
+/**
+ * @file endpointer.cpp
+ * @brief End-of-utterance detection implementation
+ */
+
+#include "endpointer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace OpenClaw {
+
+Endpointer::Endpointer(const EndpointerConfig& config)
+    : config_(config),
+      pause_count_(0),
+      pause_next_(0),
+      energy_count_(0),
+      energy_next_(0),
+      in_pause_(false),
+      hint_sent_(false),
+      pause_start_ms_(0),
+      hangover_ms_(config.hangover_ms),
+      hint_ms_(0),
+      frame_ms_(0),
+      ended_(false),
+      ended_at_ms_(0),
+      ended_pause_ms_(0),
+      utterances_(0),
+      hints_(0),
+      hints_withdrawn_(0),
+      truncations_(0) {}
+
+void Endpointer::startUtterance(uint32_t now_ms) {
+    // Speech straight after an end: the pause was mid-utterance after all
+    if (ended_) {
+        uint32_t pause_ms = ended_pause_ms_ + (now_ms - ended_at_ms_);
+        if (pause_ms <= 2u * config_.max_hangover_ms) {
+            truncations_++;
+            recordPause(std::min<uint32_t>(pause_ms, config_.max_hangover_ms));
+        }
+        ended_ = false;
+    }
+
+    energy_count_ = 0;
+    energy_next_ = 0;
+    in_pause_ = false;
+    hint_sent_ = false;
+    utterances_++;
+}
+
+EndpointEvent Endpointer::update(bool is_speech, float rms, uint16_t frame_ms, uint32_t now_ms) {
+    frame_ms_ = frame_ms;
+
+    if (is_speech) {
+        EndpointEvent event = EndpointEvent::NONE;
+        if (in_pause_) {
+            recordPause(now_ms - pause_start_ms_);
+            in_pause_ = false;
+            // The slope is of the stretch of speech before the next pause
+            energy_count_ = 0;
+            energy_next_ = 0;
+            if (hint_sent_) {
+                hint_sent_ = false;
+                hints_withdrawn_++;
+                event = EndpointEvent::RESUMED;
+            }
+        }
+
+        energy_db_[energy_next_] = 20.0f * std::log10(std::max(rms, 1.0f));
+        energy_next_ = (energy_next_ + 1) % ENERGY_HISTORY;
+        if (energy_count_ < ENERGY_HISTORY) energy_count_++;
+        return event;
+    }
+
+    if (!in_pause_) {
+        beginPause(now_ms);
+    }
+
+    uint32_t elapsed = now_ms - pause_start_ms_;
+    if (elapsed >= hangover_ms_) {
+        in_pause_ = false;
+        hint_sent_ = false;
+        ended_ = true;
+        ended_at_ms_ = now_ms;
+        ended_pause_ms_ = elapsed;
+        return EndpointEvent::FINAL;
+    }
+
+    if (config_.hint && !hint_sent_ && elapsed >= hint_ms_) {
+        hint_sent_ = true;
+        hints_++;
+        return EndpointEvent::LIKELY_FINAL;
+    }
+
+    return EndpointEvent::NONE;
+}
+
+uint32_t Endpointer::getLongPauseMs() const {
+    if (pause_count_ == 0) return 0;
+
+    uint16_t sorted[PAUSE_HISTORY];
+    std::copy(pauses_, pauses_ + pause_count_, sorted);
+    size_t index = static_cast<size_t>(pause_count_ * config_.pause_quantile);
+    if (index >= pause_count_) index = pause_count_ - 1;
+    std::nth_element(sorted, sorted + index, sorted + pause_count_);
+    return sorted[index];
+}
+
+void Endpointer::resetStats() {
+    pause_count_ = 0;
+    pause_next_ = 0;
+    ended_ = false;
+    hangover_ms_ = config_.hangover_ms;
+}
+
+void Endpointer::recordPause(uint32_t pause_ms) {
+    // Gaps shorter than a frame are VAD flicker, not pauses
+    if (pause_ms < frame_ms_) return;
+
+    pauses_[pause_next_] = static_cast<uint16_t>(std::min<uint32_t>(pause_ms, UINT16_MAX));
+    pause_next_ = (pause_next_ + 1) % PAUSE_HISTORY;
+    if (pause_count_ < PAUSE_HISTORY) pause_count_++;
+}
+
+void Endpointer::beginPause(uint32_t now_ms) {
+    in_pause_ = true;
+    pause_start_ms_ = now_ms;
+
+    if (!config_.adaptive) {
+        hangover_ms_ = config_.hangover_ms;
+    } else {
+        // Well past nearly every pause this speaker makes mid-utterance
+        float hangover = config_.hangover_ms;
+        if (pause_count_ >= MIN_PAUSES) {
+            hangover = getLongPauseMs() * config_.pause_margin + frame_ms_;
+        }
+
+        // Trailing off reads as the end of a sentence; an abrupt stop
+        // more often as a breath or a search for the next word
+        if (energySlopePer100ms() <= -config_.falling_db_per_100ms) {
+            hangover *= config_.falling_scale;
+        }
+
+        hangover = std::max(hangover, static_cast<float>(config_.min_hangover_ms));
+        hangover = std::min(hangover, static_cast<float>(config_.max_hangover_ms));
+        hangover_ms_ = static_cast<uint32_t>(hangover);
+    }
+
+    hint_ms_ = static_cast<uint32_t>(hangover_ms_ * config_.hint_fraction);
+}
+
+float Endpointer::energySlopePer100ms() const {
+    if (frame_ms_ == 0) return 0.0f;
+    size_t count = std::min<size_t>(energy_count_, (config_.slope_window_ms + frame_ms_ - 1) / frame_ms_);
+    if (count < 3) return 0.0f;
+
+    // Least-squares slope over the last voiced frames, oldest first
+    size_t first = (energy_next_ + ENERGY_HISTORY - count) % ENERGY_HISTORY;
+    float n = static_cast<float>(count);
+    float mean_x = (n - 1.0f) / 2.0f;
+    float mean_y = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        mean_y += energy_db_[(first + i) % ENERGY_HISTORY];
+    }
+    mean_y /= n;
+
+    float num = 0.0f;
+    float den = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float dx = i - mean_x;
+        num += dx * (energy_db_[(first + i) % ENERGY_HISTORY] - mean_y);
+        den += dx * dx;
+    }
+    return (num / den) * (100.0f / frame_ms_);
+}
+
+const char* endpointEventToString(EndpointEvent event) {
+    switch (event) {
+        case EndpointEvent::NONE: return "NONE";
+        case EndpointEvent::LIKELY_FINAL: return "LIKELY_FINAL";
+        case EndpointEvent::RESUMED: return "RESUMED";
+        case EndpointEvent::FINAL: return "FINAL";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,72 @@
+/**
+ * @file event_loop.cpp
+ * @brief Event-driven main loop implementation
+ */
+
+#include "event_loop.h"
+
+namespace OpenClaw {
+
+EventLoop::EventLoop()
+    : group_(nullptr),
+      last_wake_us_(0) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+EventLoop::~EventLoop() {
+    end();
+}
+
+bool EventLoop::begin() {
+    if (group_) return true;
+
+    group_ = xEventGroupCreate();
+    if (!group_) {
+        strncpy(last_error_, "Failed to create event group", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    last_wake_us_ = micros();
+    return true;
+}
+
+void EventLoop::end() {
+    if (group_) {
+        vEventGroupDelete(group_);
+        group_ = nullptr;
+    }
+}
+
+uint32_t EventLoop::wait(uint32_t timeout_ms) {
+    TickType_t ticks = (timeout_ms == LOOP_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+
+    if (!group_) {
+        // No event group: degrade to a short sleep so the loop never spins
+        // and producers are still picked up
+        TickType_t fallback = pdMS_TO_TICKS(10);
+        vTaskDelay(ticks < fallback ? (ticks > 0 ? ticks : 1) : fallback);
+        return 0;
+    }
+
+    uint32_t start_us = micros();
+    stats_.busy_us += start_us - last_wake_us_;
+
+    EventBits_t bits = xEventGroupWaitBits(group_, LOOP_SIGNAL_ALL,
+                                           pdTRUE,    // Clear on exit
+                                           pdFALSE,   // Any bit
+                                           ticks);
+    uint32_t signals = bits & LOOP_SIGNAL_ALL;
+
+    last_wake_us_ = micros();
+    stats_.idle_us += last_wake_us_ - start_us;
+    stats_.wakeups++;
+    if (signals) {
+        stats_.signal_wakeups++;
+    } else {
+        stats_.timeout_wakeups++;
+    }
+
+    return signals;
+}
+
+} // namespace OpenClaw
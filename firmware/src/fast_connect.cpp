@@ -0,0 +1,185 @@
+/**
+ * @file fast_connect.cpp
+ * @brief Boot fast-connect cache implementation
+ */
+
+#include "fast_connect.h"
+#include <Preferences.h>
+#include <esp_rom_crc.h>
+#include <sys/time.h>
+#include <cstddef>
+#include <cstring>
+
+namespace OpenClaw {
+
+static constexpr const char* NVS_NAMESPACE = "openclaw";
+static constexpr const char* NVS_KEY = "fastconn";
+
+// Kept across software resets and deep sleep; garbage after power-on,
+// which the CRC rejects
+RTC_NOINIT_ATTR static FastConnectRecord rtc_record;
+
+static uint32_t recordCrc(const FastConnectRecord& record) {
+    return esp_rom_crc32_le(0, reinterpret_cast<const uint8_t*>(&record),
+                            offsetof(FastConnectRecord, crc32));
+}
+
+static bool isValid(const FastConnectRecord& record) {
+    return record.magic == FAST_CONNECT_MAGIC && record.version == FAST_CONNECT_VERSION &&
+           record.crc32 == recordCrc(record);
+}
+
+// Survives software resets and deep sleep, like the RTC record
+static int64_t rtcSeconds() {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return now.tv_sec;
+}
+
+FastConnectCache::FastConnectCache() : source_(FastConnectSource::NONE) {
+    memset(&record_, 0, sizeof(record_));
+    record_.magic = FAST_CONNECT_MAGIC;
+    record_.version = FAST_CONNECT_VERSION;
+    last_error_[0] = '\0';
+}
+
+bool FastConnectCache::begin() {
+    if (isValid(rtc_record)) {
+        record_ = rtc_record;
+        source_ = FastConnectSource::RTC;
+        return true;
+    }
+
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+        FastConnectRecord stored;
+        size_t length = prefs.getBytes(NVS_KEY, &stored, sizeof(stored));
+        prefs.end();
+
+        if (length == sizeof(stored) && isValid(stored)) {
+            record_ = stored;
+            source_ = FastConnectSource::NVS;
+            storeRtc();
+            return true;
+        }
+    }
+
+    strncpy(last_error_, "No cached connection", sizeof(last_error_) - 1);
+    return false;
+}
+
+bool FastConnectCache::getLink(const char* ssid, uint8_t* bssid, uint8_t& channel) const {
+    if (!ssid || record_.channel == 0 || strcmp(record_.ssid, ssid) != 0) return false;
+    memcpy(bssid, record_.bssid, sizeof(record_.bssid));
+    channel = record_.channel;
+    return true;
+}
+
+bool FastConnectCache::getLease(const char* ssid, WiFiLease& lease) const {
+    if (!ssid || record_.lease.ip == 0 || strcmp(record_.ssid, ssid) != 0) return false;
+
+    // The clock restarts at power-on; an apparent step back means that
+    int64_t age = rtcSeconds() - record_.lease_obtained_s;
+    if (age < 0 || age >= record_.lease.renew_s) return false;
+
+    lease = record_.lease;
+    lease.renew_s = record_.lease.renew_s - (uint32_t)age;
+    return true;
+}
+
+uint32_t FastConnectCache::getGatewayIp(const char* host) const {
+    if (!host || strcmp(record_.gateway_host, host) != 0) return 0;
+    return record_.gateway_ip;
+}
+
+void FastConnectCache::saveLink(const char* ssid, const uint8_t* bssid, uint8_t channel) {
+    if (!ssid || !bssid || channel == 0) return;
+
+    bool same_ssid = strcmp(record_.ssid, ssid) == 0;
+    if (same_ssid && record_.channel == channel &&
+        memcmp(record_.bssid, bssid, sizeof(record_.bssid)) == 0) {
+        return;
+    }
+
+    strlcpy(record_.ssid, ssid, sizeof(record_.ssid));
+    memcpy(record_.bssid, bssid, sizeof(record_.bssid));
+    record_.channel = channel;
+    if (!same_ssid) {
+        memset(&record_.lease, 0, sizeof(record_.lease));
+    }
+
+    storeRtc();
+    storeNvs();
+}
+
+void FastConnectCache::saveLease(const WiFiLease& lease) {
+    record_.lease = lease;
+    record_.lease_obtained_s = rtcSeconds();
+    storeRtc();
+}
+
+void FastConnectCache::saveGatewayIp(const char* host, uint32_t ip) {
+    if (!host || strlen(host) > WIFI_HOST_MAX) return;
+    if (record_.gateway_ip == ip && strcmp(record_.gateway_host, host) == 0) return;
+
+    strlcpy(record_.gateway_host, host, sizeof(record_.gateway_host));
+    record_.gateway_ip = ip;
+
+    storeRtc();
+    storeNvs();
+}
+
+void FastConnectCache::clear() {
+    memset(&record_, 0, sizeof(record_));
+    record_.magic = FAST_CONNECT_MAGIC;
+    record_.version = FAST_CONNECT_VERSION;
+    memset(&rtc_record, 0, sizeof(rtc_record));
+    source_ = FastConnectSource::NONE;
+
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.remove(NVS_KEY);
+        prefs.end();
+    }
+}
+
+void FastConnectCache::storeRtc() {
+    record_.crc32 = recordCrc(record_);
+    rtc_record = record_;
+}
+
+bool FastConnectCache::storeNvs() {
+    // A lease is no use after a power cycle (no clock to age it by)
+    FastConnectRecord stored = record_;
+    memset(&stored.lease, 0, sizeof(stored.lease));
+    stored.lease_obtained_s = 0;
+    stored.crc32 = recordCrc(stored);
+
+    Preferences prefs;
+    if (!prefs.begin(NVS_NAMESPACE, false)) {
+        strncpy(last_error_, "Failed to open NVS", sizeof(last_error_) - 1);
+        return false;
+    }
+    bool ok = prefs.putBytes(NVS_KEY, &stored, sizeof(stored)) == sizeof(stored);
+    prefs.end();
+
+    if (!ok) {
+        strncpy(last_error_, "Failed to write NVS", sizeof(last_error_) - 1);
+    }
+    return ok;
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* fastConnectSourceToString(FastConnectSource source) {
+    switch (source) {
+        case FastConnectSource::NONE: return "NONE";
+        case FastConnectSource::RTC: return "RTC";
+        case FastConnectSource::NVS: return "NVS";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,124 @@
+/**
+ * @file idle_manager.cpp
+ * @brief Deep idle staging implementation
+ */
+
+#include "idle_manager.h"
+
+namespace OpenClaw {
+
+IdleManager::IdleManager()
+    : stage_(IdleStage::AWAKE),
+      on_stage_change_(nullptr),
+      last_activity_(0),
+      face_down_since_(0),
+      face_down_(false),
+      inhibited_(false),
+      last_wake_source_(WakeSource::NONE),
+      wake_count_(0) {
+}
+
+void IdleManager::begin(uint32_t now, const IdleConfig& config) {
+    config_ = config;
+    stage_ = IdleStage::AWAKE;
+    last_activity_ = now;
+    face_down_since_ = now;
+}
+
+IdleStage IdleManager::update(uint32_t now) {
+    if (inhibited_) {
+        last_activity_ = now;
+        return stage_;
+    }
+
+    // Step through each stage so its entry work runs in order
+    IdleStage target = targetStage(now);
+    while (stage_ < target) {
+        enterStage(static_cast<IdleStage>(static_cast<uint8_t>(stage_) + 1), WakeSource::NONE);
+    }
+    return stage_;
+}
+
+bool IdleManager::wake(WakeSource source, uint32_t now) {
+    last_activity_ = now;
+    if (stage_ == IdleStage::AWAKE) return false;
+
+    last_wake_source_ = source;
+    wake_count_++;
+    enterStage(IdleStage::AWAKE, source);
+    return true;
+}
+
+void IdleManager::setFaceDown(bool face_down, uint32_t now) {
+    if (face_down == face_down_) return;
+    face_down_ = face_down;
+
+    if (face_down) {
+        face_down_since_ = now;
+    } else {
+        // Picked up and turned over
+        wake(WakeSource::MOTION, now);
+    }
+}
+
+void IdleManager::setInhibited(bool inhibited, uint32_t now) {
+    inhibited_ = inhibited;
+    if (inhibited) {
+        wake(WakeSource::SYSTEM, now);
+    } else {
+        last_activity_ = now;  // Idle countdown restarts when the hold ends
+    }
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+IdleStage IdleManager::targetStage(uint32_t now) const {
+    uint32_t idle_ms = now - last_activity_;
+    uint32_t down_ms = face_down_ ? now - face_down_since_ : 0;
+
+    if (idle_ms >= config_.asleep_after_ms ||
+        (face_down_ && down_ms >= config_.face_down_asleep_ms)) {
+        return IdleStage::ASLEEP;
+    }
+    if (idle_ms >= config_.drowsy_after_ms ||
+        (face_down_ && down_ms >= config_.face_down_drowsy_ms)) {
+        return IdleStage::DROWSY;
+    }
+    return IdleStage::AWAKE;
+}
+
+void IdleManager::enterStage(IdleStage stage, WakeSource source) {
+    IdleStage from = stage_;
+    stage_ = stage;
+    if (on_stage_change_) {
+        on_stage_change_(from, stage, source);
+    }
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* idleStageToString(IdleStage stage) {
+    switch (stage) {
+        case IdleStage::AWAKE: return "AWAKE";
+        case IdleStage::DROWSY: return "DROWSY";
+        case IdleStage::ASLEEP: return "ASLEEP";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* wakeSourceToString(WakeSource source) {
+    switch (source) {
+        case WakeSource::NONE: return "NONE";
+        case WakeSource::KEYBOARD: return "KEYBOARD";
+        case WakeSource::MOTION: return "MOTION";
+        case WakeSource::GATEWAY: return "GATEWAY";
+        case WakeSource::SYSTEM: return "SYSTEM";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
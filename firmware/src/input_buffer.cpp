@@ -0,0 +1,228 @@
+/**
+ * @file input_buffer.cpp
+ * @brief Gap-buffer text editor implementation
+ */
+
+#include "input_buffer.h"
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+namespace OpenClaw {
+
+InputBuffer::InputBuffer()
+    : data_(allocate(INPUT_BUFFER_INITIAL_CAPACITY)),
+      capacity_(data_ ? INPUT_BUFFER_INITIAL_CAPACITY : 0),
+      gap_start_(0),
+      gap_end_(capacity_),
+      cursor_(0) {
+}
+
+InputBuffer::~InputBuffer() {
+    free(data_);
+}
+
+bool InputBuffer::insert(char c) {
+    if (isFull() || !reserve(1)) return false;
+
+    size_t old_cursor = cursor_;
+    moveGapTo(cursor_);
+    data_[gap_start_++] = c;
+    cursor_++;
+    recordChange(old_cursor, 0, 1, old_cursor);
+    return true;
+}
+
+bool InputBuffer::backspace() {
+    if (cursor_ == 0) return false;
+
+    size_t old_cursor = cursor_;
+    moveGapTo(cursor_);
+    gap_start_--;
+    cursor_--;
+    recordChange(cursor_, 1, 0, old_cursor);
+    return true;
+}
+
+bool InputBuffer::deleteChar() {
+    if (cursor_ >= getLength()) return false;
+
+    moveGapTo(cursor_);
+    gap_end_++;
+    recordChange(cursor_, 1, 0, cursor_);
+    return true;
+}
+
+bool InputBuffer::insertString(const char* str) {
+    size_t len = strlen(str);
+    if (getLength() + len > INPUT_BUFFER_MAX_LENGTH || !reserve(len)) return false;
+
+    size_t old_cursor = cursor_;
+    moveGapTo(cursor_);
+    memcpy(data_ + gap_start_, str, len);
+    gap_start_ += len;
+    cursor_ += len;
+    recordChange(old_cursor, 0, len, old_cursor);
+    return true;
+}
+
+void InputBuffer::clear() {
+    size_t old_length = getLength();
+    size_t old_cursor = cursor_;
+    gap_start_ = 0;
+    gap_end_ = capacity_;
+    cursor_ = 0;
+    recordChange(0, old_length, 0, old_cursor);
+}
+
+void InputBuffer::moveCursorLeft() {
+    if (cursor_ > 0) moveCursorTo(cursor_ - 1);
+}
+
+void InputBuffer::moveCursorRight() {
+    moveCursorTo(cursor_ + 1);
+}
+
+void InputBuffer::moveCursorHome() {
+    moveCursorTo(0);
+}
+
+void InputBuffer::moveCursorEnd() {
+    moveCursorTo(getLength());
+}
+
+void InputBuffer::moveCursorTo(size_t pos) {
+    if (pos > getLength()) return;
+
+    // The gap stays put until the next edit, so cursor keys cost nothing
+    size_t old_cursor = cursor_;
+    cursor_ = pos;
+    recordChange(pos, 0, 0, old_cursor);
+}
+
+const char* InputBuffer::getText() const {
+    if (!data_) return "";
+    moveGapTo(getLength());
+    data_[gap_start_] = '\0';
+    return data_;
+}
+
+char InputBuffer::charAt(size_t index) const {
+    if (index >= getLength()) return '\0';
+    return (index < gap_start_) ? data_[index] : data_[index + gapSize()];
+}
+
+size_t InputBuffer::copyRange(size_t start, size_t count, char* out) const {
+    size_t length = getLength();
+    if (start >= length) return 0;
+    if (count > length - start) count = length - start;
+
+    // Up to two spans: before and after the gap
+    size_t copied = 0;
+    if (start < gap_start_) {
+        size_t n = std::min(count, gap_start_ - start);
+        memcpy(out, data_ + start, n);
+        copied = n;
+    }
+    if (copied < count) {
+        memcpy(out + copied, data_ + start + copied + gapSize(), count - copied);
+        copied = count;
+    }
+    return copied;
+}
+
+String InputBuffer::getTextBeforeCursor() const {
+    return String(getText()).substring(0, cursor_);
+}
+
+String InputBuffer::getTextAfterCursor() const {
+    return String(getText()).substring(cursor_);
+}
+
+bool InputBuffer::setText(const char* text) {
+    size_t len = strlen(text);
+    if (len > INPUT_BUFFER_MAX_LENGTH) return false;
+
+    size_t old_length = getLength();
+    size_t old_cursor = cursor_;
+    gap_start_ = 0;
+    gap_end_ = capacity_;
+    cursor_ = 0;
+    if (!reserve(len)) {
+        recordChange(0, old_length, 0, old_cursor);
+        return false;
+    }
+
+    memcpy(data_, text, len);
+    gap_start_ = len;
+    cursor_ = len;
+    recordChange(0, old_length, len, old_cursor);
+    return true;
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+void InputBuffer::moveGapTo(size_t pos) const {
+    if (pos < gap_start_) {
+        // Shift text between pos and the gap to the right of it
+        size_t n = gap_start_ - pos;
+        memmove(data_ + gap_end_ - n, data_ + pos, n);
+        gap_start_ -= n;
+        gap_end_ -= n;
+    } else if (pos > gap_start_) {
+        size_t n = pos - gap_start_;
+        memmove(data_ + gap_start_, data_ + gap_end_, n);
+        gap_start_ += n;
+        gap_end_ += n;
+    }
+}
+
+bool InputBuffer::reserve(size_t extra) {
+    // Keep one spare byte for getText()'s terminator
+    if (gapSize() > extra) return true;
+
+    size_t length = getLength();
+    size_t needed = length + extra + 1;
+    size_t new_capacity = capacity_ ? capacity_ : INPUT_BUFFER_INITIAL_CAPACITY;
+    while (new_capacity < needed) {
+        new_capacity *= 2;
+    }
+
+    char* grown = allocate(new_capacity);
+    if (!grown) return false;
+
+    // Same gap position, wider gap
+    size_t tail = capacity_ - gap_end_;
+    if (data_) {
+        memcpy(grown, data_, gap_start_);
+        memcpy(grown + new_capacity - tail, data_ + gap_end_, tail);
+        free(data_);
+    }
+    data_ = grown;
+    gap_end_ = new_capacity - tail;
+    capacity_ = new_capacity;
+    return true;
+}
+
+void InputBuffer::recordChange(size_t pos, size_t removed, size_t inserted, size_t old_cursor) {
+    last_change_.pos = pos;
+    last_change_.removed = removed;
+    last_change_.inserted = inserted;
+    last_change_.old_cursor = old_cursor;
+    last_change_.new_cursor = cursor_;
+}
+
+char* InputBuffer::allocate(size_t size) {
+    // Long prompts belong in PSRAM; the small default fits anywhere
+    void* p = nullptr;
+    if (size > INPUT_BUFFER_INITIAL_CAPACITY) {
+        p = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!p) {
+        p = malloc(size);
+    }
+    return static_cast<char*>(p);
+}
+
+} // namespace OpenClaw
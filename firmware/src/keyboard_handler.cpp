@@ -1,6 +1,6 @@
 /**
  * @file keyboard_handler.cpp
- * @brief Keyboard handler implementation (stub)
+ * @brief Keyboard handler implementation
  */
 
 #include "keyboard_handler.h"
@@ -10,27 +10,34 @@ namespace OpenClaw {
 KeyboardHandler::KeyboardHandler()
     : initialized_(false),
       event_callback_(nullptr),
+      text_input_enabled_(true),
+      history_(nullptr),
+      phrases_(nullptr),
       key_pressed_(false),
       last_character_(0),
-      key_press_time_(0),
-      last_repeat_time_(0),
-      repeat_count_(0),
       shift_pressed_(false),
       fn_pressed_(false),
       ctrl_pressed_(false),
       opt_pressed_(false),
-      last_shift_state_(false),
-      last_fn_state_(false),
-      last_ctrl_state_(false),
-      last_opt_state_(false),
       key_repeat_enabled_(true),
       key_repeat_delay_ms_(DEFAULT_KEY_REPEAT_DELAY_MS),
       key_repeat_rate_ms_(DEFAULT_KEY_REPEAT_RATE_MS),
-      event_queue_(nullptr),
-      state_mutex_(nullptr),
-      last_poll_time_(0),
+      scan_task_(nullptr),
+      scan_interval_ms_(KEYBOARD_SCAN_INTERVAL_MS),
+      modifier_mask_(0),
+      stable_(0),
+      repeat_key_(0),
+      repeat_active_(false),
+      repeat_due_(0),
+      repeat_count_(0),
       key_press_count_(0),
-      input_submit_count_(0) {
+      input_submit_count_(0),
+      scan_count_(0),
+      deferred_edges_(0) {
+    memset(base_char_, 0, sizeof(base_char_));
+    memset(shift_char_, 0, sizeof(shift_char_));
+    memset(role_, 0, sizeof(role_));
+    memset(debounce_, 0, sizeof(debounce_));
 }
 
 KeyboardHandler::~KeyboardHandler() {
@@ -39,159 +46,414 @@ KeyboardHandler::~KeyboardHandler() {
 
 bool KeyboardHandler::begin() {
     if (initialized_) return true;
-    if (!createQueue() || !createMutexes()) return false;
+    
+    loadKeyMap();
+    stable_ = 0;
+    memset(debounce_, 0, sizeof(debounce_));
+    repeat_active_ = false;
+    
+    if (!startScanTask()) return false;
     initialized_ = true;
     return true;
 }
 
 void KeyboardHandler::end() {
-    destroyQueue();
-    destroyMutexes();
+    stopScanTask();
     initialized_ = false;
 }
 
 void KeyboardHandler::update() {
     if (!initialized_) return;
-    // Stub implementation
-}
-
-bool KeyboardHandler::readEvent(KeyEvent& event) {
-    if (!event_queue_) return false;
-    return xQueueReceive(event_queue_, &event, 0) == pdTRUE;
+    
+    // Everything typed since the last call, in order
+    KeyEvent event;
+    while (ring_.pop(event)) {
+        processEvent(event);
+    }
 }
 
 void KeyboardHandler::clearInput() {
+    if (input_buffer_.isEmpty()) return;
     input_buffer_.clear();
+    notifyEvent(KeyboardEvent::INPUT_CHANGED, &input_buffer_);
 }
 
 void KeyboardHandler::submitInput() {
     input_submit_count_++;
-    if (event_callback_) {
-        event_callback_(KeyboardEvent::INPUT_SUBMITTED, input_buffer_.getText());
-    }
+    const char* text = input_buffer_.getText();
+    if (history_) history_->add(text);
+    if (phrases_) phrases_->add(text);
+    notifyEvent(KeyboardEvent::INPUT_SUBMITTED, text);
 }
 
 bool KeyboardHandler::setInputText(const char* text) {
-    return input_buffer_.setText(text);
+    bool ok = input_buffer_.setText(text);
+    notifyEvent(KeyboardEvent::INPUT_CHANGED, &input_buffer_);
+    return ok;
 }
 
 void KeyboardHandler::onEvent(KeyboardEventCallback callback) {
     event_callback_ = callback;
 }
 
-bool KeyboardHandler::createQueue() {
-    event_queue_ = xQueueCreate(KEYBOARD_QUEUE_SIZE, sizeof(KeyEvent));
-    return event_queue_ != nullptr;
-}
-
-void KeyboardHandler::destroyQueue() {
-    if (event_queue_) {
-        vQueueDelete(event_queue_);
-        event_queue_ = nullptr;
+// =============================================================================
+// Scan task
+// =============================================================================
+
+void KeyboardHandler::loadKeyMap() {
+    modifier_mask_ = 0;
+    
+    for (uint8_t row = 0; row < KEYBOARD_ROWS; row++) {
+        for (uint8_t col = 0; col < KEYBOARD_COLS; col++) {
+            uint8_t key = row * KEYBOARD_COLS + col;
+            Point2D_t coor = {col, row};
+            auto value = M5Cardputer.Keyboard.getKeyValue(coor);
+            
+            base_char_[key] = value.value_first;
+            shift_char_[key] = value.value_second;
+            
+            switch ((uint8_t)value.value_first) {
+                case KEY_LEFT_SHIFT: role_[key] = KeyRole::SHIFT; break;
+                case KEY_FN: role_[key] = KeyRole::FN; break;
+                case KEY_LEFT_CTRL: role_[key] = KeyRole::CTRL; break;
+                case KEY_LEFT_ALT:
+                case KEY_OPT: role_[key] = KeyRole::OPT; break;
+                default: role_[key] = KeyRole::NORMAL; break;
+            }
+            if (role_[key] != KeyRole::NORMAL) {
+                modifier_mask_ |= 1ULL << key;
+            }
+        }
     }
 }
 
-bool KeyboardHandler::createMutexes() {
-    state_mutex_ = xSemaphoreCreateMutex();
-    return state_mutex_ != nullptr;
+bool KeyboardHandler::startScanTask() {
+    if (scan_task_) {
+        return true;
+    }
+    
+    // PRO CPU: the main loop and audio capture share the APP CPU, so
+    // scanning keeps its cadence however long a frame takes
+    BaseType_t result = xTaskCreatePinnedToCore(
+        scanTaskWrapper,
+        "KeyScan",
+        KEYBOARD_TASK_STACK,
+        this,
+        KEYBOARD_TASK_PRIORITY,
+        &scan_task_,
+        0
+    );
+    
+    return result == pdPASS;
 }
 
-void KeyboardHandler::destroyMutexes() {
-    if (state_mutex_) {
-        vSemaphoreDelete(state_mutex_);
-        state_mutex_ = nullptr;
+void KeyboardHandler::stopScanTask() {
+    if (scan_task_) {
+        vTaskDelete(scan_task_);
+        scan_task_ = nullptr;
     }
 }
 
-// InputBuffer implementation
-InputBuffer::InputBuffer()
-    : length_(0), cursor_(0) {
-    buffer_[0] = '\0';
+void KeyboardHandler::scanTaskWrapper(void* param) {
+    KeyboardHandler* self = static_cast<KeyboardHandler*>(param);
+    self->scanLoop();
+    vTaskDelete(nullptr);
 }
 
-bool InputBuffer::insert(char c) {
-    if (length_ >= KEYBOARD_BUFFER_SIZE - 1) return false;
-    for (size_t i = length_; i > cursor_; --i) {
-        buffer_[i] = buffer_[i - 1];
+void KeyboardHandler::scanLoop() {
+    TickType_t last_wake = xTaskGetTickCount();
+    
+    for (;;) {
+        scanOnce(millis());
+        
+        TickType_t period = pdMS_TO_TICKS(scan_interval_ms_.load());
+        vTaskDelayUntil(&last_wake, period > 0 ? period : 1);
     }
-    buffer_[cursor_] = c;
-    cursor_++;
-    length_++;
-    buffer_[length_] = '\0';
-    return true;
 }
 
-bool InputBuffer::backspace() {
-    if (cursor_ == 0 || length_ == 0) return false;
-    for (size_t i = cursor_ - 1; i < length_; ++i) {
-        buffer_[i] = buffer_[i + 1];
+uint64_t KeyboardHandler::readMatrix() {
+    M5Cardputer.Keyboard.updateKeyList();
+    
+    uint64_t keys = 0;
+    for (const auto& coor : M5Cardputer.Keyboard.keyList()) {
+        if (coor.x >= 0 && coor.x < KEYBOARD_COLS &&
+            coor.y >= 0 && coor.y < KEYBOARD_ROWS) {
+            keys |= 1ULL << (coor.y * KEYBOARD_COLS + coor.x);
+        }
     }
-    cursor_--;
-    length_--;
-    buffer_[length_] = '\0';
-    return true;
+    return keys;
 }
 
-bool InputBuffer::deleteChar() {
-    if (cursor_ >= length_) return false;
-    for (size_t i = cursor_; i < length_; ++i) {
-        buffer_[i] = buffer_[i + 1];
+void KeyboardHandler::scanOnce(uint32_t now) {
+    uint64_t raw = readMatrix();
+    scan_count_++;
+    
+    // Debounce: a key's new level must hold for KEYBOARD_DEBOUNCE_SCANS
+    // consecutive scans. Keys are independent, so any number can change
+    // in the same scan (n-key rollover).
+    uint64_t diff = raw ^ stable_;
+    uint64_t ready = 0;
+    for (uint8_t key = 0; key < KEYBOARD_KEY_COUNT; key++) {
+        uint64_t bit = 1ULL << key;
+        if (diff & bit) {
+            if (debounce_[key] < KEYBOARD_DEBOUNCE_SCANS) debounce_[key]++;
+            if (debounce_[key] >= KEYBOARD_DEBOUNCE_SCANS) ready |= bit;
+        } else {
+            debounce_[key] = 0;
+        }
     }
-    length_--;
-    buffer_[length_] = '\0';
-    return true;
-}
-
-bool InputBuffer::insertString(const char* str) {
-    while (*str) {
-        if (!insert(*str++)) return false;
+    
+    bool queued = false;
+    
+    if (ready) {
+        // Modifiers first, so a chord landing in one scan (Shift+a) reads
+        // correctly; they only qualify other keys and emit nothing
+        uint64_t modifiers = ready & modifier_mask_;
+        stable_ ^= modifiers;
+        
+        for (uint8_t key = 0; key < KEYBOARD_KEY_COUNT; key++) {
+            uint64_t bit = 1ULL << key;
+            if (modifiers & bit) {
+                debounce_[key] = 0;
+            } else if (ready & bit) {
+                // A full ring leaves a press pending; it is retried next
+                // scan instead of being dropped. Releases carry no input,
+                // so they never hold up the presses behind them.
+                bool pressed = (raw & bit) != 0;
+                if (!emitEdge(key, pressed, stable_, now) && pressed) {
+                    deferred_edges_++;
+                    break;
+                }
+                stable_ ^= bit;
+                debounce_[key] = 0;
+                queued = true;
+            }
+        }
+    }
+    
+    if (processKeyRepeat(now)) {
+        queued = true;
+    }
+    
+    if (queued) {
+        notifier_.notify();
     }
-    return true;
 }
 
-void InputBuffer::clear() {
-    length_ = 0;
-    cursor_ = 0;
-    buffer_[0] = '\0';
+bool KeyboardHandler::emitEdge(uint8_t key, bool pressed, uint64_t keys, uint32_t now) {
+    KeyEvent event = translateKey(key, keys);
+    event.pressed = pressed;
+    event.timestamp = now;
+    
+    bool queued = ring_.push(event);
+    if (!queued && pressed) return false;
+    
+    if (pressed) {
+        // Only the most recent key repeats
+        repeat_key_ = key;
+        repeat_active_ = event.isPrintable() || event.isNavigation() ||
+                         event.isBackspace() || event.isDelete();
+        repeat_due_ = now + key_repeat_delay_ms_;
+        repeat_count_ = 0;
+    } else if (repeat_key_ == key) {
+        repeat_active_ = false;
+    }
+    return queued;
 }
 
-void InputBuffer::moveCursorLeft() {
-    if (cursor_ > 0) cursor_--;
+bool KeyboardHandler::processKeyRepeat(uint32_t now) {
+    if (!key_repeat_enabled_ || !repeat_active_) return false;
+    if ((int32_t)(now - repeat_due_) < 0) return false;
+    
+    repeat_due_ = now + key_repeat_rate_ms_;
+    
+    KeyEvent event = translateKey(repeat_key_, stable_);
+    event.pressed = true;
+    event.timestamp = now;
+    event.repeat_count = (repeat_count_ < 255) ? repeat_count_ + 1 : 255;
+    
+    // Repeats are synthetic; skipping one when the UI is behind loses nothing
+    if (!ring_.push(event)) return false;
+    repeat_count_ = event.repeat_count;
+    return true;
 }
 
-void InputBuffer::moveCursorRight() {
-    if (cursor_ < length_) cursor_++;
+bool KeyboardHandler::isModifierHeld(uint64_t keys, KeyRole role) const {
+    uint64_t held = keys & modifier_mask_;
+    for (uint8_t key = 0; held; key++, held >>= 1) {
+        if ((held & 1) && role_[key] == role) return true;
+    }
+    return false;
 }
 
-void InputBuffer::moveCursorHome() {
-    cursor_ = 0;
+KeyEvent KeyboardHandler::translateKey(uint8_t key, uint64_t keys) const {
+    KeyEvent event;
+    event.key_index = key;
+    event.shift = isModifierHeld(keys, KeyRole::SHIFT);
+    event.fn = isModifierHeld(keys, KeyRole::FN);
+    event.ctrl = isModifierHeld(keys, KeyRole::CTRL);
+    event.opt = isModifierHeld(keys, KeyRole::OPT);
+    
+    char base = base_char_[key];
+    
+    // Keys with their own code in the Cardputer key map
+    switch ((uint8_t)base) {
+        case KEY_BACKSPACE:
+            if (event.fn) {
+                event.special = SpecialKey::DELETE;
+            } else {
+                event.special = SpecialKey::BACKSPACE;
+                event.character = '\b';
+            }
+            return event;
+        case KEY_TAB:
+            event.special = SpecialKey::TAB;
+            event.character = '\t';
+            return event;
+        case KEY_ENTER:
+            event.special = SpecialKey::ENTER;
+            event.character = '\r';
+            return event;
+        default:
+            break;
+    }
+    
+    // Fn layer: arrows and escape as printed on the keycaps, plus the
+    // app shortcuts; other Fn+key combos keep the base character
+    if (event.fn) {
+        switch (base) {
+            case ';': event.special = SpecialKey::UP; break;
+            case '.': event.special = SpecialKey::DOWN; break;
+            case ',': event.special = SpecialKey::LEFT; break;
+            case '/': event.special = SpecialKey::RIGHT; break;
+            case '`': event.special = SpecialKey::ESCAPE; break;
+            case 'v': event.special = SpecialKey::VOICE_TOGGLE; break;
+            case 's': event.special = SpecialKey::SEND; break;
+            default: event.character = base; break;
+        }
+        return event;
+    }
+    
+    event.character = event.shift ? shift_char_[key] : base;
+    return event;
 }
 
-void InputBuffer::moveCursorEnd() {
-    cursor_ = length_;
+// =============================================================================
+// Main loop side
+// =============================================================================
+
+void KeyboardHandler::processEvent(const KeyEvent& event) {
+    shift_pressed_ = event.shift;
+    fn_pressed_ = event.fn;
+    ctrl_pressed_ = event.ctrl;
+    opt_pressed_ = event.opt;
+    
+    if (!event.pressed) {
+        key_pressed_ = false;
+        notifyEvent(KeyboardEvent::KEY_RELEASED, &event);
+        return;
+    }
+    
+    key_pressed_ = true;
+    last_character_ = event.character;
+    if (event.repeat_count == 0) {
+        key_press_count_++;
+    }
+    
+    // Listeners see the key before it edits the input buffer
+    notifyEvent(KeyboardEvent::KEY_PRESSED, &event);
+    
+    if (text_input_enabled_) {
+        applyEdit(event);
+    }
 }
 
-void InputBuffer::moveCursorTo(size_t pos) {
-    if (pos <= length_) cursor_ = pos;
+void KeyboardHandler::applyEdit(const KeyEvent& event) {
+    bool changed = false;
+    bool recalled = false;
+    
+    if (event.special == SpecialKey::UP || event.special == SpecialKey::DOWN) {
+        changed = recallHistory(event.special == SpecialKey::UP);
+        recalled = true;
+    } else if (event.special == SpecialKey::TAB) {
+        changed = completeInput();
+    } else if (event.isEnter() || event.special == SpecialKey::SEND) {
+        if (!input_buffer_.isEmpty()) {
+            submitInput();
+            input_buffer_.clear();
+            changed = true;
+        }
+    } else if (event.isBackspace()) {
+        changed = input_buffer_.backspace();
+    } else if (event.isDelete()) {
+        changed = input_buffer_.deleteChar();
+    } else if (event.special == SpecialKey::ESCAPE) {
+        changed = !input_buffer_.isEmpty();
+        input_buffer_.clear();
+    } else if (event.isNavigation()) {
+        size_t old_cursor = input_buffer_.getCursor();
+        switch (event.special) {
+            case SpecialKey::LEFT: input_buffer_.moveCursorLeft(); break;
+            case SpecialKey::RIGHT: input_buffer_.moveCursorRight(); break;
+            case SpecialKey::HOME: input_buffer_.moveCursorHome(); break;
+            case SpecialKey::END: input_buffer_.moveCursorEnd(); break;
+            default: break;
+        }
+        changed = input_buffer_.getCursor() != old_cursor;
+    } else if (event.ctrl) {
+        // Ctrl+A / Ctrl+E: start / end of line
+        if (event.character == 'a') {
+            input_buffer_.moveCursorHome();
+            changed = true;
+        } else if (event.character == 'e') {
+            input_buffer_.moveCursorEnd();
+            changed = true;
+        }
+    } else if (!event.fn && event.isPrintable()) {
+        changed = input_buffer_.insert(event.character);
+    }
+    
+    if (changed) {
+        // Editing a recalled prompt makes it the new draft
+        if (!recalled && history_) history_->resetNavigation();
+        notifyEvent(KeyboardEvent::INPUT_CHANGED, &input_buffer_);
+    }
 }
 
-String InputBuffer::getTextBeforeCursor() const {
-    return String(buffer_).substring(0, cursor_);
+bool KeyboardHandler::recallHistory(bool older) {
+    if (!history_) return false;
+    
+    bool was_navigating = history_->isNavigating();
+    if (older && !was_navigating) {
+        history_draft_ = input_buffer_.getText();
+    }
+    
+    const char* text = older ? history_->older() : history_->newer();
+    if (text) {
+        input_buffer_.setText(text);
+        return true;
+    }
+    
+    // Down past the newest entry brings back what was being typed
+    if (older || !was_navigating) return false;
+    input_buffer_.setText(history_draft_.c_str());
+    history_draft_ = "";
+    return true;
 }
 
-String InputBuffer::getTextAfterCursor() const {
-    return String(buffer_).substring(cursor_);
+bool KeyboardHandler::completeInput() {
+    // Only completes at the end of the line
+    if (!phrases_ || input_buffer_.getCursor() != input_buffer_.getLength()) return false;
+    
+    char phrase[PHRASE_MAX_LENGTH + 1];
+    if (phrases_->complete(input_buffer_.getText(), phrase, sizeof(phrase)) == 0) return false;
+    return input_buffer_.insertString(phrase + input_buffer_.getLength());
 }
 
-bool InputBuffer::setText(const char* text) {
-    clear();
-    size_t len = strlen(text);
-    if (len >= KEYBOARD_BUFFER_SIZE) return false;
-    memcpy(buffer_, text, len);
-    length_ = len;
-    cursor_ = len;
-    buffer_[length_] = '\0';
-    return true;
+void KeyboardHandler::notifyEvent(KeyboardEvent event, const void* data) {
+    if (event_callback_) {
+        event_callback_(event, data);
+    }
 }
 
 const char* specialKeyToString(SpecialKey key) {
@@ -245,13 +507,4 @@ const char* keyboardEventToString(KeyboardEvent event) {
     }
 }
 
-bool isAncientModeTrigger(const char* text) {
-    String t = String(text);
-    t.toLowerCase();
-    return (t.indexOf("ancient wisdom") >= 0 ||
-            t.indexOf("speak as minerva") >= 0 ||
-            t.indexOf("owl mode") >= 0 ||
-            t.indexOf("by the thirty-seven claws") >= 0);
-}
-
 } // namespace OpenClaw
@@ -0,0 +1,367 @@
+/**
+ * @file loopback_socket.cpp
+ * @brief In-process gateway link implementation
+ */
+
+#include "loopback_socket.h"
+
+#ifdef OPENCLAW_LOOPBACK_GATEWAY
+
+#include <ArduinoJson.h>
+#include <new>
+#include "message_codec.h"
+
+namespace OpenClaw {
+
+// Directions, for the per-direction link state
+static constexpr size_t UP = 0;
+static constexpr size_t DOWN = 1;
+
+LoopbackSocket::LoopbackSocket()
+    : callback_(nullptr),
+      connected_(false),
+      connecting_(false),
+      use_ssl_(false),
+      handshake_due_ms_(0),
+      subprotocol_(""),
+      next_seq_(0),
+      next_frame_id_(0),
+      rng_(link_.seed ? link_.seed : 1),
+      last_report_ms_(0) {
+    link_free_ms_[UP] = link_free_ms_[DOWN] = 0;
+    last_due_ms_[UP] = last_due_ms_[DOWN] = 0;
+    partial_[UP].length = partial_[DOWN].length = 0;
+}
+
+void LoopbackSocket::setLink(const LoopbackLink& link) {
+    link_ = link;
+    rng_ = link_.seed ? link_.seed : 1;
+}
+
+void LoopbackSocket::begin(const char* host, uint16_t port, const char* url, const char* protocol) {
+    startHandshake(false, protocol);
+}
+
+void LoopbackSocket::beginSSL(const char* host, uint16_t port, const char* url,
+                              const char* fingerprint, const char* protocol) {
+    startHandshake(true, protocol);
+}
+
+void LoopbackSocket::startHandshake(bool use_ssl, const char* protocol) {
+    disconnect();
+    use_ssl_ = use_ssl;
+    stats_.handshakes++;
+
+    // The library keeps the offer when the server doesn't answer it
+    subprotocol_ = link_.subprotocol && strlen(link_.subprotocol) > 0 ? link_.subprotocol : protocol;
+
+    if (roll(link_.connect_fail_percent)) {
+        stats_.handshakes_refused++;
+        return;
+    }
+
+    // TCP handshake plus the HTTP upgrade; TLS adds two more round trips
+    uint32_t round_trips = use_ssl ? 4 : 2;
+    handshake_due_ms_ = millis() + round_trips * 2 * link_.latency_ms;
+    connecting_ = true;
+}
+
+void LoopbackSocket::loop() {
+    uint32_t now = millis();
+
+    if (connecting_ && (int32_t)(now - handshake_due_ms_) >= 0) {
+        connecting_ = false;
+        connected_ = true;
+        link_free_ms_[UP] = link_free_ms_[DOWN] = now;
+        last_due_ms_[UP] = last_due_ms_[DOWN] = now;
+        if (callback_) {
+            callback_(WStype_CONNECTED, nullptr, 0);
+        }
+    }
+
+    // Deliver everything that is due, earliest first; a callback may
+    // queue or disconnect
+    while (connected_) {
+        Frame* frame = nextDue(now);
+        if (!frame) break;
+        deliver(*frame);
+    }
+
+    if (link_.report_interval_ms > 0 && now - last_report_ms_ >= link_.report_interval_ms) {
+        last_report_ms_ = now;
+        printReport();
+    }
+}
+
+void LoopbackSocket::disconnect() {
+    bool was_connected = connected_;
+    connected_ = false;
+    connecting_ = false;
+    clearQueue();
+
+    if (was_connected && callback_) {
+        callback_(WStype_DISCONNECTED, nullptr, 0);
+    }
+}
+
+bool LoopbackSocket::sendTXT(uint8_t* payload, size_t length, bool header_to_payload) {
+    if (!connected_) return false;
+    const uint8_t* data = header_to_payload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+    return enqueue(data, length, true, false, millis());
+}
+
+bool LoopbackSocket::sendBIN(uint8_t* payload, size_t length, bool header_to_payload) {
+    if (!connected_) return false;
+    const uint8_t* data = header_to_payload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+    return enqueue(data, length, false, false, millis());
+}
+
+bool LoopbackSocket::enqueue(const uint8_t* data, size_t length, bool is_text, bool to_device,
+                             uint32_t sent_ms) {
+    size_t piece = link_.fragment_bytes > 0 && length > link_.fragment_bytes
+        ? link_.fragment_bytes : (length > 0 ? length : 1);
+    size_t pieces = length > piece ? (length + piece - 1) / piece : 1;
+
+    // All pieces or none: a frame is never left half sent
+    size_t free_slots = 0;
+    for (const Frame& frame : queue_) {
+        if (!frame.data) free_slots++;
+    }
+    if (free_slots < pieces) {
+        stats_.frames_refused++;
+        return false;
+    }
+
+    if (pieces > 1) {
+        stats_.fragments += pieces;
+    }
+    uint32_t frame_id = next_frame_id_++;
+    size_t offset = 0;
+    do {
+        size_t n = length - offset < piece ? length - offset : piece;
+        if (!enqueuePiece(data + offset, frame_id, offset, n, length, is_text, to_device, sent_ms)) {
+            return false;
+        }
+        offset += n;
+    } while (offset < length);
+    return true;
+}
+
+bool LoopbackSocket::enqueuePiece(const uint8_t* data, uint32_t frame_id, size_t offset,
+                                  size_t length, size_t total, bool is_text, bool to_device,
+                                  uint32_t sent_ms) {
+    Frame* slot = nullptr;
+    for (Frame& frame : queue_) {
+        if (!frame.data) {
+            slot = &frame;
+            break;
+        }
+    }
+
+    if (!slot) {
+        stats_.frames_refused++;
+        return false;
+    }
+
+    // A lost piece still used the sender's side of the link
+    bool lost = roll(link_.loss_percent);
+
+    size_t dir = to_device ? DOWN : UP;
+    uint32_t now = millis();
+    uint32_t start = (int32_t)(link_free_ms_[dir] - now) > 0 ? link_free_ms_[dir] : now;
+    uint32_t wire_ms = link_.bandwidth_bps > 0
+        ? (uint32_t)((uint64_t)length * 8 * 1000 / link_.bandwidth_bps) : 0;
+    link_free_ms_[dir] = start + wire_ms;
+
+    if (lost) {
+        stats_.frames_lost++;
+        return true;
+    }
+
+    uint32_t jitter = link_.jitter_ms > 0 ? nextRandom() % (2 * link_.jitter_ms + 1) : 0;
+    int32_t delay = (int32_t)link_.latency_ms + (int32_t)jitter - (int32_t)link_.jitter_ms;
+    uint32_t due = link_free_ms_[dir] + (delay > 0 ? delay : 0);
+    if ((int32_t)(last_due_ms_[dir] - due) > 0) {
+        due = last_due_ms_[dir];
+    }
+    last_due_ms_[dir] = due;
+
+    slot->data.reset(new (std::nothrow) uint8_t[length > 0 ? length : 1]);
+    if (!slot->data) {
+        stats_.frames_refused++;
+        return false;
+    }
+    memcpy(slot->data.get(), data, length);
+    slot->length = length;
+    slot->frame_id = frame_id;
+    slot->offset = offset;
+    slot->total = total;
+    slot->last = offset + length >= total;
+    slot->is_text = is_text;
+    slot->to_device = to_device;
+    slot->due_ms = due;
+    slot->sent_ms = sent_ms;
+    slot->seq = next_seq_++;
+    return true;
+}
+
+LoopbackSocket::Frame* LoopbackSocket::nextDue(uint32_t now) {
+    Frame* next = nullptr;
+    for (Frame& frame : queue_) {
+        if (!frame.data || (int32_t)(now - frame.due_ms) < 0) continue;
+        if (!next || (int32_t)(frame.due_ms - next->due_ms) < 0 ||
+            (frame.due_ms == next->due_ms && (int32_t)(frame.seq - next->seq) < 0)) {
+            next = &frame;
+        }
+    }
+    return next;
+}
+
+void LoopbackSocket::deliver(Frame& frame) {
+    // Take the piece out first; callbacks may queue into the slot
+    std::unique_ptr<uint8_t[]> data = std::move(frame.data);
+    size_t dir = frame.to_device ? DOWN : UP;
+
+    if (frame.offset == 0 && frame.last) {
+        dispatch(data.get(), frame.length, frame.is_text, frame.to_device, frame.sent_ms);
+        return;
+    }
+
+    // A gap means a piece was lost: the frame is gone, skip to the next one
+    Reassembly& partial = partial_[dir];
+    if (frame.offset == 0) {
+        partial.data.reset(new (std::nothrow) uint8_t[frame.total]);
+        partial.frame_id = frame.frame_id;
+        partial.length = 0;
+    }
+    if (!partial.data || frame.frame_id != partial.frame_id || frame.offset != partial.length) {
+        partial.data.reset();
+        return;
+    }
+    memcpy(partial.data.get() + frame.offset, data.get(), frame.length);
+    partial.length += frame.length;
+
+    if (frame.last) {
+        std::unique_ptr<uint8_t[]> whole = std::move(partial.data);
+        dispatch(whole.get(), frame.total, frame.is_text, frame.to_device, frame.sent_ms);
+    }
+}
+
+void LoopbackSocket::dispatch(const uint8_t* data, size_t length, bool is_text, bool to_device,
+                              uint32_t sent_ms) {
+    if (!to_device) {
+        stats_.frames_up++;
+        stats_.bytes_up += length;
+        answer(data, length, is_text, sent_ms);
+        return;
+    }
+
+    stats_.frames_down++;
+    stats_.bytes_down += length;
+
+    uint32_t rtt = millis() - sent_ms;
+    if (stats_.rtt_count == 0 || rtt < stats_.rtt_min_ms) stats_.rtt_min_ms = rtt;
+    if (rtt > stats_.rtt_max_ms) stats_.rtt_max_ms = rtt;
+    stats_.rtt_total_ms += rtt;
+    stats_.rtt_count++;
+
+    if (callback_) {
+        callback_(is_text ? WStype_TEXT : WStype_BIN, const_cast<uint8_t*>(data), length);
+    }
+}
+
+void LoopbackSocket::answer(const uint8_t* data, size_t length, bool is_text, uint32_t sent_ms) {
+    const MessageCodec& decoder = getMessageCodec(is_text ? CodecId::JSON : CodecId::BINARY_V2);
+    ProtocolMessage request;
+    if (!decoder.decode(data, length, request)) return;
+
+    JsonDocument reply;
+    MessageType reply_type;
+
+    switch (request.getType()) {
+        case MessageType::AUTH:
+            reply_type = MessageType::AUTH_RESPONSE;
+            reply["success"] = true;
+            reply["session_id"] = "loopback";
+            break;
+
+        case MessageType::PING:
+            reply_type = MessageType::PONG;
+            reply["ping_timestamp"] = request.getTimestamp();
+            reply["timestamp"] = millis();
+            break;
+
+        case MessageType::TEXT: {
+            JsonDocument text;
+            String json;
+            if (request.getJsonPayload(json)) deserializeJson(text, json);
+            reply_type = MessageType::RESPONSE_FINAL;
+            reply["text"] = String("echo: ") + (text["text"] | "");
+            reply["is_final"] = true;
+            break;
+        }
+
+        case MessageType::AUDIO:
+            if (!hasFlag(request.getFlags(), MessageFlags::FINAL)) return;
+            reply_type = MessageType::RESPONSE_FINAL;
+            reply["text"] = "[loopback: utterance received]";
+            reply["is_final"] = true;
+            break;
+
+        default:
+            return;
+    }
+
+    String json;
+    serializeJson(reply, json);
+    ProtocolMessage response(reply_type);
+    response.setJsonPayload(json);
+
+    // Reply in the negotiated codec, as the bridge would
+    const MessageCodec& encoder = getMessageCodec(subprotocol_);
+    static uint8_t buffer[CODEC_MAX_FRAME_SIZE];
+    size_t out_length = 0;
+    if (encoder.encode(response, buffer, sizeof(buffer), out_length)) {
+        enqueue(buffer, out_length, encoder.isText(), true, sent_ms);
+    }
+}
+
+void LoopbackSocket::clearQueue() {
+    for (Frame& frame : queue_) {
+        frame.data.reset();
+    }
+    partial_[UP].data.reset();
+    partial_[DOWN].data.reset();
+}
+
+void LoopbackSocket::printReport() const {
+    Serial.printf("[Loopback] up %lu frames/%lu B, down %lu frames/%lu B, lost %lu, refused %lu, "
+                  "fragments %lu, handshakes %lu (%lu refused)\n",
+                  (unsigned long)stats_.frames_up, (unsigned long)stats_.bytes_up,
+                  (unsigned long)stats_.frames_down, (unsigned long)stats_.bytes_down,
+                  (unsigned long)stats_.frames_lost, (unsigned long)stats_.frames_refused,
+                  (unsigned long)stats_.fragments,
+                  (unsigned long)stats_.handshakes, (unsigned long)stats_.handshakes_refused);
+    if (stats_.rtt_count > 0) {
+        Serial.printf("[Loopback] rtt min %lu / avg %lu / max %lu ms over %lu\n",
+                      (unsigned long)stats_.rtt_min_ms,
+                      (unsigned long)(stats_.rtt_total_ms / stats_.rtt_count),
+                      (unsigned long)stats_.rtt_max_ms, (unsigned long)stats_.rtt_count);
+    }
+}
+
+// xorshift32: repeatable across runs for a given seed
+uint32_t LoopbackSocket::nextRandom() {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_;
+}
+
+bool LoopbackSocket::roll(uint8_t percent) {
+    return percent > 0 && nextRandom() % 100 < percent;
+}
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_LOOPBACK_GATEWAY
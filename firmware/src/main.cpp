@@ -22,10 +22,22 @@
 #include "websocket_client.h"
 #include "audio_streamer.h"
 #include "keyboard_handler.h"
+#include "prompt_history.h"
+#include "phrase_trie.h"
+#include "trigger_matcher.h"
 #include "display_renderer.h"
 #include "app_state_machine.h"
+#include "parallel_init.h"
+#include "timer_wheel.h"
+#include "event_loop.h"
+#include "power_manager.h"
+#include "idle_manager.h"
+#include "state_machine_dsl.h"
 #include "config_manager.h"
 #include "settings_menu.h"
+#include "wifi_manager.h"
+#include "fast_connect.h"
+#include "boot_profile.h"
 
 // Avatar system
 #include "avatar/procedural_avatar.h"
@@ -44,11 +56,19 @@ using namespace OpenClaw;
 // FIRMWARE_VERSION, FIRMWARE_NAME, FIRMWARE_CODENAME defined in build flags
 
 // Timing constants
-constexpr uint32_t MAIN_LOOP_DELAY_MS = 10;
+constexpr uint32_t NETWORK_SERVICE_INTERVAL_MS = 20;      // Connecting, or no RX watcher
+constexpr uint32_t NETWORK_KEEPALIVE_INTERVAL_MS = 1000;  // Session up, traffic signalled
 constexpr uint32_t WIFI_CONNECT_TIMEOUT_MS = 30000;
-constexpr uint32_t WIFI_RECONNECT_INTERVAL_MS = 10000;
 constexpr uint32_t DISPLAY_UPDATE_INTERVAL_MS = 33;  // ~30 FPS
 constexpr uint32_t STATUS_UPDATE_INTERVAL_MS = 1000;
+constexpr uint32_t BOOT_INIT_TIMEOUT_MS = 10000;
+
+// Prompt history and phrases are written this long after a submit, so a
+// burst of prompts costs one flash write
+constexpr uint32_t HISTORY_SAVE_DELAY_MS = 10000;
+
+// Deep idle: backlight level while drowsy, as a fraction of the configured one
+constexpr uint8_t IDLE_DIM_DIVISOR = 4;
 
 // Display regions
 constexpr int16_t AVATAR_HEIGHT = 64;
@@ -62,12 +82,21 @@ struct Application {
     // Components
     WebSocketClient websocket;
     AudioStreamer audio;
+    WiFiManager wifi;
+    FastConnectCache fast_connect;
+    BootProfile boot_profile;
     KeyboardHandler keyboard;
     DisplayRenderer display;
     AppStateMachine state_machine;
+    TimerWheel timers;
+    EventLoop events;
+    PowerManager power;
+    IdleManager idle;
     AppContext context;
     ConfigManager config_manager;
     SettingsMenu settings_menu;
+    PromptHistory history;
+    PhraseTrie phrases;
     AvatarAudioBridge avatar_bridge;  // NEW: Audio-to-avatar lip-sync
 
     // Configuration
@@ -77,19 +106,22 @@ struct Application {
 
     // Runtime state
     bool initialized;
-    uint32_t last_display_update;
-    uint32_t last_status_update;
-    uint32_t last_wifi_check;
-    uint32_t wifi_connect_start;
+    TimerId network_timer;
+    uint32_t network_interval_ms;       // 0 while not servicing the gateway
+    bool utterance_sent;                // The turn's utterance has ended (final frame out)
+    TimerId display_timer;
+    TimerId status_timer;
+    TimerId sensor_timer;
+    TimerId history_save_timer;
 
     // Ancient mode
     bool ancient_mode_active;
-    uint32_t ancient_mode_start;
 
-    Application() : initialized(false), last_display_update(0),
-                    last_status_update(0), last_wifi_check(0),
-                    wifi_connect_start(0), ancient_mode_active(false),
-                    ancient_mode_start(0) {}
+    Application() : initialized(false), network_timer(INVALID_TIMER_ID),
+                    network_interval_ms(0), utterance_sent(false),
+                    display_timer(INVALID_TIMER_ID), status_timer(INVALID_TIMER_ID),
+                    sensor_timer(INVALID_TIMER_ID), history_save_timer(INVALID_TIMER_ID),
+                    ancient_mode_active(false) {}
 };
 
 static Application g_app;
@@ -99,23 +131,49 @@ static Application g_app;
 // =============================================================================
 
 bool loadConfiguration();
+void applyContextConfig(const AppConfig& config);
+void buildWebSocketConfig(const AppConfig& config, WebSocketConfig& ws_config);
+void buildAudioConfig(const AppConfig& config, AudioStreamerConfig& audio_config);
+void setupConfigSubscribers();
+bool initDisplayJob();
+bool initSensorsJob();
 void setupStateMachine();
 void setupWebSocketCallbacks();
 void setupAudioCallbacks();
 void setupKeyboardCallbacks();
+void setupPromptHistory();
+void startPhraseIndex();
+void savePromptHistory();
 void setupDisplay();
 
+void setupWiFi();
 void connectWiFi();
-void updateWiFiStatus();
 void handleWiFiConnected();
 void handleWiFiDisconnected();
+void prefetchGatewayAddress();
+void handleGatewayResolved();
 
 void onStateChange(AppState from, AppState to);
 void handleSystemEvent(AppEvent event);
 
 void processIncomingMessage(const ProtocolMessage& msg);
+void beginTurn();
+bool isStaleTurn(const JsonDocument& doc);
 void sendTextToGateway(const char* text);
 void sendAudioToGateway(const EncodedAudioPacket& packet);
+void sendAudioConfig();
+
+void setupTimers();
+void setNetworkServiceActive(bool active);
+void setNetworkServiceInterval(uint32_t interval_ms);
+void setFrameTimersActive(bool active);
+void setSensorSampleInterval(uint32_t interval_ms);
+void serviceNetwork();
+void updateSensors();
+void updateBattery();
+
+void noteActivity(WakeSource source);
+void onIdleStageChange(IdleStage from, IdleStage to, WakeSource source);
 
 void updateDisplay();
 void updateStatusBar();
@@ -123,7 +181,6 @@ void renderAvatar();
 
 void enterAncientMode();
 void exitAncientMode();
-bool checkAncientModeTrigger(const char* text);
 
 // =============================================================================
 // Setup
@@ -132,160 +189,275 @@ bool checkAncientModeTrigger(const char* text);
 void setup() {
     // Initialize serial for debugging
     Serial.begin(115200);
-    delay(1000);
 
     Serial.println("\n========================================");
     Serial.println(FIRMWARE_NAME);
     Serial.printf("Version: %s (%s)\n", FIRMWARE_VERSION, FIRMWARE_CODENAME);
     Serial.println("========================================\n");
 
-    // Initialize M5Cardputer
+    // Initialize M5Cardputer (panel, I2C, power)
     auto cfg = M5.config();
     M5Cardputer.begin(cfg, true);
 
-    // Initialize display early for boot screen
-    g_app.display.begin(g_app.display_config);
-    g_app.display.renderBootScreen(FIRMWARE_VERSION);
+    // Independent init steps run concurrently: display on SPI, config on
+    // flash, IMU on I2C. Everything below depends on their results.
+    static ParallelInit boot_init;
+    boot_init.add("display", initDisplayJob, 8192);
+    size_t config_job = boot_init.getJobCount();
+    boot_init.add("config", loadConfiguration, 8192);
+    boot_init.add("imu", initSensorsJob);
 
-    // Load configuration
-    if (!loadConfiguration()) {
-        Serial.println("Failed to load configuration");
+    bool init_ok = boot_init.run(BOOT_INIT_TIMEOUT_MS);
+    boot_init.printReport();
+
+    const InitJob& config = boot_init.getJob(config_job);
+    if (!config.done || !config.ok) {
+        Serial.printf("Failed to load configuration: %s\n", boot_init.getLastError());
         g_app.display.renderErrorScreen("Config load failed");
-        delay(5000);
+        delay(5000);  // Leave the error readable, then start over
         ESP.restart();
     }
+    if (!init_ok) {
+        Serial.printf("Boot init: %s\n", boot_init.getLastError());
+    }
+    g_app.display.setBrightness(g_app.display_config.brightness);
+
+    // Producers on other tasks wake the loop through this
+    if (!g_app.events.begin()) {
+        Serial.printf("Event loop init failed: %s\n", g_app.events.getLastError());
+    }
+
+    // Frequency scaling and light sleep; runs at the fixed clock if unavailable
+    if (!g_app.power.begin()) {
+        Serial.printf("Power management disabled: %s\n", g_app.power.getLastError());
+    }
+
+    // Deep idle staging (display, IMU and timers are switched from the callback)
+    g_app.idle.begin(millis());
+    g_app.idle.setOnStageChange(onIdleStageChange);
 
     // Setup state machine
     setupStateMachine();
 
-    // Initialize components
+    // Initialize components (allocation only; I2S starts with capture)
+    g_app.keyboard.setNotifier(g_app.events.notifier(LOOP_SIGNAL_INPUT));
     if (!g_app.keyboard.begin()) {
         Serial.println("Keyboard init failed");
     }
     setupKeyboardCallbacks();
-    delay(500);  // Small delay after keyboard
+    setupPromptHistory();
+    g_app.display.setInputBuffer(&g_app.keyboard.getInputBuffer());
 
     if (!g_app.audio.begin(g_app.audio_config)) {
         Serial.println("Audio init failed - continuing without audio");
     }
+    g_app.audio.setNotifier(g_app.events.notifier(LOOP_SIGNAL_AUDIO));
     setupAudioCallbacks();
-    delay(500);  // Small delay after audio
 
     if (!g_app.websocket.begin(g_app.ws_config)) {
-        Serial.println("WebSocket init failed");
+        Serial.printf("WebSocket init failed: %s\n", g_app.websocket.getLastError());
     }
+    g_app.websocket.setNotifier(g_app.events.notifier(LOOP_SIGNAL_NETWORK));
     setupWebSocketCallbacks();
-    delay(500);  // Small delay after websocket
+
+    // Joins are started from the WIFI_CONNECTING state
+    setupWiFi();
 
     // Start state machine
-    g_app.state_machine.begin();
-    delay(500);  // Small delay after state machine
+    g_app.state_machine.begin(&AppMachine::spec, &g_app.timers);
 
-    // Initialize settings menu
-    g_app.settings_menu.begin(&g_app.config_manager, &g_app.display);
-    delay(500);  // Small delay after settings
+    // Initialize settings menu; saved changes are applied live
+    g_app.settings_menu.begin(&g_app.config_manager, &g_app.display, &g_app.wifi);
+    setupConfigSubscribers();
+
+    // Initialize avatar as the bottom compositor layer
+    DisplayCompositor& compositor = g_app.display.getCompositor();
+    Avatar::g_avatar.begin(compositor.getCanvas());
+    compositor.setLayer(DisplayLayer::AVATAR,
+        DisplayRect(Avatar::AVATAR_X, Avatar::AVATAR_Y, Avatar::AVATAR_SIZE, Avatar::AVATAR_SIZE),
+        [](lgfx::LovyanGFX&) { Avatar::g_avatar.render(); }, true);
 
-    // Initialize avatar (using M5Cardputer's display)
-    Avatar::g_avatar.begin(&M5Cardputer.Display);
-    delay(500);  // Small delay after avatar
-    
-    // Initialize sensors (IMU)
-    Avatar::g_sensors.begin();
-    delay(500);  // Small delay after sensors
-    
     // Initialize audio-to-avatar bridge
     g_app.avatar_bridge.begin(&g_app.audio, &Avatar::g_avatar);
-    delay(500);  // Small delay after bridge
+
+    // Periodic work runs off the timer wheel from here on
+    setupTimers();
 
     g_app.initialized = true;
 
-    Serial.println("Setup complete");
+    g_app.boot_profile.mark(BootPhase::SETUP);
+    Serial.printf("Setup complete in %lu ms\n", (unsigned long)millis());
 
     // Clear boot screen before entering loop
     g_app.display.clear();
 }
 
+bool initDisplayJob() {
+    // Runs alongside config loading, so start from defaults; the loaded
+    // brightness is applied after the join
+    if (!g_app.display.begin(DisplayConfig())) {
+        Serial.println("Display init failed");
+        return false;
+    }
+    g_app.display.renderBootScreen(FIRMWARE_VERSION);
+    return true;
+}
+
+bool initSensorsJob() {
+    // No IMU is not an error; the avatar just won't react to motion
+    Avatar::g_sensors.begin();
+    return true;
+}
+
 // =============================================================================
 // Main Loop
 // =============================================================================
 
 void loop() {
-    uint32_t now = millis();
+    // Block until a producer signals or the next timer is due
+    uint32_t signals = g_app.events.wait(g_app.timers.msUntilNextDeadline());
 
-    // Update M5 systems
-    M5Cardputer.update();
-
-    // Update components
-    g_app.keyboard.update();
-    g_app.audio.update();
-    g_app.websocket.update();
-    g_app.state_machine.update();
-    g_app.avatar_bridge.update();
-    
-    // Update sensors and react
-    Avatar::g_sensors.update();
-    
-    // Apply sensor reactions to avatar
-    if (Avatar::g_sensors.isShaking()) {
-        Avatar::g_avatar.onShake();
+    // Keys typed since the last wake (scanned on their own task)
+    if (signals & LOOP_SIGNAL_INPUT) {
+        g_app.keyboard.update();
     }
-    if (Avatar::g_sensors.isFaceDown()) {
-        Avatar::g_avatar.setSleeping(true);
-    } else {
-        Avatar::g_avatar.setSleeping(false);
-        // Apply tilt when awake
-        Avatar::g_avatar.setTilt(Avatar::g_sensors.getTiltX(), 
-                                  Avatar::g_sensors.getTiltY());
+
+    // WiFi system events (link, DHCP, scan results)
+    if (signals & LOOP_SIGNAL_WIFI) {
+        g_app.wifi.update();
     }
-    
-    // Low battery reaction
-    if (Avatar::g_sensors.isLowBattery()) {
-        Avatar::g_avatar.setLowBattery(true);
+
+    // Gateway data (the RX watcher saw the socket readable)
+    if ((signals & LOOP_SIGNAL_NETWORK) && g_app.network_interval_ms != 0) {
+        serviceNetwork();
     }
-    
-    // Update settings menu if open
-    if (g_app.settings_menu.isOpen()) {
-        g_app.settings_menu.update();
-        g_app.settings_menu.render();
+
+    // Encoded audio from the capture task
+    if (signals & LOOP_SIGNAL_AUDIO) {
+        g_app.audio.update();
+
+        EncodedAudioPacket audio_packet;
+        while (g_app.audio.readEncodedPacket(audio_packet)) {
+            sendAudioToGateway(audio_packet);
+        }
     }
 
-    // Update WiFi status
-    if (now - g_app.last_wifi_check >= 1000) {
-        updateWiFiStatus();
-        g_app.last_wifi_check = now;
+    // Periodic work (display, network, sensors, state timeouts)
+    g_app.timers.advance();
+
+    // Events posted by any of the above
+    g_app.state_machine.update();
+}
+
+// =============================================================================
+// Timers
+// =============================================================================
+
+void setupTimers() {
+    TimerWheel& timers = g_app.timers;
+
+    timers.scheduleEvery(Avatar::BATTERY_CHECK_INTERVAL_MS, [](void*) { updateBattery(); });
+    timers.scheduleEvery(POWER_UPDATE_INTERVAL_MS, [](void*) {
+        g_app.power.setBacklight(g_app.display.getBacklightLevel());
+        g_app.power.update(g_app.events.getStats());
+    });
+    timers.scheduleEvery(IDLE_CHECK_INTERVAL_MS, [](void*) { g_app.idle.update(millis()); });
+
+    // Suspended while the device is idle
+    setFrameTimersActive(true);
+
+    // No IMU, no sampling wakeups
+    if (Avatar::g_sensors.isImuAvailable()) {
+        setSensorSampleInterval(Avatar::SENSOR_SAMPLE_INTERVAL_MS);
     }
+}
 
-    // Update display at ~30 FPS
-    if (now - g_app.last_display_update >= DISPLAY_UPDATE_INTERVAL_MS) {
-        updateDisplay();
-        g_app.last_display_update = now;
+void setNetworkServiceActive(bool active) {
+    // The socket needs servicing only while a gateway link exists
+    setNetworkServiceInterval(active ? NETWORK_SERVICE_INTERVAL_MS : 0);
+}
+
+void setNetworkServiceInterval(uint32_t interval_ms) {
+    if (interval_ms == g_app.network_interval_ms &&
+        (interval_ms == 0 || g_app.timers.isActive(g_app.network_timer))) {
+        return;
     }
+    g_app.timers.cancel(&g_app.network_timer);
+    g_app.network_interval_ms = interval_ms;
+    if (interval_ms > 0) {
+        g_app.network_timer = g_app.timers.scheduleEvery(interval_ms,
+                                                         [](void*) { serviceNetwork(); });
+    }
+}
 
-    // Update status bar
-    if (now - g_app.last_status_update >= STATUS_UPDATE_INTERVAL_MS) {
-        updateStatusBar();
-        g_app.last_status_update = now;
+void setFrameTimersActive(bool active) {
+    // Rendering stops entirely while the screen is dimmed or off
+    if (active && !g_app.timers.isActive(g_app.display_timer)) {
+        g_app.display_timer = g_app.timers.scheduleEvery(DISPLAY_UPDATE_INTERVAL_MS,
+                                                         [](void*) { updateDisplay(); });
+        g_app.status_timer = g_app.timers.scheduleEvery(STATUS_UPDATE_INTERVAL_MS,
+                                                        [](void*) { updateStatusBar(); });
+    } else if (!active) {
+        g_app.timers.cancel(&g_app.display_timer);
+        g_app.timers.cancel(&g_app.status_timer);
     }
+}
+
+void setSensorSampleInterval(uint32_t interval_ms) {
+    g_app.timers.cancel(&g_app.sensor_timer);
+    g_app.sensor_timer = g_app.timers.scheduleEvery(interval_ms, [](void*) { updateSensors(); });
+}
+
+void serviceNetwork() {
+    g_app.websocket.update();
 
-    // Process incoming WebSocket messages
     ProtocolMessage msg;
     while (g_app.websocket.receive(msg)) {
         processIncomingMessage(msg);
     }
 
-    // Process incoming audio packets
-    EncodedAudioPacket audio_packet;
-    while (g_app.audio.readEncodedPacket(audio_packet)) {
-        sendAudioToGateway(audio_packet);
+    // Handshakes and retries are polled; once the session is up its
+    // traffic wakes the loop and the timer only drives the keepalive
+    if (g_app.network_interval_ms != 0) {
+        setNetworkServiceInterval(g_app.websocket.isEventDriven() ? NETWORK_KEEPALIVE_INTERVAL_MS
+                                                                  : NETWORK_SERVICE_INTERVAL_MS);
     }
+}
+
+void updateSensors() {
+    Avatar::g_sensors.update();
+    g_app.power.setFaceDown(Avatar::g_sensors.isFaceDown());
+    g_app.idle.setFaceDown(Avatar::g_sensors.isFaceDown(), millis());
 
-    // Ancient mode timeout check
-    if (g_app.ancient_mode_active &&
-        (now - g_app.ancient_mode_start > 300000)) {  // 5 minutes
-        exitAncientMode();
+    // Wake-on-motion sampling: nothing on screen to react with
+    if (Avatar::g_sensors.isLowPowerMode()) {
+        if (Avatar::g_sensors.hasMotion()) {
+            noteActivity(WakeSource::MOTION);
+        }
+        return;
     }
 
-    delay(MAIN_LOOP_DELAY_MS);
+    // Apply sensor reactions to avatar
+    if (Avatar::g_sensors.isShaking()) {
+        Avatar::g_avatar.onShake();
+    }
+    if (Avatar::g_sensors.isFaceDown()) {
+        Avatar::g_avatar.setSleeping(true);
+    } else {
+        Avatar::g_avatar.setSleeping(false);
+        // Apply tilt when awake
+        Avatar::g_avatar.setTilt(Avatar::g_sensors.getTiltX(),
+                                  Avatar::g_sensors.getTiltY());
+    }
+}
+
+void updateBattery() {
+    Avatar::g_sensors.checkBattery();
+
+    // Low battery reaction
+    if (Avatar::g_sensors.isLowBattery()) {
+        Avatar::g_avatar.setLowBattery(true);
+    }
 }
 
 // =============================================================================
@@ -293,10 +465,16 @@ void loop() {
 // =============================================================================
 
 bool loadConfiguration() {
-    // Initialize config manager (mounts LittleFS)
+    // Initialize config manager (mounts LittleFS) and read /config.json
     if (!g_app.config_manager.begin()) {
         Serial.printf("ConfigManager init failed: %s\n", g_app.config_manager.getLastError());
         // Continue with defaults - not fatal
+    } else if (!g_app.config_manager.load()) {
+        Serial.printf("Config load: %s\n", g_app.config_manager.getLastError());
+    } else {
+        Serial.printf("Config loaded from %s in %lu us\n",
+                      configSourceToString(g_app.config_manager.getLoadSource()),
+                      (unsigned long)g_app.config_manager.getLoadTimeUs());
     }
 
     const auto& config = g_app.config_manager.getConfig();
@@ -309,19 +487,44 @@ bool loadConfiguration() {
         // Still continue - user can see error on display
     }
 
-    // Copy WiFi config to context
+    applyContextConfig(config);
+    buildWebSocketConfig(config, g_app.ws_config);
+    buildAudioConfig(config, g_app.audio_config);
+
+    // Display configuration
+    g_app.display_config.brightness = config.device.display_brightness;
+    g_app.display_config.auto_scroll = true;
+
+    Serial.println("Configuration loaded successfully");
+    g_app.config_manager.printConfig();
+
+    return true;
+}
+
+void applyContextConfig(const AppConfig& config) {
     strlcpy(g_app.context.config.wifi_ssid, config.wifi.ssid.c_str(),
             sizeof(g_app.context.config.wifi_ssid));
     strlcpy(g_app.context.config.wifi_password, config.wifi.password.c_str(),
             sizeof(g_app.context.config.wifi_password));
+    strlcpy(g_app.context.config.gateway_url, config.gateway.websocket_url.c_str(),
+            sizeof(g_app.context.config.gateway_url));
+    strlcpy(g_app.context.config.device_id, config.device.id.c_str(),
+            sizeof(g_app.context.config.device_id));
+    strlcpy(g_app.context.config.device_name, config.device.name.c_str(),
+            sizeof(g_app.context.config.device_name));
+    strlcpy(g_app.context.config.api_key, config.gateway.api_key.c_str(),
+            sizeof(g_app.context.config.api_key));
+}
 
+void buildWebSocketConfig(const AppConfig& config, WebSocketConfig& ws_config) {
     // Parse gateway URL (ws://host:port/path)
     String ws_url = config.gateway.websocket_url;
+    ws_config.use_ssl = false;
     if (ws_url.startsWith("ws://")) {
         ws_url = ws_url.substring(5); // Remove "ws://"
     } else if (ws_url.startsWith("wss://")) {
         ws_url = ws_url.substring(6); // Remove "wss://"
-        g_app.ws_config.use_ssl = true;
+        ws_config.use_ssl = true;
     }
 
     // Extract host, port, path
@@ -333,180 +536,223 @@ bool loadConfiguration() {
     String host = (port_idx > 0) ? host_port.substring(0, port_idx) : host_port;
     uint16_t port = (port_idx > 0) ? host_port.substring(port_idx + 1).toInt() : 8765;
 
-    // Copy gateway config to context
-    strlcpy(g_app.context.config.gateway_url, config.gateway.websocket_url.c_str(),
-            sizeof(g_app.context.config.gateway_url));
-    strlcpy(g_app.context.config.device_id, config.device.id.c_str(),
-            sizeof(g_app.context.config.device_id));
-    strlcpy(g_app.context.config.device_name, config.device.name.c_str(),
-            sizeof(g_app.context.config.device_name));
-    strlcpy(g_app.context.config.api_key, config.gateway.api_key.c_str(),
-            sizeof(g_app.context.config.api_key));
+    ws_config.host = host;
+    ws_config.host_ip = 0;  // Filled in by prefetchGatewayAddress()
+    ws_config.port = port;
+    ws_config.path = path;
+    ws_config.tls_fingerprint = config.gateway.tls_fingerprint;
+    ws_config.device_id = config.device.id;
+    ws_config.device_name = config.device.name;
+    ws_config.firmware_version = FIRMWARE_VERSION;
+    ws_config.api_key = config.gateway.api_key;
+    ws_config.reconnect_interval_ms = config.gateway.reconnect_interval_ms;
+    ws_config.ping_interval_ms = config.gateway.ping_interval_ms;
+    ws_config.connect_timeout_ms = config.gateway.connection_timeout_ms;
+}
 
-    // WebSocket configuration
-    g_app.ws_config.host = host;
-    g_app.ws_config.port = port;
-    g_app.ws_config.path = path;
-    g_app.ws_config.device_id = config.device.id;
-    g_app.ws_config.device_name = config.device.name;
-    g_app.ws_config.firmware_version = FIRMWARE_VERSION;
-    g_app.ws_config.api_key = config.gateway.api_key;
-    g_app.ws_config.reconnect_interval_ms = config.gateway.reconnect_interval_ms;
-    g_app.ws_config.ping_interval_ms = config.gateway.ping_interval_ms;
-    g_app.ws_config.connect_timeout_ms = config.gateway.connection_timeout_ms;
-
-    // Audio configuration
-    g_app.audio_config.sample_rate = config.audio.sample_rate;
-    g_app.audio_config.codec = (config.audio.codec.equals("opus")) ? AudioCodec::OPUS : AudioCodec::PCM_S16LE;
-    g_app.audio_config.frame_duration_ms = config.audio.frame_duration_ms;
-    g_app.audio_config.vad_enabled = true;
-    g_app.audio_config.vad_threshold = 500;
+void buildAudioConfig(const AppConfig& config, AudioStreamerConfig& audio_config) {
+    audio_config.sample_rate = config.audio.sample_rate;
+    audio_config.codec = (config.audio.codec.equals("opus")) ? AudioCodec::OPUS : AudioCodec::PCM_S16LE;
+    audio_config.frame_duration_ms = config.audio.frame_duration_ms;
+    audio_config.mic_gain = config.audio.mic_gain;
+    audio_config.vad_enabled = true;
+    audio_config.vad_threshold = 500;
+}
 
-    // Display configuration
+// =============================================================================
+// Live Configuration
+// =============================================================================
+
+void onWiFiConfigChanged(ConfigKeyMask, const AppConfig& config, void*) {
+    applyContextConfig(config);
+    Serial.println("[Config] WiFi settings changed, rejoining");
+
+    // New credentials invalidate the cached BSSID/channel too
+    g_app.wifi.clearNetworks();
+    g_app.wifi.addNetwork(config.wifi.ssid.c_str(), config.wifi.password.c_str());
+    connectWiFi();
+}
+
+void onGatewayConfigChanged(ConfigKeyMask, const AppConfig& config, void*) {
+    applyContextConfig(config);
+    buildWebSocketConfig(config, g_app.ws_config);
+    if (g_app.wifi.isConnected()) {
+        prefetchGatewayAddress();
+    }
+
+    // Timing-only changes keep the session
+    if (g_app.websocket.reconfigure(g_app.ws_config)) {
+        Serial.println("[Config] Gateway endpoint changed, reconnecting");
+    }
+}
+
+void onAudioConfigChanged(ConfigKeyMask changed, const AppConfig& config, void*) {
+    buildAudioConfig(config, g_app.audio_config);
+    if (!g_app.audio.reconfigure(g_app.audio_config)) {
+        Serial.printf("[Config] Audio reconfigure failed: %s\n", g_app.audio.getLastError());
+        return;
+    }
+
+    // A pending format is announced when the current capture ends
+    if ((changed & ConfigGroups::AUDIO_FORMAT) && !g_app.audio.hasPendingFormat()) {
+        sendAudioConfig();
+    }
+}
+
+void onDisplayConfigChanged(ConfigKeyMask, const AppConfig& config, void*) {
     g_app.display_config.brightness = config.device.display_brightness;
-    g_app.display_config.auto_scroll = true;
+    g_app.display.setBrightness(g_app.display_config.brightness);
+}
 
-    Serial.println("Configuration loaded successfully");
-    g_app.config_manager.printConfig();
+void onHistoryConfigChanged(ConfigKeyMask, const AppConfig& config, void*) {
+    if (config.device.save_history) {
+        startPhraseIndex();
+    } else {
+        // Stop learning and give the arenas back; what was saved stays
+        g_app.timers.cancel(&g_app.history_save_timer);
+        g_app.phrases.end();
+    }
+}
 
-    return true;
+void setupConfigSubscribers() {
+    ConfigBus& bus = g_app.config_manager.getBus();
+    bus.subscribe(configKeyBit(ConfigKey::WIFI_SSID) | configKeyBit(ConfigKey::WIFI_PASSWORD),
+                  onWiFiConfigChanged);
+    bus.subscribe(ConfigGroups::GATEWAY, onGatewayConfigChanged);
+    bus.subscribe(ConfigGroups::AUDIO, onAudioConfigChanged);
+    bus.subscribe(ConfigGroups::DISPLAY, onDisplayConfigChanged);
+    bus.subscribe(configKeyBit(ConfigKey::DEVICE_SAVE_HISTORY), onHistoryConfigChanged);
 }
 
 // =============================================================================
 // State Machine Setup
 // =============================================================================
 
-// Polyfill for std::make_unique (C++14 feature) for C++11 compatibility
-#if __cplusplus < 201402L
-template<typename T, typename... Args>
-std::unique_ptr<T> make_unique(Args&&... args) {
-    return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+// State entry/exit actions
+void onVoiceInputEnter() {
+    g_app.idle.setInhibited(true, millis());
+    g_app.power.setAudioStreaming(true);
+    g_app.power.requestBoost(POWER_BOOST_AUDIO);
+    g_app.display.addMessage("Listening...", DisplayMessageType::STATUS_MSG);
+    g_app.display.setAudioStatus(AudioIndicator::LISTENING);
+    g_app.audio.start();
 }
-#else
-using std::make_unique;
-#endif
-
-void setupStateMachine() {
-    // Create states
-    auto boot_state = make_unique<State>(AppState::BOOT, "Boot");
-    auto config_loading = make_unique<State>(AppState::CONFIG_LOADING, "ConfigLoading");
-    auto wifi_connecting = make_unique<State>(AppState::WIFI_CONNECTING, "WiFiConnecting");
-    auto gateway_connecting = make_unique<State>(AppState::GATEWAY_CONNECTING, "GatewayConnecting");
-    auto authenticating = make_unique<State>(AppState::AUTHENTICATING, "Authenticating");
-    auto ready = make_unique<State>(AppState::READY, "Ready");
-    auto voice_input = make_unique<State>(AppState::VOICE_INPUT, "VoiceInput");
-    auto ai_processing = make_unique<State>(AppState::AI_PROCESSING, "AIProcessing");
-    auto ai_responding = make_unique<State>(AppState::AI_RESPONDING, "AIResponding");
-    auto ancient_mode = make_unique<State>(AppState::ANCIENT_MODE, "AncientMode");
-    auto error_state = make_unique<State>(AppState::ERROR_STATE, "Error");
-
-    // Boot state transitions
-    boot_state->addTransition(AppEvent::BOOT_COMPLETE, AppState::CONFIG_LOADING);
-    boot_state->setTimeout(2000, AppState::CONFIG_LOADING);
-
-    // Config loading transitions
-    config_loading->addTransition(AppEvent::CONFIG_LOADED, AppState::WIFI_CONNECTING);
-    config_loading->addTransition(AppEvent::CONFIG_ERROR, AppState::ERROR_STATE);
-
-    // WiFi connecting transitions
-    wifi_connecting->addTransition(AppEvent::WIFI_CONNECTED, AppState::GATEWAY_CONNECTING);
-    wifi_connecting->addTransition(AppEvent::WIFI_ERROR, AppState::ERROR_STATE);
-    wifi_connecting->setTimeout(WIFI_CONNECT_TIMEOUT_MS, AppState::ERROR_STATE);
-    wifi_connecting->setRetryDelay(3000);  // Wait 3s before retrying
-
-    // Gateway connecting transitions
-    gateway_connecting->addTransition(AppEvent::GATEWAY_CONNECTED, AppState::AUTHENTICATING);
-    gateway_connecting->addTransition(AppEvent::GATEWAY_ERROR, AppState::ERROR_STATE);
-    gateway_connecting->addTransition(AppEvent::WIFI_DISCONNECTED, AppState::WIFI_CONNECTING);
-    gateway_connecting->setRetryDelay(5000);  // Wait 5s before retrying
-
-    // Authenticating transitions
-    authenticating->addTransition(AppEvent::AUTHENTICATED, AppState::READY);
-    authenticating->addTransition(AppEvent::AUTH_FAILED, AppState::ERROR_STATE);
-    authenticating->setTimeout(10000, AppState::ERROR_STATE);
-
-    // Ready state transitions
-    ready->addTransition(AppEvent::VOICE_KEY_PRESSED, AppState::VOICE_INPUT);
-    ready->addTransition(AppEvent::TEXT_SUBMITTED, AppState::AI_PROCESSING);
-    ready->addTransition(AppEvent::ANCIENT_MODE_TRIGGER, AppState::ANCIENT_MODE);
-    ready->addTransition(AppEvent::WIFI_DISCONNECTED, AppState::WIFI_CONNECTING);
-    ready->addTransition(AppEvent::GATEWAY_DISCONNECTED, AppState::GATEWAY_CONNECTING);
-
-    // Voice input transitions
-    voice_input->addTransition(AppEvent::VOICE_STOPPED, AppState::AI_PROCESSING);
-    voice_input->addTransition(AppEvent::VOICE_KEY_PRESSED, AppState::READY);
-    voice_input->setTimeout(30000, AppState::READY);  // 30 second timeout
-
-    // AI processing transitions
-    ai_processing->addTransition(AppEvent::AI_RESPONSE_CHUNK, AppState::AI_RESPONDING);
-    ai_processing->addTransition(AppEvent::AI_RESPONSE_COMPLETE, AppState::READY);
-    ai_processing->addTransition(AppEvent::AI_ERROR, AppState::READY);
-    ai_processing->setTimeout(60000, AppState::READY);  // 60 second timeout
-
-    // AI responding transitions
-    ai_responding->addTransition(AppEvent::AI_RESPONSE_COMPLETE, AppState::READY);
-    ai_responding->addTransition(AppEvent::AI_RESPONSE_CHUNK, AppState::AI_RESPONDING);
-
-    // Ancient mode transitions
-    ancient_mode->addTransition(AppEvent::ANCIENT_MODE_TRIGGER, AppState::READY);
-    ancient_mode->addTransition(AppEvent::TEXT_SUBMITTED, AppState::AI_PROCESSING);
-    ancient_mode->setTimeout(300000, AppState::READY);  // 5 minute timeout
-
-    // Error state transitions
-    error_state->addTransition(AppEvent::ERROR_RECOVERED, AppState::WIFI_CONNECTING);
-    error_state->addTransition(AppEvent::FORCE_RECONNECT, AppState::WIFI_CONNECTING);
-    error_state->setTimeout(5000, AppState::WIFI_CONNECTING);  // Auto-retry after 5s
-
-    // Set state entry/exit actions
-    voice_input->setEntryAction([]() {
-        g_app.display.addMessage("Listening...", DisplayMessageType::STATUS_MSG);
-        g_app.display.setAudioStatus(AudioIndicator::LISTENING);
-        g_app.audio.start();
-    });
-
-    voice_input->setExitAction([]() {
-        g_app.audio.stop();
-        g_app.display.setAudioStatus(AudioIndicator::IDLE);
-    });
-
-    ai_processing->setEntryAction([]() {
-        g_app.display.setAudioStatus(AudioIndicator::PROCESSING);
-    });
 
-    ai_responding->setEntryAction([]() {
-        g_app.display.setAudioStatus(AudioIndicator::SPEAKING);
-    });
+void onVoiceInputExit() {
+    bool format_pending = g_app.audio.hasPendingFormat();
+    g_app.audio.stop();
+    // Answering the last utterance is tracked by state from here on
+    g_app.utterance_sent = false;
+    if (format_pending) {
+        sendAudioConfig();
+    }
+    g_app.power.releaseBoost(POWER_BOOST_AUDIO);
+    g_app.power.setAudioStreaming(false);
+    g_app.idle.setInhibited(false, millis());
+    g_app.display.setAudioStatus(AudioIndicator::IDLE);
+}
 
-    ai_responding->setExitAction([]() {
-        g_app.display.setAudioStatus(AudioIndicator::IDLE);
-    });
+void onAiProcessingEnter() {
+    g_app.display.setAudioStatus(AudioIndicator::PROCESSING);
+}
 
-    ancient_mode->setEntryAction([]() {
-        enterAncientMode();
-    });
+void onAiRespondingEnter() {
+    g_app.display.setAudioStatus(AudioIndicator::SPEAKING);
+}
 
-    ancient_mode->setExitAction([]() {
-        exitAncientMode();
-    });
+void onAiRespondingExit() {
+    g_app.display.setAudioStatus(AudioIndicator::IDLE);
+}
 
-    // Add states to machine
-    g_app.state_machine.addState(std::move(boot_state));
-    g_app.state_machine.addState(std::move(config_loading));
-    g_app.state_machine.addState(std::move(wifi_connecting));
-    g_app.state_machine.addState(std::move(gateway_connecting));
-    g_app.state_machine.addState(std::move(authenticating));
-    g_app.state_machine.addState(std::move(ready));
-    g_app.state_machine.addState(std::move(voice_input));
-    g_app.state_machine.addState(std::move(ai_processing));
-    g_app.state_machine.addState(std::move(ai_responding));
-    g_app.state_machine.addState(std::move(ancient_mode));
-    g_app.state_machine.addState(std::move(error_state));
+// Application state machine, validated at compile time
+using S = AppState;
+using E = AppEvent;
+
+using AppMachine = Fsm::Machine<S::BOOT,
+    Fsm::States<
+        //            state                    timeout ms               entry                 exit                retry ms
+        Fsm::StateDef<S::BOOT,                 2000>,
+        Fsm::StateDef<S::CONFIG_LOADING>,
+        Fsm::StateDef<S::WIFI_CONNECTING,      WIFI_CONNECT_TIMEOUT_MS, nullptr,              nullptr,            3000>,
+        Fsm::StateDef<S::GATEWAY_CONNECTING,   0,                       nullptr,              nullptr,            5000>,
+        Fsm::StateDef<S::AUTHENTICATING,       10000>,
+        Fsm::StateDef<S::READY>,
+        Fsm::StateDef<S::VOICE_INPUT,          30000,                   onVoiceInputEnter,    onVoiceInputExit>,
+        Fsm::StateDef<S::AI_PROCESSING,        60000,                   onAiProcessingEnter>,
+        Fsm::StateDef<S::AI_RESPONDING,        0,                       onAiRespondingEnter,  onAiRespondingExit>,
+        Fsm::StateDef<S::ANCIENT_MODE,         300000,                  enterAncientMode,     exitAncientMode>,
+        Fsm::StateDef<S::ERROR_STATE,          5000>
+    >,
+    Fsm::Rows<
+        // Boot
+        Fsm::Row<S::BOOT, E::BOOT_COMPLETE, S::CONFIG_LOADING>,
+        Fsm::Row<S::BOOT, E::TIMEOUT, S::CONFIG_LOADING>,
+
+        // Config loading
+        Fsm::Row<S::CONFIG_LOADING, E::CONFIG_LOADED, S::WIFI_CONNECTING>,
+        Fsm::Row<S::CONFIG_LOADING, E::CONFIG_ERROR, S::ERROR_STATE>,
+
+        // WiFi connecting
+        Fsm::Row<S::WIFI_CONNECTING, E::WIFI_CONNECTED, S::GATEWAY_CONNECTING>,
+        Fsm::Row<S::WIFI_CONNECTING, E::WIFI_ERROR, S::ERROR_STATE>,
+        Fsm::Row<S::WIFI_CONNECTING, E::TIMEOUT, S::ERROR_STATE>,
+
+        // Gateway connecting
+        Fsm::Row<S::GATEWAY_CONNECTING, E::GATEWAY_CONNECTED, S::AUTHENTICATING>,
+        Fsm::Row<S::GATEWAY_CONNECTING, E::GATEWAY_ERROR, S::ERROR_STATE>,
+        Fsm::Row<S::GATEWAY_CONNECTING, E::WIFI_DISCONNECTED, S::WIFI_CONNECTING>,
+
+        // Authenticating
+        Fsm::Row<S::AUTHENTICATING, E::AUTHENTICATED, S::READY>,
+        Fsm::Row<S::AUTHENTICATING, E::AUTH_FAILED, S::ERROR_STATE>,
+        Fsm::Row<S::AUTHENTICATING, E::TIMEOUT, S::ERROR_STATE>,
+
+        // Ready
+        Fsm::Row<S::READY, E::VOICE_KEY_PRESSED, S::VOICE_INPUT>,
+        Fsm::Row<S::READY, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+        Fsm::Row<S::READY, E::ANCIENT_MODE_TRIGGER, S::ANCIENT_MODE>,
+        Fsm::Row<S::READY, E::WIFI_DISCONNECTED, S::WIFI_CONNECTING>,
+        Fsm::Row<S::READY, E::GATEWAY_DISCONNECTED, S::GATEWAY_CONNECTING>,
+
+        // Voice input
+        Fsm::Row<S::VOICE_INPUT, E::VOICE_STOPPED, S::AI_PROCESSING>,
+        Fsm::Row<S::VOICE_INPUT, E::VOICE_KEY_PRESSED, S::READY>,
+        Fsm::Row<S::VOICE_INPUT, E::TIMEOUT, S::READY>,
+
+        // AI processing
+        Fsm::Row<S::AI_PROCESSING, E::AI_RESPONSE_CHUNK, S::AI_RESPONDING>,
+        Fsm::Row<S::AI_PROCESSING, E::AI_RESPONSE_COMPLETE, S::READY>,
+        Fsm::Row<S::AI_PROCESSING, E::AI_ERROR, S::READY>,
+        Fsm::Row<S::AI_PROCESSING, E::TIMEOUT, S::READY>,
+        Fsm::Row<S::AI_PROCESSING, E::VOICE_KEY_PRESSED, S::VOICE_INPUT>,       // Barge-in
+        Fsm::Row<S::AI_PROCESSING, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+
+        // AI responding
+        Fsm::Row<S::AI_RESPONDING, E::AI_RESPONSE_COMPLETE, S::READY>,
+        Fsm::Row<S::AI_RESPONDING, E::AI_RESPONSE_CHUNK, S::AI_RESPONDING>,
+        Fsm::Row<S::AI_RESPONDING, E::AI_ERROR, S::READY>,
+        Fsm::Row<S::AI_RESPONDING, E::VOICE_KEY_PRESSED, S::VOICE_INPUT>,       // Barge-in
+        Fsm::Row<S::AI_RESPONDING, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+
+        // Ancient mode
+        Fsm::Row<S::ANCIENT_MODE, E::ANCIENT_MODE_TRIGGER, S::READY>,
+        Fsm::Row<S::ANCIENT_MODE, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+        Fsm::Row<S::ANCIENT_MODE, E::TIMEOUT, S::READY>,
+
+        // Error
+        Fsm::Row<S::ERROR_STATE, E::ERROR_RECOVERED, S::WIFI_CONNECTING>,
+        Fsm::Row<S::ERROR_STATE, E::FORCE_RECONNECT, S::WIFI_CONNECTING>,
+        Fsm::Row<S::ERROR_STATE, E::TIMEOUT, S::WIFI_CONNECTING>
+    >
+>;
 
+void setupStateMachine() {
     // Set state change callback
     g_app.state_machine.setOnStateChange(onStateChange);
 
-    // Start with boot event
+    // Boot and config loading are already done by the time the machine starts
     g_app.state_machine.postEvent(AppEvent::BOOT_COMPLETE);
+    g_app.state_machine.postEvent(AppEvent::CONFIG_LOADED);
 }
 
 void onStateChange(AppState from, AppState to) {
@@ -514,28 +760,38 @@ void onStateChange(AppState from, AppState to) {
 
     g_app.context.state.current_state = to;
 
-    // Clear screen when leaving boot state
-    if (from == AppState::BOOT) {
-        M5Cardputer.Display.fillScreen(Colors::BACKGROUND);
-    }
+    // Drop any full-screen page; states below re-raise one if needed
+    g_app.display.showMainScreen();
 
     // Update display based on state
     switch (to) {
         case AppState::WIFI_CONNECTING:
+            setNetworkServiceActive(false);
             g_app.display.renderConnectionScreen(g_app.context.config.wifi_ssid);
             connectWiFi();
             break;
 
         case AppState::GATEWAY_CONNECTING:
-            g_app.websocket.connect();
+            setNetworkServiceActive(true);
+            // A session still up here is left over from a failed or timed
+            // out auth; connect() would keep it, so start a fresh one
+            if (g_app.websocket.isConnected()) {
+                g_app.websocket.reconnect();
+            } else {
+                g_app.websocket.connect();
+            }
             break;
 
         case AppState::READY:
-            g_app.display.clearInput();
+            if (!g_app.boot_profile.isMarked(BootPhase::READY)) {
+                g_app.boot_profile.mark(BootPhase::READY);
+                g_app.boot_profile.printReport();
+            }
             g_app.display.setConnectionStatus(ConnectionIndicator::CONNECTED);
             break;
 
         case AppState::ERROR_STATE:
+            setNetworkServiceActive(false);
             g_app.display.setConnectionStatus(ConnectionIndicator::ERROR);
             break;
 
@@ -552,12 +808,17 @@ void setupWebSocketCallbacks() {
     g_app.websocket.onEvent([](WebSocketEvent event, const void* data) {
         switch (event) {
             case WebSocketEvent::CONNECTED:
-                Serial.println("WebSocket connected");
+                Serial.printf("WebSocket connected (%s, handshake %lu ms)\n",
+                              codecIdToString(static_cast<const MessageCodec*>(data)->getId()),
+                              (unsigned long)g_app.websocket.getStats().handshake_ms);
+                g_app.boot_profile.mark(BootPhase::GATEWAY_CONNECTED);
                 g_app.state_machine.postEvent(AppEvent::GATEWAY_CONNECTED);
                 break;
 
             case WebSocketEvent::DISCONNECTED:
                 Serial.println("WebSocket disconnected");
+                // The cached lease may be stale; don't keep it on a suspect link
+                g_app.wifi.renewLease();
                 g_app.state_machine.postEvent(AppEvent::GATEWAY_DISCONNECTED);
                 break;
 
@@ -565,6 +826,7 @@ void setupWebSocketCallbacks() {
                 Serial.println("Authenticated");
                 g_app.context.state.authenticated = true;
                 g_app.state_machine.postEvent(AppEvent::AUTHENTICATED);
+                sendAudioConfig();
                 break;
 
             case WebSocketEvent::AUTH_FAILED:
@@ -572,14 +834,8 @@ void setupWebSocketCallbacks() {
                 g_app.state_machine.postEvent(AppEvent::AUTH_FAILED);
                 break;
 
-            case WebSocketEvent::MESSAGE_RECEIVED: {
-                auto* msg = static_cast<const ProtocolMessage*>(data);
-                processIncomingMessage(*msg);
-                break;
-            }
-
             case WebSocketEvent::ERROR:
-                Serial.println("WebSocket error");
+                Serial.printf("WebSocket error: %s\n", static_cast<const char*>(data));
                 g_app.state_machine.postEvent(AppEvent::GATEWAY_ERROR);
                 break;
 
@@ -590,6 +846,9 @@ void setupWebSocketCallbacks() {
 }
 
 void processIncomingMessage(const ProtocolMessage& msg) {
+    // A gateway push counts as activity (keeps the UI responsive for it)
+    noteActivity(WakeSource::GATEWAY);
+
     switch (msg.getType()) {
         case MessageType::RESPONSE:
         case MessageType::RESPONSE_FINAL: {
@@ -598,11 +857,28 @@ void processIncomingMessage(const ProtocolMessage& msg) {
                 JsonDocument doc;
                 DeserializationError err = deserializeJson(doc, text);
                 if (!err) {
+                    if (isStaleTurn(doc)) break;
+
                     const char* response_text = doc["text"] | "";
                     bool is_final = doc["is_final"] | true;
+                    bool append = doc["append"] | false;
 
-                    g_app.display.addMessage(response_text,
-                        is_final ? DisplayMessageType::AI_MSG : DisplayMessageType::STATUS_MSG);
+                    if (!g_app.context.state.turn_answered) {
+                        g_app.context.state.turn_answered = true;
+                        Serial.printf("[Turn] %lu: first reply after %lu ms\n",
+                                      (unsigned long)g_app.context.state.turn_id,
+                                      (unsigned long)(millis() - g_app.context.state.turn_started_ms));
+                    }
+
+                    // Streamed chunks build up one AI line; the final
+                    // message replaces it with the full reply
+                    if (append) {
+                        g_app.display.appendToLastMessage(response_text, DisplayMessageType::AI_MSG);
+                    } else if (is_final) {
+                        g_app.display.finishLastMessage(response_text, DisplayMessageType::AI_MSG);
+                    } else {
+                        g_app.display.addMessage(response_text, DisplayMessageType::STATUS_MSG);
+                    }
 
                     if (is_final) {
                         g_app.state_machine.postEvent(AppEvent::AI_RESPONSE_COMPLETE);
@@ -619,7 +895,7 @@ void processIncomingMessage(const ProtocolMessage& msg) {
             if (msg.getJsonPayload(text)) {
                 JsonDocument doc;
                 DeserializationError err = deserializeJson(doc, text);
-                if (!err) {
+                if (!err && !isStaleTurn(doc)) {
                     const char* status = doc["status"] | "";
                     g_app.display.setStatusText(status);
                 }
@@ -633,6 +909,7 @@ void processIncomingMessage(const ProtocolMessage& msg) {
                 JsonDocument doc;
                 DeserializationError err = deserializeJson(doc, text);
                 if (!err) {
+                    if (isStaleTurn(doc)) break;
                     const char* error = doc["error"] | "Unknown error";
                     g_app.display.addMessage(error, DisplayMessageType::ERROR_MSG);
                 }
@@ -646,13 +923,42 @@ void processIncomingMessage(const ProtocolMessage& msg) {
     }
 }
 
+// Starts a conversation turn. A turn still being answered is cancelled
+// first: the gateway stops working on it and its late replies are dropped.
+// While listening, that is a turn whose utterance has already gone out.
+void beginTurn() {
+    AppState state = g_app.context.state.current_state;
+    uint32_t previous = g_app.context.state.turn_id;
+    bool answering = state == AppState::AI_PROCESSING || state == AppState::AI_RESPONDING ||
+                     g_app.utterance_sent;
+
+    if (previous != 0 && answering) {
+        g_app.websocket.sendCommand("cancel", previous);
+        g_app.context.stats.turns_cancelled++;
+        Serial.printf("[Turn] %lu cancelled\n", (unsigned long)previous);
+    }
+
+    g_app.context.state.turn_id = previous + 1;
+    g_app.context.state.turn_started_ms = millis();
+    g_app.context.state.turn_answered = false;
+    g_app.utterance_sent = false;
+}
+
+// Replies tagged with an older turn belong to a cancelled request
+bool isStaleTurn(const JsonDocument& doc) {
+    uint32_t turn = doc["turn"] | 0;
+    if (turn == 0 || turn == g_app.context.state.turn_id) return false;
+    g_app.context.stats.stale_replies_dropped++;
+    return true;
+}
+
 void sendTextToGateway(const char* text) {
     if (!g_app.websocket.isAuthenticated()) {
         g_app.display.addMessage("Not connected", DisplayMessageType::ERROR_MSG);
         return;
     }
 
-    if (!g_app.websocket.sendText(text)) {
+    if (!g_app.websocket.sendText(text, g_app.context.state.turn_id)) {
         g_app.display.addMessage("Failed to send", DisplayMessageType::ERROR_MSG);
     } else {
         g_app.context.stats.messages_sent++;
@@ -662,8 +968,43 @@ void sendTextToGateway(const char* text) {
 void sendAudioToGateway(const EncodedAudioPacket& packet) {
     if (!g_app.websocket.isAuthenticated()) return;
 
-    // Send audio packet
-    g_app.websocket.sendAudio(packet.data.get(), packet.length, packet.is_final);
+    // Every utterance is a turn of its own: speech after the end of one
+    // (still listening) must not reuse its turn id
+    if (g_app.utterance_sent) {
+        beginTurn();
+    }
+
+    // The end itself rides on is_final; hints go by name so the gateway
+    // can start transcribing before the hangover runs out
+    const char* endpoint = nullptr;
+    if (packet.endpoint == EndpointEvent::LIKELY_FINAL) {
+        endpoint = "likely_final";
+    } else if (packet.endpoint == EndpointEvent::RESUMED) {
+        endpoint = "resumed";
+    }
+
+    // Labelled with what the streamer produced, not what was configured:
+    // it falls back to PCM without an Opus encoder
+    g_app.websocket.sendAudio(packet.data.get(), packet.length, packet.is_final,
+                              packet.codec == AudioCodec::OPUS ? "opus" : "pcm",
+                              g_app.context.state.turn_id, endpoint);
+
+    if (packet.is_final) {
+        g_app.utterance_sent = true;
+        const Endpointer& endpointer = g_app.audio.getEndpointer();
+        Serial.printf("[Audio] Utterance ended after %lu ms of silence (long pause %lu ms, %lu truncated)\n",
+                      (unsigned long)endpointer.getHangoverMs(),
+                      (unsigned long)endpointer.getLongPauseMs(),
+                      (unsigned long)endpointer.getTruncations());
+    }
+}
+
+void sendAudioConfig() {
+    if (!g_app.websocket.isAuthenticated()) return;
+
+    const AudioStreamerConfig& audio = g_app.audio.getConfig();
+    g_app.websocket.send(ProtocolMessage::createAudioConfig(
+        audio.sample_rate, 1, 16, audio.codec == AudioCodec::OPUS ? "opus" : "pcm"));
 }
 
 // =============================================================================
@@ -697,6 +1038,11 @@ void setupAudioCallbacks() {
 
 void setupKeyboardCallbacks() {
     g_app.keyboard.onEvent([](KeyboardEvent event, const void* data) {
+        noteActivity(WakeSource::KEYBOARD);
+
+        // Keys routed to the menu must not also edit the prompt
+        g_app.keyboard.setTextInputEnabled(!g_app.settings_menu.isOpen());
+
         // If settings menu is open, route all input there
         if (g_app.settings_menu.isOpen()) {
             if (event == KeyboardEvent::KEY_PRESSED) {
@@ -712,6 +1058,10 @@ void setupKeyboardCallbacks() {
 
                 // Check for voice toggle key
                 if (key_event->special == SpecialKey::VOICE_TOGGLE) {
+                    // Pressing it again while listening just stops
+                    if (g_app.context.state.current_state != AppState::VOICE_INPUT) {
+                        beginTurn();
+                    }
                     g_app.state_machine.postEvent(AppEvent::VOICE_KEY_PRESSED);
                     return;
                 }
@@ -734,8 +1084,16 @@ void setupKeyboardCallbacks() {
             case KeyboardEvent::INPUT_SUBMITTED: {
                 auto* text = static_cast<const char*>(data);
 
-                // Check for ancient mode trigger phrases
-                if (checkAncientModeTrigger(text)) {
+                // History and phrases were updated by the handler
+                if (g_app.config_manager.getConfig().device.save_history &&
+                    !g_app.timers.isActive(g_app.history_save_timer)) {
+                    g_app.history_save_timer = g_app.timers.schedule(HISTORY_SAVE_DELAY_MS,
+                        [](void*) { savePromptHistory(); });
+                }
+
+                // One pass finds every trigger phrase in the prompt
+                TriggerMask triggers = scanTriggers(text);
+                if (triggers & triggerBit(TriggerId::ANCIENT_MODE)) {
                     g_app.state_machine.postEvent(AppEvent::ANCIENT_MODE_TRIGGER);
                     return;
                 }
@@ -743,7 +1101,8 @@ void setupKeyboardCallbacks() {
                 // Display user message
                 g_app.display.addMessage(text, DisplayMessageType::USER_MSG);
 
-                // Send to gateway
+                // Send to gateway as a new turn
+                beginTurn();
                 sendTextToGateway(text);
 
                 // Trigger state transition
@@ -753,7 +1112,7 @@ void setupKeyboardCallbacks() {
 
             case KeyboardEvent::INPUT_CHANGED: {
                 auto* buffer = static_cast<const InputBuffer*>(data);
-                g_app.display.setInputText(buffer->getText(), buffer->getCursor());
+                g_app.display.onInputChanged(buffer->getLastChange());
                 break;
             }
 
@@ -763,48 +1122,257 @@ void setupKeyboardCallbacks() {
     });
 }
 
+void setupPromptHistory() {
+    // Phrases are learned only while history is saved; otherwise the
+    // index holds no memory at all
+    if (g_app.config_manager.getConfig().device.save_history) {
+        g_app.history.load();
+        startPhraseIndex();
+        Serial.printf("History: %u prompts, %u phrases (%u nodes)\n",
+                      (unsigned)g_app.history.getCount(),
+                      (unsigned)g_app.phrases.getPhraseCount(),
+                      (unsigned)g_app.phrases.getNodeCount());
+    }
+
+    g_app.keyboard.setHistory(&g_app.history);
+    g_app.keyboard.setPhraseIndex(&g_app.phrases);
+}
+
+void startPhraseIndex() {
+    if (!g_app.phrases.begin()) {
+        Serial.printf("Phrase index disabled: %s\n", g_app.phrases.getLastError());
+        return;
+    }
+    if (!g_app.phrases.load()) {
+        Serial.printf("Phrase index: %s\n", g_app.phrases.getLastError());
+    }
+}
+
+void savePromptHistory() {
+    if (g_app.history.isDirty() && !g_app.history.save()) {
+        Serial.println("Failed to save prompt history");
+    }
+    if (g_app.phrases.isDirty() && !g_app.phrases.save()) {
+        Serial.printf("Failed to save phrases: %s\n", g_app.phrases.getLastError());
+    }
+}
+
 // =============================================================================
 // WiFi Management
 // =============================================================================
 
+void setupWiFi() {
+    g_app.wifi.setNotifier(g_app.events.notifier(LOOP_SIGNAL_WIFI));
+    if (!g_app.wifi.begin(&g_app.timers)) {
+        Serial.printf("WiFi init failed: %s\n", g_app.wifi.getLastError());
+        return;
+    }
+    const char* ssid = g_app.context.config.wifi_ssid;
+    g_app.wifi.addNetwork(ssid, g_app.context.config.wifi_password);
+
+    // Last boot's AP and lease let the first join skip the scan and DHCP
+    if (g_app.fast_connect.begin()) {
+        uint8_t bssid[6];
+        uint8_t channel;
+        WiFiLease lease;
+        bool fast_path = g_app.fast_connect.getLink(ssid, bssid, channel) &&
+                         g_app.wifi.setFastPath(ssid, bssid, channel);
+        bool cached_lease = fast_path && g_app.config_manager.getConfig().wifi.dhcp &&
+                            g_app.fast_connect.getLease(ssid, lease) &&
+                            g_app.wifi.setCachedLease(ssid, lease);
+        Serial.printf("Fast connect: cache from %s, AP %s, lease %s\n",
+                      fastConnectSourceToString(g_app.fast_connect.getSource()),
+                      fast_path ? "cached" : "unknown", cached_lease ? "cached" : "none");
+    }
+
+    g_app.wifi.onEvent([](WiFiManagerEvent event) {
+        switch (event) {
+            case WiFiManagerEvent::STATE_CHANGED:
+                Serial.printf("WiFi: %s\n", wifiLinkStateToString(g_app.wifi.getState()));
+                break;
+
+            case WiFiManagerEvent::CONNECTED:
+                handleWiFiConnected();
+                break;
+
+            case WiFiManagerEvent::DISCONNECTED:
+                handleWiFiDisconnected();
+                break;
+
+            case WiFiManagerEvent::SCAN_DONE:
+                g_app.settings_menu.onWiFiScanDone();
+                break;
+
+            case WiFiManagerEvent::HOST_RESOLVED:
+                handleGatewayResolved();
+                break;
+        }
+    });
+}
+
 void connectWiFi() {
-    Serial.printf("Connecting to WiFi: %s\n", g_app.context.config.wifi_ssid);
+    // The link can outlive a gateway failure; no CONNECTED event will come
+    // for it, so move on to the gateway right away
+    if (g_app.wifi.isConnected()) {
+        g_app.state_machine.postEvent(AppEvent::WIFI_CONNECTED);
+        return;
+    }
+
+    // No-op while a join or retry is already in flight
+    if (!g_app.wifi.connect()) {
+        Serial.printf("WiFi connect failed: %s\n", g_app.wifi.getLastError());
+        g_app.state_machine.postEvent(AppEvent::WIFI_ERROR);
+    }
+}
+
+void handleWiFiConnected() {
+    WiFiManager& wifi = g_app.wifi;
+    uint32_t now = millis();
+    Serial.printf("WiFi connected to %s, IP: %s (associated in %lu ms, IP in %lu ms%s%s)\n",
+                  wifi.getSsid(), WiFi.localIP().toString().c_str(),
+                  (unsigned long)wifi.getLastAssocMs(), (unsigned long)wifi.getLastJoinMs(),
+                  wifi.isLastJoinFast() ? ", fast" : "",
+                  wifi.isUsingCachedLease() ? ", cached lease" : "");
+
+    if (!g_app.boot_profile.isMarked(BootPhase::WIFI_IP)) {
+        g_app.boot_profile.mark(BootPhase::WIFI_ASSOCIATED,
+                                now - (wifi.getLastJoinMs() - wifi.getLastAssocMs()));
+        g_app.boot_profile.mark(BootPhase::WIFI_IP, now);
+        g_app.boot_profile.setFlags((wifi.isLastJoinFast() ? BootFlags::FAST_JOIN : 0) |
+                                    (wifi.isUsingCachedLease() ? BootFlags::CACHED_LEASE : 0));
+    }
+
+    // Remember where we landed for the next boot
+    WiFiLease lease;
+    g_app.fast_connect.saveLink(wifi.getSsid(), WiFi.BSSID(), WiFi.channel());
+    if (wifi.getLease(lease)) {
+        g_app.fast_connect.saveLease(lease);
+    }
 
-    WiFi.mode(WIFI_STA);
-    WiFi.begin(g_app.context.config.wifi_ssid, g_app.context.config.wifi_password);
+    g_app.context.state.wifi_connected = true;
+    g_app.power.setWifiConnected(true);
+    g_app.display.setWiFiSignal(wifi.getRssi());
 
-    g_app.wifi_connect_start = millis();
+    // Before the state change, so the gateway connect sees a cached address
+    prefetchGatewayAddress();
+    g_app.state_machine.postEvent(AppEvent::WIFI_CONNECTED);
 }
 
-void updateWiFiStatus() {
-    static bool was_connected = false;
-    bool is_connected = (WiFi.status() == WL_CONNECTED);
+void handleWiFiDisconnected() {
+    Serial.println("WiFi disconnected");
+    g_app.context.state.wifi_connected = false;
+    g_app.power.setWifiConnected(false);
+    g_app.state_machine.postEvent(AppEvent::WIFI_DISCONNECTED);
+}
 
-    if (is_connected != was_connected) {
-        was_connected = is_connected;
+void prefetchGatewayAddress() {
+    const char* host = g_app.ws_config.host.c_str();
+    if (host[0] == '\0') return;
 
-        if (is_connected) {
-            Serial.printf("WiFi connected, IP: %s\n", WiFi.localIP().toString().c_str());
-            g_app.context.state.wifi_connected = true;
-            g_app.state_machine.postEvent(AppEvent::WIFI_CONNECTED);
-        } else {
-            Serial.println("WiFi disconnected");
-            g_app.context.state.wifi_connected = false;
-            g_app.state_machine.postEvent(AppEvent::WIFI_DISCONNECTED);
+    // Literal address: nothing to look up
+    IPAddress address;
+    if (address.fromString(host)) {
+        g_app.ws_config.host_ip = address;
+        g_app.boot_profile.mark(BootPhase::GATEWAY_RESOLVED);
+        g_app.websocket.reconfigure(g_app.ws_config);
+        return;
+    }
+
+    // Use the cached address now; the lookup below refreshes it
+    uint32_t cached_ip = g_app.fast_connect.getGatewayIp(host);
+    if (cached_ip != 0) {
+        g_app.ws_config.host_ip = cached_ip;
+        if (!g_app.boot_profile.isMarked(BootPhase::GATEWAY_RESOLVED)) {
+            g_app.boot_profile.mark(BootPhase::GATEWAY_RESOLVED);
+            g_app.boot_profile.setFlags(BootFlags::CACHED_DNS);
         }
+        g_app.websocket.reconfigure(g_app.ws_config);
     }
 
-    // Update WiFi signal strength
-    if (is_connected) {
-        int8_t rssi = WiFi.RSSI();
-        g_app.display.setWiFiSignal(rssi);
+    if (!g_app.wifi.resolveHost(host)) {
+        Serial.printf("Gateway lookup: %s\n", g_app.wifi.getLastError());
     }
+}
+
+void handleGatewayResolved() {
+    // Stale answer for a host that has since been changed
+    const char* host = g_app.ws_config.host.c_str();
+    if (strcmp(g_app.wifi.getResolvedHost(), host) != 0) return;
 
-    // Auto-reconnect if disconnected
-    if (!is_connected &&
-        millis() - g_app.wifi_connect_start > WIFI_RECONNECT_INTERVAL_MS) {
-        WiFi.reconnect();
-        g_app.wifi_connect_start = millis();
+    uint32_t ip = g_app.wifi.getResolvedIp();
+    if (ip == 0) {
+        Serial.printf("Gateway lookup failed: %s\n", host);
+        return;
+    }
+
+    g_app.boot_profile.mark(BootPhase::GATEWAY_RESOLVED);
+    g_app.fast_connect.saveGatewayIp(host, ip);
+    if (g_app.ws_config.host_ip != ip) {
+        // Takes effect on the next connect; an open session is kept
+        g_app.ws_config.host_ip = ip;
+        g_app.websocket.reconfigure(g_app.ws_config);
+    }
+}
+
+// =============================================================================
+// Deep Idle
+// =============================================================================
+
+void noteActivity(WakeSource source) {
+    g_app.power.noteUserActivity();
+    g_app.idle.wake(source, millis());
+}
+
+void onIdleStageChange(IdleStage from, IdleStage to, WakeSource source) {
+    DisplayCompositor& compositor = g_app.display.getCompositor();
+
+    switch (to) {
+        case IdleStage::DROWSY:
+            // One last frame with the avatar asleep, then stop rendering
+            Avatar::g_avatar.setSleeping(true);
+            updateDisplay();
+            setFrameTimersActive(false);
+            compositor.setFrozen(true);
+            g_app.display.setBacklightLevel(g_app.display.getBrightness() / IDLE_DIM_DIVISOR);
+            Serial.printf("[Idle] %s -> DROWSY\n", idleStageToString(from));
+            break;
+
+        case IdleStage::ASLEEP:
+            // I2S is already down: capture only runs in VOICE_INPUT, which
+            // holds the idle manager off
+            g_app.display.sleepPanel();
+            g_app.keyboard.setScanInterval(KEYBOARD_IDLE_SCAN_INTERVAL_MS);
+            if (Avatar::g_sensors.isImuAvailable()) {
+                Avatar::g_sensors.setLowPowerMode(true);
+                setSensorSampleInterval(Avatar::SENSOR_IDLE_SAMPLE_INTERVAL_MS);
+            }
+            Serial.printf("[Idle] %s -> ASLEEP\n", idleStageToString(from));
+            break;
+
+        case IdleStage::AWAKE: {
+            uint32_t start_us = micros();
+
+            if (from == IdleStage::ASLEEP) {
+                if (Avatar::g_sensors.isImuAvailable()) {
+                    Avatar::g_sensors.setLowPowerMode(false);
+                    setSensorSampleInterval(Avatar::SENSOR_SAMPLE_INTERVAL_MS);
+                }
+                g_app.display.wakePanel();
+                g_app.keyboard.setScanInterval(KEYBOARD_SCAN_INTERVAL_MS);
+            }
+            g_app.display.restoreBacklight();
+            compositor.setFrozen(false);
+            Avatar::g_avatar.setSleeping(false);
+
+            // Draw now rather than on the next frame tick
+            setFrameTimersActive(true);
+            updateDisplay();
+
+            Serial.printf("[Idle] %s -> AWAKE (%s), resumed in %lu us\n",
+                          idleStageToString(from), wakeSourceToString(source),
+                          (unsigned long)(micros() - start_us));
+            break;
+        }
     }
 }
 
@@ -816,8 +1384,8 @@ void renderAvatar() {
     // Update avatar animation
     Avatar::g_avatar.update(33.0f);  // ~30 FPS
     
-    // Render to display
-    Avatar::g_avatar.render();
+    // Avatar animates continuously; the compositor redraws it next flush
+    g_app.display.getCompositor().damage(DisplayLayer::AVATAR);
 }
 
 // =============================================================================
@@ -825,12 +1393,25 @@ void renderAvatar() {
 // =============================================================================
 
 void updateDisplay() {
-    // Only render - UI handles its own clearing
+    PowerManager::ScopedBoost boost(g_app.power, POWER_BOOST_RENDER);
+
+    // Per-frame work that used to ride on the 10 ms poll
+    g_app.avatar_bridge.update();
+    if (g_app.settings_menu.isOpen()) {
+        g_app.settings_menu.update();
+    }
+
+    // Animate, then composite all damaged layers in a single flush
     renderAvatar();
-    g_app.display.renderMainScreen();
+    g_app.display.update();
+    g_app.display.render();
 }
 
 void updateStatusBar() {
+    if (g_app.wifi.isConnected()) {
+        g_app.display.setWiFiSignal(g_app.wifi.getRssi());
+    }
+
     // Update connection status
     if (g_app.websocket.isAuthenticated()) {
         g_app.display.setConnectionStatus(ConnectionIndicator::CONNECTED);
@@ -863,7 +1444,6 @@ void updateStatusBar() {
 
 void enterAncientMode() {
     g_app.ancient_mode_active = true;
-    g_app.ancient_mode_start = millis();
     g_app.display.addMessage("Ancient wisdom awakened...", DisplayMessageType::STATUS_MSG);
     // Additional ancient mode initialization would go here
 }
@@ -872,13 +1452,3 @@ void exitAncientMode() {
     g_app.ancient_mode_active = false;
     g_app.display.addMessage("Returning to present...", DisplayMessageType::STATUS_MSG);
 }
-
-bool checkAncientModeTrigger(const char* text) {
-    String t = String(text);
-    t.toLowerCase();
-
-    return (t.indexOf("ancient wisdom") >= 0 ||
-            t.indexOf("speak as minerva") >= 0 ||
-            t.indexOf("owl mode") >= 0 ||
-            t.indexOf("by the thirty-seven claws") >= 0);
-}
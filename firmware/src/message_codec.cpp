@@ -0,0 +1,245 @@
+/**
+ * @file message_codec.cpp
+ * @brief Wire codec implementations
+ */
+
+#include "message_codec.h"
+#include <ArduinoJson.h>
+
+namespace OpenClaw {
+
+// =============================================================================
+// Shared Helpers
+// =============================================================================
+
+static size_t writeFrame(uint8_t* buffer, uint8_t version, MessageType type, uint8_t flags,
+                         uint32_t timestamp, size_t payload_length) {
+    ProtocolHeader header;
+    header.magic = PROTOCOL_MAGIC;
+    header.version = version;
+    header.type = static_cast<uint8_t>(type);
+    header.flags = flags;
+    header.payload_length = payload_length;
+    header.timestamp = timestamp;
+    header.encode(buffer);
+
+    size_t data_length = PROTOCOL_HEADER_SIZE + payload_length;
+    uint16_t crc = ProtocolMessage::calculateCRC16(buffer, data_length);
+    buffer[data_length] = crc & 0xFF;
+    buffer[data_length + 1] = (crc >> 8) & 0xFF;
+    return data_length + PROTOCOL_FOOTER_SIZE;
+}
+
+// Either binary version; a packed payload is turned back into JSON
+static bool decodeBinary(const uint8_t* data, size_t length, ProtocolMessage& out_message) {
+    if (!out_message.deserialize(data, length)) return false;
+    if (!hasFlag(out_message.getFlags(), MessageFlags::COMPRESSED)) return true;
+
+    JsonDocument doc;
+    if (deserializeMsgPack(doc, out_message.getPayload(), out_message.getPayloadLength())) {
+        return false;
+    }
+
+    String json;
+    serializeJson(doc, json);
+    out_message.setJsonPayload(json);
+    out_message.setFlags(static_cast<MessageFlags>(
+        static_cast<uint8_t>(out_message.getFlags()) & ~static_cast<uint8_t>(MessageFlags::COMPRESSED)));
+    return true;
+}
+
+// =============================================================================
+// JSON
+// =============================================================================
+
+class JsonCodec : public MessageCodec {
+public:
+    CodecId getId() const override { return CodecId::JSON; }
+    const char* getSubprotocol() const override { return "openclaw.json"; }
+    bool isText() const override { return true; }
+
+    bool encode(const ProtocolMessage& message, uint8_t* buffer, size_t size,
+                size_t& out_length) const override {
+        // Splice the type into the payload object rather than re-parsing it:
+        // {"k":...} becomes {"type":"name","k":...}
+        const char* payload = reinterpret_cast<const char*>(message.getPayload());
+        size_t payload_length = message.getPayloadLength();
+        if (payload_length > 0 && payload[0] != '{') return false;
+
+        bool has_fields = payload_length > 2;
+        int prefix = snprintf(reinterpret_cast<char*>(buffer), size, "{\"type\":\"%s\"%s",
+                              messageTypeToName(message.getType()), has_fields ? "," : "}");
+        if (prefix < 0 || (size_t)prefix >= size) return false;
+        out_length = prefix;
+
+        if (has_fields) {
+            size_t rest = payload_length - 1;
+            if (out_length + rest > size) return false;
+            memcpy(buffer + out_length, payload + 1, rest);
+            out_length += rest;
+        }
+        return true;
+    }
+
+    bool decode(const uint8_t* data, size_t length, ProtocolMessage& out_message) const override {
+        JsonDocument doc;
+        if (deserializeJson(doc, reinterpret_cast<const char*>(data), length)) return false;
+        if (!doc.is<JsonObject>()) return false;
+
+        MessageType type = messageTypeFromName(doc["type"] | "");
+        if (type == MessageType::UNKNOWN) return false;
+        doc.remove("type");
+
+        // Older gateways carry the text (or error) in "payload"
+        if (doc["payload"].is<const char*>()) {
+            const char* field = type == MessageType::ERROR ? "error" : "text";
+            if (doc[field].isNull()) {
+                doc[field] = doc["payload"];
+            }
+            doc.remove("payload");
+        }
+
+        out_message = ProtocolMessage(type);
+        if (doc["is_final"] | false) {
+            out_message.setFlags(MessageFlags::FINAL);
+        }
+
+        String json;
+        serializeJson(doc, json);
+        return out_message.setJsonPayload(json);
+    }
+};
+
+// =============================================================================
+// Binary v1
+// =============================================================================
+
+class BinaryV1Codec : public MessageCodec {
+public:
+    CodecId getId() const override { return CodecId::BINARY_V1; }
+    const char* getSubprotocol() const override { return "openclaw.v1"; }
+    bool isText() const override { return false; }
+
+    bool encode(const ProtocolMessage& message, uint8_t* buffer, size_t size,
+                size_t& out_length) const override {
+        return message.serialize(buffer, size, out_length, PROTOCOL_VERSION);
+    }
+
+    bool decode(const uint8_t* data, size_t length, ProtocolMessage& out_message) const override {
+        return decodeBinary(data, length, out_message);
+    }
+};
+
+// =============================================================================
+// Binary v2
+// =============================================================================
+
+class BinaryV2Codec : public MessageCodec {
+public:
+    CodecId getId() const override { return CodecId::BINARY_V2; }
+    const char* getSubprotocol() const override { return "openclaw.v2"; }
+    bool isText() const override { return false; }
+
+    bool encode(const ProtocolMessage& message, uint8_t* buffer, size_t size,
+                size_t& out_length) const override {
+        size_t json_length = message.getPayloadLength();
+        uint8_t flags = static_cast<uint8_t>(message.getFlags());
+
+        if (json_length > 0 && !hasFlag(message.getFlags(), MessageFlags::BINARY)) {
+            JsonDocument doc;
+            if (!deserializeJson(doc, reinterpret_cast<const char*>(message.getPayload()), json_length)) {
+                size_t packed_length = measureMsgPack(doc);
+                if (packed_length < json_length &&
+                    PROTOCOL_HEADER_SIZE + packed_length + PROTOCOL_FOOTER_SIZE <= size) {
+                    serializeMsgPack(doc, buffer + PROTOCOL_HEADER_SIZE, packed_length);
+                    out_length = writeFrame(buffer, PROTOCOL_VERSION_V2, message.getType(),
+                                            flags | static_cast<uint8_t>(MessageFlags::COMPRESSED),
+                                            message.getTimestamp(), packed_length);
+                    return true;
+                }
+            }
+        }
+
+        // Nothing to gain; v1 layout under the v2 version byte
+        return message.serialize(buffer, size, out_length, PROTOCOL_VERSION_V2);
+    }
+
+    bool decode(const uint8_t* data, size_t length, ProtocolMessage& out_message) const override {
+        return decodeBinary(data, length, out_message);
+    }
+};
+
+// =============================================================================
+// Lookup
+// =============================================================================
+
+static const JsonCodec json_codec;
+static const BinaryV1Codec binary_v1_codec;
+static const BinaryV2Codec binary_v2_codec;
+
+const MessageCodec& getMessageCodec(CodecId id) {
+    switch (id) {
+        case CodecId::BINARY_V2: return binary_v2_codec;
+        case CodecId::JSON: return json_codec;
+        default: return binary_v1_codec;
+    }
+}
+
+const MessageCodec& getMessageCodec(const char* subprotocol) {
+    if (subprotocol) {
+        for (size_t i = 0; i < static_cast<size_t>(CodecId::COUNT); i++) {
+            const MessageCodec& codec = getMessageCodec(static_cast<CodecId>(i));
+            if (strcmp(subprotocol, codec.getSubprotocol()) == 0) {
+                return codec;
+            }
+        }
+    }
+    return binary_v1_codec;
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* codecIdToString(CodecId id) {
+    switch (id) {
+        case CodecId::BINARY_V2: return "BINARY_V2";
+        case CodecId::BINARY_V1: return "BINARY_V1";
+        case CodecId::JSON: return "JSON";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* messageTypeToName(MessageType type) {
+    switch (type) {
+        case MessageType::AUTH: return "auth";
+        case MessageType::AUTH_RESPONSE: return "auth_response";
+        case MessageType::PING: return "ping";
+        case MessageType::PONG: return "pong";
+        case MessageType::TEXT: return "text";
+        case MessageType::AUDIO: return "audio";
+        case MessageType::RESPONSE: return "response";
+        case MessageType::RESPONSE_FINAL: return "response_final";
+        case MessageType::STATUS: return "status";
+        case MessageType::COMMAND: return "command";
+        case MessageType::ERROR: return "error";
+        case MessageType::AUDIO_CONFIG: return "audio_config";
+        default: return "unknown";
+    }
+}
+
+MessageType messageTypeFromName(const char* name) {
+    static constexpr MessageType types[] = {
+        MessageType::AUTH, MessageType::AUTH_RESPONSE, MessageType::PING, MessageType::PONG,
+        MessageType::TEXT, MessageType::AUDIO, MessageType::RESPONSE, MessageType::RESPONSE_FINAL,
+        MessageType::STATUS, MessageType::COMMAND, MessageType::ERROR, MessageType::AUDIO_CONFIG
+    };
+
+    if (!name) return MessageType::UNKNOWN;
+    for (MessageType type : types) {
+        if (strcmp(name, messageTypeToName(type)) == 0) return type;
+    }
+    return MessageType::UNKNOWN;
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,125 @@
+/**
+ * @file parallel_init.cpp
+ * @brief Concurrent component initialization implementation
+ */
+
+#include "parallel_init.h"
+
+namespace OpenClaw {
+
+ParallelInit::ParallelInit()
+    : job_count_(0),
+      done_group_(nullptr),
+      elapsed_ms_(0) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+ParallelInit::~ParallelInit() {
+    if (done_group_) {
+        vEventGroupDelete(done_group_);
+        done_group_ = nullptr;
+    }
+}
+
+bool ParallelInit::add(const char* name, InitJobFn fn, uint32_t stack_size) {
+    if (!fn || job_count_ >= PARALLEL_INIT_MAX_JOBS) {
+        strncpy(last_error_, "Job table full", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    InitJob& job = jobs_[job_count_];
+    job = InitJob();
+    job.name = name;
+    job.fn = fn;
+    job.stack_size = stack_size;
+    job_count_++;
+    return true;
+}
+
+bool ParallelInit::run(uint32_t timeout_ms) {
+    if (job_count_ == 0) return true;
+
+    if (!done_group_) {
+        done_group_ = xEventGroupCreate();
+        if (!done_group_) {
+            strncpy(last_error_, "Failed to create event group", sizeof(last_error_) - 1);
+            return false;
+        }
+    }
+    xEventGroupClearBits(done_group_, (1UL << job_count_) - 1);
+
+    uint32_t start = millis();
+    EventBits_t expected = 0;
+
+    for (size_t i = 0; i < job_count_; i++) {
+        contexts_[i].owner = this;
+        contexts_[i].index = i;
+
+        // Same priority as the caller; unpinned so both cores are used
+        BaseType_t result = xTaskCreate(
+            jobTaskWrapper,
+            jobs_[i].name,
+            jobs_[i].stack_size,
+            &contexts_[i],
+            uxTaskPriorityGet(nullptr),
+            nullptr
+        );
+
+        if (result == pdPASS) {
+            expected |= (1UL << i);
+        } else {
+            // No task to spare; run it here instead
+            uint32_t job_start = millis();
+            jobs_[i].ok = jobs_[i].fn();
+            jobs_[i].duration_ms = millis() - job_start;
+            jobs_[i].done = true;
+        }
+    }
+
+    TickType_t wait = (timeout_ms == 0) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = expected
+        ? xEventGroupWaitBits(done_group_, expected, pdFALSE, pdTRUE, wait)
+        : 0;
+
+    elapsed_ms_ = millis() - start;
+
+    bool all_ok = true;
+    for (size_t i = 0; i < job_count_; i++) {
+        bool finished = jobs_[i].done || (bits & (1UL << i));
+        if (!finished) {
+            snprintf(last_error_, sizeof(last_error_), "Init job timed out: %s", jobs_[i].name);
+            all_ok = false;
+        } else if (!jobs_[i].ok) {
+            snprintf(last_error_, sizeof(last_error_), "Init job failed: %s", jobs_[i].name);
+            all_ok = false;
+        }
+    }
+
+    return all_ok;
+}
+
+void ParallelInit::printReport() const {
+    Serial.printf("[Init] %u jobs in %lu ms\n", (unsigned)job_count_, (unsigned long)elapsed_ms_);
+    for (size_t i = 0; i < job_count_; i++) {
+        const InitJob& job = jobs_[i];
+        Serial.printf("  %-10s %-7s %lu ms\n", job.name,
+                      !job.done ? "PENDING" : (job.ok ? "OK" : "FAILED"),
+                      (unsigned long)job.duration_ms);
+    }
+}
+
+void ParallelInit::jobTaskWrapper(void* param) {
+    JobContext* ctx = static_cast<JobContext*>(param);
+    ParallelInit* self = ctx->owner;
+    InitJob& job = self->jobs_[ctx->index];
+
+    uint32_t start = millis();
+    job.ok = job.fn();
+    job.duration_ms = millis() - start;
+    job.done = true;
+
+    xEventGroupSetBits(self->done_group_, 1UL << ctx->index);
+    vTaskDelete(nullptr);
+}
+
+} // namespace OpenClaw
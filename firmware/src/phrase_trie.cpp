@@ -0,0 +1,405 @@
+/**
+ * @file phrase_trie.cpp
+ * @brief Compact radix trie implementation
+ */
+
+#include "phrase_trie.h"
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+
+namespace OpenClaw {
+
+// On-flash layout: header, then the node arena, then the label arena
+static constexpr uint32_t PHRASE_TRIE_MAGIC = 0x5450434F;  // "OCPT"
+static constexpr uint16_t PHRASE_TRIE_VERSION = 1;
+
+struct PhraseTrieHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t node_size;
+    uint32_t node_count;
+    uint32_t label_bytes;
+    uint32_t phrase_count;
+};
+
+// Double capacity (from initial) until it holds needed, up to max. The
+// arena moves to a new block; PSRAM first, internal RAM only while it
+// stays within internal_max.
+static bool growArena(void*& arena, size_t& capacity, size_t used, size_t needed,
+                      size_t initial, size_t max, size_t internal_max, size_t unit) {
+    if (needed <= capacity) return true;
+    if (needed > max) return false;
+
+    size_t grown_capacity = capacity ? capacity : initial;
+    while (grown_capacity < needed) {
+        grown_capacity *= 2;
+    }
+    grown_capacity = std::min(grown_capacity, max);
+
+    void* grown = heap_caps_malloc(grown_capacity * unit, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!grown && grown_capacity <= internal_max) {
+        grown = malloc(grown_capacity * unit);
+    }
+    if (!grown) return false;
+
+    if (arena) {
+        memcpy(grown, arena, used * unit);
+        free(arena);
+    }
+    arena = grown;
+    capacity = grown_capacity;
+    return true;
+}
+
+PhraseTrie::PhraseTrie()
+    : nodes_(nullptr),
+      labels_(nullptr),
+      node_capacity_(0),
+      label_capacity_(0),
+      node_count_(0),
+      label_bytes_(0),
+      phrase_count_(0),
+      dirty_(false) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+PhraseTrie::~PhraseTrie() {
+    end();
+}
+
+bool PhraseTrie::begin() {
+    node_count_ = 0;
+    label_bytes_ = 0;
+    if (!reserve(PHRASE_TRIE_INITIAL_NODES, PHRASE_TRIE_INITIAL_LABEL_BYTES)) {
+        end();
+        strncpy(last_error_, "Failed to allocate phrase arenas", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    clear();
+    dirty_ = false;
+    return true;
+}
+
+void PhraseTrie::end() {
+    free(nodes_);
+    free(labels_);
+    nodes_ = nullptr;
+    labels_ = nullptr;
+    node_capacity_ = 0;
+    label_capacity_ = 0;
+    node_count_ = 0;
+    label_bytes_ = 0;
+    phrase_count_ = 0;
+    dirty_ = false;
+}
+
+bool PhraseTrie::add(const char* phrase, uint16_t count) {
+    if (!nodes_) return false;
+
+    size_t len = strlen(phrase);
+    if (len == 0 || len > PHRASE_MAX_LENGTH || count == 0) return false;
+
+    // Worst case is one edge split plus a leaf holding the whole phrase;
+    // room is made before any node is referenced, as growing moves them
+    if (isFull() || !reserve(node_count_ + 2, label_bytes_ + len)) {
+        strncpy(last_error_, "Phrase index full", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    uint16_t path[PHRASE_MAX_LENGTH + 1];
+    size_t depth = 0;
+    uint16_t node = 0;
+    size_t pos = 0;
+    path[depth++] = node;
+
+    while (pos < len) {
+        uint16_t child = findChild(node, phrase[pos]);
+        if (child == NIL) {
+            // New leaf holding the rest of the phrase
+            size_t rest = len - pos;
+            memcpy(labels_ + label_bytes_, phrase + pos, rest);
+            uint16_t leaf = newNode(label_bytes_, rest);
+            label_bytes_ += rest;
+            nodes_[leaf].next_sibling = nodes_[node].first_child;
+            nodes_[node].first_child = leaf;
+            path[depth++] = leaf;
+            node = leaf;
+            break;
+        }
+
+        Node& edge = nodes_[child];
+        const char* label = labels_ + edge.label;
+        size_t common = 1;
+        while (common < edge.label_len && pos + common < len &&
+               label[common] == phrase[pos + common]) {
+            common++;
+        }
+
+        if (common < edge.label_len) {
+            // Split the edge; the tail keeps the old phrase and children
+            uint16_t tail = newNode(edge.label + common, edge.label_len - common);
+            nodes_[tail].weight = edge.weight;
+            nodes_[tail].best = edge.best;
+            nodes_[tail].first_child = edge.first_child;
+            edge.label_len = common;
+            edge.weight = 0;
+            edge.first_child = tail;
+        }
+
+        path[depth++] = child;
+        node = child;
+        pos += common;
+    }
+
+    Node& end = nodes_[node];
+    if (end.weight == 0) {
+        phrase_count_++;
+    }
+    uint32_t weight = (uint32_t)end.weight + count;
+    end.weight = weight > 0xFFFF ? 0xFFFF : (uint16_t)weight;
+
+    for (size_t i = 0; i < depth; i++) {
+        if (nodes_[path[i]].best < end.weight) {
+            nodes_[path[i]].best = end.weight;
+        }
+    }
+    dirty_ = true;
+
+    if (end.weight == 0xFFFF) {
+        decay();
+    }
+    return true;
+}
+
+uint16_t PhraseTrie::getWeight(const char* phrase) const {
+    if (!nodes_) return 0;
+
+    size_t len = strlen(phrase);
+    uint16_t node = 0;
+    size_t pos = 0;
+    while (pos < len) {
+        uint16_t child = findChild(node, phrase[pos]);
+        if (child == NIL) return 0;
+        const Node& edge = nodes_[child];
+        if (edge.label_len > len - pos ||
+            memcmp(labels_ + edge.label, phrase + pos, edge.label_len) != 0) {
+            return 0;
+        }
+        pos += edge.label_len;
+        node = child;
+    }
+    return nodes_[node].weight;
+}
+
+size_t PhraseTrie::complete(const char* prefix, char* out, size_t out_size) const {
+    if (!nodes_ || out_size == 0) return 0;
+
+    size_t len = strlen(prefix);
+    if (len > PHRASE_MAX_LENGTH) return 0;
+
+    char phrase[PHRASE_MAX_LENGTH];
+    size_t n = 0;
+
+    // Follow the prefix; it may end part way along an edge
+    uint16_t node = 0;
+    while (n < len) {
+        uint16_t child = findChild(node, prefix[n]);
+        if (child == NIL) return 0;
+        const Node& edge = nodes_[child];
+        size_t k = std::min<size_t>(edge.label_len, len - n);
+        if (memcmp(labels_ + edge.label, prefix + n, k) != 0) return 0;
+        if (n + edge.label_len > sizeof(phrase)) return 0;
+        memcpy(phrase + n, labels_ + edge.label, edge.label_len);
+        n += edge.label_len;
+        node = child;
+    }
+
+    // Walk towards the heaviest phrase below; each subtree's best weight
+    // is cached, so this never searches beyond one level of siblings
+    while (nodes_[node].weight == 0 || nodes_[node].weight < nodes_[node].best || n == len) {
+        uint16_t pick = NIL;
+        for (uint16_t c = nodes_[node].first_child; c != NIL; c = nodes_[c].next_sibling) {
+            if (pick == NIL || nodes_[c].best > nodes_[pick].best) {
+                pick = c;
+            }
+        }
+        if (pick == NIL) break;
+
+        const Node& edge = nodes_[pick];
+        if (n + edge.label_len > sizeof(phrase)) return 0;
+        memcpy(phrase + n, labels_ + edge.label, edge.label_len);
+        n += edge.label_len;
+        node = pick;
+    }
+
+    if (nodes_[node].weight == 0 || n <= len || n >= out_size) return 0;
+    memcpy(out, phrase, n);
+    out[n] = '\0';
+    return n;
+}
+
+void PhraseTrie::clear() {
+    if (!nodes_) return;
+    node_count_ = 0;
+    label_bytes_ = 0;
+    phrase_count_ = 0;
+    newNode(0, 0);
+    dirty_ = true;
+}
+
+bool PhraseTrie::load(const char* path) {
+    if (!nodes_) return false;
+
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        strncpy(last_error_, "Phrase file not found", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    PhraseTrieHeader header;
+    bool ok = file.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              header.magic == PHRASE_TRIE_MAGIC &&
+              header.version == PHRASE_TRIE_VERSION &&
+              header.node_size == sizeof(Node) &&
+              header.node_count >= 1 && header.node_count <= PHRASE_TRIE_MAX_NODES &&
+              header.label_bytes <= PHRASE_TRIE_MAX_LABEL_BYTES &&
+              file.size() == sizeof(header) + header.node_count * sizeof(Node) + header.label_bytes;
+    if (ok && !reserve(header.node_count, header.label_bytes)) {
+        file.close();
+        strncpy(last_error_, "Phrase file too large for memory", sizeof(last_error_) - 1);
+        clear();
+        dirty_ = false;
+        return false;
+    }
+
+    // The arenas are read back verbatim; indices stay valid
+    if (ok) {
+        size_t node_bytes = header.node_count * sizeof(Node);
+        ok = file.read(reinterpret_cast<uint8_t*>(nodes_), node_bytes) == node_bytes &&
+             file.read(reinterpret_cast<uint8_t*>(labels_), header.label_bytes) == header.label_bytes;
+    }
+    file.close();
+
+    if (!ok) {
+        strncpy(last_error_, "Phrase file invalid", sizeof(last_error_) - 1);
+        clear();
+        dirty_ = false;
+        return false;
+    }
+
+    node_count_ = header.node_count;
+    label_bytes_ = header.label_bytes;
+    phrase_count_ = header.phrase_count;
+    dirty_ = false;
+    return true;
+}
+
+bool PhraseTrie::save(const char* path) {
+    if (!nodes_) return false;
+
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        strncpy(last_error_, "Failed to open phrase file for writing", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    PhraseTrieHeader header;
+    header.magic = PHRASE_TRIE_MAGIC;
+    header.version = PHRASE_TRIE_VERSION;
+    header.node_size = sizeof(Node);
+    header.node_count = node_count_;
+    header.label_bytes = label_bytes_;
+    header.phrase_count = phrase_count_;
+
+    size_t node_bytes = node_count_ * sizeof(Node);
+    bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+              file.write(reinterpret_cast<const uint8_t*>(nodes_), node_bytes) == node_bytes &&
+              file.write(reinterpret_cast<const uint8_t*>(labels_), label_bytes_) == label_bytes_;
+    file.close();
+
+    if (!ok) {
+        strncpy(last_error_, "Failed to write phrase file", sizeof(last_error_) - 1);
+        return false;
+    }
+    dirty_ = false;
+    return true;
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+bool PhraseTrie::reserve(size_t nodes, size_t label_bytes) {
+    void* node_arena = nodes_;
+    void* label_arena = labels_;
+    bool ok = growArena(node_arena, node_capacity_, node_count_, nodes,
+                        PHRASE_TRIE_INITIAL_NODES, PHRASE_TRIE_MAX_NODES,
+                        PHRASE_TRIE_INTERNAL_MAX_NODES, sizeof(Node)) &&
+              growArena(label_arena, label_capacity_, label_bytes_, label_bytes,
+                        PHRASE_TRIE_INITIAL_LABEL_BYTES, PHRASE_TRIE_MAX_LABEL_BYTES,
+                        PHRASE_TRIE_INTERNAL_MAX_LABEL_BYTES, 1);
+    nodes_ = static_cast<Node*>(node_arena);
+    labels_ = static_cast<char*>(label_arena);
+    return ok;
+}
+
+uint16_t PhraseTrie::findChild(uint16_t parent, char c) const {
+    // Edges out of a node start with distinct characters
+    for (uint16_t child = nodes_[parent].first_child; child != NIL;
+         child = nodes_[child].next_sibling) {
+        if (labels_[nodes_[child].label] == c) return child;
+    }
+    return NIL;
+}
+
+uint16_t PhraseTrie::newNode(uint32_t label, uint16_t label_len) {
+    uint16_t index = node_count_++;
+    Node& node = nodes_[index];
+    node.label = label;
+    node.label_len = label_len;
+    node.weight = 0;
+    node.best = 0;
+    node.first_child = NIL;
+    node.next_sibling = NIL;
+    node.reserved = 0;
+    return index;
+}
+
+void PhraseTrie::decay() {
+    for (size_t i = 0; i < node_count_; i++) {
+        if (nodes_[i].weight > 0) {
+            nodes_[i].weight = (nodes_[i].weight + 1) / 2;  // Never drops to zero
+        }
+    }
+
+    // Recompute the cached bests depth-first, every subtree before its
+    // root. Each edge is at least one byte, so the depth is bounded.
+    uint16_t stack[PHRASE_MAX_LENGTH + 1];
+    uint16_t next[PHRASE_MAX_LENGTH + 1];   // Next child to visit per level
+    size_t depth = 1;
+    stack[0] = 0;
+    next[0] = nodes_[0].first_child;
+    nodes_[0].best = nodes_[0].weight;
+
+    while (depth > 0) {
+        uint16_t child = next[depth - 1];
+        if (child != NIL) {
+            next[depth - 1] = nodes_[child].next_sibling;
+            nodes_[child].best = nodes_[child].weight;
+            stack[depth] = child;
+            next[depth] = nodes_[child].first_child;
+            depth++;
+            continue;
+        }
+
+        // Subtree done: fold it into its parent
+        const Node& done = nodes_[stack[--depth]];
+        if (depth > 0 && done.best > nodes_[stack[depth - 1]].best) {
+            nodes_[stack[depth - 1]].best = done.best;
+        }
+    }
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,206 @@
+/**
+ * @file power_manager.cpp
+ * @brief Power management implementation
+ */
+
+#include "power_manager.h"
+#include <esp_wifi.h>
+#include <esp_idf_version.h>
+
+namespace OpenClaw {
+
+PowerManager::PowerManager()
+    : cpu_max_lock_(nullptr),
+      no_sleep_lock_(nullptr),
+      cpu_max_held_(false),
+      no_sleep_held_(false),
+      pm_enabled_(false),
+      light_sleep_available_(false),
+      applied_wifi_ps_(WifiPowerSave::NONE),
+      wifi_ps_applied_(false),
+      last_activity_(0),
+      last_idle_us_(0),
+      last_busy_us_(0),
+      initialized_(false) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+PowerManager::~PowerManager() {
+    end();
+}
+
+bool PowerManager::begin(const PowerPolicyConfig& config) {
+    if (initialized_) return true;
+
+    policy_.setConfig(config);
+    last_activity_ = millis();
+    initialized_ = true;
+
+    if (!configurePm(config)) {
+        return false;
+    }
+
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "boost", &cpu_max_lock_) != ESP_OK ||
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "awake", &no_sleep_lock_) != ESP_OK) {
+        strncpy(last_error_, "Failed to create PM locks", sizeof(last_error_) - 1);
+        pm_enabled_ = false;
+        return false;
+    }
+
+    // Start awake; the first update() decides from there
+    setNoSleepLock(true);
+    decision_ = PowerDecision();
+
+    Serial.printf("[Power] DFS %u-%u MHz, light sleep %s\n",
+                  config.min_cpu_mhz, config.max_cpu_mhz,
+                  light_sleep_available_ ? "on" : "unavailable");
+    return true;
+}
+
+void PowerManager::end() {
+    if (!initialized_) return;
+
+    setCpuMaxLock(false);
+    setNoSleepLock(false);
+    if (cpu_max_lock_) {
+        esp_pm_lock_delete(cpu_max_lock_);
+        cpu_max_lock_ = nullptr;
+    }
+    if (no_sleep_lock_) {
+        esp_pm_lock_delete(no_sleep_lock_);
+        no_sleep_lock_ = nullptr;
+    }
+
+    applyWifiPowerSave(WifiPowerSave::NONE);
+    pm_enabled_ = false;
+    initialized_ = false;
+}
+
+void PowerManager::update(const EventLoopStats& loop_stats) {
+    if (!initialized_) return;
+
+    // Busy share since the previous update
+    uint64_t idle = loop_stats.idle_us - last_idle_us_;
+    uint64_t busy = loop_stats.busy_us - last_busy_us_;
+    last_idle_us_ = loop_stats.idle_us;
+    last_busy_us_ = loop_stats.busy_us;
+    if (idle + busy > 0) {
+        inputs_.cpu_busy_percent = (uint8_t)((busy * 100) / (idle + busy));
+    }
+
+    inputs_.ms_since_input = millis() - last_activity_;
+
+    PowerDecision next = policy_.evaluate(inputs_, light_sleep_available_);
+    if (next != decision_) {
+        if (next.mode != decision_.mode) {
+            Serial.printf("[Power] %s -> %s (WiFi PS %s)\n",
+                          powerModeToString(decision_.mode), powerModeToString(next.mode),
+                          wifiPowerSaveToString(next.wifi_ps));
+        }
+        apply(next);
+    }
+}
+
+void PowerManager::requestBoost(PowerBoost source) {
+    inputs_.boost_mask |= source;
+    setCpuMaxLock(true);
+}
+
+void PowerManager::releaseBoost(PowerBoost source) {
+    inputs_.boost_mask &= ~source;
+    if (inputs_.boost_mask == 0) {
+        setCpuMaxLock(false);
+    }
+}
+
+float PowerManager::getEstimatedCurrentMa() const {
+    return policy_.estimateCurrentMa(inputs_, decision_);
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+bool PowerManager::configurePm(const PowerPolicyConfig& config) {
+#if CONFIG_PM_ENABLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+    esp_pm_config_t pm_config = {};
+#else
+    esp_pm_config_esp32s3_t pm_config = {};
+#endif
+    pm_config.max_freq_mhz = config.max_cpu_mhz;
+    pm_config.min_freq_mhz = config.min_cpu_mhz;
+    pm_config.light_sleep_enable = config.allow_light_sleep;
+
+    esp_err_t err = esp_pm_configure(&pm_config);
+    if (err == ESP_ERR_NOT_SUPPORTED && pm_config.light_sleep_enable) {
+        // Tickless idle not built in; keep DFS without light sleep
+        pm_config.light_sleep_enable = false;
+        err = esp_pm_configure(&pm_config);
+    }
+    if (err != ESP_OK) {
+        snprintf(last_error_, sizeof(last_error_), "esp_pm_configure failed: %d", (int)err);
+        return false;
+    }
+
+    pm_enabled_ = true;
+    light_sleep_available_ = pm_config.light_sleep_enable;
+    return true;
+#else
+    (void)config;
+    strncpy(last_error_, "CONFIG_PM_ENABLE not set", sizeof(last_error_) - 1);
+    return false;
+#endif
+}
+
+void PowerManager::apply(const PowerDecision& decision) {
+    // CPU clock follows the boost mask directly (see requestBoost), so
+    // only sleep permission and radio mode are applied here
+    setNoSleepLock(!decision.light_sleep);
+
+    if (inputs_.wifi_connected) {
+        applyWifiPowerSave(decision.wifi_ps);
+    } else {
+        wifi_ps_applied_ = false;  // Re-apply after the next connect
+    }
+
+    decision_ = decision;
+}
+
+void PowerManager::applyWifiPowerSave(WifiPowerSave ps) {
+    if (wifi_ps_applied_ && ps == applied_wifi_ps_) return;
+
+    wifi_ps_type_t type = WIFI_PS_NONE;
+    switch (ps) {
+        case WifiPowerSave::NONE: type = WIFI_PS_NONE; break;
+        case WifiPowerSave::MIN_MODEM: type = WIFI_PS_MIN_MODEM; break;
+        case WifiPowerSave::MAX_MODEM: type = WIFI_PS_MAX_MODEM; break;
+    }
+
+    if (esp_wifi_set_ps(type) == ESP_OK) {
+        applied_wifi_ps_ = ps;
+        wifi_ps_applied_ = true;
+    }
+}
+
+void PowerManager::setCpuMaxLock(bool held) {
+    if (!pm_enabled_ || held == cpu_max_held_) return;
+    if (held) {
+        esp_pm_lock_acquire(cpu_max_lock_);
+    } else {
+        esp_pm_lock_release(cpu_max_lock_);
+    }
+    cpu_max_held_ = held;
+}
+
+void PowerManager::setNoSleepLock(bool held) {
+    if (!pm_enabled_ || held == no_sleep_held_) return;
+    if (held) {
+        esp_pm_lock_acquire(no_sleep_lock_);
+    } else {
+        esp_pm_lock_release(no_sleep_lock_);
+    }
+    no_sleep_held_ = held;
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,87 @@
+/**
+ * @file power_policy.cpp
+ * @brief Power policy engine implementation
+ */
+
+#include "power_policy.h"
+
+namespace OpenClaw {
+
+PowerDecision PowerPolicy::evaluate(const PowerInputs& inputs, bool light_sleep_available) const {
+    PowerDecision d;
+
+    if (inputs.boost_mask != 0) {
+        d.mode = PowerMode::BOOST;
+    } else if (inputs.face_down || inputs.ms_since_input >= config_.idle_after_ms) {
+        d.mode = PowerMode::IDLE;
+    } else {
+        d.mode = PowerMode::ACTIVE;
+    }
+
+    d.cpu_mhz = (d.mode == PowerMode::BOOST) ? config_.max_cpu_mhz : config_.min_cpu_mhz;
+    d.light_sleep = (d.mode == PowerMode::IDLE) && config_.allow_light_sleep &&
+                    light_sleep_available && !inputs.audio_streaming;
+
+    // Radio: full power only while streaming audio; otherwise sleep between
+    // beacons, longer when nobody is looking
+    if (!inputs.wifi_connected || inputs.audio_streaming) {
+        d.wifi_ps = WifiPowerSave::NONE;
+    } else if (d.mode == PowerMode::IDLE) {
+        d.wifi_ps = WifiPowerSave::MAX_MODEM;
+    } else {
+        d.wifi_ps = WifiPowerSave::MIN_MODEM;
+    }
+
+    return d;
+}
+
+float PowerPolicy::estimateCurrentMa(const PowerInputs& inputs, const PowerDecision& decision) const {
+    float busy = inputs.cpu_busy_percent / 100.0f;
+    if (busy > 1.0f) busy = 1.0f;
+
+    // Bursts run at max clock when boosted, min clock otherwise; the rest
+    // of the time the CPU idles or light-sleeps
+    float active = (decision.cpu_mhz >= config_.max_cpu_mhz)
+        ? model_.cpu_active_ma_max
+        : model_.cpu_active_ma_min;
+    float idle = decision.light_sleep ? model_.cpu_light_sleep_ma : model_.cpu_idle_ma;
+    float cpu = active * busy + idle * (1.0f - busy);
+
+    float wifi = 0.0f;
+    if (inputs.wifi_connected) {
+        switch (decision.wifi_ps) {
+            case WifiPowerSave::NONE: wifi = model_.wifi_on_ma; break;
+            case WifiPowerSave::MIN_MODEM: wifi = model_.wifi_min_modem_ma; break;
+            case WifiPowerSave::MAX_MODEM: wifi = model_.wifi_max_modem_ma; break;
+        }
+    }
+
+    float backlight = model_.backlight_ma_full * (inputs.backlight / 255.0f);
+    float audio = inputs.audio_streaming ? model_.audio_ma : 0.0f;
+
+    return model_.base_ma + cpu + wifi + backlight + audio;
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* powerModeToString(PowerMode mode) {
+    switch (mode) {
+        case PowerMode::BOOST: return "BOOST";
+        case PowerMode::ACTIVE: return "ACTIVE";
+        case PowerMode::IDLE: return "IDLE";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* wifiPowerSaveToString(WifiPowerSave ps) {
+    switch (ps) {
+        case WifiPowerSave::NONE: return "NONE";
+        case WifiPowerSave::MIN_MODEM: return "MIN_MODEM";
+        case WifiPowerSave::MAX_MODEM: return "MAX_MODEM";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
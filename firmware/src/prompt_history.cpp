@@ -0,0 +1,98 @@
+/**
+ * @file prompt_history.cpp
+ * @brief Submitted prompt history implementation
+ */
+
+#include "prompt_history.h"
+#include <LittleFS.h>
+
+namespace OpenClaw {
+
+PromptHistory::PromptHistory()
+    : head_(0),
+      count_(0),
+      nav_age_(-1),
+      dirty_(false) {
+}
+
+void PromptHistory::add(const char* text) {
+    resetNavigation();
+    if (text[0] == '\0') return;
+
+    // One prompt per line on flash
+    if (strchr(text, '\n')) return;
+
+    const char* newest = get(0);
+    if (newest && strcmp(newest, text) == 0) return;
+
+    entries_[head_] = text;
+    head_ = (head_ + 1) % PROMPT_HISTORY_SIZE;
+    if (count_ < PROMPT_HISTORY_SIZE) {
+        count_++;
+    }
+    dirty_ = true;
+}
+
+const char* PromptHistory::older() {
+    if (nav_age_ + 1 >= (int)count_) return nullptr;
+    nav_age_++;
+    return get(nav_age_);
+}
+
+const char* PromptHistory::newer() {
+    if (nav_age_ < 0) return nullptr;
+    nav_age_--;
+    return nav_age_ >= 0 ? get(nav_age_) : nullptr;
+}
+
+const char* PromptHistory::get(size_t age) const {
+    if (age >= count_) return nullptr;
+    size_t index = (head_ + PROMPT_HISTORY_SIZE - 1 - age) % PROMPT_HISTORY_SIZE;
+    return entries_[index].c_str();
+}
+
+void PromptHistory::clear() {
+    for (size_t i = 0; i < PROMPT_HISTORY_SIZE; i++) {
+        entries_[i] = "";
+    }
+    head_ = 0;
+    count_ = 0;
+    resetNavigation();
+    dirty_ = true;
+}
+
+bool PromptHistory::load(const char* path) {
+    File file = LittleFS.open(path, "r");
+    if (!file) return false;
+
+    clear();
+    while (file.available()) {
+        String line = file.readStringUntil('\n');
+        add(line.c_str());
+    }
+    file.close();
+
+    dirty_ = false;
+    return true;
+}
+
+bool PromptHistory::save(const char* path) {
+    File file = LittleFS.open(path, "w");
+    if (!file) return false;
+
+    bool ok = true;
+    for (size_t age = count_; age-- > 0 && ok;) {
+        const char* text = get(age);
+        size_t len = strlen(text);
+        ok = file.write(reinterpret_cast<const uint8_t*>(text), len) == len &&
+             file.write('\n') == 1;
+    }
+    file.close();
+
+    if (ok) {
+        dirty_ = false;
+    }
+    return ok;
+}
+
+} // namespace OpenClaw
@@ -5,6 +5,7 @@
 
 #include "protocol.h"
 #include <ArduinoJson.h>
+#include <base64.h>
 
 namespace OpenClaw {
 
@@ -108,6 +109,10 @@ ProtocolMessage ProtocolMessage::createAuth(const char* device_id, const char* d
         doc["api_key"] = api_key;
     }
     
+    // Replies may arrive as appended RESPONSE chunks before RESPONSE_FINAL
+    JsonArray capabilities = doc["capabilities"].to<JsonArray>();
+    capabilities.add("stream");
+    
     String json;
     serializeJson(doc, json);
     msg.setJsonPayload(json);
@@ -131,12 +136,15 @@ ProtocolMessage ProtocolMessage::createAuthResponse(bool success, const char* er
     return msg;
 }
 
-ProtocolMessage ProtocolMessage::createText(const char* text, const char* device_id) {
+ProtocolMessage ProtocolMessage::createText(const char* text, const char* device_id, uint32_t turn) {
     ProtocolMessage msg(MessageType::TEXT);
     
     JsonDocument doc;
     doc["text"] = text;
     doc["device_id"] = device_id;
+    if (turn != 0) {
+        doc["turn"] = turn;
+    }
     
     String json;
     serializeJson(doc, json);
@@ -146,7 +154,8 @@ ProtocolMessage ProtocolMessage::createText(const char* text, const char* device
 }
 
 ProtocolMessage ProtocolMessage::createAudio(const uint8_t* data, size_t length, bool is_final,
-                                              const char* codec) {
+                                              const char* codec, uint32_t turn,
+                                              const char* endpoint) {
     ProtocolMessage msg(MessageType::AUDIO);
     
     if (is_final) {
@@ -157,14 +166,30 @@ ProtocolMessage ProtocolMessage::createAudio(const uint8_t* data, size_t length,
     JsonDocument doc;
     doc["codec"] = codec;
     doc["is_final"] = is_final;
+    if (turn != 0) {
+        doc["turn"] = turn;
+    }
+    if (endpoint) {
+        doc["endpoint"] = endpoint;
+    }
     
-    // Base64 encode the audio data
-    size_t encoded_len = ((length + 2) / 3) * 4 + 1;
-    char* encoded = new char[encoded_len];
-    // Note: Base64 encoding would go here
-    // For now, we'll use a placeholder
-    doc["data"] = "base64_encoded_audio_data";
-    delete[] encoded;
+    doc["data"] = base64::encode(data, length);
+    
+    String json;
+    serializeJson(doc, json);
+    msg.setJsonPayload(json);
+    
+    return msg;
+}
+
+ProtocolMessage ProtocolMessage::createCommand(const char* command, uint32_t turn) {
+    ProtocolMessage msg(MessageType::COMMAND);
+    
+    JsonDocument doc;
+    doc["command"] = command;
+    if (turn != 0) {
+        doc["turn"] = turn;
+    }
     
     String json;
     serializeJson(doc, json);
@@ -260,7 +285,8 @@ ProtocolMessage ProtocolMessage::createAudioConfig(uint16_t sample_rate, uint8_t
     return msg;
 }
 
-bool ProtocolMessage::serialize(uint8_t* buffer, size_t buffer_size, size_t& out_length) const {
+bool ProtocolMessage::serialize(uint8_t* buffer, size_t buffer_size, size_t& out_length,
+                                uint8_t version) const {
     size_t total_size = getTotalSize();
     if (buffer_size < total_size) {
         return false;
@@ -269,7 +295,7 @@ bool ProtocolMessage::serialize(uint8_t* buffer, size_t buffer_size, size_t& out
     // Build header
     ProtocolHeader header;
     header.magic = PROTOCOL_MAGIC;
-    header.version = PROTOCOL_VERSION;
+    header.version = version;
     header.type = static_cast<uint8_t>(type_);
     header.flags = static_cast<uint8_t>(flags_);
     header.payload_length = payload_length_;
@@ -390,7 +416,7 @@ bool ProtocolParser::feed(const uint8_t* data, size_t length, ProtocolMessage& o
             case ParseState::WAITING_MAGIC:
                 if (buffer_[0] == PROTOCOL_MAGIC) {
                     state_ = ParseState::WAITING_HEADER;
-                    expected_length_ = 10; // Full header size
+                    expected_length_ = PROTOCOL_HEADER_SIZE;
                 } else {
                     buffer_pos_ = 0; // Reset, wait for magic
                 }
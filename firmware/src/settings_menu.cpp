@@ -70,7 +70,7 @@ const MenuItem SettingsMenu::menu_items_[] = {
 };
 
 SettingsMenu::SettingsMenu()
-    : config_mgr_(nullptr), display_(nullptr),
+    : config_mgr_(nullptr), display_(nullptr), wifi_(nullptr),
       state_(MenuState::CLOSED), current_category_(MenuCategory::WIFI),
       selected_item_(0), scroll_offset_(0), modified_(false),
       edit_cursor_pos_(0), edit_mode_(false), message_timeout_(0),
@@ -83,14 +83,24 @@ SettingsMenu::SettingsMenu()
 SettingsMenu::~SettingsMenu() {
 }
 
-bool SettingsMenu::begin(ConfigManager* config_mgr, DisplayRenderer* display) {
+bool SettingsMenu::begin(ConfigManager* config_mgr, DisplayRenderer* display,
+                         WiFiManager* wifi) {
     config_mgr_ = config_mgr;
     display_ = display;
+    wifi_ = wifi;
 
     if (config_mgr_) {
         config_copy_ = config_mgr_->getMutableConfig();
     }
 
+    if (display_) {
+        // Opaque full-screen overlay; hidden until the menu is opened
+        DisplayCompositor& compositor = display_->getCompositor();
+        compositor.setLayer(DisplayLayer::MENU_OVERLAY, FULL_SCREEN_RECT,
+            [this](lgfx::LovyanGFX& gfx) { render(gfx); }, true);
+        compositor.setLayerVisible(DisplayLayer::MENU_OVERLAY, false);
+    }
+
     return true;
 }
 
@@ -106,11 +116,25 @@ void SettingsMenu::open() {
     modified_ = false;
     edit_mode_ = false;
     clearMessage();
+
+    display_->getCompositor().setLayerVisible(DisplayLayer::MENU_OVERLAY, true);
+    invalidate();
 }
 
 void SettingsMenu::close() {
     state_ = MenuState::CLOSED;
     edit_mode_ = false;
+    wifi_scanning_ = false;
+
+    if (display_) {
+        display_->getCompositor().setLayerVisible(DisplayLayer::MENU_OVERLAY, false);
+    }
+}
+
+void SettingsMenu::invalidate() {
+    if (display_ && state_ != MenuState::CLOSED) {
+        display_->getCompositor().damage(DisplayLayer::MENU_OVERLAY);
+    }
 }
 
 void SettingsMenu::onKeyEvent(const KeyEvent& event) {
@@ -118,6 +142,9 @@ void SettingsMenu::onKeyEvent(const KeyEvent& event) {
 
     if (!event.pressed) return;  // Only handle press, not release
 
+    // Every handled press can change what the menu shows
+    invalidate();
+
     // Handle special device info/WiFi scan dismissal
     int base_state = (int)state_;
     if (base_state >= (int)MenuState::SHOW_MESSAGE + 20) {
@@ -189,6 +216,7 @@ void SettingsMenu::onKeyEvent(const KeyEvent& event) {
         case MenuState::SHOW_MESSAGE:
             if (millis() > message_timeout_) {
                 clearMessage();
+                wifi_scanning_ = false;  // Dismissed; drop late scan results
                 state_ = MenuState::MAIN_MENU;
             }
             break;
@@ -201,27 +229,44 @@ void SettingsMenu::onKeyEvent(const KeyEvent& event) {
 void SettingsMenu::update() {
     if (state_ == MenuState::CLOSED) return;
 
-    if (state_ == MenuState::SHOW_MESSAGE && millis() > message_timeout_) {
+    // "Scanning..." stays up until the results arrive
+    if (state_ == MenuState::SHOW_MESSAGE && !wifi_scanning_ &&
+        millis() > message_timeout_) {
         clearMessage();
         state_ = MenuState::MAIN_MENU;
+        invalidate();
     }
 }
 
-void SettingsMenu::render() {
+void SettingsMenu::render(lgfx::LovyanGFX& canvas) {
     if (state_ == MenuState::CLOSED) return;
 
+    // Special views live at offsets above SHOW_MESSAGE
+    int base_state = (int)state_;
+    if (base_state >= (int)MenuState::SHOW_MESSAGE + 20) {
+        renderDeviceInfo(canvas);
+        return;
+    }
+    if (base_state >= (int)MenuState::SHOW_MESSAGE + 10) {
+        renderWiFiScan(canvas);
+        return;
+    }
+
     switch (state_) {
         case MenuState::MAIN_MENU:
-            renderMainMenu();
+            renderMainMenu(canvas);
             break;
         case MenuState::EDIT_ITEM:
-            renderEditScreen();
+            renderEditScreen(canvas);
             break;
         case MenuState::CONFIRM_SAVE:
-            renderConfirmDialog();
+            // Dialogs are drawn over the menu they were opened from
+            renderMainMenu(canvas);
+            renderConfirmDialog(canvas);
             break;
         case MenuState::SHOW_MESSAGE:
-            renderMessage();
+            renderMainMenu(canvas);
+            renderMessage(canvas);
             break;
         default:
             break;
@@ -447,37 +492,42 @@ void SettingsMenu::testConnection() {
 void SettingsMenu::startWiFiScan() {
     if (!display_) return;
 
-    // Start scan
     state_ = MenuState::SHOW_MESSAGE;
+    if (!wifi_ || !wifi_->startScan()) {
+        snprintf(message_buffer_, sizeof(message_buffer_), "Scan failed: %s",
+                 wifi_ ? wifi_->getLastError() : "no WiFi");
+        message_timeout_ = millis() + 2000;
+        return;
+    }
+
+    // Results arrive through onWiFiScanDone(); the menu stays responsive
     wifi_scanning_ = true;
     wifi_scan_count_ = 0;
     snprintf(message_buffer_, sizeof(message_buffer_), "Scanning...");
-    message_timeout_ = 0;  // Don't auto-dismiss
-
-    // Trigger scan
-    WiFi.mode(WIFI_STA);
-    WiFi.disconnect();
-    int16_t result = WiFi.scanNetworks(true, true, false, 200);
-
-    if (result >= 0) {
-        wifi_scan_count_ = (result < 20) ? result : 20;
-        for (int i = 0; i < wifi_scan_count_; i++) {
-            wifi_networks_[i].ssid = WiFi.SSID(i);
-            wifi_networks_[i].rssi = WiFi.RSSI(i);
-            wifi_networks_[i].encryption = WiFi.encryptionType(i);
-        }
+    message_timeout_ = 0;
+}
 
-        selected_item_ = 0;
-        scroll_offset_ = 0;
-        // Use SHOW_MESSAGE as base, offset for special views
-        state_ = (MenuState)((int)MenuState::SHOW_MESSAGE + 10);  // WiFi scan results
-    } else {
-        snprintf(message_buffer_, sizeof(message_buffer_), "Scan failed: %d", result);
-        message_timeout_ = millis() + 2000;
+void SettingsMenu::onWiFiScanDone() {
+    if (!wifi_scanning_) return;
+    wifi_scanning_ = false;
+
+    // Menu was closed or moved on while scanning
+    if (state_ != MenuState::SHOW_MESSAGE) return;
+
+    size_t count = wifi_->getScanCount();
+    wifi_scan_count_ = (count < 20) ? (int)count : 20;
+    for (int i = 0; i < wifi_scan_count_; i++) {
+        const WiFiScanEntry* entry = wifi_->getScanEntry(i);
+        wifi_networks_[i].ssid = entry->ssid;
+        wifi_networks_[i].rssi = entry->getAverageRssi();
+        wifi_networks_[i].encryption = entry->encryption;
     }
 
-    WiFi.scanDelete();
-    wifi_scanning_ = false;
+    selected_item_ = 0;
+    scroll_offset_ = 0;
+    // Use SHOW_MESSAGE as base, offset for special views
+    state_ = (MenuState)((int)MenuState::SHOW_MESSAGE + 10);  // WiFi scan results
+    invalidate();
 }
 
 void SettingsMenu::showDeviceInfo() {
@@ -671,10 +721,7 @@ void SettingsMenu::applyValue(const MenuItem* item) {
     }
 }
 
-void SettingsMenu::renderMainMenu() {
-    if (!display_) return;
-
-    auto& canvas = M5Cardputer.Display;
+void SettingsMenu::renderMainMenu(lgfx::LovyanGFX& canvas) {
     canvas.fillScreen(TFT_BLACK);
 
     // Title bar
@@ -749,10 +796,7 @@ void SettingsMenu::renderMainMenu() {
     canvas.print("\x1E\x1F=nav \x11=edit ESC=back");
 }
 
-void SettingsMenu::renderEditScreen() {
-    if (!display_) return;
-
-    auto& canvas = M5Cardputer.Display;
+void SettingsMenu::renderEditScreen(lgfx::LovyanGFX& canvas) {
     canvas.fillScreen(TFT_BLACK);
 
     const MenuItem* item = getItem(selected_item_);
@@ -790,11 +834,7 @@ void SettingsMenu::renderEditScreen() {
     canvas.print("ENTER=save ESC=cancel");
 }
 
-void SettingsMenu::renderConfirmDialog() {
-    if (!display_) return;
-
-    auto& canvas = M5Cardputer.Display;
-
+void SettingsMenu::renderConfirmDialog(lgfx::LovyanGFX& canvas) {
     // Modal background
     canvas.fillRect(20, 30, 200, 75, 0x2104);
     canvas.drawRect(20, 30, 200, 75, TFT_WHITE);
@@ -821,22 +861,7 @@ void SettingsMenu::renderConfirmDialog() {
     canvas.print("N = No");
 }
 
-void SettingsMenu::renderMessage() {
-    if (!display_) return;
-
-    // Handle special views with larger offsets
-    int base_state = (int)state_;
-    if (base_state >= (int)MenuState::SHOW_MESSAGE + 10) {
-        renderWiFiScan();
-        return;
-    }
-    if (base_state >= (int)MenuState::SHOW_MESSAGE + 20) {
-        renderDeviceInfo();
-        return;
-    }
-
-    auto& canvas = M5Cardputer.Display;
-
+void SettingsMenu::renderMessage(lgfx::LovyanGFX& canvas) {
     // Centered message box
     int msg_len = strlen(message_buffer_);
     int line_count = 1;
@@ -876,10 +901,7 @@ void SettingsMenu::renderMessage() {
     }
 }
 
-void SettingsMenu::renderWiFiScan() {
-    if (!display_) return;
-
-    auto& canvas = M5Cardputer.Display;
+void SettingsMenu::renderWiFiScan(lgfx::LovyanGFX& canvas) {
     canvas.fillScreen(TFT_BLACK);
 
     // Title
@@ -934,10 +956,7 @@ void SettingsMenu::renderWiFiScan() {
     canvas.print("\x1E\x1F=nav ENTER=select ESC=back");
 }
 
-void SettingsMenu::renderDeviceInfo() {
-    if (!display_) return;
-
-    auto& canvas = M5Cardputer.Display;
+void SettingsMenu::renderDeviceInfo(lgfx::LovyanGFX& canvas) {
     canvas.fillScreen(TFT_BLACK);
 
     // Title
@@ -948,26 +967,21 @@ void SettingsMenu::renderDeviceInfo() {
 
     // Info text
     canvas.setTextColor(TFT_WHITE, TFT_BLACK);
+    // Layer may be re-rendered any number of times; leave the buffer intact
     char line[48];
     int y = 26;
-    char* ptr = message_buffer_;
+    const char* ptr = message_buffer_;
 
     while (*ptr && y < 130) {
-        char* newline = strchr(ptr, '\n');
-        if (newline) {
-            *newline = '\0';
-            strncpy(line, ptr, 47);
-            line[47] = '\0';
-            canvas.setCursor(4, y);
-            canvas.print(line);
-            ptr = newline + 1;
-        } else {
-            strncpy(line, ptr, 47);
-            line[47] = '\0';
-            canvas.setCursor(4, y);
-            canvas.print(line);
-            break;
-        }
+        const char* newline = strchr(ptr, '\n');
+        size_t len = newline ? (size_t)(newline - ptr) : strlen(ptr);
+        if (len > sizeof(line) - 1) len = sizeof(line) - 1;
+        memcpy(line, ptr, len);
+        line[len] = '\0';
+        canvas.setCursor(4, y);
+        canvas.print(line);
+        if (!newline) break;
+        ptr = newline + 1;
         y += 10;
     }
 
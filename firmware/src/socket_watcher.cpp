@@ -0,0 +1,102 @@
+/**
+ * @file socket_watcher.cpp
+ * @brief Gateway socket receive watcher implementation
+ */
+
+#include "socket_watcher.h"
+#include <lwip/sockets.h>
+
+namespace OpenClaw {
+
+SocketWatcher::SocketWatcher()
+    : task_(nullptr),
+      fd_(-1),
+      running_(false),
+      wake_count_(0) {
+    memset(last_error_, 0, sizeof(last_error_));
+}
+
+SocketWatcher::~SocketWatcher() {
+    end();
+}
+
+bool SocketWatcher::begin(const LoopNotifier& notifier) {
+    if (task_) return true;
+
+    notifier_ = notifier;
+    running_ = true;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        watchTask,
+        "SocketWatch",
+        TASK_STACK_SIZE,
+        this,
+        TASK_PRIORITY,
+        &task_,
+        0  // Next to the WiFi and lwIP tasks
+    );
+
+    if (result != pdPASS) {
+        running_ = false;
+        task_ = nullptr;
+        strncpy(last_error_, "Failed to create watcher task", sizeof(last_error_) - 1);
+        return false;
+    }
+    return true;
+}
+
+void SocketWatcher::end() {
+    if (!task_) return;
+
+    running_ = false;
+    fd_ = -1;
+    xTaskNotifyGive(task_);
+
+    // The task clears task_ on its way out; at worst it is in select()
+    uint32_t start = millis();
+    while (task_ && millis() - start < SELECT_TIMEOUT_MS + 100) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+void SocketWatcher::watch(int fd) {
+    if (!task_) return;
+    fd_ = fd;
+    xTaskNotifyGive(task_);
+}
+
+void SocketWatcher::watchTask(void* param) {
+    SocketWatcher* watcher = static_cast<SocketWatcher*>(param);
+    watcher->watchLoop();
+    watcher->task_ = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void SocketWatcher::watchLoop() {
+    while (running_) {
+        int fd = fd_.load();
+        if (fd < 0) {
+            // Nothing open: sleep until watch() hands over a socket
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(fd, &readable);
+        struct timeval timeout = {0, (long)SELECT_TIMEOUT_MS * 1000};
+
+        int ready = select(fd + 1, &readable, nullptr, nullptr, &timeout);
+        if (ready > 0) {
+            // Data (or EOF) stays readable until the loop reads it: signal
+            // once, then wait to be re-armed
+            wake_count_++;
+            notifier_.notify();
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REARM_TIMEOUT_MS));
+        } else if (ready < 0) {
+            // Closed under us; the loop reports the next socket, or none
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REARM_TIMEOUT_MS));
+        }
+    }
+}
+
+} // namespace OpenClaw
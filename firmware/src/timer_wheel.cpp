@@ -0,0 +1,313 @@
+/**
+ * @file timer_wheel.cpp
+ * @brief Hierarchical timer wheel implementation
+ */
+
+#include "timer_wheel.h"
+
+namespace OpenClaw {
+
+TimerWheel::TimerWheel()
+    : free_head_(0),
+      now_tick_(0),
+      advance_target_(0),
+      active_count_(0),
+      fired_count_(0) {
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        memset(slots_[level], NIL, sizeof(slots_[level]));
+        occupied_[level] = 0;
+    }
+
+    for (size_t i = 0; i < TIMER_WHEEL_MAX_TIMERS; i++) {
+        Timer& t = timers_[i];
+        t.expires = 0;
+        t.period = 0;
+        t.callback = nullptr;
+        t.ctx = nullptr;
+        t.generation = 1;
+        t.prev = NIL;
+        t.next = (i + 1 < TIMER_WHEEL_MAX_TIMERS) ? (uint8_t)(i + 1) : NIL;
+        t.level = 0;
+        t.slot = 0;
+        t.active = false;
+    }
+}
+
+TimerId TimerWheel::schedule(uint32_t delay_ms, TimerCallback callback, void* ctx) {
+    return add(delay_ms, 0, callback, ctx);
+}
+
+TimerId TimerWheel::scheduleEvery(uint32_t period_ms, TimerCallback callback, void* ctx) {
+    if (period_ms == 0) period_ms = 1;
+    return add(period_ms, period_ms, callback, ctx);
+}
+
+TimerId TimerWheel::add(uint32_t delay_ms, uint32_t period_ms, TimerCallback callback, void* ctx) {
+    if (!callback || free_head_ == NIL) return INVALID_TIMER_ID;
+
+    uint8_t index = free_head_;
+    Timer& t = timers_[index];
+    free_head_ = t.next;
+
+    t.expires = deadlineFromNow(delay_ms);
+    t.period = period_ms;
+    t.callback = callback;
+    t.ctx = ctx;
+    t.active = true;
+    active_count_++;
+
+    insert(index);
+    return makeId(index, t.generation);
+}
+
+bool TimerWheel::reschedule(TimerId id, uint32_t delay_ms) {
+    uint8_t index = findIndex(id);
+    if (index == NIL) return false;
+
+    unlink(index);
+    timers_[index].expires = deadlineFromNow(delay_ms);
+    insert(index);
+    return true;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint8_t index = findIndex(id);
+    if (index == NIL) return false;
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::cancel(TimerId* id) {
+    if (!id) return;
+    cancel(*id);
+    *id = INVALID_TIMER_ID;
+}
+
+bool TimerWheel::isActive(TimerId id) const {
+    return findIndex(id) != NIL;
+}
+
+size_t TimerWheel::advance(uint32_t now) {
+    size_t fired = 0;
+    advance_target_ = now;
+
+    while ((int32_t)(now - now_tick_) > 0) {
+        // Nothing pending anywhere: jump straight to now
+        if ((occupied_[0] | occupied_[1] | occupied_[2] | occupied_[3]) == 0) {
+            now_tick_ = now;
+            break;
+        }
+
+        // Step to the next occupied level-0 slot or the next cascade
+        // boundary, whichever comes first
+        uint32_t next = nextTick();
+        if ((int32_t)(next - now) > 0) {
+            now_tick_ = now;
+            break;
+        }
+        now_tick_ = next;
+
+        if ((now_tick_ & SLOT_MASK) == 0) {
+            // Cascade top-down so timers can fall more than one level
+            uint8_t top = 1;
+            while (top < LEVELS - 1 &&
+                   ((now_tick_ >> (SLOT_BITS * top)) & SLOT_MASK) == 0) {
+                top++;
+            }
+            for (uint8_t level = top; level >= 1; level--) {
+                cascade(level);
+            }
+        }
+
+        fired += expireSlot(now_tick_ & SLOT_MASK);
+    }
+
+    return fired;
+}
+
+uint32_t TimerWheel::msUntilNextDeadline(uint32_t now) const {
+    if (active_count_ == 0) return TIMER_WHEEL_NO_DEADLINE;
+
+    bool any = false;
+    uint32_t earliest = 0;
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        bool found = false;
+        uint32_t e = earliestInLevel(level, found);
+        if (!found) continue;
+        if (!any || (int32_t)(e - earliest) < 0) earliest = e;
+        any = true;
+    }
+
+    if (!any) return TIMER_WHEEL_NO_DEADLINE;
+    int32_t remaining = (int32_t)(earliest - now);
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+uint32_t TimerWheel::deadlineFromNow(uint32_t delay_ms) const {
+    // Level selection is relative to the last processed tick, which may
+    // trail millis() if advance() has not run yet
+    uint32_t lag = millis() - now_tick_;
+    uint64_t delta = (uint64_t)lag + delay_ms;
+    if (delta < 1) delta = 1;
+    if (delta > MAX_DELAY_MS) delta = MAX_DELAY_MS;
+    return now_tick_ + (uint32_t)delta;
+}
+
+void TimerWheel::insert(uint8_t index) {
+    Timer& t = timers_[index];
+
+    // Lowest level whose window still holds the deadline
+    uint8_t level = 0;
+    if (t.expires - now_tick_ >= SLOTS) {
+        level = 1;
+        while (level < LEVELS - 1 &&
+               (t.expires >> (SLOT_BITS * level)) - (now_tick_ >> (SLOT_BITS * level)) >= SLOTS) {
+            level++;
+        }
+    }
+
+    uint8_t slot = (t.expires >> (SLOT_BITS * level)) & SLOT_MASK;
+    t.level = level;
+    t.slot = slot;
+    t.prev = NIL;
+    t.next = slots_[level][slot];
+    if (t.next != NIL) {
+        timers_[t.next].prev = index;
+    }
+    slots_[level][slot] = index;
+    occupied_[level] |= (1ULL << slot);
+}
+
+void TimerWheel::unlink(uint8_t index) {
+    Timer& t = timers_[index];
+
+    if (t.prev != NIL) {
+        timers_[t.prev].next = t.next;
+    } else {
+        slots_[t.level][t.slot] = t.next;
+    }
+    if (t.next != NIL) {
+        timers_[t.next].prev = t.prev;
+    }
+    if (slots_[t.level][t.slot] == NIL) {
+        occupied_[t.level] &= ~(1ULL << t.slot);
+    }
+
+    t.prev = NIL;
+    t.next = NIL;
+}
+
+void TimerWheel::release(uint8_t index) {
+    Timer& t = timers_[index];
+    t.active = false;
+    t.callback = nullptr;
+    t.ctx = nullptr;
+
+    // Invalidate outstanding ids; generation stays non-zero so ids are never 0
+    t.generation = (t.generation + 1) & 0x00FFFFFF;
+    if (t.generation == 0) t.generation = 1;
+
+    t.next = free_head_;
+    free_head_ = index;
+    active_count_--;
+}
+
+void TimerWheel::cascade(uint8_t level) {
+    uint8_t slot = (now_tick_ >> (SLOT_BITS * level)) & SLOT_MASK;
+    uint8_t index = slots_[level][slot];
+
+    slots_[level][slot] = NIL;
+    occupied_[level] &= ~(1ULL << slot);
+
+    while (index != NIL) {
+        uint8_t next = timers_[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+size_t TimerWheel::expireSlot(uint8_t slot) {
+    size_t fired = 0;
+
+    // Callbacks may schedule or cancel freely; re-read the head each time
+    while (slots_[0][slot] != NIL) {
+        uint8_t index = slots_[0][slot];
+        Timer& t = timers_[index];
+        TimerCallback callback = t.callback;
+        void* ctx = t.ctx;
+
+        unlink(index);
+
+        if (t.period > 0) {
+            // Keep phase; skip periods missed while the loop was busy
+            uint32_t next = t.expires + t.period;
+            if ((int32_t)(next - advance_target_) <= 0) {
+                uint32_t missed = (advance_target_ - t.expires) / t.period;
+                next = t.expires + (missed + 1) * t.period;
+            }
+            uint32_t delta = next - now_tick_;
+            t.expires = (delta > MAX_DELAY_MS) ? now_tick_ + MAX_DELAY_MS : next;
+            insert(index);
+        } else {
+            release(index);
+        }
+
+        fired++;
+        fired_count_++;
+        callback(ctx);
+    }
+
+    return fired;
+}
+
+uint32_t TimerWheel::nextTick() const {
+    uint32_t base = now_tick_ & ~(uint32_t)SLOT_MASK;
+    uint8_t pos = now_tick_ & SLOT_MASK;
+
+    if (pos < SLOT_MASK) {
+        uint64_t ahead = occupied_[0] & (~0ULL << (pos + 1));
+        if (ahead) {
+            return base + __builtin_ctzll(ahead);
+        }
+    }
+    return base + SLOTS;
+}
+
+uint32_t TimerWheel::earliestInLevel(uint8_t level, bool& found) const {
+    found = false;
+    uint64_t mask = occupied_[level];
+    if (!mask) return 0;
+
+    // Slots are in time order starting just after the current position
+    uint8_t pos = (now_tick_ >> (SLOT_BITS * level)) & SLOT_MASK;
+    uint8_t start = (pos + 1) & SLOT_MASK;
+    uint64_t rotated = start ? (mask >> start) | (mask << (SLOTS - start)) : mask;
+    uint8_t slot = (start + __builtin_ctzll(rotated)) & SLOT_MASK;
+
+    uint32_t earliest = 0;
+    for (uint8_t index = slots_[level][slot]; index != NIL; index = timers_[index].next) {
+        uint32_t e = timers_[index].expires;
+        if (!found || (int32_t)(e - earliest) < 0) earliest = e;
+        found = true;
+    }
+    return earliest;
+}
+
+uint8_t TimerWheel::findIndex(TimerId id) const {
+    if (id == INVALID_TIMER_ID) return NIL;
+
+    uint32_t index = id & 0xFF;
+    if (index >= TIMER_WHEEL_MAX_TIMERS) return NIL;
+
+    const Timer& t = timers_[index];
+    if (!t.active || t.generation != (id >> 8)) return NIL;
+    return (uint8_t)index;
+}
+
+} // namespace OpenClaw
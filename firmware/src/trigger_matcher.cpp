@@ -0,0 +1,51 @@
+/**
+ * @file trigger_matcher.cpp
+ * @brief Multi-pattern trigger phrase matcher implementation
+ */
+
+#include "trigger_matcher.h"
+
+namespace OpenClaw {
+
+#include "trigger_tables.inc"
+
+static_assert(TRIGGER_STATE_COUNT <= 65536, "TriggerScanner state is 16 bits");
+
+TriggerMask TriggerScanner::feed(const char* data, size_t length) {
+    TriggerMask matched = 0;
+    uint16_t state = state_;
+    for (size_t i = 0; i < length; i++) {
+        state = TRIGGER_NEXT[state][TRIGGER_CHAR_CLASS[static_cast<uint8_t>(data[i])]];
+        matched |= TRIGGER_OUTPUT[state];
+    }
+    state_ = state;
+    return matched;
+}
+
+TriggerMask TriggerScanner::feed(const char* text) {
+    TriggerMask matched = 0;
+    uint16_t state = state_;
+    for (; *text; text++) {
+        state = TRIGGER_NEXT[state][TRIGGER_CHAR_CLASS[static_cast<uint8_t>(*text)]];
+        matched |= TRIGGER_OUTPUT[state];
+    }
+    state_ = state;
+    return matched;
+}
+
+TriggerMask scanTriggers(const char* text) {
+    if (!text) return 0;
+    TriggerScanner scanner;
+    return scanner.feed(text);
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* triggerIdToString(TriggerId id) {
+    uint8_t index = static_cast<uint8_t>(id);
+    return index < TRIGGER_ID_COUNT ? TRIGGER_NAMES[index] : "UNKNOWN";
+}
+
+} // namespace OpenClaw
@@ -1,27 +1,25 @@
 /**
  * @file websocket_client.cpp
- * @brief WebSocket client implementation (stub)
+ * @brief Gateway transport implementation
  */
 
 #include "websocket_client.h"
+#include <ArduinoJson.h>
+#include <new>
 
 namespace OpenClaw {
 
 WebSocketClient* WebSocketClient::instance_ = nullptr;
 
 WebSocketClient::WebSocketClient()
-    : state_(ConnectionState::DISCONNECTED),
+    : codec_(&getMessageCodec(CodecId::BINARY_V1)),
+      state_(ConnectionState::DISCONNECTED),
       event_callback_(nullptr),
       last_connect_attempt_(0),
-      last_ping_time_(0),
-      last_pong_time_(0),
       connection_start_time_(0),
       current_reconnect_delay_(1000),
       reconnect_attempts_(0),
-      stats_mutex_(nullptr),
-      send_queue_(nullptr),
       receive_queue_(nullptr),
-      auth_sent_(false),
       auth_sent_time_(0) {
     instance_ = this;
     last_error_[0] = '\0';
@@ -34,51 +32,208 @@ WebSocketClient::~WebSocketClient() {
 
 bool WebSocketClient::begin(const WebSocketConfig& config) {
     config_ = config;
-    return createQueues() && createMutexes();
+    current_reconnect_delay_ = config_.reconnect_interval_ms;
+
+    tx_buffer_.reset(new (std::nothrow) uint8_t[WEBSOCKETS_MAX_HEADER_SIZE + CODEC_MAX_FRAME_SIZE]);
+    if (!tx_buffer_) {
+        strncpy(last_error_, "Failed to allocate send buffer", sizeof(last_error_) - 1);
+        return false;
+    }
+    return createQueues();
+}
+
+bool WebSocketClient::reconfigure(const WebSocketConfig& config) {
+    bool session_changed =
+        config.host != config_.host || config.port != config_.port ||
+        config.path != config_.path || config.use_ssl != config_.use_ssl ||
+        config.tls_fingerprint != config_.tls_fingerprint ||
+        config.api_key != config_.api_key || config.device_id != config_.device_id ||
+        config.device_name != config_.device_name;
+
+    size_t receive_queue_size = config_.receive_queue_size;
+    config_ = config;
+    config_.receive_queue_size = receive_queue_size;
+
+    if (!session_changed || state_ == ConnectionState::DISCONNECTED) {
+        if (config_.ping_interval_ms > 0) {
+            ws_client_.enableHeartbeat(config_.ping_interval_ms, config_.pong_timeout_ms, 2);
+        } else {
+            ws_client_.disableHeartbeat();
+        }
+        return false;
+    }
+    reconnect();
+    return true;
 }
 
 void WebSocketClient::end() {
     disconnect();
+    watchSocket();
     destroyQueues();
-    destroyMutexes();
+    tx_buffer_.reset();
 }
 
 bool WebSocketClient::connect() {
-    // Stub implementation
-    state_ = ConnectionState::CONNECTING;
+    if (!tx_buffer_) {
+        strncpy(last_error_, "Not initialized", sizeof(last_error_) - 1);
+        return false;
+    }
+    // Already up or on its way; reconnect() forces a new session
+    if (state_ == ConnectionState::CONNECTING || isConnected()) {
+        return true;
+    }
+
+    // A fresh start resets the backoff; a pending retry keeps it
+    if (state_ == ConnectionState::DISCONNECTED || state_ == ConnectionState::ERROR) {
+        reconnect_attempts_ = 0;
+        current_reconnect_delay_ = config_.reconnect_interval_ms;
+    }
+
+    closeSocket();
+    startAttempt();
     return true;
 }
 
 void WebSocketClient::disconnect() {
-    state_ = ConnectionState::DISCONNECTED;
+    closeSocket();
+    connection_start_time_ = 0;
+    setState(ConnectionState::DISCONNECTED);
 }
 
 void WebSocketClient::update() {
-    // Stub implementation
+    uint32_t now = millis();
+
+    switch (state_) {
+        case ConnectionState::RECONNECTING:
+            if (now - last_connect_attempt_ >= current_reconnect_delay_) {
+                startAttempt();
+            }
+            break;
+
+        case ConnectionState::CONNECTING:
+            ws_client_.loop();
+            if (state_ == ConnectionState::CONNECTING &&
+                now - last_connect_attempt_ > config_.connect_timeout_ms) {
+                handleError("Connection timed out");
+            }
+            break;
+
+        case ConnectionState::WAITING_AUTH:
+            ws_client_.loop();
+            if (state_ == ConnectionState::WAITING_AUTH &&
+                now - auth_sent_time_ > config_.connect_timeout_ms) {
+                handleError("Authentication timed out");
+            }
+            break;
+
+        case ConnectionState::AUTHENTICATED:
+            ws_client_.loop();
+            break;
+
+        default:
+            break;
+    }
+
+    watchSocket();
 }
 
-bool WebSocketClient::send(const ProtocolMessage& message) {
-    return false;
+void WebSocketClient::setNotifier(const LoopNotifier& notifier) {
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+    notifier_ = notifier;
+    if (notifier_.isAttached() && !rx_watcher_.begin(notifier_)) {
+        Serial.printf("[WS] No RX watcher (%s), polling\n", rx_watcher_.getLastError());
+    }
+#else
+    (void)notifier;
+#endif
 }
 
-bool WebSocketClient::sendText(const char* text) {
+bool WebSocketClient::isEventDriven() const {
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+    return state_ == ConnectionState::AUTHENTICATED && rx_watcher_.isWatching();
+#else
     return false;
+#endif
 }
 
-bool WebSocketClient::sendAudio(const uint8_t* data, size_t length, bool is_final) {
-    return false;
+void WebSocketClient::watchSocket() {
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+    // Hand the watcher the current socket (re-arming it: whatever it saw
+    // has just been read)
+    bool open = state_ == ConnectionState::CONNECTING ||
+                state_ == ConnectionState::WAITING_AUTH ||
+                state_ == ConnectionState::AUTHENTICATED;
+    rx_watcher_.watch(open ? ws_client_.getFd() : -1);
+
+    // More frames already buffered: come straight back for them
+    if (open && ws_client_.hasBufferedInput()) {
+        notifier_.notify();
+    }
+#endif
+}
+
+bool WebSocketClient::send(const ProtocolMessage& message) {
+    if (!isConnected()) {
+        strncpy(last_error_, "Not connected", sizeof(last_error_) - 1);
+        stats_.messages_dropped++;
+        return false;
+    }
+
+    // Encode behind the reserved header room; the library frames and
+    // masks the buffer in place
+    uint8_t* frame = tx_buffer_.get() + WEBSOCKETS_MAX_HEADER_SIZE;
+    size_t length = 0;
+    if (!codec_->encode(message, frame, CODEC_MAX_FRAME_SIZE, length)) {
+        strncpy(last_error_, "Message could not be encoded", sizeof(last_error_) - 1);
+        stats_.messages_dropped++;
+        return false;
+    }
+
+    bool sent = codec_->isText() ? ws_client_.sendTXT(tx_buffer_.get(), length, true)
+                                 : ws_client_.sendBIN(tx_buffer_.get(), length, true);
+    if (!sent) {
+        strncpy(last_error_, "Send failed", sizeof(last_error_) - 1);
+        stats_.messages_dropped++;
+        stats_.errors++;
+        return false;
+    }
+
+    stats_.messages_sent++;
+    stats_.bytes_sent += length;
+    return true;
+}
+
+bool WebSocketClient::sendText(const char* text, uint32_t turn) {
+    return send(ProtocolMessage::createText(text, config_.device_id.c_str(), turn));
+}
+
+bool WebSocketClient::sendAudio(const uint8_t* data, size_t length, bool is_final,
+                                const char* codec, uint32_t turn, const char* endpoint) {
+    return send(ProtocolMessage::createAudio(data, length, is_final, codec, turn, endpoint));
+}
+
+bool WebSocketClient::sendCommand(const char* command, uint32_t turn) {
+    return send(ProtocolMessage::createCommand(command, turn));
 }
 
 bool WebSocketClient::sendPing() {
-    return false;
+    if (!send(ProtocolMessage::createPing())) return false;
+    stats_.ping_count++;
+    return true;
 }
 
 bool WebSocketClient::receive(ProtocolMessage& message) {
-    return false;
+    ProtocolMessage* received = nullptr;
+    if (!receive_queue_ || xQueueReceive(receive_queue_, &received, 0) != pdTRUE) {
+        return false;
+    }
+    message = std::move(*received);
+    delete received;
+    return true;
 }
 
 bool WebSocketClient::isConnected() const {
-    return state_ == ConnectionState::AUTHENTICATED;
+    return state_ == ConnectionState::WAITING_AUTH || state_ == ConnectionState::AUTHENTICATED;
 }
 
 bool WebSocketClient::isAuthenticated() const {
@@ -98,7 +253,9 @@ void WebSocketClient::onEvent(WebSocketEventCallback callback) {
 }
 
 ConnectionStats WebSocketClient::getStats() const {
-    return stats_;
+    ConnectionStats stats = stats_;
+    stats.connection_duration_ms = getConnectionTime();
+    return stats;
 }
 
 void WebSocketClient::resetStats() {
@@ -106,7 +263,8 @@ void WebSocketClient::resetStats() {
 }
 
 uint32_t WebSocketClient::getConnectionTime() const {
-    return 0;
+    if (connection_start_time_ == 0) return 0;
+    return millis() - connection_start_time_;
 }
 
 void WebSocketClient::reconnect() {
@@ -115,42 +273,257 @@ void WebSocketClient::reconnect() {
 }
 
 bool WebSocketClient::createQueues() {
-    send_queue_ = xQueueCreate(config_.send_queue_size, sizeof(ProtocolMessage));
-    receive_queue_ = xQueueCreate(config_.receive_queue_size, sizeof(ProtocolMessage));
-    return send_queue_ != nullptr && receive_queue_ != nullptr;
+    if (!receive_queue_) {
+        receive_queue_ = xQueueCreate(config_.receive_queue_size, sizeof(ProtocolMessage*));
+    }
+    if (!receive_queue_) {
+        strncpy(last_error_, "Failed to create receive queue", sizeof(last_error_) - 1);
+        return false;
+    }
+    return true;
 }
 
 void WebSocketClient::destroyQueues() {
-    if (send_queue_) {
-        vQueueDelete(send_queue_);
-        send_queue_ = nullptr;
-    }
     if (receive_queue_) {
+        ProtocolMessage* pending = nullptr;
+        while (xQueueReceive(receive_queue_, &pending, 0) == pdTRUE) {
+            delete pending;
+        }
         vQueueDelete(receive_queue_);
         receive_queue_ = nullptr;
     }
 }
 
-bool WebSocketClient::createMutexes() {
-    stats_mutex_ = xSemaphoreCreateMutex();
-    return stats_mutex_ != nullptr;
+void WebSocketClient::setState(ConnectionState new_state) {
+    if (state_ == new_state) return;
+    state_ = new_state;
+    emit(WebSocketEvent::STATE_CHANGED, &state_);
 }
 
-void WebSocketClient::destroyMutexes() {
-    if (stats_mutex_) {
-        vSemaphoreDelete(stats_mutex_);
-        stats_mutex_ = nullptr;
+void WebSocketClient::emit(WebSocketEvent event, const void* data) {
+    if (event_callback_) {
+        event_callback_(event, data);
     }
 }
 
-void WebSocketClient::setState(ConnectionState new_state) {
-    state_ = new_state;
+void WebSocketClient::startAttempt() {
+    // Every attempt re-offers all codecs; the library overwrites its copy
+    // of the offer with the server's answer
+    codec_ = &getMessageCodec(CodecId::BINARY_V1);
+    last_connect_attempt_ = millis();
+    setState(ConnectionState::CONNECTING);
+
+    ws_client_.onEvent(webSocketEvent);
+    ws_client_.setReconnectInterval(config_.connect_timeout_ms);
+    if (config_.ping_interval_ms > 0) {
+        ws_client_.enableHeartbeat(config_.ping_interval_ms, config_.pong_timeout_ms, 2);
+    } else {
+        ws_client_.disableHeartbeat();
+    }
+
+    if (config_.use_ssl) {
+        // No CA is loaded; a pinned gateway is checked in handleConnect().
+        // Always a full handshake: there is no session to resume with.
+        ws_client_.beginSSL(config_.host.c_str(), config_.port, config_.path.c_str(),
+                            "", CODEC_SUBPROTOCOL_OFFER);
+    } else {
+        String host = config_.host_ip != 0 ? IPAddress(config_.host_ip).toString() : config_.host;
+        ws_client_.begin(host.c_str(), config_.port, config_.path.c_str(), CODEC_SUBPROTOCOL_OFFER);
+    }
+}
+
+void WebSocketClient::scheduleRetry() {
+    connection_start_time_ = 0;
+    if (reconnect_attempts_ < UINT8_MAX) {
+        reconnect_attempts_++;
+    }
+
+    if (config_.max_reconnect_attempts > 0 && reconnect_attempts_ >= config_.max_reconnect_attempts) {
+        setState(ConnectionState::ERROR);
+        emit(WebSocketEvent::ERROR, last_error_);
+        return;
+    }
+
+    // Exponential backoff from the base interval, capped
+    uint32_t delay = config_.reconnect_interval_ms;
+    for (uint8_t i = 1; i < reconnect_attempts_ && delay < config_.reconnect_max_interval_ms; i++) {
+        delay *= 2;
+    }
+    current_reconnect_delay_ = min(delay, config_.reconnect_max_interval_ms);
+    stats_.reconnect_count++;
+    setState(ConnectionState::RECONNECTING);
+}
+
+void WebSocketClient::closeSocket() {
+    // Our own close isn't a drop; keep the library from reporting it
+    ws_client_.onEvent(nullptr);
+    ws_client_.disconnect();
+    ws_client_.onEvent(webSocketEvent);
+}
+
+void WebSocketClient::handleConnect() {
+    stats_.handshake_ms = millis() - last_connect_attempt_;
+
+    // Check the pin before the API key goes out
+    const String& pin = config_.tls_fingerprint;
+    if (config_.use_ssl && pin.length() > 0 && !ws_client_.verifyPeer(pin.c_str())) {
+        handleError("Gateway certificate does not match pin");
+        return;
+    }
+
+    codec_ = &getMessageCodec(ws_client_.getSubprotocol());
+    connection_start_time_ = millis();
+    sendAuthMessage();
+    emit(WebSocketEvent::CONNECTED, codec_);
+}
+
+void WebSocketClient::handleDisconnect() {
+    // Drops only; our own closes are not reported (closeSocket)
+    if (!isConnected()) return;
+
+    strncpy(last_error_, "Connection closed", sizeof(last_error_) - 1);
+    scheduleRetry();
+    emit(WebSocketEvent::DISCONNECTED);
+}
+
+void WebSocketClient::handleMessage(const uint8_t* data, size_t length, bool is_text) {
+    stats_.bytes_received += length;
+
+    // Decode by frame type: a JSON gateway answers in text whatever was
+    // offered, and both binary versions share one decoder
+    const MessageCodec& codec = getMessageCodec(is_text ? CodecId::JSON : CodecId::BINARY_V2);
+    std::unique_ptr<ProtocolMessage> message(new (std::nothrow) ProtocolMessage());
+    if (!message || !codec.decode(data, length, *message)) {
+        strncpy(last_error_, "Malformed message", sizeof(last_error_) - 1);
+        stats_.errors++;
+        return;
+    }
+    stats_.messages_received++;
+
+    switch (message->getType()) {
+        case MessageType::AUTH_RESPONSE:
+            handleAuthResponse(*message);
+            return;
+
+        case MessageType::PONG:
+            stats_.pong_count++;
+            return;
+
+        default:
+            break;
+    }
+
+    if (state_ != ConnectionState::AUTHENTICATED) return;
+
+    ProtocolMessage* queued = message.release();
+    if (xQueueSend(receive_queue_, &queued, 0) != pdTRUE) {
+        delete queued;
+        stats_.messages_dropped++;
+    }
+}
+
+void WebSocketClient::handleError(const char* error) {
+    strncpy(last_error_, error, sizeof(last_error_) - 1);
+    stats_.errors++;
+    closeSocket();
+    scheduleRetry();
+}
+
+void WebSocketClient::handleAuthResponse(const ProtocolMessage& msg) {
+    if (state_ != ConnectionState::WAITING_AUTH) return;
+
+    JsonDocument doc;
+    String json;
+    if (msg.getJsonPayload(json)) {
+        deserializeJson(doc, json);
+    }
+
+    if (doc["success"] | false) {
+        reconnect_attempts_ = 0;
+        current_reconnect_delay_ = config_.reconnect_interval_ms;
+        setState(ConnectionState::AUTHENTICATED);
+        emit(WebSocketEvent::AUTHENTICATED);
+        return;
+    }
+
+    // Retrying with the same credentials won't help
+    strncpy(last_error_, doc["error"] | "Authentication failed", sizeof(last_error_) - 1);
+    closeSocket();
+    connection_start_time_ = 0;
+    setState(ConnectionState::ERROR);
+    emit(WebSocketEvent::AUTH_FAILED, last_error_);
+}
+
+void WebSocketClient::sendAuthMessage() {
+    setState(ConnectionState::WAITING_AUTH);
+    auth_sent_time_ = millis();
+
+    send(ProtocolMessage::createAuth(config_.device_id.c_str(), config_.device_name.c_str(),
+                                     config_.firmware_version.c_str(), config_.api_key.c_str()));
 }
 
 void WebSocketClient::webSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
-    // Stub
+    if (!instance_) return;
+
+    switch (type) {
+        case WStype_CONNECTED:
+            instance_->handleConnect();
+            break;
+
+        case WStype_DISCONNECTED:
+            instance_->handleDisconnect();
+            break;
+
+        case WStype_TEXT:
+            instance_->handleMessage(payload, length, true);
+            break;
+
+        case WStype_BIN:
+            instance_->handleMessage(payload, length, false);
+            break;
+
+        case WStype_ERROR:
+            instance_->handleError("WebSocket error");
+            break;
+
+        case WStype_PING:
+            instance_->stats_.ping_count++;
+            break;
+
+        case WStype_PONG:
+            instance_->stats_.pong_count++;
+            break;
+
+        default:
+            break;
+    }
 }
 
+// =============================================================================
+// GatewaySocket
+// =============================================================================
+
+#ifndef OPENCLAW_LOOPBACK_GATEWAY
+bool GatewaySocket::verifyPeer(const char* fingerprint) {
+    if (!fingerprint || !_client.isSSL || !_client.ssl) return false;
+    return _client.ssl->verify(fingerprint, nullptr);
+}
+
+int GatewaySocket::getFd() const {
+    // WiFiClientSecure reports its TLS socket; -1 (polled) if it can't
+    if (_client.isSSL && _client.ssl) return _client.ssl->fd();
+    return _client.tcp ? _client.tcp->fd() : -1;
+}
+
+bool GatewaySocket::hasBufferedInput() const {
+    return _client.tcp && _client.tcp->available() > 0;
+}
+#endif
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
 const char* connectionStateToString(ConnectionState state) {
     switch (state) {
         case ConnectionState::DISCONNECTED: return "DISCONNECTED";
@@ -169,7 +542,6 @@ const char* webSocketEventToString(WebSocketEvent event) {
         case WebSocketEvent::DISCONNECTED: return "DISCONNECTED";
         case WebSocketEvent::AUTHENTICATED: return "AUTHENTICATED";
         case WebSocketEvent::AUTH_FAILED: return "AUTH_FAILED";
-        case WebSocketEvent::MESSAGE_RECEIVED: return "MESSAGE_RECEIVED";
         case WebSocketEvent::ERROR: return "ERROR";
         case WebSocketEvent::STATE_CHANGED: return "STATE_CHANGED";
         default: return "UNKNOWN";
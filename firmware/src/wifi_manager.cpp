@@ -0,0 +1,714 @@
+/**
+ * @file wifi_manager.cpp
+ * @brief Asynchronous WiFi manager implementation
+ */
+
+#include "wifi_manager.h"
+#include <esp_wifi.h>
+#include <esp_netif.h>
+#include <esp_netif_net_stack.h>
+#include <lwip/dhcp.h>
+#include <lwip/dns.h>
+#include <lwip/tcpip.h>
+#include <cstring>
+
+namespace OpenClaw {
+
+WiFiManager* WiFiManager::instance_ = nullptr;
+
+// Joins: the cached BSSID/channel is tried first, then a full join
+static constexpr uint8_t FAST_PATH_ATTEMPTS = 1;
+static constexpr uint8_t ATTEMPTS_PER_NETWORK = 3;
+static constexpr uint32_t FAST_ATTEMPT_TIMEOUT_MS = 3000;
+static constexpr uint32_t ATTEMPT_TIMEOUT_MS = 12000;
+
+// Back-off between rounds (a round = every known network tried)
+static constexpr uint32_t RETRY_BASE_MS = 1000;
+static constexpr uint32_t RETRY_MAX_MS = 30000;
+
+// Ranking
+static constexpr uint32_t SCAN_EXPIRY_MS = 5 * 60 * 1000;
+static constexpr int FAILURE_PENALTY_DB = 10;
+static constexpr int UNSEEN_SCORE = -127;
+
+static constexpr uint32_t SCAN_DWELL_MS = 120;     // Per channel
+static constexpr size_t EVENT_QUEUE_SIZE = 8;
+
+// Queued by the lwIP thread when a lookup ends; not a system event id
+static constexpr arduino_event_id_t EVENT_HOST_RESOLVED = ARDUINO_EVENT_MAX;
+
+// =============================================================================
+// Scan Entries
+// =============================================================================
+
+int8_t WiFiScanEntry::getRssi() const {
+    if (rssi_count == 0) return UNSEEN_SCORE;
+    return rssi_history[(rssi_head + WIFI_RSSI_HISTORY - 1) % WIFI_RSSI_HISTORY];
+}
+
+int8_t WiFiScanEntry::getAverageRssi() const {
+    if (rssi_count == 0) return UNSEEN_SCORE;
+    int sum = 0;
+    for (uint8_t i = 0; i < rssi_count; i++) {
+        sum += rssi_history[i];
+    }
+    return (int8_t)(sum / rssi_count);
+}
+
+// =============================================================================
+// WiFiManager
+// =============================================================================
+
+WiFiManager::WiFiManager()
+    : network_count_(0),
+      scan_count_(0),
+      scanning_(false),
+      state_(WiFiLinkState::IDLE),
+      target_(0),
+      attempt_(0),
+      round_(0),
+      fast_attempt_(false),
+      static_ip_(false),
+      last_join_fast_(false),
+      lease_renew_s_(0),
+      link_lost_ms_(0),
+      last_assoc_ms_(0),
+      last_join_ms_(0),
+      reconnect_count_(0),
+      timers_(nullptr),
+      attempt_timer_(INVALID_TIMER_ID),
+      retry_timer_(INVALID_TIMER_ID),
+      renew_timer_(INVALID_TIMER_ID),
+      resolved_ip_(0),
+      resolving_(false),
+      event_queue_(nullptr),
+      event_handle_(0),
+      event_callback_(nullptr) {
+    memset(networks_, 0, sizeof(networks_));
+    memset(rank_, 0, sizeof(rank_));
+    memset(scan_cache_, 0, sizeof(scan_cache_));
+    resolve_host_[0] = '\0';
+    last_error_[0] = '\0';
+}
+
+WiFiManager::~WiFiManager() {
+    end();
+}
+
+bool WiFiManager::begin(TimerWheel* timers) {
+    if (event_queue_) return true;
+
+    timers_ = timers;
+    event_queue_ = xQueueCreate(EVENT_QUEUE_SIZE, sizeof(SystemEvent));
+    if (!event_queue_) {
+        strncpy(last_error_, "Failed to create event queue", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    // Retries are ours: the core's own reconnect would race the fast path
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+    WiFi.mode(WIFI_STA);
+
+    instance_ = this;
+    event_handle_ = WiFi.onEvent(systemEventHandler);
+    return true;
+}
+
+void WiFiManager::end() {
+    if (!event_queue_) return;
+
+    disconnect();
+    WiFi.removeEvent(event_handle_);
+    instance_ = nullptr;
+    vQueueDelete(event_queue_);
+    event_queue_ = nullptr;
+}
+
+bool WiFiManager::addNetwork(const char* ssid, const char* password) {
+    size_t ssid_len = ssid ? strlen(ssid) : 0;
+    if (ssid_len == 0 || ssid_len > WIFI_SSID_MAX) {
+        strncpy(last_error_, "Invalid SSID", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    for (size_t i = 0; i < network_count_; i++) {
+        if (strcmp(networks_[i].ssid, ssid) == 0) {
+            strlcpy(networks_[i].password, password ? password : "", sizeof(networks_[i].password));
+            networks_[i].failures = 0;
+            return true;
+        }
+    }
+
+    if (network_count_ >= WIFI_MAX_NETWORKS) {
+        strncpy(last_error_, "Too many networks", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    WiFiNetworkProfile& network = networks_[network_count_];
+    memset(&network, 0, sizeof(network));
+    strlcpy(network.ssid, ssid, sizeof(network.ssid));
+    strlcpy(network.password, password ? password : "", sizeof(network.password));
+    rank_[network_count_] = network_count_;
+    network_count_++;
+    return true;
+}
+
+void WiFiManager::clearNetworks() {
+    disconnect();
+    network_count_ = 0;
+}
+
+const WiFiNetworkProfile* WiFiManager::getNetwork(size_t index) const {
+    return index < network_count_ ? &networks_[index] : nullptr;
+}
+
+bool WiFiManager::setFastPath(const char* ssid, const uint8_t* bssid, uint8_t channel) {
+    WiFiNetworkProfile* network = findNetwork(ssid);
+    if (!network || !bssid || channel == 0) return false;
+
+    memcpy(network->bssid, bssid, sizeof(network->bssid));
+    network->channel = channel;
+    network->has_fast_path = true;
+    return true;
+}
+
+bool WiFiManager::setCachedLease(const char* ssid, const WiFiLease& lease) {
+    // Only fast joins use a lease: same AP, so the same subnet
+    WiFiNetworkProfile* network = findNetwork(ssid);
+    if (!network || !network->has_fast_path || lease.ip == 0) return false;
+
+    network->lease = lease;
+    network->has_lease = true;
+    return true;
+}
+
+bool WiFiManager::getLease(WiFiLease& lease) const {
+    if (!isConnected() || static_ip_) return false;
+
+    esp_netif_t* netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    struct netif* lwip_netif = netif ? static_cast<struct netif*>(esp_netif_get_netif_impl(netif)) : nullptr;
+    const struct dhcp* dhcp = lwip_netif ? netif_dhcp_data(lwip_netif) : nullptr;
+    if (!dhcp || dhcp->offered_t1_renew == 0) return false;
+
+    lease.ip = WiFi.localIP();
+    lease.gateway = WiFi.gatewayIP();
+    lease.subnet = WiFi.subnetMask();
+    lease.dns = WiFi.dnsIP(0);
+    lease.renew_s = dhcp->offered_t1_renew;
+    return true;
+}
+
+bool WiFiManager::connect() {
+    if (!event_queue_) {
+        strncpy(last_error_, "WiFiManager not initialized", sizeof(last_error_) - 1);
+        return false;
+    }
+    if (network_count_ == 0) {
+        strncpy(last_error_, "No networks configured", sizeof(last_error_) - 1);
+        return false;
+    }
+    if (state_ != WiFiLinkState::IDLE) {
+        return true;
+    }
+
+    rankNetworks();
+    target_ = 0;
+    attempt_ = 0;
+    round_ = 0;
+    link_lost_ms_ = millis();
+    setState(WiFiLinkState::CONNECTING);
+    startAttempt();
+    return true;
+}
+
+void WiFiManager::disconnect() {
+    if (timers_) {
+        timers_->cancel(&attempt_timer_);
+        timers_->cancel(&retry_timer_);
+        timers_->cancel(&renew_timer_);
+    }
+
+    bool was_connected = state_ == WiFiLinkState::CONNECTED;
+    if (state_ != WiFiLinkState::IDLE) {
+        // Set first, so the resulting disconnect event is ignored
+        setState(WiFiLinkState::IDLE);
+        WiFi.disconnect();
+    }
+    if (was_connected) {
+        emit(WiFiManagerEvent::DISCONNECTED);
+    }
+}
+
+bool WiFiManager::startScan() {
+    if (scanning_) return true;
+
+    // The radio can't leave the channel mid-association
+    if (state_ == WiFiLinkState::CONNECTING || state_ == WiFiLinkState::RECONNECTING) {
+        strncpy(last_error_, "Busy connecting", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    int16_t result = WiFi.scanNetworks(true, false, false, SCAN_DWELL_MS);
+    if (result == WIFI_SCAN_FAILED) {
+        strncpy(last_error_, "Scan failed to start", sizeof(last_error_) - 1);
+        return false;
+    }
+    scanning_ = true;
+    return true;
+}
+
+void WiFiManager::renewLease() {
+    if (state_ == WiFiLinkState::CONNECTED && static_ip_) {
+        // Handled as a link drop; the fast rejoin then runs DHCP
+        WiFi.disconnect();
+    }
+}
+
+bool WiFiManager::resolveHost(const char* host) {
+    size_t host_len = host ? strlen(host) : 0;
+    if (host_len == 0 || host_len > WIFI_HOST_MAX) {
+        strncpy(last_error_, "Invalid host name", sizeof(last_error_) - 1);
+        return false;
+    }
+    if (resolving_ || !event_queue_) {
+        strncpy(last_error_, "Lookup already running", sizeof(last_error_) - 1);
+        return false;
+    }
+
+    // lwIP's DNS client is only safe to call from the lwIP thread
+    strlcpy(resolve_host_, host, sizeof(resolve_host_));
+    resolved_ip_ = 0;
+    resolving_ = true;
+    if (tcpip_callback(startLookup, this) != ERR_OK) {
+        resolving_ = false;
+        strncpy(last_error_, "Failed to start lookup", sizeof(last_error_) - 1);
+        return false;
+    }
+    return true;
+}
+
+const WiFiScanEntry* WiFiManager::getScanEntry(size_t index) const {
+    return index < scan_count_ ? &scan_cache_[index] : nullptr;
+}
+
+void WiFiManager::update() {
+    if (!event_queue_) return;
+
+    SystemEvent event;
+    while (xQueueReceive(event_queue_, &event, 0) == pdTRUE) {
+        if (event.id == EVENT_HOST_RESOLVED) {
+            resolving_ = false;
+            resolved_ip_ = event.address;
+            emit(WiFiManagerEvent::HOST_RESOLVED);
+            continue;
+        }
+
+        switch (event.id) {
+            case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+                if (state_ == WiFiLinkState::CONNECTING || state_ == WiFiLinkState::RECONNECTING) {
+                    last_assoc_ms_ = millis() - link_lost_ms_;
+                }
+                break;
+
+            case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                handleGotIp();
+                break;
+
+            case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+                handleDisconnected(event.reason);
+                break;
+
+            case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+                // DHCP lease gone while still associated
+                if (state_ == WiFiLinkState::CONNECTED) {
+                    handleDisconnected(0);
+                }
+                break;
+
+            case ARDUINO_EVENT_WIFI_SCAN_DONE:
+                handleScanDone();
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+const char* WiFiManager::getSsid() const {
+    if (state_ == WiFiLinkState::IDLE || network_count_ == 0) return "";
+    return networks_[rank_[target_]].ssid;
+}
+
+int8_t WiFiManager::getRssi() const {
+    return isConnected() ? (int8_t)WiFi.RSSI() : 0;
+}
+
+// =============================================================================
+// Private
+// =============================================================================
+
+void WiFiManager::setState(WiFiLinkState state) {
+    if (state_ == state) return;
+    state_ = state;
+    emit(WiFiManagerEvent::STATE_CHANGED);
+}
+
+void WiFiManager::emit(WiFiManagerEvent event) {
+    if (event_callback_) {
+        event_callback_(event);
+    }
+}
+
+int WiFiManager::scoreNetwork(const WiFiNetworkProfile& network) const {
+    uint32_t now = millis();
+    int best = UNSEEN_SCORE;
+    for (size_t i = 0; i < scan_count_; i++) {
+        const WiFiScanEntry& entry = scan_cache_[i];
+        if (now - entry.last_seen_ms < SCAN_EXPIRY_MS &&
+            strcmp(entry.ssid, network.ssid) == 0 &&
+            entry.getAverageRssi() > best) {
+            best = entry.getAverageRssi();
+        }
+    }
+    return best - network.failures * FAILURE_PENALTY_DB;
+}
+
+void WiFiManager::rankNetworks() {
+    int scores[WIFI_MAX_NETWORKS];
+    for (size_t i = 0; i < network_count_; i++) {
+        rank_[i] = i;
+        scores[i] = scoreNetwork(networks_[i]);
+    }
+
+    // Insertion sort: best score first, most recently joined breaks ties
+    for (size_t i = 1; i < network_count_; i++) {
+        uint8_t index = rank_[i];
+        size_t j = i;
+        while (j > 0) {
+            uint8_t prev = rank_[j - 1];
+            bool better = scores[index] > scores[prev] ||
+                          (scores[index] == scores[prev] &&
+                           networks_[index].last_connected_ms > networks_[prev].last_connected_ms);
+            if (!better) break;
+            rank_[j] = prev;
+            j--;
+        }
+        rank_[j] = index;
+    }
+}
+
+void WiFiManager::startAttempt() {
+    WiFiNetworkProfile& network = currentNetwork();
+    fast_attempt_ = network.has_fast_path && attempt_ < FAST_PATH_ATTEMPTS;
+
+    // A cached lease is good for one fast join; everything else uses DHCP
+    bool use_lease = fast_attempt_ && network.has_lease;
+    network.has_lease = false;
+    if (use_lease) {
+        WiFi.config(IPAddress(network.lease.ip), IPAddress(network.lease.gateway),
+                    IPAddress(network.lease.subnet), IPAddress(network.lease.dns));
+        lease_renew_s_ = network.lease.renew_s;
+    } else if (static_ip_) {
+        WiFi.config(IPAddress(), IPAddress(), IPAddress());   // Back to DHCP
+    }
+    static_ip_ = use_lease;
+
+    if (fast_attempt_) {
+        // Known AP: no channel scan, straight to authentication
+        WiFi.begin(network.ssid, network.password, network.channel, network.bssid, true);
+    } else {
+        WiFi.begin(network.ssid, network.password);
+    }
+
+    if (timers_) {
+        timers_->cancel(&attempt_timer_);
+        attempt_timer_ = timers_->schedule(fast_attempt_ ? FAST_ATTEMPT_TIMEOUT_MS : ATTEMPT_TIMEOUT_MS,
+                                           attemptTimeout, this);
+    }
+}
+
+void WiFiManager::attemptFailed(uint8_t reason) {
+    if (timers_) timers_->cancel(&attempt_timer_);
+
+    WiFiNetworkProfile& network = currentNetwork();
+    if (reason == WIFI_REASON_AUTH_FAIL || reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT ||
+        reason == WIFI_REASON_HANDSHAKE_TIMEOUT) {
+        if (network.failures < 0xFF) network.failures++;
+    }
+
+    // Next attempt on this network, else the next-ranked one
+    bool round_done = false;
+    if (++attempt_ >= ATTEMPTS_PER_NETWORK) {
+        attempt_ = 0;
+        if (++target_ >= network_count_) {
+            target_ = 0;
+            if (round_ < 0xFF) round_++;
+            round_done = true;
+            rankNetworks();
+        }
+    }
+
+    if (!round_done || !timers_) {
+        startAttempt();
+        return;
+    }
+
+    uint32_t shift = round_ - 1 < 5 ? round_ - 1 : 5;
+    uint32_t delay_ms = RETRY_BASE_MS << shift;
+    if (delay_ms > RETRY_MAX_MS) delay_ms = RETRY_MAX_MS;
+
+    setState(WiFiLinkState::BACKOFF);
+    WiFi.disconnect();
+    timers_->cancel(&retry_timer_);
+    retry_timer_ = timers_->schedule(delay_ms, retryTimer, this);
+}
+
+void WiFiManager::handleGotIp() {
+    if (state_ == WiFiLinkState::IDLE || state_ == WiFiLinkState::CONNECTED) return;
+    if (timers_) {
+        timers_->cancel(&attempt_timer_);
+        timers_->cancel(&retry_timer_);
+    }
+
+    // Remember exactly where we landed for the next fast reconnect
+    WiFiNetworkProfile& network = currentNetwork();
+    const uint8_t* bssid = WiFi.BSSID();
+    if (bssid) {
+        memcpy(network.bssid, bssid, sizeof(network.bssid));
+        network.channel = WiFi.channel();
+        network.has_fast_path = true;
+    }
+    network.failures = 0;
+    network.last_connected_ms = millis();
+
+    last_join_ms_ = millis() - link_lost_ms_;
+    last_join_fast_ = fast_attempt_;
+    attempt_ = 0;
+    round_ = 0;
+
+    // Nobody renews a cached lease; rejoin through DHCP when it is due
+    if (static_ip_ && timers_) {
+        uint32_t renew_ms = lease_renew_s_ < UINT32_MAX / 1000 ? lease_renew_s_ * 1000 : UINT32_MAX;
+        timers_->cancel(&renew_timer_);
+        renew_timer_ = timers_->schedule(renew_ms, renewTimer, this);
+    }
+
+    setState(WiFiLinkState::CONNECTED);
+    emit(WiFiManagerEvent::CONNECTED);
+}
+
+void WiFiManager::handleDisconnected(uint8_t reason) {
+    switch (state_) {
+        case WiFiLinkState::IDLE:
+        case WiFiLinkState::BACKOFF:
+            // Our own disconnect()
+            return;
+
+        case WiFiLinkState::CONNECTED:
+            // AP blip: go straight back to the same AP, no back-off
+            if (timers_) timers_->cancel(&renew_timer_);
+            link_lost_ms_ = millis();
+            reconnect_count_++;
+            attempt_ = 0;
+            round_ = 0;
+            setState(WiFiLinkState::RECONNECTING);
+            emit(WiFiManagerEvent::DISCONNECTED);
+            startAttempt();
+            return;
+
+        case WiFiLinkState::CONNECTING:
+        case WiFiLinkState::RECONNECTING:
+            // A new begin() drops the previous attempt with ASSOC_LEAVE
+            if (reason != WIFI_REASON_ASSOC_LEAVE) {
+                attemptFailed(reason);
+            }
+            return;
+    }
+}
+
+void WiFiManager::handleScanDone() {
+    int16_t count = WiFi.scanComplete();
+    if (count >= 0) {
+        mergeScanResults(count);
+    }
+    WiFi.scanDelete();
+    scanning_ = false;
+    emit(WiFiManagerEvent::SCAN_DONE);
+}
+
+void WiFiManager::mergeScanResults(int16_t count) {
+    uint32_t now = millis();
+
+    for (int16_t i = 0; i < count; i++) {
+        String ssid = WiFi.SSID(i);
+        const uint8_t* bssid = WiFi.BSSID(i);
+        if (ssid.length() == 0 || !bssid) continue;     // Hidden network
+
+        // Same AP as before, a free slot, or the longest-unseen entry
+        WiFiScanEntry* entry = nullptr;
+        for (size_t j = 0; j < scan_count_; j++) {
+            if (memcmp(scan_cache_[j].bssid, bssid, 6) == 0) {
+                entry = &scan_cache_[j];
+                break;
+            }
+        }
+        if (!entry && scan_count_ < WIFI_SCAN_CACHE_SIZE) {
+            entry = &scan_cache_[scan_count_++];
+            memset(entry, 0, sizeof(*entry));
+        }
+        if (!entry) {
+            entry = &scan_cache_[0];
+            for (size_t j = 1; j < scan_count_; j++) {
+                if (scan_cache_[j].last_seen_ms < entry->last_seen_ms) entry = &scan_cache_[j];
+            }
+            memset(entry, 0, sizeof(*entry));
+        }
+
+        strlcpy(entry->ssid, ssid.c_str(), sizeof(entry->ssid));
+        memcpy(entry->bssid, bssid, sizeof(entry->bssid));
+        entry->channel = WiFi.channel(i);
+        entry->encryption = WiFi.encryptionType(i);
+        entry->rssi_history[entry->rssi_head] = (int8_t)WiFi.RSSI(i);
+        entry->rssi_head = (entry->rssi_head + 1) % WIFI_RSSI_HISTORY;
+        if (entry->rssi_count < WIFI_RSSI_HISTORY) entry->rssi_count++;
+        entry->last_seen_ms = now;
+    }
+
+    // Drop stale APs, then order strongest first
+    size_t kept = 0;
+    for (size_t j = 0; j < scan_count_; j++) {
+        if (now - scan_cache_[j].last_seen_ms < SCAN_EXPIRY_MS) {
+            if (kept != j) scan_cache_[kept] = scan_cache_[j];
+            kept++;
+        }
+    }
+    scan_count_ = kept;
+
+    for (size_t i = 1; i < scan_count_; i++) {
+        WiFiScanEntry entry = scan_cache_[i];
+        size_t j = i;
+        while (j > 0 && scan_cache_[j - 1].getAverageRssi() < entry.getAverageRssi()) {
+            scan_cache_[j] = scan_cache_[j - 1];
+            j--;
+        }
+        scan_cache_[j] = entry;
+    }
+}
+
+WiFiNetworkProfile* WiFiManager::findNetwork(const char* ssid) {
+    if (!ssid) return nullptr;
+    for (size_t i = 0; i < network_count_; i++) {
+        if (strcmp(networks_[i].ssid, ssid) == 0) return &networks_[i];
+    }
+    return nullptr;
+}
+
+void WiFiManager::systemEventHandler(arduino_event_t* event) {
+    // Event task context: queue and wake the main loop
+    WiFiManager* self = instance_;
+    if (!self || !self->event_queue_) return;
+
+    SystemEvent queued;
+    queued.id = event->event_id;
+    queued.reason = 0;
+    queued.address = 0;
+
+    switch (event->event_id) {
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            queued.reason = event->event_info.wifi_sta_disconnected.reason;
+            break;
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+        case ARDUINO_EVENT_WIFI_SCAN_DONE:
+            break;
+        default:
+            return;
+    }
+
+    if (xQueueSend(self->event_queue_, &queued, 0) == pdTRUE) {
+        self->notifier_.notify();
+    }
+}
+
+void WiFiManager::attemptTimeout(void* ctx) {
+    WiFiManager* self = static_cast<WiFiManager*>(ctx);
+    self->attempt_timer_ = INVALID_TIMER_ID;
+    if (self->state_ == WiFiLinkState::CONNECTING || self->state_ == WiFiLinkState::RECONNECTING) {
+        WiFi.disconnect();  // Abort; the ASSOC_LEAVE it causes is ignored
+        self->attemptFailed(WIFI_REASON_NO_AP_FOUND);
+    }
+}
+
+void WiFiManager::retryTimer(void* ctx) {
+    WiFiManager* self = static_cast<WiFiManager*>(ctx);
+    self->retry_timer_ = INVALID_TIMER_ID;
+    if (self->state_ == WiFiLinkState::BACKOFF) {
+        self->setState(WiFiLinkState::RECONNECTING);
+        self->startAttempt();
+    }
+}
+
+void WiFiManager::renewTimer(void* ctx) {
+    WiFiManager* self = static_cast<WiFiManager*>(ctx);
+    self->renew_timer_ = INVALID_TIMER_ID;
+    self->renewLease();
+}
+
+void WiFiManager::startLookup(void* ctx) {
+    // lwIP thread
+    WiFiManager* self = static_cast<WiFiManager*>(ctx);
+    ip_addr_t address;
+    err_t err = dns_gethostbyname_addrtype(self->resolve_host_, &address, lookupDone, self,
+                                           LWIP_DNS_ADDRTYPE_IPV4);
+    if (err == ERR_OK) {
+        lookupDone(self->resolve_host_, &address, self);   // Cached or a literal address
+    } else if (err != ERR_INPROGRESS) {
+        lookupDone(self->resolve_host_, nullptr, self);
+    }
+}
+
+void WiFiManager::lookupDone(const char*, const ip_addr_t* address, void* ctx) {
+    // lwIP thread: queue the result like a system event
+    WiFiManager* self = static_cast<WiFiManager*>(ctx);
+    if (!self->event_queue_) return;
+
+    SystemEvent queued;
+    queued.id = EVENT_HOST_RESOLVED;
+    queued.reason = 0;
+    queued.address = (address && IP_IS_V4(address)) ? ip4_addr_get_u32(ip_2_ip4(address)) : 0;
+
+    if (xQueueSend(self->event_queue_, &queued, 0) == pdTRUE) {
+        self->notifier_.notify();
+    }
+}
+
+// =============================================================================
+// Utility Functions
+// =============================================================================
+
+const char* wifiLinkStateToString(WiFiLinkState state) {
+    switch (state) {
+        case WiFiLinkState::IDLE: return "IDLE";
+        case WiFiLinkState::CONNECTING: return "CONNECTING";
+        case WiFiLinkState::CONNECTED: return "CONNECTED";
+        case WiFiLinkState::RECONNECTING: return "RECONNECTING";
+        case WiFiLinkState::BACKOFF: return "BACKOFF";
+        default: return "UNKNOWN";
+    }
+}
+
+const char* wifiManagerEventToString(WiFiManagerEvent event) {
+    switch (event) {
+        case WiFiManagerEvent::STATE_CHANGED: return "STATE_CHANGED";
+        case WiFiManagerEvent::CONNECTED: return "CONNECTED";
+        case WiFiManagerEvent::DISCONNECTED: return "DISCONNECTED";
+        case WiFiManagerEvent::SCAN_DONE: return "SCAN_DONE";
+        case WiFiManagerEvent::HOST_RESOLVED: return "HOST_RESOLVED";
+        default: return "UNKNOWN";
+    }
+}
+
+} // namespace OpenClaw
@@ -0,0 +1,147 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core, for the native test env
+ *
+ * Only what the host-built modules use. Time is a fake clock that the
+ * tests move forward (HostClock::advance), so timer-driven code runs
+ * deterministically and as fast as the host allows.
+ */
+
+#ifndef OPENCLAW_HOST_ARDUINO_H
+#define OPENCLAW_HOST_ARDUINO_H
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using std::max;
+using std::min;
+
+namespace HostClock {
+inline uint32_t now_ms = 0;
+
+inline void set(uint32_t ms) { now_ms = ms; }
+inline void advance(uint32_t ms) { now_ms += ms; }
+} // namespace HostClock
+
+inline uint32_t millis() { return HostClock::now_ms; }
+inline uint32_t micros() { return HostClock::now_ms * 1000; }
+inline void delay(uint32_t ms) { HostClock::advance(ms); }
+inline void yield() {}
+
+// Arduino String over std::string; enough for the host-built modules
+// and ArduinoJson's String reader/writer
+class String {
+public:
+    String() {}
+    String(const char* s) : s_(s ? s : "") {}
+    String(const char* s, size_t length) : s_(s, length) {}
+    String(const std::string& s) : s_(s) {}
+    explicit String(char c) : s_(1, c) {}
+    explicit String(int v) : s_(std::to_string(v)) {}
+    explicit String(unsigned int v) : s_(std::to_string(v)) {}
+    explicit String(long v) : s_(std::to_string(v)) {}
+    explicit String(unsigned long v) : s_(std::to_string(v)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    size_t length() const { return s_.size(); }
+    bool isEmpty() const { return s_.empty(); }
+    bool reserve(size_t size) { s_.reserve(size); return true; }
+    char operator[](size_t i) const { return i < s_.size() ? s_[i] : 0; }
+    char charAt(size_t i) const { return (*this)[i]; }
+
+    bool concat(const char* s) { if (s) s_ += s; return true; }
+    bool concat(const String& s) { s_ += s.s_; return true; }
+    bool concat(char c) { s_ += c; return true; }
+    String& operator+=(const char* s) { concat(s); return *this; }
+    String& operator+=(const String& s) { concat(s); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+
+    bool equals(const String& o) const { return s_ == o.s_; }
+    bool operator==(const String& o) const { return s_ == o.s_; }
+    bool operator==(const char* o) const { return s_ == (o ? o : ""); }
+    bool operator!=(const String& o) const { return s_ != o.s_; }
+    bool operator!=(const char* o) const { return !(*this == o); }
+    bool startsWith(const String& p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+    bool endsWith(const String& p) const {
+        return s_.size() >= p.s_.size() && s_.compare(s_.size() - p.s_.size(), p.s_.size(), p.s_) == 0;
+    }
+
+    int indexOf(char c, size_t from = 0) const {
+        size_t i = s_.find(c, from);
+        return i == std::string::npos ? -1 : int(i);
+    }
+    int indexOf(const String& p, size_t from = 0) const {
+        size_t i = s_.find(p.s_, from);
+        return i == std::string::npos ? -1 : int(i);
+    }
+    String substring(size_t from) const { return from < s_.size() ? String(s_.substr(from)) : String(); }
+    String substring(size_t from, size_t to) const {
+        return from < to && from < s_.size() ? String(s_.substr(from, to - from)) : String();
+    }
+    void remove(size_t index) { if (index < s_.size()) s_.erase(index); }
+    void remove(size_t index, size_t count) { if (index < s_.size()) s_.erase(index, count); }
+    long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+
+private:
+    std::string s_;
+};
+
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const String& a, const String& b) {
+    String r(a);
+    r += b;
+    return r;
+}
+inline StringSumHelper operator+(const String& a, const char* b) { return a + String(b); }
+inline StringSumHelper operator+(const char* a, const String& b) { return String(a) + b; }
+
+// Serial writes to stdout
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+    int printf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        int n = vprintf(format, args);
+        va_end(args);
+        return n;
+    }
+    size_t print(const char* s) { return fputs(s, stdout) >= 0 ? strlen(s) : 0; }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t println(const char* s = "") { size_t n = print(s); putchar('\n'); return n + 1; }
+    size_t println(const String& s) { return println(s.c_str()); }
+};
+
+inline HostSerial Serial;
+
+// IPv4 address, stored in network order like the core's
+class IPAddress {
+public:
+    IPAddress() : address_(0) {}
+    IPAddress(uint32_t address) : address_(address) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : address_(uint32_t(a) | uint32_t(b) << 8 | uint32_t(c) << 16 | uint32_t(d) << 24) {}
+
+    operator uint32_t() const { return address_; }
+    uint8_t operator[](int index) const { return uint8_t(address_ >> (8 * index)); }
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+        return String(text);
+    }
+
+private:
+    uint32_t address_;
+};
+
+#endif // OPENCLAW_HOST_ARDUINO_H
@@ -0,0 +1,105 @@
+/**
+ * @file LittleFS.h
+ * @brief Host stand-in for LittleFS: an in-memory file system
+ *
+ * Files live in a map for the life of the process; format() empties it.
+ * Only the File calls the host-built modules use are provided.
+ */
+
+#ifndef OPENCLAW_HOST_LITTLEFS_H
+#define OPENCLAW_HOST_LITTLEFS_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class File {
+public:
+    File() : pos_(0) {}
+    File(std::shared_ptr<std::vector<uint8_t>> data, bool append)
+        : data_(data), pos_(append ? data->size() : 0) {}
+
+    operator bool() const { return data_ != nullptr; }
+
+    size_t read(uint8_t* buffer, size_t length) {
+        if (!data_ || pos_ >= data_->size()) return 0;
+        size_t n = std::min(length, data_->size() - pos_);
+        memcpy(buffer, data_->data() + pos_, n);
+        pos_ += n;
+        return n;
+    }
+
+    size_t write(const uint8_t* buffer, size_t length) {
+        if (!data_) return 0;
+        if (pos_ + length > data_->size()) data_->resize(pos_ + length);
+        memcpy(data_->data() + pos_, buffer, length);
+        pos_ += length;
+        return length;
+    }
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t readBytes(char* buffer, size_t length) {
+        return read(reinterpret_cast<uint8_t*>(buffer), length);
+    }
+
+    bool seek(size_t position) {
+        if (!data_ || position > data_->size()) return false;
+        pos_ = position;
+        return true;
+    }
+    size_t position() const { return pos_; }
+    size_t size() const { return data_ ? data_->size() : 0; }
+    int available() const { return data_ ? int(data_->size() - pos_) : 0; }
+    void flush() {}
+    // No wall clock on the host; size alone stamps a file
+    time_t getLastWrite() const { return 0; }
+    void close() { data_.reset(); }
+
+private:
+    std::shared_ptr<std::vector<uint8_t>> data_;
+    size_t pos_;
+};
+
+class HostFS {
+public:
+    bool begin(bool = false) { return true; }
+    void end() {}
+    bool format() { files_.clear(); return true; }
+
+    File open(const char* path, const char* mode = "r") {
+        auto it = files_.find(path);
+        if (mode[0] == 'r') {
+            return it == files_.end() ? File() : File(it->second, false);
+        }
+        if (mode[0] == 'w' || it == files_.end()) {
+            files_[path] = std::make_shared<std::vector<uint8_t>>();
+        }
+        return File(files_[path], mode[0] == 'a');
+    }
+
+    bool exists(const char* path) const { return files_.count(path) != 0; }
+    bool remove(const char* path) { return files_.erase(path) != 0; }
+    bool rename(const char* from, const char* to) {
+        auto it = files_.find(from);
+        if (it == files_.end()) return false;
+        files_[to] = it->second;
+        files_.erase(from);
+        return true;
+    }
+
+    // Test access to the raw bytes of a file (nullptr if absent)
+    std::vector<uint8_t>* data(const char* path) {
+        auto it = files_.find(path);
+        return it == files_.end() ? nullptr : it->second.get();
+    }
+
+private:
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files_;
+};
+
+inline HostFS LittleFS;
+
+#endif // OPENCLAW_HOST_LITTLEFS_H
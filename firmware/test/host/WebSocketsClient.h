@@ -0,0 +1,28 @@
+/**
+ * @file WebSocketsClient.h
+ * @brief Host stand-in for links2004/WebSockets: event types only
+ *
+ * Host builds use the loopback transport (OPENCLAW_LOOPBACK_GATEWAY), so
+ * the client class itself is never needed.
+ */
+
+#ifndef OPENCLAW_HOST_WEBSOCKETS_CLIENT_H
+#define OPENCLAW_HOST_WEBSOCKETS_CLIENT_H
+
+#define WEBSOCKETS_MAX_HEADER_SIZE (14)
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+#endif // OPENCLAW_HOST_WEBSOCKETS_CLIENT_H
@@ -0,0 +1,31 @@
+/**
+ * @file base64.h
+ * @brief Host stand-in for the Arduino core's base64 encoder
+ */
+
+#ifndef OPENCLAW_HOST_BASE64_H
+#define OPENCLAW_HOST_BASE64_H
+
+#include <Arduino.h>
+
+class base64 {
+public:
+    static String encode(const uint8_t* data, size_t length) {
+        static const char ALPHABET[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        out.reserve((length + 2) / 3 * 4);
+        for (size_t i = 0; i < length; i += 3) {
+            uint32_t chunk = uint32_t(data[i]) << 16;
+            if (i + 1 < length) chunk |= uint32_t(data[i + 1]) << 8;
+            if (i + 2 < length) chunk |= data[i + 2];
+            out += ALPHABET[(chunk >> 18) & 0x3F];
+            out += ALPHABET[(chunk >> 12) & 0x3F];
+            out += i + 1 < length ? ALPHABET[(chunk >> 6) & 0x3F] : '=';
+            out += i + 2 < length ? ALPHABET[chunk & 0x3F] : '=';
+        }
+        return String(out);
+    }
+};
+
+#endif // OPENCLAW_HOST_BASE64_H
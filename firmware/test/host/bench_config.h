@@ -0,0 +1,51 @@
+/**
+ * @file bench_config.h
+ * @brief The bench device's configuration, shared by the host suites
+ *
+ * Every field is set away from its default so that a round trip which
+ * drops or resets a field shows up in a comparison.
+ */
+
+#ifndef OPENCLAW_HOST_BENCH_CONFIG_H
+#define OPENCLAW_HOST_BENCH_CONFIG_H
+
+#include "config_manager.h"
+
+namespace OpenClaw {
+
+static constexpr const char* BENCH_DEVICE_ID = "cardputer-042";
+static constexpr const char* BENCH_API_KEY = "k-0123456789abcdef";
+
+inline AppConfig benchConfig() {
+    AppConfig c;
+    c.wifi.ssid = "workshop";
+    c.wifi.password = "correct horse battery";
+    c.wifi.dhcp = false;
+    c.wifi.static_ip = "192.168.4.20";
+    c.wifi.gateway = "192.168.4.1";
+    c.wifi.subnet = "255.255.255.0";
+    c.gateway.websocket_url = "wss://claw.example.net:443/ws";
+    c.gateway.fallback_http_url = "https://claw.example.net/api";
+    c.gateway.api_key = BENCH_API_KEY;
+    c.gateway.tls_fingerprint = "AB:CD:EF:01:23:45:67:89";
+    c.gateway.reconnect_interval_ms = 2500;
+    c.gateway.ping_interval_ms = 15000;
+    c.gateway.connection_timeout_ms = 8000;
+    c.device.id = BENCH_DEVICE_ID;
+    c.device.name = "Bench";
+    c.device.firmware_version = "2.0.0";
+    c.device.auto_connect = false;
+    c.device.save_history = true;
+    c.device.display_brightness = 200;
+    c.audio.sample_rate = 24000;
+    c.audio.frame_duration_ms = 40;
+    c.audio.codec = "pcm";
+    c.audio.mic_gain = 77;
+    c.audio.noise_suppression = false;
+    c.audio.auto_gain_control = true;
+    return c;
+}
+
+} // namespace OpenClaw
+
+#endif // OPENCLAW_HOST_BENCH_CONFIG_H
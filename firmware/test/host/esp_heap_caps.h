@@ -0,0 +1,28 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in for ESP-IDF capability allocation (plain malloc,
+ *        with PSRAM that tests can switch off)
+ */
+
+#ifndef OPENCLAW_HOST_ESP_HEAP_CAPS_H
+#define OPENCLAW_HOST_ESP_HEAP_CAPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+// Tests turn PSRAM off to exercise the internal-RAM paths
+struct HostHeap {
+    static inline bool spiram_available = true;
+};
+
+inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    if ((caps & MALLOC_CAP_SPIRAM) && !HostHeap::spiram_available) return nullptr;
+    return malloc(size);
+}
+
+#endif // OPENCLAW_HOST_ESP_HEAP_CAPS_H
@@ -0,0 +1,23 @@
+/**
+ * @file esp_rom_crc.h
+ * @brief Host stand-in for the ESP32 ROM CRC routines
+ */
+
+#ifndef OPENCLAW_HOST_ESP_ROM_CRC_H
+#define OPENCLAW_HOST_ESP_ROM_CRC_H
+
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3, reflected), same convention as the ROM routine
+inline uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+    crc = ~crc;
+    while (len--) {
+        crc ^= *buf++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+#endif // OPENCLAW_HOST_ESP_ROM_CRC_H
@@ -0,0 +1,19 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS base types
+ */
+
+#ifndef OPENCLAW_HOST_FREERTOS_H
+#define OPENCLAW_HOST_FREERTOS_H
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+
+#endif // OPENCLAW_HOST_FREERTOS_H
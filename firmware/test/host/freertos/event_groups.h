@@ -0,0 +1,50 @@
+/**
+ * @file event_groups.h
+ * @brief Host stand-in for FreeRTOS event groups: bits are set and read
+ *        back, nothing ever blocks (tests are single-threaded)
+ */
+
+#ifndef OPENCLAW_HOST_FREERTOS_EVENT_GROUPS_H
+#define OPENCLAW_HOST_FREERTOS_EVENT_GROUPS_H
+
+#include <freertos/FreeRTOS.h>
+
+typedef uint32_t EventBits_t;
+
+struct HostEventGroup {
+    EventBits_t bits;
+};
+
+typedef HostEventGroup* EventGroupHandle_t;
+
+inline EventGroupHandle_t xEventGroupCreate() {
+    return new HostEventGroup{0};
+}
+
+inline void vEventGroupDelete(EventGroupHandle_t group) {
+    delete group;
+}
+
+inline EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    group->bits |= bits;
+    return group->bits;
+}
+
+inline BaseType_t xEventGroupSetBitsFromISR(EventGroupHandle_t group, EventBits_t bits,
+                                            BaseType_t* higher_priority_woken) {
+    group->bits |= bits;
+    if (higher_priority_woken) *higher_priority_woken = pdFALSE;
+    return pdTRUE;
+}
+
+inline EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    return before;
+}
+
+inline EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    return group->bits;
+}
+
+#endif // OPENCLAW_HOST_FREERTOS_EVENT_GROUPS_H
@@ -0,0 +1,54 @@
+/**
+ * @file queue.h
+ * @brief Host stand-in for FreeRTOS queues: fixed-size items, copied in
+ *        and out, never blocking (tests are single-threaded)
+ */
+
+#ifndef OPENCLAW_HOST_FREERTOS_QUEUE_H
+#define OPENCLAW_HOST_FREERTOS_QUEUE_H
+
+#include <freertos/FreeRTOS.h>
+#include <cstring>
+#include <vector>
+
+struct HostQueue {
+    std::vector<uint8_t> items;
+    UBaseType_t capacity;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    HostQueue* queue = new HostQueue;
+    queue->items.resize(size_t(length) * item_size);
+    queue->capacity = length;
+    queue->item_size = item_size;
+    queue->head = 0;
+    queue->count = 0;
+    return queue;
+}
+
+inline void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t) {
+    if (queue->count == queue->capacity) return pdFALSE;
+    UBaseType_t tail = (queue->head + queue->count) % queue->capacity;
+    memcpy(&queue->items[size_t(tail) * queue->item_size], item, queue->item_size);
+    queue->count++;
+    return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t) {
+    if (queue->count == 0) return pdFALSE;
+    memcpy(item, &queue->items[size_t(queue->head) * queue->item_size], queue->item_size);
+    queue->head = (queue->head + 1) % queue->capacity;
+    queue->count--;
+    return pdTRUE;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) { return queue->count; }
+
+#endif // OPENCLAW_HOST_FREERTOS_QUEUE_H
@@ -0,0 +1,213 @@
+/**
+ * @file test_main.cpp
+ * @brief ConfigBlob round-trip, corruption and boot-load benchmark
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <esp_rom_crc.h>
+#include <chrono>
+#include <initializer_list>
+#include <cstddef>
+#include "config_blob.h"
+#include "config_manager.h"
+#include "bench_config.h"
+
+using namespace OpenClaw;
+
+static void assertConfigEqual(const AppConfig& a, const AppConfig& b) {
+    TEST_ASSERT_TRUE(a.wifi.ssid == b.wifi.ssid);
+    TEST_ASSERT_TRUE(a.wifi.password == b.wifi.password);
+    TEST_ASSERT_EQUAL(a.wifi.dhcp, b.wifi.dhcp);
+    TEST_ASSERT_TRUE(a.wifi.static_ip == b.wifi.static_ip);
+    TEST_ASSERT_TRUE(a.wifi.gateway == b.wifi.gateway);
+    TEST_ASSERT_TRUE(a.wifi.subnet == b.wifi.subnet);
+    TEST_ASSERT_TRUE(a.gateway.websocket_url == b.gateway.websocket_url);
+    TEST_ASSERT_TRUE(a.gateway.fallback_http_url == b.gateway.fallback_http_url);
+    TEST_ASSERT_TRUE(a.gateway.api_key == b.gateway.api_key);
+    TEST_ASSERT_TRUE(a.gateway.tls_fingerprint == b.gateway.tls_fingerprint);
+    TEST_ASSERT_EQUAL_UINT16(a.gateway.reconnect_interval_ms, b.gateway.reconnect_interval_ms);
+    TEST_ASSERT_EQUAL_UINT16(a.gateway.ping_interval_ms, b.gateway.ping_interval_ms);
+    TEST_ASSERT_EQUAL_UINT16(a.gateway.connection_timeout_ms, b.gateway.connection_timeout_ms);
+    TEST_ASSERT_TRUE(a.device.id == b.device.id);
+    TEST_ASSERT_TRUE(a.device.name == b.device.name);
+    TEST_ASSERT_TRUE(a.device.firmware_version == b.device.firmware_version);
+    TEST_ASSERT_EQUAL(a.device.auto_connect, b.device.auto_connect);
+    TEST_ASSERT_EQUAL(a.device.save_history, b.device.save_history);
+    TEST_ASSERT_EQUAL_UINT8(a.device.display_brightness, b.device.display_brightness);
+    TEST_ASSERT_EQUAL_UINT16(a.audio.sample_rate, b.audio.sample_rate);
+    TEST_ASSERT_EQUAL_UINT8(a.audio.frame_duration_ms, b.audio.frame_duration_ms);
+    TEST_ASSERT_TRUE(a.audio.codec == b.audio.codec);
+    TEST_ASSERT_EQUAL_UINT8(a.audio.mic_gain, b.audio.mic_gain);
+    TEST_ASSERT_EQUAL(a.audio.noise_suppression, b.audio.noise_suppression);
+    TEST_ASSERT_EQUAL(a.audio.auto_gain_control, b.audio.auto_gain_control);
+}
+
+static ConfigBlob blob;
+
+void setUp() {
+    LittleFS.format();
+    memset(&blob, 0, sizeof(blob));
+}
+
+void tearDown() {}
+
+void test_round_trip() {
+    AppConfig in = benchConfig();
+    TEST_ASSERT_TRUE(packConfigBlob(in, ConfigJsonStamp{812, 1700000000}, 7, blob));
+    TEST_ASSERT_TRUE(validateConfigBlob(blob));
+    TEST_ASSERT_EQUAL_UINT32(7, blob.log_generation);
+    TEST_ASSERT_EQUAL_UINT32(812, blob.json_stamp.size);
+
+    AppConfig out;
+    unpackConfigBlob(blob, out);
+    assertConfigEqual(in, out);
+}
+
+void test_pack_is_deterministic() {
+    ConfigBlob again;
+    AppConfig in = benchConfig();
+    TEST_ASSERT_TRUE(packConfigBlob(in, ConfigJsonStamp{1, 2}, 3, blob));
+    memset(&again, 0xA5, sizeof(again));
+    TEST_ASSERT_TRUE(packConfigBlob(in, ConfigJsonStamp{1, 2}, 3, again));
+    TEST_ASSERT_EQUAL_MEMORY(&blob, &again, sizeof(blob));
+}
+
+void test_oversized_strings_are_refused() {
+    AppConfig in = benchConfig();
+    std::string big(CONFIG_STRING_TABLE_SIZE, 'x');
+    in.gateway.api_key = big.c_str();
+    TEST_ASSERT_FALSE(packConfigBlob(in, ConfigJsonStamp{0, 0}, 0, blob));
+}
+
+// Any single corrupted byte, anywhere in the image, must be rejected
+void test_every_corrupted_byte_is_rejected() {
+    TEST_ASSERT_TRUE(packConfigBlob(benchConfig(), ConfigJsonStamp{0, 0}, 1, blob));
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(&blob);
+    size_t accepted = 0;
+    for (size_t i = 0; i < sizeof(blob); i++) {
+        for (uint8_t flip : {0x01, 0x80, 0xFF}) {
+            bytes[i] ^= flip;
+            if (validateConfigBlob(blob)) accepted++;
+            bytes[i] ^= flip;
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0, accepted);
+    TEST_ASSERT_TRUE(validateConfigBlob(blob));
+}
+
+void test_bad_string_table_is_rejected_even_with_good_crc() {
+    TEST_ASSERT_TRUE(packConfigBlob(benchConfig(), ConfigJsonStamp{0, 0}, 1, blob));
+    constexpr size_t crc_start = offsetof(ConfigBlob, json_stamp);
+    auto reseal = [] {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&blob);
+        blob.crc32 = esp_rom_crc32_le(0, bytes + crc_start, sizeof(blob) - crc_start);
+    };
+
+    blob.string_offset[static_cast<size_t>(ConfigString::DEVICE_NAME)] = blob.string_bytes;
+    reseal();
+    TEST_ASSERT_FALSE(validateConfigBlob(blob));
+
+    TEST_ASSERT_TRUE(packConfigBlob(benchConfig(), ConfigJsonStamp{0, 0}, 1, blob));
+    blob.strings[blob.string_bytes - 1] = 'x';     // Unterminated table
+    reseal();
+    TEST_ASSERT_FALSE(validateConfigBlob(blob));
+}
+
+// Version 2 layout: everything but the TLS fingerprint slot
+struct ConfigBlobV2 {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;
+    uint32_t crc32;
+    ConfigJsonStamp json_stamp;
+    uint32_t log_generation;
+    uint16_t reconnect_interval_ms;
+    uint16_t ping_interval_ms;
+    uint16_t connection_timeout_ms;
+    uint16_t sample_rate;
+    uint8_t frame_duration_ms;
+    uint8_t mic_gain;
+    uint8_t display_brightness;
+    uint8_t flags;
+    uint16_t string_offset[static_cast<size_t>(ConfigString::GATEWAY_TLS_FINGERPRINT)];
+    uint16_t string_bytes;
+    char strings[CONFIG_STRING_TABLE_SIZE];
+};
+
+void test_upgrade_from_version_2() {
+    AppConfig in = benchConfig();
+    in.gateway.tls_fingerprint = "";
+    TEST_ASSERT_TRUE(packConfigBlob(in, ConfigJsonStamp{5, 6}, 9, blob));
+
+    ConfigBlobV2 old;
+    memset(&old, 0, sizeof(old));
+    memcpy(&old, &blob, offsetof(ConfigBlobV2, string_offset));
+    memcpy(old.string_offset, blob.string_offset, sizeof(old.string_offset));
+    old.string_bytes = blob.string_bytes;
+    memcpy(old.strings, blob.strings, sizeof(old.strings));
+    old.version = 2;
+    old.size = sizeof(old);
+    constexpr size_t crc_start = offsetof(ConfigBlobV2, json_stamp);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&old);
+    old.crc32 = esp_rom_crc32_le(0, bytes + crc_start, sizeof(old) - crc_start);
+
+    ConfigBlob upgraded;
+    TEST_ASSERT_TRUE(upgradeConfigBlob(bytes, sizeof(old), upgraded));
+    TEST_ASSERT_EQUAL_UINT32(9, upgraded.log_generation);
+    AppConfig out;
+    unpackConfigBlob(upgraded, out);
+    assertConfigEqual(in, out);
+
+    // Not a v2 image: wrong length, or corrupt
+    TEST_ASSERT_FALSE(upgradeConfigBlob(bytes, sizeof(old) - 1, upgraded));
+    old.mic_gain ^= 1;
+    TEST_ASSERT_FALSE(upgradeConfigBlob(bytes, sizeof(old), upgraded));
+}
+
+// What boot does: one file read, validate, unpack into AppConfig
+void test_boot_load_benchmark() {
+    TEST_ASSERT_TRUE(packConfigBlob(benchConfig(), ConfigJsonStamp{0, 0}, 1, blob));
+    File out = LittleFS.open("/config.bin", "w");
+    TEST_ASSERT_EQUAL_size_t(sizeof(blob), out.write(reinterpret_cast<const uint8_t*>(&blob), sizeof(blob)));
+    out.close();
+
+    constexpr int LOADS = 20000;
+    int loaded = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < LOADS; i++) {
+        ConfigBlob image;
+        AppConfig config;
+        File in = LittleFS.open("/config.bin", "r");
+        bool ok = in.size() == sizeof(image) &&
+                  in.read(reinterpret_cast<uint8_t*>(&image), sizeof(image)) == sizeof(image) &&
+                  validateConfigBlob(image);
+        in.close();
+        if (ok) {
+            unpackConfigBlob(image, config);
+            loaded++;
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / LOADS;
+
+    char report[96];
+    snprintf(report, sizeof(report), "%zu-byte image: %.2f us per load (read + CRC + unpack)",
+             sizeof(ConfigBlob), us);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_EQUAL_INT(LOADS, loaded);
+    TEST_ASSERT_TRUE(us < 1000.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_pack_is_deterministic);
+    RUN_TEST(test_oversized_strings_are_refused);
+    RUN_TEST(test_every_corrupted_byte_is_rejected);
+    RUN_TEST(test_bad_string_table_is_rejected_even_with_good_crc);
+    RUN_TEST(test_upgrade_from_version_2);
+    RUN_TEST(test_boot_load_benchmark);
+    return UNITY_END();
+}
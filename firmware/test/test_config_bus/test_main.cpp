@@ -0,0 +1,321 @@
+/**
+ * @file test_main.cpp
+ * @brief ConfigBus masks and what ConfigManager::save() publishes
+ *
+ * The subscribers are the ones main.cpp registers, with the same masks.
+ * Every save must reach exactly the subscribers whose keys changed, with
+ * exactly those keys; the gateway subscriber drives a real client over
+ * the loopback link to show which changes cost a reconnect.
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <memory>
+#include <vector>
+#include "config_manager.h"
+#include "websocket_client.h"
+#include "bench_config.h"
+
+using namespace OpenClaw;
+
+// As setupConfigSubscribers() registers them
+enum Subscriber { WIFI, GATEWAY, AUDIO, DISPLAY, HISTORY, SUBSCRIBER_COUNT };
+
+static const ConfigKeyMask SUBSCRIBER_MASKS[SUBSCRIBER_COUNT] = {
+    configKeyBit(ConfigKey::WIFI_SSID) | configKeyBit(ConfigKey::WIFI_PASSWORD),
+    ConfigGroups::GATEWAY,
+    ConfigGroups::AUDIO,
+    ConfigGroups::DISPLAY,
+    configKeyBit(ConfigKey::DEVICE_SAVE_HISTORY),
+};
+
+// What each subscriber was handed since the last clearDeliveries()
+struct Delivery {
+    ConfigKeyMask changed;
+    size_t calls;
+};
+
+static std::unique_ptr<ConfigManager> manager;
+static std::unique_ptr<WebSocketClient> client;
+static Delivery deliveries[SUBSCRIBER_COUNT];
+static uint32_t authentications;
+static uint32_t reconnects;
+
+static void clearDeliveries() {
+    for (Delivery& d : deliveries) d = {0, 0};
+}
+
+static void record(ConfigKeyMask changed, const AppConfig&, void* ctx) {
+    Delivery& d = *static_cast<Delivery*>(ctx);
+    d.changed |= changed;
+    d.calls++;
+}
+
+static WebSocketConfig gatewayConfig(const AppConfig& config) {
+    WebSocketConfig ws;
+    ws.host = "gateway.local";
+    ws.api_key = config.gateway.api_key;
+    ws.device_id = config.device.id;
+    ws.device_name = config.device.name;
+    ws.tls_fingerprint = config.gateway.tls_fingerprint;
+    ws.reconnect_interval_ms = config.gateway.reconnect_interval_ms;
+    ws.ping_interval_ms = config.gateway.ping_interval_ms;
+    ws.connect_timeout_ms = config.gateway.connection_timeout_ms;
+    return ws;
+}
+
+// onGatewayConfigChanged() without the rest of the app
+static void onGateway(ConfigKeyMask changed, const AppConfig& config, void* ctx) {
+    record(changed, config, ctx);
+    if (client->reconfigure(gatewayConfig(config))) reconnects++;
+}
+
+static LoopbackLink quietLink() {
+    LoopbackLink link;
+    link.latency_ms = 20;
+    link.jitter_ms = 0;
+    link.loss_percent = 0;
+    link.fragment_bytes = 0;
+    link.bandwidth_bps = 0;
+    link.connect_fail_percent = 0;
+    link.report_interval_ms = 0;
+    return link;
+}
+
+static void run(uint32_t ms) {
+    for (uint32_t i = 0; i < ms; i++) {
+        HostClock::advance(1);
+        client->update();
+        ProtocolMessage message;
+        while (client->receive(message)) {}
+    }
+}
+
+static bool runUntilAuthenticated(uint32_t limit_ms) {
+    for (uint32_t i = 0; i < limit_ms && !client->isAuthenticated(); i++) {
+        run(1);
+    }
+    return client->isAuthenticated();
+}
+
+// A different value for one setting, so that only its key changes
+static void change(AppConfig& c, ConfigKey key, int round) {
+    String tag = String(round);
+    switch (key) {
+        case ConfigKey::WIFI_SSID: c.wifi.ssid = String("lab-") + tag; break;
+        case ConfigKey::WIFI_PASSWORD: c.wifi.password = String("hunter") + tag; break;
+        case ConfigKey::WIFI_DHCP: c.wifi.dhcp = !c.wifi.dhcp; break;
+        case ConfigKey::WIFI_STATIC_IP: c.wifi.static_ip = String("10.0.0.") + tag; break;
+        case ConfigKey::WIFI_GATEWAY: c.wifi.gateway = String("10.0.1.") + tag; break;
+        case ConfigKey::WIFI_SUBNET: c.wifi.subnet = String("255.255.") + tag + ".0"; break;
+        case ConfigKey::GATEWAY_WEBSOCKET_URL:
+            c.gateway.websocket_url = String("wss://claw") + tag + ".example.net/ws"; break;
+        case ConfigKey::GATEWAY_FALLBACK_URL:
+            c.gateway.fallback_http_url = String("https://claw") + tag + ".example.net/api"; break;
+        case ConfigKey::GATEWAY_API_KEY: c.gateway.api_key = String("k-") + tag; break;
+        case ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS: c.gateway.reconnect_interval_ms += 100; break;
+        case ConfigKey::GATEWAY_PING_INTERVAL_MS: c.gateway.ping_interval_ms += 1000; break;
+        case ConfigKey::GATEWAY_CONNECTION_TIMEOUT_MS: c.gateway.connection_timeout_ms += 500; break;
+        case ConfigKey::DEVICE_ID: c.device.id = String("cardputer-") + tag; break;
+        case ConfigKey::DEVICE_NAME: c.device.name = String("Bench ") + tag; break;
+        case ConfigKey::DEVICE_FIRMWARE_VERSION: c.device.firmware_version = String("2.1.") + tag; break;
+        case ConfigKey::DEVICE_AUTO_CONNECT: c.device.auto_connect = !c.device.auto_connect; break;
+        case ConfigKey::DEVICE_SAVE_HISTORY: c.device.save_history = !c.device.save_history; break;
+        case ConfigKey::DEVICE_DISPLAY_BRIGHTNESS: c.device.display_brightness += 7; break;
+        case ConfigKey::AUDIO_SAMPLE_RATE:
+            c.audio.sample_rate = c.audio.sample_rate == 16000 ? 24000 : 16000; break;
+        case ConfigKey::AUDIO_FRAME_DURATION_MS:
+            c.audio.frame_duration_ms = c.audio.frame_duration_ms == 20 ? 40 : 20; break;
+        case ConfigKey::AUDIO_CODEC: c.audio.codec = c.audio.codec == "opus" ? "pcm" : "opus"; break;
+        case ConfigKey::AUDIO_MIC_GAIN: c.audio.mic_gain += 3; break;
+        case ConfigKey::AUDIO_NOISE_SUPPRESSION: c.audio.noise_suppression = !c.audio.noise_suppression; break;
+        case ConfigKey::AUDIO_AUTO_GAIN_CONTROL: c.audio.auto_gain_control = !c.audio.auto_gain_control; break;
+        case ConfigKey::GATEWAY_TLS_FINGERPRINT:
+            c.gateway.tls_fingerprint = String("AB:CD:EF:") + tag; break;
+        case ConfigKey::COUNT: break;
+    }
+}
+
+// Save the edits, returning the keys diffConfig() says changed
+static ConfigKeyMask save(void (*edit)(AppConfig&)) {
+    AppConfig before = manager->getConfig();
+    edit(manager->getMutableConfig());
+    ConfigKeyMask changed = diffConfig(before, manager->getConfig());
+    clearDeliveries();
+    TEST_ASSERT_TRUE(manager->save());
+    return changed;
+}
+
+// Each subscriber saw changed & its mask, once, or nothing at all
+static size_t wrongDeliveries(ConfigKeyMask changed) {
+    size_t wrong = 0;
+    for (int s = 0; s < SUBSCRIBER_COUNT; s++) {
+        ConfigKeyMask expected = changed & SUBSCRIBER_MASKS[s];
+        if (deliveries[s].changed != expected) wrong++;
+        if (deliveries[s].calls != (expected ? 1u : 0u)) wrong++;
+    }
+    return wrong;
+}
+
+void setUp() {
+    HostClock::set(1000);
+    LittleFS.format();
+    clearDeliveries();
+    authentications = 0;
+    reconnects = 0;
+
+    manager.reset(new ConfigManager());
+    TEST_ASSERT_TRUE(manager->begin());
+    TEST_ASSERT_TRUE(manager->load());
+    manager->getMutableConfig() = benchConfig();
+    TEST_ASSERT_TRUE(manager->save());
+
+    ConfigBus& bus = manager->getBus();
+    for (int s = 0; s < SUBSCRIBER_COUNT; s++) {
+        TEST_ASSERT_TRUE(bus.subscribe(SUBSCRIBER_MASKS[s], s == GATEWAY ? onGateway : record,
+                                       &deliveries[s]));
+    }
+
+    client.reset();
+    client.reset(new WebSocketClient());
+    TEST_ASSERT_TRUE(client->begin(gatewayConfig(manager->getConfig())));
+    client->getLoopback().setLink(quietLink());
+    client->onEvent([](WebSocketEvent event, const void*) {
+        if (event == WebSocketEvent::AUTHENTICATED) authentications++;
+    });
+}
+
+void tearDown() {
+    client.reset();
+    manager.reset();
+}
+
+void test_publish_delivers_only_the_subscribed_keys() {
+    ConfigBus bus;
+    Delivery a = {0, 0}, b = {0, 0};
+    ConfigKeyMask ssid = configKeyBit(ConfigKey::WIFI_SSID);
+    ConfigKeyMask ping = configKeyBit(ConfigKey::GATEWAY_PING_INTERVAL_MS);
+    TEST_ASSERT_TRUE(bus.subscribe(ConfigGroups::WIFI, record, &a));
+    TEST_ASSERT_TRUE(bus.subscribe(ConfigGroups::WIFI | ConfigGroups::GATEWAY_TIMING, record, &b));
+
+    AppConfig config = benchConfig();
+    TEST_ASSERT_EQUAL_size_t(2, bus.publish(ssid | ping, config));
+    TEST_ASSERT_EQUAL_UINT32(ssid, a.changed);
+    TEST_ASSERT_EQUAL_UINT32(ssid | ping, b.changed);
+
+    TEST_ASSERT_EQUAL_size_t(1, bus.publish(ping, config));
+    TEST_ASSERT_EQUAL_size_t(1, a.calls);
+    TEST_ASSERT_EQUAL_size_t(2, b.calls);
+
+    TEST_ASSERT_EQUAL_size_t(0, bus.publish(ConfigGroups::DISPLAY, config));
+    TEST_ASSERT_EQUAL_size_t(0, bus.publish(0, config));
+}
+
+void test_subscriber_table_is_bounded() {
+    ConfigBus bus;
+    Delivery d = {0, 0};
+    TEST_ASSERT_FALSE(bus.subscribe(ConfigGroups::WIFI, nullptr));
+    for (size_t i = 0; i < ConfigBus::MAX_SUBSCRIBERS; i++) {
+        TEST_ASSERT_TRUE(bus.subscribe(ConfigGroups::WIFI, record, &d));
+    }
+    TEST_ASSERT_FALSE(bus.subscribe(ConfigGroups::WIFI, record, &d));
+    TEST_ASSERT_EQUAL_size_t(ConfigBus::MAX_SUBSCRIBERS, bus.getSubscriberCount());
+    TEST_ASSERT_EQUAL_size_t(ConfigBus::MAX_SUBSCRIBERS,
+                             bus.publish(configKeyBit(ConfigKey::WIFI_SSID), benchConfig()));
+}
+
+// Every setting on its own, then a few at once: save() publishes exactly
+// what diffConfig() reports, to exactly the subscribers that asked
+void test_save_publishes_exactly_the_changed_keys() {
+    size_t wrong = 0;
+    for (int round = 0; round < 3; round++) {
+        for (uint8_t k = 0; k < static_cast<uint8_t>(ConfigKey::COUNT); k++) {
+            ConfigKey key = static_cast<ConfigKey>(k);
+            AppConfig before = manager->getConfig();
+            change(manager->getMutableConfig(), key, round);
+            ConfigKeyMask changed = diffConfig(before, manager->getConfig());
+            if (changed != configKeyBit(key)) wrong++;
+
+            clearDeliveries();
+            TEST_ASSERT_TRUE(manager->save());
+            wrong += wrongDeliveries(changed);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+
+    ConfigKeyMask changed = save([](AppConfig& c) {
+        change(c, ConfigKey::DEVICE_DISPLAY_BRIGHTNESS, 0);
+        change(c, ConfigKey::GATEWAY_PING_INTERVAL_MS, 0);
+        change(c, ConfigKey::AUDIO_CODEC, 0);
+        change(c, ConfigKey::WIFI_DHCP, 0);
+    });
+    TEST_ASSERT_EQUAL_UINT32(configKeyBit(ConfigKey::DEVICE_DISPLAY_BRIGHTNESS) |
+                             configKeyBit(ConfigKey::GATEWAY_PING_INTERVAL_MS) |
+                             configKeyBit(ConfigKey::AUDIO_CODEC) |
+                             configKeyBit(ConfigKey::WIFI_DHCP), changed);
+    TEST_ASSERT_EQUAL_size_t(0, wrongDeliveries(changed));
+    // DHCP is in no subscription: nothing rejoins WiFi
+    TEST_ASSERT_EQUAL_size_t(0, deliveries[WIFI].calls);
+}
+
+void test_unchanged_save_publishes_nothing() {
+    ConfigKeyMask changed = save([](AppConfig& c) {
+        c.device.display_brightness = c.device.display_brightness;
+    });
+    TEST_ASSERT_EQUAL_UINT32(0, changed);
+    TEST_ASSERT_EQUAL_size_t(0, wrongDeliveries(0));
+
+    // Changed and changed back between saves
+    changed = save([](AppConfig& c) {
+        c.wifi.ssid = "elsewhere";
+        c.wifi.ssid = "workshop";
+    });
+    TEST_ASSERT_EQUAL_UINT32(0, changed);
+    TEST_ASSERT_EQUAL_size_t(0, wrongDeliveries(0));
+}
+
+// Brightness never reaches the gateway; timing is applied to the live
+// session; only session settings cost a reconnect
+void test_only_session_settings_reconnect_the_gateway() {
+    client->connect();
+    TEST_ASSERT_TRUE(runUntilAuthenticated(1000));
+    TEST_ASSERT_EQUAL_UINT32(1, authentications);
+
+    save([](AppConfig& c) { c.device.display_brightness = 30; });
+    TEST_ASSERT_EQUAL_size_t(1, deliveries[DISPLAY].calls);
+    TEST_ASSERT_EQUAL_size_t(0, deliveries[GATEWAY].calls);
+    run(500);
+    TEST_ASSERT_TRUE(client->isAuthenticated());
+    TEST_ASSERT_EQUAL_UINT32(1, authentications);
+
+    save([](AppConfig& c) {
+        c.gateway.ping_interval_ms = 5000;
+        c.gateway.reconnect_interval_ms = 4000;
+    });
+    TEST_ASSERT_EQUAL_size_t(1, deliveries[GATEWAY].calls);
+    TEST_ASSERT_EQUAL_UINT32(configKeyBit(ConfigKey::GATEWAY_PING_INTERVAL_MS) |
+                             configKeyBit(ConfigKey::GATEWAY_RECONNECT_INTERVAL_MS),
+                             deliveries[GATEWAY].changed);
+    TEST_ASSERT_EQUAL_UINT32(0, reconnects);
+    TEST_ASSERT_EQUAL_UINT32(5000, client->getConfig().ping_interval_ms);
+    TEST_ASSERT_EQUAL_UINT32(4000, client->getConfig().reconnect_interval_ms);
+    run(500);
+    TEST_ASSERT_TRUE(client->isAuthenticated());
+    TEST_ASSERT_EQUAL_UINT32(1, authentications);
+
+    save([](AppConfig& c) { c.gateway.api_key = "k-rotated"; });
+    TEST_ASSERT_EQUAL_UINT32(configKeyBit(ConfigKey::GATEWAY_API_KEY), deliveries[GATEWAY].changed);
+    TEST_ASSERT_EQUAL_UINT32(1, reconnects);
+    TEST_ASSERT_TRUE(runUntilAuthenticated(1000));
+    TEST_ASSERT_EQUAL_UINT32(2, authentications);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_publish_delivers_only_the_subscribed_keys);
+    RUN_TEST(test_subscriber_table_is_bounded);
+    RUN_TEST(test_save_publishes_exactly_the_changed_keys);
+    RUN_TEST(test_unchanged_save_publishes_nothing);
+    RUN_TEST(test_only_session_settings_reconnect_the_gateway);
+    return UNITY_END();
+}
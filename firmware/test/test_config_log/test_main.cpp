@@ -0,0 +1,174 @@
+/**
+ * @file test_main.cpp
+ * @brief Config delta log: power cut and corruption at every byte offset
+ *
+ * A log is built the way ConfigManager writes it (header, then one
+ * committed batch per save) and then cut short or damaged at every
+ * offset. Replay must always land on exactly one of the saved
+ * configurations: the last one whose commit is fully intact.
+ */
+
+#include <unity.h>
+#include <initializer_list>
+#include <vector>
+#include "config_log.h"
+#include "config_manager.h"
+#include "bench_config.h"
+
+using namespace OpenClaw;
+
+static constexpr uint32_t GENERATION = 7;
+
+// One save per step: single keys, several keys, strings growing and shrinking
+static void edit(AppConfig& c, int step) {
+    switch (step % 6) {
+        case 0: c.device.display_brightness = uint8_t(40 + step); break;
+        case 1: c.wifi.ssid = String("lab-network-") + String(step);
+                c.wifi.password = "hunter2"; break;
+        case 2: c.gateway.reconnect_interval_ms = uint16_t(1000 + step * 250);
+                c.audio.noise_suppression = !c.audio.noise_suppression; break;
+        case 3: c.device.name = String("A much longer device name, take ") + String(step); break;
+        case 4: c.device.name = "B"; c.audio.codec = "pcm"; c.wifi.dhcp = false;
+                c.wifi.static_ip = "10.0.0.9"; break;
+        case 5: c.gateway.tls_fingerprint = "AB:CD:EF:01:23:45:67:89";
+                c.audio.mic_gain = uint8_t(step); break;
+    }
+}
+
+static bool sameConfig(const AppConfig& a, const AppConfig& b) {
+    return diffConfig(a, b) == 0;
+}
+
+// A log as ConfigManager leaves it after a series of saves
+struct SavedLog {
+    std::vector<uint8_t> bytes;
+    std::vector<AppConfig> states;      // states[k]: after k commits
+    std::vector<size_t> commit_end;     // commit_end[k]: file size once k commits landed
+};
+
+static SavedLog writeLog(int saves) {
+    SavedLog log;
+    ConfigLogHeader header;
+    makeConfigLogHeader(GENERATION, header);
+    const uint8_t* h = reinterpret_cast<const uint8_t*>(&header);
+    log.bytes.assign(h, h + sizeof(header));
+    log.states.push_back(benchConfig());
+    log.commit_end.push_back(log.bytes.size());
+
+    uint8_t batch[CONFIG_LOG_BATCH_MAX];
+    for (int i = 0; i < saves; i++) {
+        AppConfig next = log.states.back();
+        edit(next, i);
+        size_t length = 0;
+        TEST_ASSERT_TRUE(buildConfigLogBatch(log.states.back(), next, uint32_t(i + 1),
+                                             batch, sizeof(batch), length));
+        TEST_ASSERT_TRUE(length > 0);
+        log.bytes.insert(log.bytes.end(), batch, batch + length);
+        log.states.push_back(next);
+        log.commit_end.push_back(log.bytes.size());
+    }
+    return log;
+}
+
+// What boot does with a log: replay onto the base image, keep the base
+// if the header itself is unusable
+static AppConfig boot(const std::vector<uint8_t>& bytes, size_t size, ConfigLogReplay& replay) {
+    AppConfig config = benchConfig();
+    if (!replayConfigLog(bytes.data(), size, GENERATION, config, replay)) {
+        replay.sequence = 0;
+        replay.valid_bytes = 0;
+    }
+    return config;
+}
+
+// Commits wholly inside the first `bytes` bytes of the log
+static size_t commitsWithin(const SavedLog& log, size_t bytes) {
+    size_t k = 0;
+    while (k + 1 < log.commit_end.size() && log.commit_end[k + 1] <= bytes) k++;
+    return k;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_replay_reaches_every_save() {
+    SavedLog log = writeLog(12);
+    ConfigLogReplay replay;
+    AppConfig config = boot(log.bytes, log.bytes.size(), replay);
+    TEST_ASSERT_TRUE(sameConfig(log.states.back(), config));
+    TEST_ASSERT_EQUAL_UINT32(12, replay.sequence);
+    TEST_ASSERT_EQUAL_size_t(log.bytes.size(), replay.valid_bytes);
+}
+
+// Power lost after any number of bytes reached flash, with the rest of
+// the file missing, erased (0xFF) or zeroed
+void test_power_cut_at_every_offset() {
+    SavedLog log = writeLog(12);
+    size_t wrong = 0;
+    for (size_t cut = 0; cut <= log.bytes.size(); cut++) {
+        size_t k = commitsWithin(log, cut);
+        for (int tail : {-1, 0xFF, 0x00}) {
+            std::vector<uint8_t> bytes(log.bytes.begin(), log.bytes.begin() + cut);
+            if (tail >= 0) bytes.resize(log.bytes.size(), uint8_t(tail));
+
+            ConfigLogReplay replay;
+            AppConfig config = boot(bytes, bytes.size(), replay);
+            bool header_ok = cut >= sizeof(ConfigLogHeader);
+            if (!sameConfig(log.states[k], config) ||
+                replay.sequence != k ||
+                (header_ok && replay.valid_bytes != log.commit_end[k])) {
+                wrong++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+}
+
+// A damaged byte anywhere drops its batch and everything after it
+void test_corruption_at_every_offset() {
+    SavedLog log = writeLog(12);
+    size_t wrong = 0;
+    for (size_t i = 0; i < log.bytes.size(); i++) {
+        size_t k = i < sizeof(ConfigLogHeader) ? 0 : commitsWithin(log, i);
+        for (uint8_t flip : {0x01, 0x80, 0xFF}) {
+            std::vector<uint8_t> bytes = log.bytes;
+            bytes[i] ^= flip;
+            ConfigLogReplay replay;
+            AppConfig config = boot(bytes, bytes.size(), replay);
+            if (!sameConfig(log.states[k], config) || replay.sequence != k) wrong++;
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+}
+
+// Left behind by a compaction cut short: the image moved on, the log did not
+void test_log_of_another_generation_is_ignored() {
+    SavedLog log = writeLog(3);
+    AppConfig config = benchConfig();
+    ConfigLogReplay replay;
+    TEST_ASSERT_FALSE(replayConfigLog(log.bytes.data(), log.bytes.size(), GENERATION + 1,
+                                      config, replay));
+    TEST_ASSERT_TRUE(sameConfig(benchConfig(), config));
+}
+
+// A batch replayed twice (the same commit appended again) stops replay
+void test_out_of_order_batch_stops_replay() {
+    SavedLog log = writeLog(2);
+    std::vector<uint8_t> bytes = log.bytes;
+    bytes.insert(bytes.end(), log.bytes.begin() + log.commit_end[1], log.bytes.end());
+    ConfigLogReplay replay;
+    AppConfig config = boot(bytes, bytes.size(), replay);
+    TEST_ASSERT_TRUE(sameConfig(log.states[2], config));
+    TEST_ASSERT_EQUAL_UINT32(2, replay.sequence);
+    TEST_ASSERT_EQUAL_size_t(log.bytes.size(), replay.valid_bytes);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_replay_reaches_every_save);
+    RUN_TEST(test_power_cut_at_every_offset);
+    RUN_TEST(test_corruption_at_every_offset);
+    RUN_TEST(test_log_of_another_generation_is_ignored);
+    RUN_TEST(test_out_of_order_batch_stops_replay);
+    return UNITY_END();
+}
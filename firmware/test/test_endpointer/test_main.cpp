@@ -0,0 +1,350 @@
+/**
+ * @file test_main.cpp
+ * @brief Endpointer: fixed and adaptive hangover, energy slope, the
+ *        LIKELY_FINAL/RESUMED hint, truncation learning and clamping
+ *
+ * A scripted speaker feeds 20 ms frames the way AudioStreamer does,
+ * from the VAD's voice start until FINAL.
+ */
+
+#include <unity.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "endpointer.h"
+
+using namespace OpenClaw;
+
+static constexpr uint16_t FRAME_MS = 20;
+static constexpr float VOICE_RMS = 3000.0f;
+
+struct Event {
+    EndpointEvent event;
+    uint32_t at;
+};
+
+static Endpointer* endpointer;
+static uint32_t now;
+static std::vector<Event> events;
+static bool ended;
+
+static EndpointerConfig quietConfig(bool adaptive) {
+    EndpointerConfig config;
+    config.adaptive = adaptive;
+    config.hint = false;
+    return config;
+}
+
+static void feed(bool is_speech, float rms) {
+    EndpointEvent event = endpointer->update(is_speech, rms, FRAME_MS, now);
+    if (event != EndpointEvent::NONE) events.push_back({event, now});
+    if (event == EndpointEvent::FINAL) ended = true;
+    now += FRAME_MS;
+}
+
+static void beginUtterance() {
+    endpointer->startUtterance(now);
+    events.clear();
+    ended = false;
+}
+
+// A new utterance, long enough after the last one not to continue it
+static void startUtterance() {
+    now += 5000;
+    beginUtterance();
+}
+
+// Voiced frames, level changing by db_per_frame from one to the next
+static void speak(uint32_t ms, float db_per_frame = 0.0f) {
+    float rms = VOICE_RMS;
+    for (uint32_t t = 0; t < ms && !ended; t += FRAME_MS) {
+        feed(true, rms);
+        rms *= std::pow(10.0f, db_per_frame / 20.0f);
+    }
+}
+
+// Silence for ms, or until the utterance ends; returns the silence fed
+static uint32_t pause(uint32_t ms) {
+    uint32_t t = 0;
+    for (; t < ms && !ended; t += FRAME_MS) feed(false, 40.0f);
+    return t;
+}
+
+// Speech again ms after the last FINAL
+static void resumeAfter(uint32_t ms) {
+    now = events.back().at + ms;
+    beginUtterance();
+}
+
+// Silence until FINAL; returns how long the pause ran
+static uint32_t pauseUntilFinal() {
+    uint32_t start = now;
+    pause(10000);
+    TEST_ASSERT_TRUE(ended);
+    return events.back().at - start;
+}
+
+// A mid-utterance pause of exactly ms (speech resumes after it)
+static void midPause(uint32_t ms) {
+    pause(ms);
+    TEST_ASSERT_FALSE(ended);
+    speak(FRAME_MS);
+}
+
+void setUp() {
+    now = 1000;
+    events.clear();
+    ended = false;
+    endpointer = new Endpointer(quietConfig(true));
+}
+
+void tearDown() {
+    delete endpointer;
+    endpointer = nullptr;
+}
+
+// =============================================================================
+// Hangover
+// =============================================================================
+
+// Not adaptive: every utterance ends hangover_ms into its pause, whatever
+// the speaker's pauses or the energy slope
+void test_fixed_hangover_when_not_adaptive() {
+    endpointer->setConfig(quietConfig(false));
+    for (int i = 0; i < 6; i++) {
+        startUtterance();
+        speak(400);
+        for (int p = 0; p < 6; p++) {
+            midPause(120);
+            speak(200);
+        }
+        speak(200, i % 2 ? -3.0f : 0.0f);
+        TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+        TEST_ASSERT_EQUAL_UINT32(500, endpointer->getHangoverMs());
+    }
+    TEST_ASSERT_EQUAL_UINT32(120, endpointer->getLongPauseMs());
+}
+
+// The speaker's pauses move the hangover only once MIN_PAUSES are known
+void test_adapts_only_after_min_pauses() {
+    startUtterance();
+    speak(300);
+    for (size_t p = 0; p < Endpointer::MIN_PAUSES; p++) {
+        // Too few pauses known yet: the configured hangover
+        pause(FRAME_MS);
+        TEST_ASSERT_EQUAL_UINT32(500, endpointer->getHangoverMs());
+        pause(200 - FRAME_MS);
+        speak(200);
+    }
+
+    // margin x the long pause, plus a frame
+    TEST_ASSERT_EQUAL_UINT32(200, endpointer->getLongPauseMs());
+    TEST_ASSERT_EQUAL_UINT32(200 * 3 / 2 + FRAME_MS, pauseUntilFinal());
+    TEST_ASSERT_EQUAL_UINT32(200 * 3 / 2 + FRAME_MS, endpointer->getHangoverMs());
+
+    // A few long pauses push the quantile, and the hangover, up
+    startUtterance();
+    speak(300);
+    for (int p = 0; p < 4; p++) {
+        midPause(300);
+        speak(200);
+    }
+    TEST_ASSERT_EQUAL_UINT32(300, endpointer->getLongPauseMs());
+    TEST_ASSERT_EQUAL_UINT32(300 * 3 / 2 + FRAME_MS, endpointer->getHangoverMs());
+    // Ends on the first frame past it
+    TEST_ASSERT_EQUAL_UINT32(480, pauseUntilFinal());
+}
+
+// Speech that trails off ends sooner than speech that stops at full level
+void test_falling_slope_shortens_the_hangover() {
+    startUtterance();
+    speak(400);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+
+    startUtterance();
+    speak(400, 2.0f);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+
+    // 1 dB per frame is 5 dB per 100 ms: past the 4 dB threshold
+    startUtterance();
+    speak(400, -1.0f);
+    TEST_ASSERT_EQUAL_UINT32(360, pauseUntilFinal());
+    TEST_ASSERT_EQUAL_UINT32(500 * 7 / 10, endpointer->getHangoverMs());
+
+    // 0.5 dB per frame is not
+    startUtterance();
+    speak(400, -0.5f);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+
+    // Only the speech since the last pause counts
+    startUtterance();
+    speak(400, -1.0f);
+    midPause(100);
+    speak(400);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+}
+
+// =============================================================================
+// Hint
+// =============================================================================
+
+void test_hint_precedes_final_and_is_withdrawn_on_resume() {
+    EndpointerConfig config = quietConfig(false);
+    config.hint = true;
+    endpointer->setConfig(config);
+
+    startUtterance();
+    speak(400);
+    uint32_t pause_start = now;
+    pause(300);
+    speak(200);
+    TEST_ASSERT_EQUAL_size_t(2, events.size());
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(EndpointEvent::LIKELY_FINAL), uint8_t(events[0].event));
+    TEST_ASSERT_EQUAL_UINT32(pause_start + 260, events[0].at);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(EndpointEvent::RESUMED), uint8_t(events[1].event));
+    TEST_ASSERT_EQUAL_UINT32(pause_start + 300, events[1].at);
+
+    // Short pauses never hint
+    midPause(200);
+    TEST_ASSERT_EQUAL_size_t(2, events.size());
+
+    pause_start = now;
+    pauseUntilFinal();
+    TEST_ASSERT_EQUAL_size_t(4, events.size());
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(EndpointEvent::LIKELY_FINAL), uint8_t(events[2].event));
+    TEST_ASSERT_EQUAL_UINT32(pause_start + 260, events[2].at);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(EndpointEvent::FINAL), uint8_t(events[3].event));
+    TEST_ASSERT_EQUAL_UINT32(pause_start + 500, events[3].at);
+
+    TEST_ASSERT_EQUAL_UINT32(2, endpointer->getHints());
+    TEST_ASSERT_EQUAL_UINT32(1, endpointer->getHintsWithdrawn());
+}
+
+// Random speech and pauses, adaptive and sloped: at most one hint open at
+// a time, RESUMED only withdraws an open hint, FINAL ends the utterance
+void test_hint_ordering_holds_for_random_speech() {
+    EndpointerConfig config;
+    config.hint = true;
+    endpointer->setConfig(config);
+
+    std::mt19937 rng(7);
+    size_t wrong = 0;
+    uint32_t finals = 0;
+    uint32_t resumed = 0;
+    for (int u = 0; u < 2000; u++) {
+        startUtterance();
+        bool open = false;
+        for (int round = 0; !ended; round++) {
+            size_t before = events.size();
+            speak(FRAME_MS * (1 + rng() % 20), float(int(rng() % 5) - 3) * 0.5f);
+            // A speaker who keeps pausing below the hangover talks until stopped
+            pause(round < 30 ? FRAME_MS * (rng() % 40) : 10000);
+            for (size_t i = before; i < events.size(); i++) {
+                switch (events[i].event) {
+                    case EndpointEvent::LIKELY_FINAL:
+                        if (open) wrong++;
+                        open = true;
+                        break;
+                    case EndpointEvent::RESUMED:
+                        if (!open) wrong++;
+                        open = false;
+                        resumed++;
+                        break;
+                    case EndpointEvent::FINAL:
+                        if (i + 1 != events.size()) wrong++;
+                        finals++;
+                        break;
+                    default:
+                        wrong++;
+                }
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+    TEST_ASSERT_EQUAL_UINT32(2000, finals);
+    TEST_ASSERT_EQUAL_UINT32(resumed, endpointer->getHintsWithdrawn());
+    TEST_ASSERT_TRUE(resumed > 100);
+    TEST_ASSERT_EQUAL_UINT32(0, endpointer->getTruncations());
+}
+
+// =============================================================================
+// Truncation and limits
+// =============================================================================
+
+// Speech right after FINAL: the whole gap was a mid-utterance pause
+void test_truncation_is_learned_as_a_pause() {
+    startUtterance();
+    speak(400);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+
+    resumeAfter(100);
+    TEST_ASSERT_EQUAL_UINT32(1, endpointer->getTruncations());
+    TEST_ASSERT_EQUAL_UINT32(600, endpointer->getLongPauseMs());
+
+    // Resumed long after the end: a new utterance, nothing learned
+    speak(400);
+    pauseUntilFinal();
+    resumeAfter(2 * 900);
+    TEST_ASSERT_EQUAL_UINT32(1, endpointer->getTruncations());
+
+    // Enough truncations and the hangover outlasts the pause that cut them
+    for (size_t i = 1; i < Endpointer::MIN_PAUSES; i++) {
+        speak(400);
+        pauseUntilFinal();
+        resumeAfter(100);
+    }
+    TEST_ASSERT_EQUAL_UINT32(Endpointer::MIN_PAUSES, endpointer->getTruncations());
+    speak(400);
+    TEST_ASSERT_EQUAL_UINT32(600, endpointer->getLongPauseMs());
+    TEST_ASSERT_EQUAL_UINT32(900, pauseUntilFinal());     // 920, held at the maximum
+
+    // resetStats() forgets the speaker
+    endpointer->resetStats();
+    TEST_ASSERT_EQUAL_UINT32(0, endpointer->getLongPauseMs());
+    startUtterance();
+    speak(400);
+    TEST_ASSERT_EQUAL_UINT32(500, pauseUntilFinal());
+}
+
+void test_hangover_is_clamped() {
+    // Very short pauses: margin x 40 ms would be far under the minimum
+    startUtterance();
+    speak(300);
+    for (int p = 0; p < 8; p++) {
+        midPause(40);
+        speak(100);
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, endpointer->getLongPauseMs());
+    TEST_ASSERT_EQUAL_UINT32(200, pauseUntilFinal());
+
+    // Trailing off cannot take it below the minimum either
+    startUtterance();
+    speak(300, -2.0f);
+    TEST_ASSERT_EQUAL_UINT32(200, pauseUntilFinal());
+
+    // Very long pauses: held at the maximum
+    EndpointerConfig config = quietConfig(true);
+    config.hangover_ms = 900;
+    endpointer->setConfig(config);
+    endpointer->resetStats();
+    startUtterance();
+    speak(300);
+    for (int p = 0; p < 8; p++) {
+        midPause(800);
+        speak(100);
+    }
+    TEST_ASSERT_EQUAL_UINT32(800, endpointer->getLongPauseMs());
+    TEST_ASSERT_EQUAL_UINT32(900, pauseUntilFinal());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_hangover_when_not_adaptive);
+    RUN_TEST(test_adapts_only_after_min_pauses);
+    RUN_TEST(test_falling_slope_shortens_the_hangover);
+    RUN_TEST(test_hint_precedes_final_and_is_withdrawn_on_resume);
+    RUN_TEST(test_hint_ordering_holds_for_random_speech);
+    RUN_TEST(test_truncation_is_learned_as_a_pause);
+    RUN_TEST(test_hangover_is_clamped);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+/**
+ * @file test_main.cpp
+ * @brief WebSocketClient and the codecs over the loopback link: codec
+ *        negotiation, ordering, reconnect storms and a throughput benchmark
+ *
+ * The client is driven the way the main loop drives it, one update() per
+ * millisecond of fake clock, with the link scripted per test.
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <ArduinoJson.h>
+#include "websocket_client.h"
+#include "bench_config.h"
+
+using namespace OpenClaw;
+
+static std::unique_ptr<WebSocketClient> client;
+static uint32_t authentications;
+
+static WebSocketConfig clientConfig() {
+    WebSocketConfig config;
+    config.host = "gateway.local";
+    config.device_id = BENCH_DEVICE_ID;
+    config.api_key = BENCH_API_KEY;
+    config.connect_timeout_ms = 3000;
+    config.reconnect_interval_ms = 500;
+    config.reconnect_max_interval_ms = 8000;
+    config.receive_queue_size = 64;
+    return config;
+}
+
+// A clean link: fixed latency, nothing lost, quiet
+static LoopbackLink quietLink() {
+    LoopbackLink link;
+    link.latency_ms = 20;
+    link.jitter_ms = 0;
+    link.loss_percent = 0;
+    link.fragment_bytes = 0;
+    link.bandwidth_bps = 0;
+    link.connect_fail_percent = 0;
+    link.report_interval_ms = 0;
+    return link;
+}
+
+// Move the clock forward one millisecond at a time, collecting the text
+// of every reply
+static void run(uint32_t ms, std::vector<String>* replies = nullptr) {
+    for (uint32_t i = 0; i < ms; i++) {
+        HostClock::advance(1);
+        client->update();
+        ProtocolMessage message;
+        while (client->receive(message)) {
+            JsonDocument doc;
+            String json;
+            if (replies && message.getJsonPayload(json) && !deserializeJson(doc, json)) {
+                replies->push_back(String(doc["text"] | ""));
+            }
+        }
+    }
+}
+
+static bool runUntilAuthenticated(uint32_t limit_ms) {
+    for (uint32_t i = 0; i < limit_ms && !client->isAuthenticated(); i++) {
+        run(1);
+    }
+    return client->isAuthenticated();
+}
+
+void setUp() {
+    HostClock::set(1000);
+    authentications = 0;
+    client.reset();                 // One client at a time: it owns the callback
+    client.reset(new WebSocketClient());
+    TEST_ASSERT_TRUE(client->begin(clientConfig()));
+    client->getLoopback().setLink(quietLink());
+    client->getLoopback().resetStats();
+    client->onEvent([](WebSocketEvent event, const void*) {
+        if (event == WebSocketEvent::AUTHENTICATED) authentications++;
+    });
+}
+
+void tearDown() {
+    client.reset();
+}
+
+// Every codec the bridge may answer with: the client speaks it, and a
+// gateway that ignores the offer leaves it on the first one offered
+void test_each_codec_round_trips() {
+    const char* accepted[] = {"openclaw.v2", "openclaw.v1", "openclaw.json", ""};
+    const CodecId expected[] = {CodecId::BINARY_V2, CodecId::BINARY_V1, CodecId::JSON,
+                                CodecId::BINARY_V1};
+    for (size_t i = 0; i < 4; i++) {
+        LoopbackLink link = quietLink();
+        link.subprotocol = accepted[i];
+        client->getLoopback().setLink(link);
+        client->reconnect();
+        TEST_ASSERT_TRUE(runUntilAuthenticated(1000));
+        TEST_ASSERT_EQUAL_UINT8(uint8_t(expected[i]), uint8_t(client->getCodec().getId()));
+
+        std::vector<String> replies;
+        TEST_ASSERT_TRUE(client->sendText("hello"));
+        run(100, &replies);
+        TEST_ASSERT_EQUAL_size_t(1, replies.size());
+        TEST_ASSERT_EQUAL_STRING("echo: hello", replies[0].c_str());
+    }
+}
+
+// Jitter larger than the gap between sends, and frames split into small
+// pieces, must still hand replies over whole and in the order asked
+void test_replies_stay_in_order_under_jitter_and_fragmentation() {
+    LoopbackLink link = quietLink();
+    link.jitter_ms = 15;
+    link.fragment_bytes = 32;
+    link.seed = 42;
+    client->getLoopback().setLink(link);
+    client->connect();
+    TEST_ASSERT_TRUE(runUntilAuthenticated(1000));
+
+    constexpr int REQUESTS = 300;
+    std::vector<String> replies;
+    for (int i = 0; i < REQUESTS; i++) {
+        TEST_ASSERT_TRUE(client->sendText(String(i).c_str()));
+        run(8, &replies);
+    }
+    run(200, &replies);
+
+    TEST_ASSERT_EQUAL_size_t(REQUESTS, replies.size());
+    size_t wrong = 0;
+    for (int i = 0; i < REQUESTS; i++) {
+        if (replies[i] != String("echo: ") + String(i)) wrong++;
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+    TEST_ASSERT_TRUE(client->getLoopback().getStats().fragments > 0);
+}
+
+// Most handshakes refused and every session dropped soon after it comes
+// up: the client keeps trying at no more than the capped backoff, never
+// hammers the gateway, and is back as soon as the link heals
+void test_reconnect_storm_recovers_with_bounded_backoff() {
+    WebSocketConfig config = clientConfig();
+    LoopbackLink link = quietLink();
+    link.connect_fail_percent = 70;
+    link.seed = 7;
+    client->getLoopback().setLink(link);
+    client->connect();
+
+    constexpr uint32_t STORM_MS = 10 * 60 * 1000;
+    uint32_t longest_delay = 0;
+    uint32_t drops = 0;
+    uint32_t up_since = 0;
+    for (uint32_t t = 0; t < STORM_MS; t++) {
+        run(1);
+        longest_delay = max(longest_delay, client->getReconnectDelay());
+        if (!client->isAuthenticated()) {
+            up_since = 0;
+        } else if (up_since == 0) {
+            up_since = millis();
+        } else if (millis() - up_since >= 2000) {
+            client->getLoopback().disconnect();     // Gateway closes the session
+            drops++;
+        }
+    }
+
+    const LoopbackStats& stats = client->getLoopback().getStats();
+    char report[128];
+    snprintf(report, sizeof(report),
+             "10 min storm: %lu handshakes (%lu refused), %lu sessions, %lu drops, longest wait %lu ms",
+             (unsigned long)stats.handshakes, (unsigned long)stats.handshakes_refused,
+             (unsigned long)authentications, (unsigned long)drops, (unsigned long)longest_delay);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_TRUE(drops > 10);
+    TEST_ASSERT_TRUE(stats.handshakes_refused > 10);
+    TEST_ASSERT_EQUAL_UINT32(drops, authentications - (client->isAuthenticated() ? 1 : 0));
+    TEST_ASSERT_TRUE(longest_delay <= config.reconnect_max_interval_ms);
+    // At least the base interval between attempts, even refused ones
+    TEST_ASSERT_TRUE(stats.handshakes <= STORM_MS / config.reconnect_interval_ms);
+    TEST_ASSERT_NOT_EQUAL(ConnectionState::ERROR, client->getState());
+
+    // Healed: back within one capped wait plus a connect timeout
+    link.connect_fail_percent = 0;
+    client->getLoopback().setLink(link);
+    TEST_ASSERT_TRUE(runUntilAuthenticated(config.reconnect_max_interval_ms +
+                                           config.connect_timeout_ms + 1000));
+    TEST_ASSERT_EQUAL_UINT32(config.reconnect_interval_ms, client->getReconnectDelay());
+
+    std::vector<String> replies;
+    TEST_ASSERT_TRUE(client->sendText("after the storm"));
+    run(100, &replies);
+    TEST_ASSERT_EQUAL_size_t(1, replies.size());
+}
+
+// Requests as fast as the link takes them over a 1 Mbit/s, 20 ms link:
+// simulated throughput and round trip, and host time per message
+// (encode, link, decode both ways)
+void test_throughput_benchmark() {
+    LoopbackLink link = quietLink();
+    link.bandwidth_bps = 1000000;
+    client->getLoopback().setLink(link);
+    client->connect();
+    TEST_ASSERT_TRUE(runUntilAuthenticated(1000));
+    client->getLoopback().resetStats();
+
+    constexpr int REQUESTS = 20000;
+    const char* text = "turn the workshop lights off and set a timer for ten minutes";
+    std::vector<String> replies;
+    replies.reserve(REQUESTS);
+
+    uint32_t start_ms = millis();
+    auto start = std::chrono::steady_clock::now();
+    int sent = 0;
+    while (replies.size() < size_t(REQUESTS) && millis() - start_ms < 600000) {
+        // Fill the link until it pushes back, then let time pass
+        while (sent < REQUESTS && client->sendText(text)) sent++;
+        run(1, &replies);
+    }
+    double wall_us = std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count();
+    uint32_t elapsed_ms = millis() - start_ms;
+
+    const LoopbackStats& stats = client->getLoopback().getStats();
+    char report[160];
+    snprintf(report, sizeof(report),
+             "%d requests in %lu ms simulated: %.0f msg/s, %.1f kB/s up; rtt min %lu / avg %lu / max %lu ms; "
+             "%.2f us host time per round trip",
+             REQUESTS, (unsigned long)elapsed_ms, REQUESTS * 1000.0 / elapsed_ms,
+             stats.bytes_up / (double)elapsed_ms, (unsigned long)stats.rtt_min_ms,
+             (unsigned long)(stats.rtt_count ? stats.rtt_total_ms / stats.rtt_count : 0),
+             (unsigned long)stats.rtt_max_ms, wall_us / REQUESTS);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_EQUAL_size_t(REQUESTS, replies.size());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.frames_lost);
+    TEST_ASSERT_TRUE(stats.rtt_min_ms >= 2 * link.latency_ms);
+    // The cap is the bottleneck: upstream runs at more than half of it
+    TEST_ASSERT_TRUE(stats.bytes_up * 8.0 * 1000 / elapsed_ms > link.bandwidth_bps / 2);
+    TEST_ASSERT_TRUE(wall_us / REQUESTS < 1000.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_each_codec_round_trips);
+    RUN_TEST(test_replies_stay_in_order_under_jitter_and_fragmentation);
+    RUN_TEST(test_reconnect_storm_recovers_with_bounded_backoff);
+    RUN_TEST(test_throughput_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_main.cpp
+ * @brief IdleManager stage thresholds, face-down handling, the three wake
+ *        sources, and wake latency at the deep-idle sampling rates
+ */
+
+#include <unity.h>
+#include <optional>
+#include <vector>
+#include "idle_manager.h"
+#include "timer_wheel.h"
+
+using namespace OpenClaw;
+
+struct StageChange {
+    IdleStage from;
+    IdleStage to;
+    WakeSource source;
+    uint32_t at;
+};
+
+static IdleManager* idle;
+static std::vector<StageChange> changes;
+
+static void recordChange(IdleStage from, IdleStage to, WakeSource source) {
+    changes.push_back({from, to, source, millis()});
+}
+
+static void assertChange(size_t index, IdleStage from, IdleStage to, WakeSource source) {
+    TEST_ASSERT_TRUE(index < changes.size());
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(from), uint8_t(changes[index].from));
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(to), uint8_t(changes[index].to));
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(source), uint8_t(changes[index].source));
+}
+
+// Run update() as main.cpp does, every IDLE_CHECK_INTERVAL_MS
+static void runFor(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += IDLE_CHECK_INTERVAL_MS) {
+        HostClock::advance(min(IDLE_CHECK_INTERVAL_MS, ms - t));
+        idle->update(millis());
+    }
+}
+
+void setUp() {
+    HostClock::set(5000);
+    changes.clear();
+    idle = new IdleManager();
+    idle->begin(millis());
+    idle->setOnStageChange(recordChange);
+}
+
+void tearDown() {
+    delete idle;
+    idle = nullptr;
+}
+
+// =============================================================================
+// Thresholds
+// =============================================================================
+
+void test_untouched_device_goes_drowsy_then_asleep() {
+    IdleConfig config;
+    uint32_t start = millis();
+
+    idle->update(start + config.drowsy_after_ms - 1);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+    idle->update(start + config.drowsy_after_ms);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+    idle->update(start + config.asleep_after_ms - 1);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+    idle->update(start + config.asleep_after_ms);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::ASLEEP), uint8_t(idle->getStage()));
+
+    TEST_ASSERT_EQUAL_size_t(2, changes.size());
+    assertChange(0, IdleStage::AWAKE, IdleStage::DROWSY, WakeSource::NONE);
+    assertChange(1, IdleStage::DROWSY, IdleStage::ASLEEP, WakeSource::NONE);
+}
+
+// A late check still steps through DROWSY, so its work runs first
+void test_late_update_steps_through_each_stage() {
+    idle->update(millis() + 10 * 60 * 1000);
+    TEST_ASSERT_EQUAL_size_t(2, changes.size());
+    assertChange(0, IdleStage::AWAKE, IdleStage::DROWSY, WakeSource::NONE);
+    assertChange(1, IdleStage::DROWSY, IdleStage::ASLEEP, WakeSource::NONE);
+}
+
+// Activity restarts the countdown without a stage change
+void test_activity_while_awake_restarts_the_countdown() {
+    IdleConfig config;
+    runFor(config.drowsy_after_ms - 1000);
+    TEST_ASSERT_FALSE(idle->wake(WakeSource::KEYBOARD, millis()));
+    runFor(config.drowsy_after_ms - 1000);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+    runFor(1000);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+    TEST_ASSERT_EQUAL_UINT32(0, idle->getWakeCount());
+}
+
+// A voice capture holds the device awake; the countdown starts over when
+// the hold ends
+void test_inhibit_holds_awake() {
+    IdleConfig config;
+    idle->setInhibited(true, millis());
+    runFor(config.asleep_after_ms * 2);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+
+    idle->setInhibited(false, millis());
+    runFor(config.drowsy_after_ms - IDLE_CHECK_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+    runFor(IDLE_CHECK_INTERVAL_MS);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+}
+
+// =============================================================================
+// Face-down
+// =============================================================================
+
+void test_face_down_sleeps_fast_and_face_up_wakes() {
+    IdleConfig config;
+    uint32_t down = millis();
+    idle->setFaceDown(true, down);
+
+    idle->update(down + config.face_down_drowsy_ms - 1);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+    idle->update(down + config.face_down_drowsy_ms);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+    idle->update(down + config.face_down_asleep_ms - 1);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::DROWSY), uint8_t(idle->getStage()));
+    idle->update(down + config.face_down_asleep_ms);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::ASLEEP), uint8_t(idle->getStage()));
+
+    // Repeated samples don't restart the face-down clock
+    idle->setFaceDown(true, down + config.face_down_asleep_ms + 100);
+
+    // Turned back over: one change straight to AWAKE, as motion
+    HostClock::set(down + config.face_down_asleep_ms + 500);
+    idle->setFaceDown(false, millis());
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+    TEST_ASSERT_EQUAL_size_t(3, changes.size());
+    assertChange(2, IdleStage::ASLEEP, IdleStage::AWAKE, WakeSource::MOTION);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(WakeSource::MOTION), uint8_t(idle->getLastWakeSource()));
+
+    // And the untouched countdown runs from the pick-up
+    idle->update(millis() + config.drowsy_after_ms - 1);
+    TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+}
+
+// Face-down for a moment (set down and picked up again) never dims
+void test_brief_face_down_stays_awake() {
+    IdleConfig config;
+    idle->setFaceDown(true, millis());
+    runFor(config.face_down_drowsy_ms - IDLE_CHECK_INTERVAL_MS);
+    idle->setFaceDown(false, millis());
+    runFor(config.face_down_asleep_ms);
+    TEST_ASSERT_EQUAL_size_t(0, changes.size());
+    TEST_ASSERT_EQUAL_UINT32(0, idle->getWakeCount());
+}
+
+// =============================================================================
+// Wake sources
+// =============================================================================
+
+void test_each_source_wakes_from_either_stage() {
+    IdleConfig config;
+    const WakeSource sources[] = {WakeSource::KEYBOARD, WakeSource::MOTION, WakeSource::GATEWAY};
+    const IdleStage stages[] = {IdleStage::DROWSY, IdleStage::ASLEEP};
+    uint32_t wakes = 0;
+
+    for (WakeSource source : sources) {
+        for (IdleStage stage : stages) {
+            uint32_t after = stage == IdleStage::DROWSY ? config.drowsy_after_ms
+                                                        : config.asleep_after_ms;
+            runFor(after);
+            TEST_ASSERT_EQUAL_UINT8(uint8_t(stage), uint8_t(idle->getStage()));
+
+            changes.clear();
+            TEST_ASSERT_TRUE(idle->wake(source, millis()));
+            wakes++;
+            TEST_ASSERT_EQUAL_size_t(1, changes.size());
+            assertChange(0, stage, IdleStage::AWAKE, source);
+            TEST_ASSERT_EQUAL_UINT8(uint8_t(source), uint8_t(idle->getLastWakeSource()));
+            TEST_ASSERT_EQUAL_UINT32(wakes, idle->getWakeCount());
+
+            // Already awake: nothing more to do
+            TEST_ASSERT_FALSE(idle->wake(source, millis()));
+            TEST_ASSERT_EQUAL_size_t(1, changes.size());
+        }
+    }
+}
+
+// =============================================================================
+// Wake latency
+//
+// The main loop as it runs in deep idle: the key scan task and the IMU
+// are sampled on timers at their ASLEEP rates (keyboard_handler.h,
+// avatar_sensors.h), and a gateway push wakes the loop straight from the
+// socket watcher. The time from the event to the AWAKE callback must stay
+// under the 100 ms resume target, wherever the event falls between samples.
+// =============================================================================
+
+constexpr uint32_t WAKE_TARGET_MS = 100;
+constexpr uint32_t IDLE_KEY_SCAN_MS = 25;           // KEYBOARD_IDLE_SCAN_INTERVAL_MS
+constexpr uint32_t IDLE_MOTION_SAMPLE_MS = 100;     // SENSOR_IDLE_SAMPLE_INTERVAL_MS
+
+static std::optional<TimerWheel> timers;
+static WakeSource pending_source;
+static uint32_t pending_at;
+
+static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+static bool eventPending(WakeSource source) {
+    return pending_source == source && !before(millis(), pending_at);
+}
+
+static void scanKeys(void*) {
+    if (eventPending(WakeSource::KEYBOARD)) idle->wake(WakeSource::KEYBOARD, millis());
+}
+
+static void sampleMotion(void*) {
+    if (eventPending(WakeSource::MOTION)) idle->wake(WakeSource::MOTION, millis());
+}
+
+// Worst event-to-AWAKE time for one source over every offset between samples
+static uint32_t worstWakeLatency(WakeSource source) {
+    uint32_t worst = 0;
+    for (uint32_t offset = 0; offset < 2 * IDLE_MOTION_SAMPLE_MS; offset++) {
+        HostClock::set(5000);
+        changes.clear();
+        idle->begin(millis());
+        timers.emplace();
+        timers->scheduleEvery(IDLE_CHECK_INTERVAL_MS, [](void*) { idle->update(millis()); });
+        timers->scheduleEvery(IDLE_KEY_SCAN_MS, scanKeys);
+        timers->scheduleEvery(IDLE_MOTION_SAMPLE_MS, sampleMotion);
+        pending_source = WakeSource::NONE;
+
+        // Fall asleep, then the event lands somewhere between samples
+        idle->setFaceDown(true, millis());
+        while (idle->getStage() != IdleStage::ASLEEP) {
+            HostClock::advance(1);
+            timers->advance(millis());
+        }
+        pending_source = source;
+        pending_at = millis() + 1 + offset;
+
+        for (uint32_t t = 0; idle->getStage() == IdleStage::ASLEEP && t < 1000 + offset; t++) {
+            HostClock::advance(1);
+            timers->advance(millis());
+            if (source == WakeSource::GATEWAY && eventPending(source)) {
+                idle->wake(source, millis());       // LOOP_SIGNAL_NETWORK
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT8(uint8_t(IdleStage::AWAKE), uint8_t(idle->getStage()));
+        worst = max(worst, changes.back().at - pending_at);
+    }
+    timers.reset();
+    return worst;
+}
+
+void test_wake_latency_within_target() {
+    uint32_t keyboard = worstWakeLatency(WakeSource::KEYBOARD);
+    uint32_t motion = worstWakeLatency(WakeSource::MOTION);
+    uint32_t gateway = worstWakeLatency(WakeSource::GATEWAY);
+
+    char report[128];
+    snprintf(report, sizeof(report),
+             "worst wake from ASLEEP: keyboard %lu ms, motion %lu ms, gateway %lu ms",
+             (unsigned long)keyboard, (unsigned long)motion, (unsigned long)gateway);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_TRUE(keyboard < WAKE_TARGET_MS);
+    TEST_ASSERT_TRUE(motion < WAKE_TARGET_MS);
+    TEST_ASSERT_EQUAL_UINT32(0, gateway);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_untouched_device_goes_drowsy_then_asleep);
+    RUN_TEST(test_late_update_steps_through_each_stage);
+    RUN_TEST(test_activity_while_awake_restarts_the_countdown);
+    RUN_TEST(test_inhibit_holds_awake);
+    RUN_TEST(test_face_down_sleeps_fast_and_face_up_wakes);
+    RUN_TEST(test_brief_face_down_stays_awake);
+    RUN_TEST(test_each_source_wakes_from_either_stage);
+    RUN_TEST(test_wake_latency_within_target);
+    return UNITY_END();
+}
@@ -0,0 +1,328 @@
+/**
+ * @file test_main.cpp
+ * @brief InputBuffer against a std::string reference: random edits at
+ *        random cursor positions, the length cap, change ranges, and a
+ *        per-keystroke benchmark at short and long prompts
+ */
+
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include "input_buffer.h"
+
+using namespace OpenClaw;
+
+static InputBuffer* buffer;
+
+void setUp() {
+    buffer = new InputBuffer();
+}
+
+void tearDown() {
+    delete buffer;
+    buffer = nullptr;
+}
+
+static void assertChange(size_t pos, size_t removed, size_t inserted,
+                         size_t old_cursor, size_t new_cursor) {
+    const InputChange& change = buffer->getLastChange();
+    TEST_ASSERT_EQUAL_size_t(pos, change.pos);
+    TEST_ASSERT_EQUAL_size_t(removed, change.removed);
+    TEST_ASSERT_EQUAL_size_t(inserted, change.inserted);
+    TEST_ASSERT_EQUAL_size_t(old_cursor, change.old_cursor);
+    TEST_ASSERT_EQUAL_size_t(new_cursor, change.new_cursor);
+}
+
+// =============================================================================
+// Change ranges
+// =============================================================================
+
+void test_each_edit_reports_its_range() {
+    TEST_ASSERT_TRUE(buffer->setText("hello world"));
+    assertChange(0, 0, 11, 0, 11);
+
+    buffer->moveCursorTo(5);
+    assertChange(5, 0, 0, 11, 5);
+    TEST_ASSERT_TRUE(buffer->getLastChange().isCursorOnly());
+
+    TEST_ASSERT_TRUE(buffer->insert(','));
+    assertChange(5, 0, 1, 5, 6);
+    TEST_ASSERT_TRUE(buffer->insertString(" big"));
+    assertChange(6, 0, 4, 6, 10);
+    TEST_ASSERT_TRUE(buffer->backspace());
+    assertChange(9, 1, 0, 10, 9);
+    TEST_ASSERT_TRUE(buffer->deleteChar());
+    assertChange(9, 1, 0, 9, 9);
+    TEST_ASSERT_EQUAL_STRING("hello, biworld", buffer->getText());
+
+    buffer->moveCursorHome();
+    TEST_ASSERT_FALSE(buffer->backspace());     // Nothing before the cursor
+    assertChange(0, 0, 0, 9, 0);
+    buffer->moveCursorEnd();
+    TEST_ASSERT_FALSE(buffer->deleteChar());    // Nothing after it
+    assertChange(14, 0, 0, 0, 14);
+
+    buffer->clear();
+    assertChange(0, 14, 0, 14, 0);
+    TEST_ASSERT_TRUE(buffer->isEmpty());
+    TEST_ASSERT_EQUAL_STRING("", buffer->getText());
+}
+
+// =============================================================================
+// Cap
+// =============================================================================
+
+void test_cap_at_max_length() {
+    std::string full(INPUT_BUFFER_MAX_LENGTH - 1, 'x');
+    TEST_ASSERT_TRUE(buffer->setText(full.c_str()));
+    buffer->moveCursorTo(100);
+    TEST_ASSERT_TRUE(buffer->insert('y'));
+    TEST_ASSERT_TRUE(buffer->isFull());
+    full.insert(100, 1, 'y');
+
+    // Full: every way in is refused and leaves text and change as they were
+    TEST_ASSERT_FALSE(buffer->insert('z'));
+    TEST_ASSERT_FALSE(buffer->insertString("z"));
+    assertChange(100, 0, 1, 100, 101);
+    TEST_ASSERT_EQUAL_size_t(INPUT_BUFFER_MAX_LENGTH, buffer->getLength());
+    TEST_ASSERT_TRUE(full == buffer->getText());
+
+    std::string over(INPUT_BUFFER_MAX_LENGTH + 1, 'o');
+    TEST_ASSERT_FALSE(buffer->setText(over.c_str()));
+    TEST_ASSERT_TRUE(full == buffer->getText());
+
+    // A string that would cross the cap goes in whole or not at all
+    TEST_ASSERT_TRUE(buffer->backspace());
+    TEST_ASSERT_FALSE(buffer->insertString("ab"));
+    TEST_ASSERT_EQUAL_size_t(INPUT_BUFFER_MAX_LENGTH - 1, buffer->getLength());
+    TEST_ASSERT_TRUE(buffer->insertString("a"));
+    TEST_ASSERT_TRUE(buffer->isFull());
+}
+
+// =============================================================================
+// Random edits against a reference
+// =============================================================================
+
+static std::mt19937 rng;
+static std::string text;
+static size_t cursor;
+static size_t wrong;
+
+static void check(size_t pos, size_t removed, size_t inserted, size_t old_cursor) {
+    const InputChange& change = buffer->getLastChange();
+    if (buffer->getLength() != text.size() || buffer->getCursor() != cursor) wrong++;
+    if (change.pos != pos || change.removed != removed || change.inserted != inserted ||
+        change.old_cursor != old_cursor || change.new_cursor != cursor) {
+        wrong++;
+    }
+}
+
+// Both random access paths, without closing the gap
+static void checkText() {
+    for (size_t i = 0; i < text.size(); i++) {
+        if (buffer->charAt(i) != text[i]) {
+            wrong++;
+            break;
+        }
+    }
+    if (buffer->charAt(text.size()) != '\0') wrong++;
+
+    char window[64];
+    size_t start = text.empty() ? 0 : rng() % text.size();
+    size_t n = buffer->copyRange(start, sizeof(window), window);
+    size_t expected = text.empty() ? 0 : std::min(sizeof(window), text.size() - start);
+    if (n != expected || text.compare(start, n, window, n) != 0) wrong++;
+}
+
+static bool sameChange(const InputChange& a, const InputChange& b) {
+    return a.pos == b.pos && a.removed == b.removed && a.inserted == b.inserted &&
+           a.old_cursor == b.old_cursor && a.new_cursor == b.new_cursor;
+}
+
+enum class Edit { INSERT, INSERT_STRING, BACKSPACE, DELETE, MOVE, STEP, REDRAW };
+
+// Mostly typing while growing, mostly deleting while shrinking
+static Edit randomKind(bool growing) {
+    static const Edit grow[] = {Edit::INSERT, Edit::INSERT, Edit::INSERT, Edit::INSERT,
+                                Edit::INSERT, Edit::INSERT_STRING, Edit::BACKSPACE,
+                                Edit::MOVE, Edit::STEP, Edit::REDRAW};
+    static const Edit shrink[] = {Edit::INSERT, Edit::BACKSPACE, Edit::BACKSPACE,
+                                  Edit::DELETE, Edit::DELETE, Edit::DELETE,
+                                  Edit::MOVE, Edit::STEP, Edit::STEP, Edit::REDRAW};
+    return growing ? grow[rng() % 10] : shrink[rng() % 10];
+}
+
+static void randomEdit(bool growing) {
+    size_t old_cursor = cursor;
+    const InputChange before = buffer->getLastChange();
+    bool applied = false;
+
+    switch (randomKind(growing)) {
+        case Edit::INSERT: {
+            char c = char('a' + rng() % 26);
+            applied = text.size() < INPUT_BUFFER_MAX_LENGTH;
+            if (buffer->insert(c) != applied) wrong++;
+            if (applied) {
+                text.insert(cursor++, 1, c);
+                check(old_cursor, 0, 1, old_cursor);
+            }
+            break;
+        }
+        case Edit::INSERT_STRING: {
+            std::string s(rng() % 24, char('A' + rng() % 26));
+            applied = text.size() + s.size() <= INPUT_BUFFER_MAX_LENGTH;
+            if (buffer->insertString(s.c_str()) != applied) wrong++;
+            if (applied) {
+                text.insert(cursor, s);
+                cursor += s.size();
+                check(old_cursor, 0, s.size(), old_cursor);
+            }
+            break;
+        }
+        case Edit::BACKSPACE:
+            applied = cursor > 0;
+            if (buffer->backspace() != applied) wrong++;
+            if (applied) {
+                text.erase(--cursor, 1);
+                check(cursor, 1, 0, old_cursor);
+            }
+            break;
+        case Edit::DELETE:
+            applied = cursor < text.size();
+            if (buffer->deleteChar() != applied) wrong++;
+            if (applied) {
+                text.erase(cursor, 1);
+                check(cursor, 1, 0, old_cursor);
+            }
+            break;
+        case Edit::MOVE:
+            applied = true;
+            cursor = rng() % (text.size() + 1);
+            buffer->moveCursorTo(cursor);
+            check(cursor, 0, 0, old_cursor);
+            break;
+        case Edit::STEP:
+            // Left at the start and right at the end are no-ops; home and
+            // end always report a move
+            switch (rng() % 4) {
+                case 0:
+                    applied = cursor > 0;
+                    buffer->moveCursorLeft();
+                    if (applied) cursor--;
+                    break;
+                case 1:
+                    applied = cursor < text.size();
+                    buffer->moveCursorRight();
+                    if (applied) cursor++;
+                    break;
+                case 2:
+                    applied = true;
+                    buffer->moveCursorHome();
+                    cursor = 0;
+                    break;
+                default:
+                    applied = true;
+                    buffer->moveCursorEnd();
+                    cursor = text.size();
+                    break;
+            }
+            if (applied) check(cursor, 0, 0, old_cursor);
+            break;
+        case Edit::REDRAW:
+            // Closes the gap at the end; editing goes on from there
+            if (text != buffer->getText()) wrong++;
+            break;
+    }
+
+    // Refused edits, no-op moves and reads leave everything as it was
+    if (!applied) {
+        if (!sameChange(before, buffer->getLastChange())) wrong++;
+        if (buffer->getLength() != text.size() || buffer->getCursor() != cursor) wrong++;
+    }
+}
+
+void test_random_edits_match_reference() {
+    rng.seed(1);
+    text.clear();
+    cursor = 0;
+    wrong = 0;
+
+    // Grow to the cap and back down, twice
+    size_t refused_at_cap = 0;
+    for (int round = 0; round < 4; round++) {
+        bool growing = round % 2 == 0;
+        for (int step = 0; step < 60000; step++) {
+            randomEdit(growing);
+            if (text.size() == INPUT_BUFFER_MAX_LENGTH) refused_at_cap++;
+            if (step % 64 == 0) checkText();
+        }
+        if (growing) {
+            TEST_ASSERT_EQUAL_size_t(INPUT_BUFFER_MAX_LENGTH, text.size());
+        } else {
+            TEST_ASSERT_TRUE(text.size() < 64);
+        }
+    }
+    TEST_ASSERT_TRUE(refused_at_cap > 1000);
+    TEST_ASSERT_TRUE(text == buffer->getText());
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+
+    // And a wholesale replace at the end of it all
+    TEST_ASSERT_TRUE(buffer->setText("fresh"));
+    TEST_ASSERT_EQUAL_STRING("fresh", buffer->getText());
+    TEST_ASSERT_EQUAL_size_t(5, buffer->getCursor());
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+// Nanoseconds per keystroke (type a character, then take it back) in the
+// middle of a prompt of the given length; best of a few runs
+static double keystrokeNs(size_t length) {
+    std::string start(length, 'p');
+    double best = 1e30;
+    for (int run = 0; run < 5; run++) {
+        buffer->setText(start.c_str());
+        buffer->moveCursorTo(length / 2);
+        buffer->insert('k');                // Gap moves to the cursor once
+
+        constexpr int KEYSTROKES = 200000;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < KEYSTROKES; i++) {
+            if (i & 1) {
+                buffer->backspace();
+            } else {
+                buffer->insert(char('a' + i % 26));
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - t0).count() / KEYSTROKES;
+        best = std::min(best, ns);
+    }
+    TEST_ASSERT_EQUAL_size_t(length + 1, buffer->getLength());
+    return best;
+}
+
+void test_keystroke_cost_independent_of_length() {
+    double short_ns = keystrokeNs(100);
+    double long_ns = keystrokeNs(INPUT_BUFFER_MAX_LENGTH - 192);
+
+    char report[128];
+    snprintf(report, sizeof(report),
+             "per keystroke mid-prompt: %.1f ns at 100 B, %.1f ns at 8 KB (%.2fx)",
+             short_ns, long_ns, long_ns / short_ns);
+    TEST_MESSAGE(report);
+
+    // A shifting buffer would be ~80x slower at 8 KB; the gap keeps it flat
+    TEST_ASSERT_TRUE(long_ns < short_ns * 4 + 5);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_each_edit_reports_its_range);
+    RUN_TEST(test_cap_at_max_length);
+    RUN_TEST(test_random_edits_match_reference);
+    RUN_TEST(test_keystroke_cost_independent_of_length);
+    return UNITY_END();
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_main.cpp
+ * @brief PhraseTrie against a brute-force reference, arena growth with
+ *        and without PSRAM, and a lookup benchmark
+ */
+
+#include <unity.h>
+#include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "phrase_trie.h"
+
+using namespace OpenClaw;
+
+static const char* const WORDS[] = {
+    "what", "is", "the", "weather", "today", "tell", "me", "a", "joke", "about",
+    "owls", "how", "do", "i", "set", "timer", "for", "minutes", "play", "music",
+    "turn", "on", "lights", "in", "kitchen", "remind", "to", "call", "mom", "tomorrow",
+};
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+// Phrases with plenty of shared prefixes, so adds split edges often
+static std::vector<std::string> makePhrases(size_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::string> phrases;
+    while (phrases.size() < count) {
+        std::string p;
+        size_t words = 1 + rng() % 5;
+        for (size_t i = 0; i < words; i++) {
+            if (i) p += ' ';
+            p += WORDS[rng() % WORD_COUNT];
+        }
+        if (rng() % 2) p += " " + std::to_string(rng() % 100);
+        phrases.push_back(p);
+    }
+    return phrases;
+}
+
+// What the trie should hold: same saturation and halving rule
+struct Reference {
+    std::map<std::string, uint32_t> weights;
+
+    void add(const std::string& phrase, uint16_t count) {
+        uint32_t& w = weights[phrase];
+        w = std::min<uint32_t>(w + count, 0xFFFF);
+        if (w == 0xFFFF) {
+            for (auto& kv : weights) kv.second = (kv.second + 1) / 2;
+        }
+    }
+
+    // Heaviest weight among phrases strictly longer than the prefix
+    uint32_t best(const std::string& prefix) const {
+        uint32_t best = 0;
+        for (auto it = weights.lower_bound(prefix); it != weights.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) != 0) break;
+            if (it->first.size() > prefix.size()) best = std::max(best, it->second);
+        }
+        return best;
+    }
+};
+
+static PhraseTrie* trie;
+
+void setUp() {
+    LittleFS.format();
+    trie = new PhraseTrie();
+    TEST_ASSERT_TRUE(trie->begin());
+}
+
+void tearDown() {
+    delete trie;
+    HostHeap::spiram_available = true;
+}
+
+// Completion must return a phrase of the heaviest weight below the
+// prefix; large counts saturate weights so decay() runs many times
+static size_t checkAgainst(const Reference& ref, const std::vector<std::string>& phrases,
+                           std::mt19937& rng, size_t probes) {
+    size_t mismatches = 0;
+    char out[PHRASE_MAX_LENGTH + 1];
+    for (size_t i = 0; i < probes; i++) {
+        const std::string& p = phrases[rng() % phrases.size()];
+        std::string prefix = p.substr(0, 1 + rng() % p.size());
+
+        uint32_t expected = ref.best(prefix);
+        size_t n = trie->complete(prefix.c_str(), out, sizeof(out));
+        if (expected == 0) {
+            if (n != 0) mismatches++;
+            continue;
+        }
+        auto it = ref.weights.find(out);
+        if (n == 0 || it == ref.weights.end() || it->second != expected ||
+            it->first.compare(0, prefix.size(), prefix) != 0) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+void test_matches_reference_without_decay() {
+    std::vector<std::string> phrases = makePhrases(1500, 1);
+    std::mt19937 rng(2);
+    Reference ref;
+    for (size_t i = 0; i < 20000; i++) {
+        const std::string& p = phrases[std::min(rng() % phrases.size(), rng() % phrases.size())];
+        TEST_ASSERT_TRUE(trie->add(p.c_str()));
+        ref.add(p, 1);
+    }
+    TEST_ASSERT_EQUAL_size_t(ref.weights.size(), trie->getPhraseCount());
+    for (const auto& kv : ref.weights) {
+        TEST_ASSERT_EQUAL_UINT32(kv.second, trie->getWeight(kv.first.c_str()));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, checkAgainst(ref, phrases, rng, 20000));
+}
+
+void test_matches_reference_through_decay() {
+    std::vector<std::string> phrases = makePhrases(1500, 3);
+    std::mt19937 rng(4);
+    Reference ref;
+    size_t mismatches = 0;
+    for (size_t round = 0; round < 40; round++) {
+        for (size_t i = 0; i < 500; i++) {
+            const std::string& p = phrases[rng() % phrases.size()];
+            uint16_t count = 1 + rng() % 4000;
+            TEST_ASSERT_TRUE(trie->add(p.c_str(), count));
+            ref.add(p, count);
+        }
+        mismatches += checkAgainst(ref, phrases, rng, 1000);
+    }
+    for (const auto& kv : ref.weights) {
+        TEST_ASSERT_EQUAL_UINT32(kv.second, trie->getWeight(kv.first.c_str()));
+    }
+    TEST_ASSERT_EQUAL_size_t(0, mismatches);
+}
+
+void test_save_load_round_trip() {
+    std::vector<std::string> phrases = makePhrases(500, 5);
+    for (size_t i = 0; i < phrases.size(); i++) {
+        TEST_ASSERT_TRUE(trie->add(phrases[i].c_str(), 1 + i % 7));
+    }
+    TEST_ASSERT_TRUE(trie->save());
+    TEST_ASSERT_FALSE(trie->isDirty());
+
+    PhraseTrie loaded;
+    TEST_ASSERT_TRUE(loaded.begin());
+    TEST_ASSERT_TRUE(loaded.load());
+    TEST_ASSERT_EQUAL_size_t(trie->getNodeCount(), loaded.getNodeCount());
+    for (const auto& p : phrases) {
+        TEST_ASSERT_EQUAL_UINT16(trie->getWeight(p.c_str()), loaded.getWeight(p.c_str()));
+    }
+
+    // A truncated file is rejected and leaves an empty trie
+    LittleFS.data(PHRASE_TRIE_FILE)->pop_back();
+    TEST_ASSERT_FALSE(loaded.load());
+    TEST_ASSERT_EQUAL_size_t(0, loaded.getPhraseCount());
+}
+
+// Starts at a few KB and doubles as phrases come in, up to the cap;
+// nothing added along the way is lost to a move
+static size_t fillUntilRefused(PhraseTrie& t, std::vector<std::string>& added) {
+    size_t last_arena = t.getArenaBytes();
+    size_t growths = 0;
+    for (uint32_t i = 0;; i++) {
+        std::string p = "phrase " + std::to_string(i * 7919u) + " of the day";
+        if (!t.add(p.c_str())) break;
+        added.push_back(p);
+        if (t.getArenaBytes() != last_arena) {
+            growths++;
+            last_arena = t.getArenaBytes();
+        }
+    }
+    return growths;
+}
+
+void test_arenas_grow_on_demand_to_the_cap() {
+    TEST_ASSERT_EQUAL_size_t(PHRASE_TRIE_INITIAL_NODES * 16 + PHRASE_TRIE_INITIAL_LABEL_BYTES,
+                             trie->getArenaBytes());
+
+    std::vector<std::string> added;
+    size_t growths = fillUntilRefused(*trie, added);
+    TEST_ASSERT_TRUE(growths >= 5);
+    TEST_ASSERT_TRUE(trie->isFull() || trie->getLabelBytes() + 32 > PHRASE_TRIE_MAX_LABEL_BYTES);
+    TEST_ASSERT_TRUE(trie->getArenaBytes() <= PHRASE_TRIE_MAX_NODES * 16 + PHRASE_TRIE_MAX_LABEL_BYTES);
+    TEST_ASSERT_EQUAL_STRING("Phrase index full", trie->getLastError());
+    for (const auto& p : added) {
+        TEST_ASSERT_EQUAL_UINT16(1, trie->getWeight(p.c_str()));
+    }
+
+    // A saved full index loads into a fresh, small trie
+    TEST_ASSERT_TRUE(trie->save());
+    PhraseTrie loaded;
+    TEST_ASSERT_TRUE(loaded.begin());
+    TEST_ASSERT_TRUE(loaded.load());
+    TEST_ASSERT_EQUAL_size_t(added.size(), loaded.getPhraseCount());
+    TEST_ASSERT_EQUAL_UINT16(1, loaded.getWeight(added.back().c_str()));
+}
+
+// No PSRAM: the arenas stop at the internal-RAM limit instead of taking
+// the whole cap out of SRAM, and what fitted keeps working
+void test_without_psram_stays_within_internal_limit() {
+    std::vector<std::string> big;
+    fillUntilRefused(*trie, big);
+    TEST_ASSERT_TRUE(trie->save());
+
+    HostHeap::spiram_available = false;
+    PhraseTrie small;
+    TEST_ASSERT_TRUE(small.begin());
+
+    std::vector<std::string> added;
+    fillUntilRefused(small, added);
+    TEST_ASSERT_TRUE(added.size() > 100);
+    TEST_ASSERT_TRUE(small.getArenaBytes() <= PHRASE_TRIE_INTERNAL_MAX_NODES * 16 +
+                                              PHRASE_TRIE_INTERNAL_MAX_LABEL_BYTES);
+    TEST_ASSERT_EQUAL_STRING("Phrase index full", small.getLastError());
+    char out[PHRASE_MAX_LENGTH + 1];
+    TEST_ASSERT_TRUE(small.complete("phrase", out, sizeof(out)) > 0);
+    for (const auto& p : added) {
+        TEST_ASSERT_EQUAL_UINT16(1, small.getWeight(p.c_str()));
+    }
+
+    // An index saved on a bigger heap doesn't fit: refused, left empty
+    TEST_ASSERT_FALSE(small.load());
+    TEST_ASSERT_EQUAL_STRING("Phrase file too large for memory", small.getLastError());
+    TEST_ASSERT_EQUAL_size_t(0, small.getPhraseCount());
+    TEST_ASSERT_TRUE(small.add("still works"));
+
+    small.end();
+    TEST_ASSERT_EQUAL_size_t(0, small.getArenaBytes());
+    TEST_ASSERT_FALSE(small.add("after end"));
+}
+
+// Thousands of entries; the budget on the device is 1 ms per lookup
+void test_lookup_benchmark() {
+    std::vector<std::string> phrases = makePhrases(3000, 6);
+    std::mt19937 rng(7);
+    for (size_t i = 0; i < 30000; i++) {
+        trie->add(phrases[std::min(rng() % phrases.size(), rng() % phrases.size())].c_str());
+    }
+
+    constexpr size_t LOOKUPS = 200000;
+    std::vector<std::string> prefixes;
+    for (size_t i = 0; i < LOOKUPS; i++) {
+        const std::string& p = phrases[rng() % phrases.size()];
+        prefixes.push_back(p.substr(0, 1 + rng() % std::min<size_t>(p.size(), 12)));
+    }
+
+    char out[PHRASE_MAX_LENGTH + 1];
+    size_t hits = 0;
+    std::vector<double> times_us;
+    times_us.reserve(LOOKUPS);
+    for (const auto& prefix : prefixes) {
+        auto t0 = std::chrono::steady_clock::now();
+        hits += trie->complete(prefix.c_str(), out, sizeof(out)) > 0;
+        times_us.push_back(std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - t0).count());
+    }
+    double mean_us = 0;
+    for (double t : times_us) mean_us += t;
+    mean_us /= LOOKUPS;
+    std::sort(times_us.begin(), times_us.end());
+    double p99_us = times_us[LOOKUPS * 99 / 100];
+
+    char report[128];
+    snprintf(report, sizeof(report), "%zu phrases, %zu nodes: %.2f us/lookup (p99 %.2f us), %zu hits",
+             trie->getPhraseCount(), trie->getNodeCount(), mean_us, p99_us, hits);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_GREATER_THAN(0, hits);
+    TEST_ASSERT_TRUE(p99_us < 1000.0);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_reference_without_decay);
+    RUN_TEST(test_matches_reference_through_decay);
+    RUN_TEST(test_save_load_round_trip);
+    RUN_TEST(test_arenas_grow_on_demand_to_the_cap);
+    RUN_TEST(test_without_psram_stays_within_internal_limit);
+    RUN_TEST(test_lookup_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,133 @@
+/**
+ * @file test_main.cpp
+ * @brief PowerPolicy decision and current-model tests
+ */
+
+#include <unity.h>
+#include <initializer_list>
+#include "power_policy.h"
+
+using namespace OpenClaw;
+
+static PowerPolicy policy;
+
+static PowerInputs interacting() {
+    PowerInputs in;
+    in.wifi_connected = true;
+    in.ms_since_input = 1000;
+    in.backlight = 128;
+    in.cpu_busy_percent = 20;
+    return in;
+}
+
+void setUp() {
+    policy = PowerPolicy();
+}
+
+void tearDown() {}
+
+void test_interaction_runs_slow_and_awake() {
+    PowerDecision d = policy.evaluate(interacting());
+    TEST_ASSERT_EQUAL(PowerMode::ACTIVE, d.mode);
+    TEST_ASSERT_EQUAL_UINT16(80, d.cpu_mhz);
+    TEST_ASSERT_FALSE(d.light_sleep);
+    TEST_ASSERT_EQUAL(WifiPowerSave::MIN_MODEM, d.wifi_ps);
+}
+
+void test_any_boost_holds_max_clock() {
+    for (uint8_t bit : {POWER_BOOST_AUDIO, POWER_BOOST_RENDER, POWER_BOOST_NETWORK}) {
+        PowerInputs in = interacting();
+        in.boost_mask = bit;
+        in.face_down = true;            // Boost wins over idle
+        PowerDecision d = policy.evaluate(in);
+        TEST_ASSERT_EQUAL(PowerMode::BOOST, d.mode);
+        TEST_ASSERT_EQUAL_UINT16(240, d.cpu_mhz);
+        TEST_ASSERT_FALSE(d.light_sleep);
+    }
+}
+
+void test_idle_after_timeout_or_face_down() {
+    PowerInputs in = interacting();
+    in.ms_since_input = 29999;
+    TEST_ASSERT_EQUAL(PowerMode::ACTIVE, policy.evaluate(in).mode);
+
+    in.ms_since_input = 30000;
+    PowerDecision d = policy.evaluate(in);
+    TEST_ASSERT_EQUAL(PowerMode::IDLE, d.mode);
+    TEST_ASSERT_TRUE(d.light_sleep);
+    TEST_ASSERT_EQUAL(WifiPowerSave::MAX_MODEM, d.wifi_ps);
+
+    in = interacting();
+    in.face_down = true;
+    TEST_ASSERT_EQUAL(PowerMode::IDLE, policy.evaluate(in).mode);
+}
+
+void test_light_sleep_needs_platform_config_and_quiet_mic() {
+    PowerInputs in = interacting();
+    in.face_down = true;
+    TEST_ASSERT_TRUE(policy.evaluate(in).light_sleep);
+    TEST_ASSERT_FALSE(policy.evaluate(in, false).light_sleep);
+
+    in.audio_streaming = true;
+    TEST_ASSERT_FALSE(policy.evaluate(in).light_sleep);
+
+    PowerPolicyConfig config;
+    config.allow_light_sleep = false;
+    policy.setConfig(config);
+    in.audio_streaming = false;
+    TEST_ASSERT_FALSE(policy.evaluate(in).light_sleep);
+}
+
+void test_radio_full_power_only_while_streaming() {
+    PowerInputs in = interacting();
+    in.audio_streaming = true;
+    TEST_ASSERT_EQUAL(WifiPowerSave::NONE, policy.evaluate(in).wifi_ps);
+
+    in = interacting();
+    in.wifi_connected = false;
+    TEST_ASSERT_EQUAL(WifiPowerSave::NONE, policy.evaluate(in).wifi_ps);
+}
+
+void test_current_estimate_orders_modes() {
+    PowerInputs active = interacting();
+    PowerInputs boosted = interacting();
+    boosted.boost_mask = POWER_BOOST_AUDIO;
+    boosted.audio_streaming = true;
+    PowerInputs idle = interacting();
+    idle.face_down = true;
+    idle.backlight = 0;
+
+    float boost_ma = policy.estimateCurrentMa(boosted, policy.evaluate(boosted));
+    float active_ma = policy.estimateCurrentMa(active, policy.evaluate(active));
+    float idle_ma = policy.estimateCurrentMa(idle, policy.evaluate(idle));
+
+    TEST_ASSERT_TRUE(boost_ma > active_ma);
+    TEST_ASSERT_TRUE(active_ma > idle_ma);
+
+    // Idle: base + light sleep mix + max modem sleep, nothing else
+    const PowerModel& m = policy.getModel();
+    float expected = m.base_ma + m.cpu_active_ma_min * 0.2f + m.cpu_light_sleep_ma * 0.8f +
+                     m.wifi_max_modem_ma;
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, expected, idle_ma);
+}
+
+void test_busy_percent_is_clamped() {
+    PowerInputs in = interacting();
+    in.cpu_busy_percent = 100;
+    PowerDecision d = policy.evaluate(in);
+    float full = policy.estimateCurrentMa(in, d);
+    in.cpu_busy_percent = 250;
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, full, policy.estimateCurrentMa(in, d));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_interaction_runs_slow_and_awake);
+    RUN_TEST(test_any_boost_holds_max_clock);
+    RUN_TEST(test_idle_after_timeout_or_face_down);
+    RUN_TEST(test_light_sleep_needs_platform_config_and_quiet_mic);
+    RUN_TEST(test_radio_full_power_only_while_streaming);
+    RUN_TEST(test_current_estimate_orders_modes);
+    RUN_TEST(test_busy_percent_is_clamped);
+    return UNITY_END();
+}
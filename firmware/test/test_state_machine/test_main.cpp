@@ -0,0 +1,237 @@
+/**
+ * @file test_main.cpp
+ * @brief AppStateMachine and ring buffer tests, with an event-burst benchmark
+ */
+
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <optional>
+#include <thread>
+#include "ring_buffer.h"
+#include "state_machine_dsl.h"
+
+using namespace OpenClaw;
+using S = AppState;
+using E = AppEvent;
+
+// Every heap allocation in the process, to show dispatch makes none
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static uint32_t g_chunks = 0;
+static void countChunk() { g_chunks++; }
+
+using BurstMachine = Fsm::Machine<S::READY,
+    Fsm::States<
+        Fsm::StateDef<S::READY>,
+        Fsm::StateDef<S::AI_PROCESSING, 60000>,
+        Fsm::StateDef<S::AI_RESPONDING>>,
+    Fsm::Rows<
+        Fsm::Row<S::READY, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+        Fsm::Row<S::AI_PROCESSING, E::AI_RESPONSE_CHUNK, S::AI_RESPONDING, nullptr, countChunk>,
+        Fsm::Row<S::AI_PROCESSING, E::TIMEOUT, S::READY>,
+        Fsm::Row<S::AI_PROCESSING, E::TEXT_SUBMITTED, S::AI_PROCESSING>,
+        Fsm::Row<S::AI_RESPONDING, E::AI_RESPONSE_CHUNK, S::AI_RESPONDING, nullptr, countChunk>,
+        Fsm::Row<S::AI_RESPONDING, E::AI_RESPONSE_COMPLETE, S::READY>>>;
+
+using ReconnectMachine = Fsm::Machine<S::GATEWAY_CONNECTING,
+    Fsm::States<
+        Fsm::StateDef<S::GATEWAY_CONNECTING, 0, nullptr, nullptr, 5000>,
+        Fsm::StateDef<S::AUTHENTICATING>,
+        Fsm::StateDef<S::READY>,
+        Fsm::StateDef<S::ERROR_STATE, 5000>>,
+    Fsm::Rows<
+        Fsm::Row<S::GATEWAY_CONNECTING, E::GATEWAY_CONNECTED, S::AUTHENTICATING>,
+        Fsm::Row<S::GATEWAY_CONNECTING, E::GATEWAY_ERROR, S::ERROR_STATE>,
+        Fsm::Row<S::AUTHENTICATING, E::AUTHENTICATED, S::READY>,
+        Fsm::Row<S::READY, E::GATEWAY_DISCONNECTED, S::GATEWAY_CONNECTING>,
+        Fsm::Row<S::ERROR_STATE, E::TIMEOUT, S::GATEWAY_CONNECTING>>>;
+
+static std::optional<TimerWheel> timers;
+static std::optional<AppStateMachine> machine;
+
+void setUp() {
+    HostClock::set(0);
+    g_chunks = 0;
+    timers.emplace();
+    machine.emplace();
+}
+
+void tearDown() {
+    machine->end();
+    machine.reset();
+    timers.reset();
+}
+
+void test_ring_buffer_fifo_and_wrap() {
+    RingBuffer<int, 4> ring;
+    int out = 0;
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 4; i++) TEST_ASSERT_TRUE(ring.push(round * 4 + i));
+        TEST_ASSERT_FALSE(ring.push(-1));
+        for (int i = 0; i < 4; i++) {
+            TEST_ASSERT_TRUE(ring.pop(out));
+            TEST_ASSERT_EQUAL(round * 4 + i, out);
+        }
+        TEST_ASSERT_FALSE(ring.pop(out));
+    }
+}
+
+void test_spsc_ring_buffer_two_threads() {
+    static SpscRingBuffer<uint32_t, 64> ring;
+    constexpr uint32_t COUNT = 1000000;
+
+    std::thread producer([] {
+        for (uint32_t i = 0; i < COUNT; i++) {
+            while (!ring.push(i)) std::this_thread::yield();
+        }
+    });
+
+    uint32_t expected = 0;
+    uint32_t value = 0;
+    while (expected < COUNT) {
+        if (ring.pop(value)) {
+            if (value != expected) break;
+            expected++;
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_UINT32(COUNT, expected);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void test_dispatch_follows_table() {
+    TEST_ASSERT_TRUE(machine->begin(&BurstMachine::spec, &*timers));
+    TEST_ASSERT_EQUAL(S::READY, machine->getCurrentState());
+
+    machine->postEvent(E::AI_RESPONSE_CHUNK);       // No row in READY: ignored
+    machine->postEvent(E::TEXT_SUBMITTED);
+    machine->postEvent(E::AI_RESPONSE_CHUNK);
+    machine->postEvent(E::AI_RESPONSE_CHUNK);
+    machine->update();
+
+    TEST_ASSERT_EQUAL(S::AI_RESPONDING, machine->getCurrentState());
+    TEST_ASSERT_EQUAL_UINT32(2, g_chunks);
+}
+
+static void runUntil(uint32_t now_ms) {
+    HostClock::set(now_ms);
+    timers->advance(now_ms);
+    machine->update();
+}
+
+// A second prompt mid-wait gets a full timeout of its own
+void test_self_row_restarts_timeout() {
+    TEST_ASSERT_TRUE(machine->begin(&BurstMachine::spec, &*timers));
+    machine->postEvent(E::TEXT_SUBMITTED);
+    runUntil(0);
+    TEST_ASSERT_EQUAL(S::AI_PROCESSING, machine->getCurrentState());
+
+    machine->postEvent(E::TEXT_SUBMITTED);
+    runUntil(50000);
+    TEST_ASSERT_EQUAL(S::AI_PROCESSING, machine->getCurrentState());
+    TEST_ASSERT_EQUAL_UINT32(0, machine->getTimeInCurrentState());
+
+    runUntil(60001);
+    TEST_ASSERT_EQUAL(S::AI_PROCESSING, machine->getCurrentState());
+    runUntil(110001);
+    TEST_ASSERT_EQUAL(S::READY, machine->getCurrentState());
+}
+
+// The first reconnect after a drop is not held by the retry back-off
+void test_reconnect_after_drop_is_immediate() {
+    TEST_ASSERT_TRUE(machine->begin(&ReconnectMachine::spec, &*timers));
+    machine->postEvent(E::GATEWAY_CONNECTED);
+    machine->postEvent(E::AUTHENTICATED);
+    runUntil(100);
+    TEST_ASSERT_EQUAL(S::READY, machine->getCurrentState());
+
+    machine->postEvent(E::GATEWAY_DISCONNECTED);
+    runUntil(200);
+    TEST_ASSERT_EQUAL(S::GATEWAY_CONNECTING, machine->getCurrentState());
+    TEST_ASSERT_FALSE(machine->isTransitionPending());
+}
+
+// A retry after a failed attempt waits out the back-off
+void test_retry_after_failure_is_deferred() {
+    TEST_ASSERT_TRUE(machine->begin(&ReconnectMachine::spec, &*timers));
+    machine->postEvent(E::GATEWAY_ERROR);
+    runUntil(0);
+    TEST_ASSERT_EQUAL(S::ERROR_STATE, machine->getCurrentState());
+
+    runUntil(5000);
+    TEST_ASSERT_EQUAL(S::ERROR_STATE, machine->getCurrentState());
+    TEST_ASSERT_TRUE(machine->isTransitionPending());
+    TEST_ASSERT_EQUAL(S::GATEWAY_CONNECTING, machine->getPendingState());
+
+    runUntil(10000);
+    TEST_ASSERT_EQUAL(S::GATEWAY_CONNECTING, machine->getCurrentState());
+    TEST_ASSERT_FALSE(machine->isTransitionPending());
+}
+
+void test_full_queue_counts_drops() {
+    TEST_ASSERT_TRUE(machine->begin(&BurstMachine::spec, &*timers));
+    for (size_t i = 0; i < EVENT_QUEUE_CAPACITY; i++) {
+        TEST_ASSERT_TRUE(machine->postEvent(E::USER_ACTIVITY));
+    }
+    TEST_ASSERT_FALSE(machine->postEvent(E::USER_ACTIVITY));
+    TEST_ASSERT_EQUAL_UINT32(1, machine->getDroppedEventCount());
+    machine->update();
+    TEST_ASSERT_EQUAL_size_t(0, machine->getPendingEventCount());
+}
+
+// Bursts the size of the queue: a text turn streaming its reply back
+void test_burst_dispatch_benchmark() {
+    TEST_ASSERT_TRUE(machine->begin(&BurstMachine::spec, &*timers));
+
+    constexpr int BURSTS = 100000;
+    size_t allocations_before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int b = 0; b < BURSTS; b++) {
+        machine->postEvent(E::TEXT_SUBMITTED);
+        for (size_t i = 0; i < EVENT_QUEUE_CAPACITY - 2; i++) {
+            machine->postEvent(E::AI_RESPONSE_CHUNK);
+        }
+        machine->postEvent(E::AI_RESPONSE_COMPLETE);
+        machine->update();
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    size_t allocations = g_allocations - allocations_before;
+    double events = double(BURSTS) * EVENT_QUEUE_CAPACITY;
+    double ns_per_event = std::chrono::duration<double, std::nano>(elapsed).count() / events;
+
+    char report[96];
+    snprintf(report, sizeof(report), "%.0f events, %.1f ns/event, %zu allocations",
+             events, ns_per_event, allocations);
+    TEST_MESSAGE(report);
+
+    TEST_ASSERT_EQUAL_size_t(0, allocations);
+    TEST_ASSERT_EQUAL_UINT32(0, machine->getDroppedEventCount());
+    TEST_ASSERT_EQUAL_UINT32(uint32_t(BURSTS) * (EVENT_QUEUE_CAPACITY - 2), g_chunks);
+    TEST_ASSERT_EQUAL(S::READY, machine->getCurrentState());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_buffer_fifo_and_wrap);
+    RUN_TEST(test_spsc_ring_buffer_two_threads);
+    RUN_TEST(test_dispatch_follows_table);
+    RUN_TEST(test_self_row_restarts_timeout);
+    RUN_TEST(test_reconnect_after_drop_is_immediate);
+    RUN_TEST(test_retry_after_failure_is_deferred);
+    RUN_TEST(test_full_queue_counts_drops);
+    RUN_TEST(test_burst_dispatch_benchmark);
+    return UNITY_END();
+}
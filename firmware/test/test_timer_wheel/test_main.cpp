@@ -0,0 +1,312 @@
+/**
+ * @file test_main.cpp
+ * @brief TimerWheel: cascading, next-deadline, cancel from callbacks,
+ *        millis() wraparound, and a fuzz run against a sorted-deadline model
+ */
+
+#include <unity.h>
+#include <optional>
+#include <random>
+#include <vector>
+#include "timer_wheel.h"
+
+using namespace OpenClaw;
+
+static std::optional<TimerWheel> wheel;
+
+// Walk the (idle) wheel forward in steps it can follow; advance() only
+// moves forward by less than half the clock range at a time
+static void walkTo(uint32_t now) {
+    while (millis() != now) {
+        uint32_t step = now - millis();
+        if (step > 0x40000000) step = 0x40000000;
+        HostClock::advance(step);
+        wheel->advance(millis());
+    }
+}
+
+static void at(uint32_t now) {
+    HostClock::set(now);
+    wheel->advance(now);
+}
+
+// =============================================================================
+// Targeted cases
+// =============================================================================
+
+struct Fired {
+    std::vector<std::pair<int, uint32_t>> log;      // (tag, millis at fire)
+};
+static Fired fired;
+
+static void record(void* ctx) {
+    fired.log.push_back({int(reinterpret_cast<intptr_t>(ctx)), millis()});
+}
+
+void setUp() {
+    HostClock::set(0);
+    wheel.emplace();
+    fired.log.clear();
+}
+
+void tearDown() {
+    wheel.reset();
+}
+
+// One timer per level; each fires exactly at its deadline, not a tick
+// early, however far the clock jumps in between
+void test_cascades_through_every_level() {
+    const uint32_t delays[] = {10, 100, 5000, 300000, 10000000};
+    for (size_t i = 0; i < 5; i++) {
+        TEST_ASSERT_NOT_EQUAL(INVALID_TIMER_ID,
+                              wheel->schedule(delays[i], record, reinterpret_cast<void*>(i)));
+    }
+
+    for (size_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT32(delays[i] - millis(), wheel->msUntilNextDeadline(millis()));
+        at(delays[i] - 1);
+        TEST_ASSERT_EQUAL_size_t(i, fired.log.size());
+        TEST_ASSERT_EQUAL_UINT32(1, wheel->msUntilNextDeadline(millis()));
+        at(delays[i]);
+        TEST_ASSERT_EQUAL_size_t(i + 1, fired.log.size());
+        TEST_ASSERT_EQUAL_INT(int(i), fired.log[i].first);
+    }
+    TEST_ASSERT_EQUAL_UINT32(TIMER_WHEEL_NO_DEADLINE, wheel->msUntilNextDeadline(millis()));
+    TEST_ASSERT_EQUAL_size_t(0, wheel->getActiveCount());
+}
+
+// The deadline is exact whether advance() has kept up or is running late
+void test_next_deadline_is_exact() {
+    at(1000);
+    wheel->schedule(4097, record);
+    wheel->schedule(70, record);
+    TEST_ASSERT_EQUAL_UINT32(70, wheel->msUntilNextDeadline(1000));
+    TEST_ASSERT_EQUAL_UINT32(30, wheel->msUntilNextDeadline(1040));
+    TEST_ASSERT_EQUAL_UINT32(0, wheel->msUntilNextDeadline(1200));     // Overdue
+    at(1070);
+    TEST_ASSERT_EQUAL_UINT32(4027, wheel->msUntilNextDeadline(1070));
+
+    // Scheduled before advance() caught up: still relative to millis()
+    HostClock::set(2000);
+    wheel->schedule(5, record);
+    TEST_ASSERT_EQUAL_UINT32(5, wheel->msUntilNextDeadline(2000));
+}
+
+static TimerId rivals[2];
+static TimerId later;
+static TimerId periodic;
+
+// Fires first of the two rivals due in the same tick (either may), and
+// cancels the other, a timer due later, and a periodic one
+static void cancelOthers(void* ctx) {
+    record(ctx);
+    size_t self = size_t(reinterpret_cast<intptr_t>(ctx));
+    TEST_ASSERT_TRUE(wheel->cancel(rivals[1 - self]));
+    TEST_ASSERT_TRUE(wheel->cancel(later));
+    TEST_ASSERT_TRUE(wheel->cancel(periodic));
+}
+
+void test_cancel_from_callback() {
+    rivals[0] = wheel->schedule(50, cancelOthers, reinterpret_cast<void*>(0));
+    rivals[1] = wheel->schedule(50, cancelOthers, reinterpret_cast<void*>(1));
+    later = wheel->schedule(5000, record, reinterpret_cast<void*>(2));
+    periodic = wheel->scheduleEvery(50, record, reinterpret_cast<void*>(3));
+
+    at(10000);
+    TEST_ASSERT_TRUE(fired.log.size() <= 2);
+    size_t rivals_fired = 0;
+    for (auto& f : fired.log) {
+        if (f.first < 2) rivals_fired++;
+        TEST_ASSERT_NOT_EQUAL(2, f.first);
+    }
+    TEST_ASSERT_EQUAL_size_t(1, rivals_fired);
+    TEST_ASSERT_EQUAL_size_t(0, wheel->getActiveCount());
+    TEST_ASSERT_FALSE(wheel->cancel(later));         // Stale id
+    TEST_ASSERT_EQUAL_UINT32(TIMER_WHEEL_NO_DEADLINE, wheel->msUntilNextDeadline(millis()));
+}
+
+// Deadlines that straddle the 32-bit millis() wrap fire in order and on time
+void test_millis_wraparound() {
+    walkTo(0xFFFFFF00);
+    wheel->schedule(0x80, record, reinterpret_cast<void*>(1));        // Before the wrap
+    wheel->schedule(0x200, record, reinterpret_cast<void*>(2));       // After it
+    wheel->schedule(0x30000, record, reinterpret_cast<void*>(3));     // Level 2, after it
+    TEST_ASSERT_EQUAL_UINT32(0x80, wheel->msUntilNextDeadline(millis()));
+
+    at(0xFFFFFF7F);
+    TEST_ASSERT_EQUAL_size_t(0, fired.log.size());
+    at(0x00000100);
+    TEST_ASSERT_EQUAL_size_t(2, fired.log.size());
+    TEST_ASSERT_EQUAL_INT(1, fired.log[0].first);
+    TEST_ASSERT_EQUAL_INT(2, fired.log[1].first);
+    TEST_ASSERT_EQUAL_UINT32(0x30000 - 0x200, wheel->msUntilNextDeadline(millis()));
+    at(0x0002FEFF);
+    TEST_ASSERT_EQUAL_size_t(2, fired.log.size());
+    at(0x0002FF00);
+    TEST_ASSERT_EQUAL_size_t(3, fired.log.size());
+}
+
+// =============================================================================
+// Fuzz against a model: every live timer with its deadline, kept the
+// simple way (a linear scan for the minimum)
+// =============================================================================
+
+struct ModelTimer {
+    TimerId id;
+    uint32_t deadline;
+    uint32_t period;
+    bool live;
+};
+
+static std::vector<ModelTimer> model;
+static std::mt19937 rng;
+static uint32_t advance_to;
+static uint32_t last_deadline;
+static bool fired_any;
+static size_t wrong;
+
+static bool before(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+
+static uint32_t randomDelay() {
+    switch (rng() % 5) {
+        case 0: return rng() % 70;                  // Level 0 (and 0 itself)
+        case 1: return rng() % 4096;                // Level 1
+        case 2: return rng() % 262144;              // Level 2
+        case 3: return rng() % 10000000;            // Level 3
+        default: return 1 + rng() % 3;
+    }
+}
+
+static uint32_t modelDeadline(uint32_t delay) {
+    // What the wheel promises: at least 1 ms out, at most its horizon
+    constexpr uint32_t HORIZON = (1UL << 24) - (1UL << 18) - 1;
+    if (delay < 1) delay = 1;
+    if (delay > HORIZON) delay = HORIZON;
+    return millis() + delay;
+}
+
+static void fuzzFire(void* ctx) {
+    ModelTimer& t = model[size_t(reinterpret_cast<intptr_t>(ctx))];
+    if (!t.live || before(advance_to, t.deadline)) wrong++;     // Cancelled or early
+    if (fired_any && before(t.deadline, last_deadline)) wrong++; // Out of order
+    last_deadline = t.deadline;
+    fired_any = true;
+
+    if (t.period > 0) {
+        uint32_t next = t.deadline + t.period;
+        if (!before(advance_to, next)) {
+            next = t.deadline + ((advance_to - t.deadline) / t.period + 1) * t.period;
+        }
+        t.deadline = next;
+    } else {
+        t.live = false;
+    }
+
+    // Now and then cancel someone else from inside the callback
+    if (rng() % 4 == 0) {
+        ModelTimer& other = model[rng() % model.size()];
+        if (&other != &t && other.live) {
+            if (!wheel->cancel(other.id)) wrong++;
+            other.live = false;
+        }
+    }
+}
+
+static void checkAgainstModel() {
+    size_t live = 0;
+    bool any = false;
+    uint32_t earliest = 0;
+    for (const ModelTimer& t : model) {
+        if (!t.live) continue;
+        live++;
+        if (!before(advance_to, t.deadline)) wrong++;             // Missed
+        if (!any || before(t.deadline, earliest)) earliest = t.deadline;
+        any = true;
+    }
+    if (live != wheel->getActiveCount()) wrong++;
+    uint32_t expected = any ? earliest - advance_to : TIMER_WHEEL_NO_DEADLINE;
+    if (wheel->msUntilNextDeadline(advance_to) != expected) wrong++;
+}
+
+static void fuzzFrom(uint32_t start, uint32_t seed, int steps) {
+    rng.seed(seed);
+    model.clear();
+    model.reserve(size_t(steps) * 2 + 1);
+    fired_any = false;
+    walkTo(start);
+    advance_to = millis();
+
+    for (int step = 0; step < steps; step++) {
+        // Act at the current time: schedule, reschedule or cancel
+        switch (rng() % 6) {
+            case 0: case 1: case 2: {
+                bool periodic = rng() % 4 == 0;
+                uint32_t delay = periodic ? 1 + rng() % 2000 : randomDelay();
+                void* ctx = reinterpret_cast<void*>(intptr_t(model.size()));
+                TimerId id = periodic ? wheel->scheduleEvery(delay, fuzzFire, ctx)
+                                      : wheel->schedule(delay, fuzzFire, ctx);
+                if (id != INVALID_TIMER_ID) {
+                    model.push_back({id, modelDeadline(delay), periodic ? delay : 0, true});
+                }
+                break;
+            }
+            case 3: {
+                if (model.empty()) break;
+                ModelTimer& t = model[rng() % model.size()];
+                uint32_t delay = randomDelay();
+                bool live = t.live && wheel->reschedule(t.id, delay);
+                if (live != t.live) wrong++;
+                if (live) t.deadline = modelDeadline(delay);
+                break;
+            }
+            case 4: {
+                if (model.empty()) break;
+                ModelTimer& t = model[rng() % model.size()];
+                if (wheel->cancel(t.id) != t.live) wrong++;
+                t.live = false;
+                break;
+            }
+            default:
+                break;
+        }
+
+        // Then let time pass: a tick, a busy loop, or a long sleep
+        uint32_t pass;
+        switch (rng() % 3) {
+            case 0: pass = rng() % 4; break;
+            case 1: pass = rng() % 5000; break;
+            default: pass = rng() % 400000; break;
+        }
+        HostClock::advance(pass);
+        advance_to = millis();
+        wheel->advance(advance_to);
+        checkAgainstModel();
+    }
+}
+
+void test_fuzz_against_model() {
+    wrong = 0;
+    fuzzFrom(0, 1, 100000);
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+    TEST_ASSERT_TRUE(wheel->getFiredCount() > 50000);
+}
+
+// Same, with the run crossing the 32-bit wrap
+void test_fuzz_across_wraparound() {
+    wrong = 0;
+    fuzzFrom(0xFF000000, 2, 100000);
+    TEST_ASSERT_TRUE(millis() < 0xFF000000);        // Wrapped
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+    TEST_ASSERT_TRUE(wheel->getFiredCount() > 50000);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_cascades_through_every_level);
+    RUN_TEST(test_next_deadline_is_exact);
+    RUN_TEST(test_cancel_from_callback);
+    RUN_TEST(test_millis_wraparound);
+    RUN_TEST(test_fuzz_against_model);
+    RUN_TEST(test_fuzz_across_wraparound);
+    return UNITY_END();
+}
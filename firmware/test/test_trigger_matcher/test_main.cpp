@@ -0,0 +1,155 @@
+/**
+ * @file test_main.cpp
+ * @brief Trigger matcher: case folding, overlapping phrases, phrases split
+ *        across feeds, and the insult/please checks it replaced
+ */
+
+#include <unity.h>
+#include <algorithm>
+#include <cctype>
+#include <random>
+#include <string>
+#include "trigger_matcher.h"
+
+using namespace OpenClaw;
+
+static const TriggerMask ANCIENT = triggerBit(TriggerId::ANCIENT_MODE);
+static const TriggerMask RITUAL = triggerBit(TriggerId::RITUAL_AWAKEN);
+static const TriggerMask INSULT = triggerBit(TriggerId::INSULT);
+static const TriggerMask PLEASE = triggerBit(TriggerId::PLEASE);
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_case_is_folded() {
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT, scanTriggers("Speak As Minerva") & ANCIENT);
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT, scanTriggers("OWL MODE") & ANCIENT);
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT, scanTriggers("oWl MoDe, now") & ANCIENT);
+    TEST_ASSERT_EQUAL_UINT32(PLEASE, scanTriggers("PlEaSe"));
+
+    // Only letters fold: punctuation and spacing must match exactly
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers("owl  mode"));
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers("owlmode"));
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers("speak as minerv4"));
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers(""));
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers(nullptr));
+}
+
+// One phrase can belong to several triggers, and phrases can end inside
+// each other; every one is reported
+void test_overlapping_phrases_set_every_trigger() {
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL, scanTriggers("ancient wisdom"));
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL, scanTriggers("By the Thirty-Seven Claws!"));
+    TEST_ASSERT_EQUAL_UINT32(RITUAL, scanTriggers("by the thirty seven claws"));
+
+    // "owl mode" inside "owl mode activate"
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL, scanTriggers("owl mode activate"));
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT, scanTriggers("owl mode act"));
+
+    // "speak ancient" runs into "ancient wisdom"
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL, scanTriggers("speak ancient wisdom"));
+    TEST_ASSERT_EQUAL_UINT32(RITUAL, scanTriggers("minerva, awaken"));
+
+    // Everything at once
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL | INSULT | PLEASE,
+                             scanTriggers("please, ancient wisdom, this buggy thing"));
+}
+
+// A phrase split anywhere across feeds matches, in the feed where it ends
+void test_phrase_split_across_feeds() {
+    const std::string text = "the owl says: Ancient Wisdom, please";
+    const TriggerMask whole = scanTriggers(text.c_str());
+    TEST_ASSERT_EQUAL_UINT32(ANCIENT | RITUAL | PLEASE, whole);
+
+    for (size_t split = 0; split <= text.size(); split++) {
+        TriggerScanner scanner;
+        TriggerMask first = scanner.feed(text.data(), split);
+        TriggerMask second = scanner.feed(text.c_str() + split);
+
+        // "ancient wisdom" ends at offset 28, "please" at the very end
+        TriggerMask expect_first = (split >= 28 ? ANCIENT | RITUAL : 0) |
+                                   (split == text.size() ? PLEASE : 0);
+        TEST_ASSERT_EQUAL_UINT32(expect_first, first);
+        TEST_ASSERT_EQUAL_UINT32(whole & ~expect_first, second);
+    }
+
+    // One byte at a time
+    TriggerScanner scanner;
+    TriggerMask mask = 0;
+    for (char c : text) mask |= scanner.feed(&c, 1);
+    TEST_ASSERT_EQUAL_UINT32(whole, mask);
+
+    // reset() drops a partial match
+    scanner.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, scanner.feed("ancient wis"));
+    scanner.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, scanner.feed("dom"));
+}
+
+// =============================================================================
+// Insults and please, as EasterEggManager checked them before the
+// matcher: lower-case the text, then look for each word anywhere in it
+// =============================================================================
+
+static const char* const OLD_INSULTS[] = {
+    "stupid", "dumb", "idiot", "useless", "broken",
+    "trash", "garbage", "worst", "hate", "suck",
+    "terrible", "awful", "bad code", "buggy"
+};
+
+static TriggerMask oldEasterEggTriggers(const std::string& text) {
+    std::string t = text;
+    std::transform(t.begin(), t.end(), t.begin(), [](unsigned char c) { return std::tolower(c); });
+    TriggerMask mask = 0;
+    for (const char* insult : OLD_INSULTS) {
+        if (t.find(insult) != std::string::npos) mask |= INSULT;
+    }
+    if (t.find("please") != std::string::npos) mask |= PLEASE;
+    return mask;
+}
+
+void test_insult_and_please_match_old_checks() {
+    // Substring matches, as before: "whatever" holds "hate"
+    TEST_ASSERT_EQUAL_UINT32(INSULT, scanTriggers("whatever"));
+    TEST_ASSERT_EQUAL_UINT32(INSULT, scanTriggers("this SUCKS"));
+    TEST_ASSERT_EQUAL_UINT32(PLEASE, scanTriggers("I'm displeased"));
+    TEST_ASSERT_EQUAL_UINT32(0, scanTriggers("bad  code"));
+
+    static const char* const PIECES[] = {
+        "please", "PLEASE", "plea", "se", "stupid", "Dumb", "idiot", "use", "less",
+        "broken", "trash", "garbage", "worst", "hate", "suck", "terrible", "awful",
+        "bad", "code", "bad code", "buggy", "bug", "gy", "w", "hat", "ever", "owl",
+        "the", "a", " ", " ", ",", "!", "-", "x",
+    };
+    constexpr size_t PIECE_COUNT = sizeof(PIECES) / sizeof(PIECES[0]);
+
+    std::mt19937 rng(1);
+    size_t wrong = 0;
+    size_t insults = 0;
+    size_t pleases = 0;
+    for (int i = 0; i < 100000; i++) {
+        std::string text;
+        size_t pieces = 1 + rng() % 8;
+        for (size_t p = 0; p < pieces; p++) {
+            text += PIECES[rng() % PIECE_COUNT];
+        }
+        TriggerMask expected = oldEasterEggTriggers(text);
+        TriggerMask got = scanTriggers(text.c_str()) & (INSULT | PLEASE);
+        if (got != expected) wrong++;
+        if (expected & INSULT) insults++;
+        if (expected & PLEASE) pleases++;
+    }
+    TEST_ASSERT_EQUAL_size_t(0, wrong);
+    TEST_ASSERT_TRUE(insults > 10000);
+    TEST_ASSERT_TRUE(pleases > 10000);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_case_is_folded);
+    RUN_TEST(test_overlapping_phrases_set_every_trigger);
+    RUN_TEST(test_phrase_split_across_feeds);
+    RUN_TEST(test_insult_and_please_match_old_checks);
+    return UNITY_END();
+}